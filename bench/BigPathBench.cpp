@@ -6,8 +6,13 @@
  */
 
 #include "Benchmark.h"
+#include "SkBitmap.h"
+#include "SkBitmapProcShader.h"
+#include "SkBlitter.h"
 #include "SkCanvas.h"
 #include "SkPath.h"
+#include "SkRasterClip.h"
+#include "SkScan.h"
 #include "SkString.h"
 
 static void make_path(SkPath& path) {
@@ -22,22 +27,41 @@ enum Align {
 
 const char* gAlignName[] = { "left", "middle", "right" };
 
+// kCanvas_Scan draws through the canvas.  The others stroke the path up front and scan-convert
+// the fill straight into an offscreen bitmap, choosing the anti-aliasing algorithm explicitly
+// rather than through the process-wide gSkUseAnalyticAA.
+enum Scan {
+    kCanvas_Scan,
+    kSupersample_Scan,
+    kAnalytic_Scan
+};
+
+const char* gScanSuffix[] = { "", "_ssaa", "_aaa" };
+
 // Inspired by crbug.com/455429
 class BigPathBench : public Benchmark {
     SkPath      fPath;
     SkString    fName;
     Align       fAlign;
     bool        fRound;
+    Scan        fScan;
+    SkBitmap    fScanDst;
 
 public:
-    BigPathBench(Align align, bool round) : fAlign(align), fRound(round) {
+    BigPathBench(Align align, bool round, Scan scan = kCanvas_Scan)
+        : fAlign(align), fRound(round), fScan(scan) {
         fName.printf("bigpath_%s", gAlignName[fAlign]);
         if (round) {
             fName.append("_round");
         }
+        fName.append(gScanSuffix[fScan]);
     }
 
 protected:
+    bool isSuitableFor(Backend backend) override {
+        return (kCanvas_Scan != fScan) == (kNonRendering_Backend == backend);
+    }
+
     const char* onGetName() override {
         return fName.c_str();
     }
@@ -47,37 +71,64 @@ protected:
     }
 
     void onPreDraw() override {
+        fPath.reset();
         make_path(fPath);
+        if (kCanvas_Scan != fScan) {
+            SkPaint paint;
+            this->setupStroke(&paint);
+            SkPath fill;
+            paint.getFillPath(fPath, &fill);
+            fill.offset(this->alignDX(), 0, &fPath);
+            fScanDst.allocN32Pixels(640, 100);
+        }
     }
 
     void onDraw(const int loops, SkCanvas* canvas) override {
         SkPaint paint;
-        paint.setAntiAlias(true);
-        paint.setStyle(SkPaint::kStroke_Style);
-        paint.setStrokeWidth(2);
+        this->setupStroke(&paint);
+        this->setupPaint(&paint);
+
+        if (kCanvas_Scan != fScan) {
+            paint.setStyle(SkPaint::kFill_Style);
+            const SkRasterClip clip(SkIRect::MakeWH(fScanDst.width(), fScanDst.height()));
+            SkTBlitterAllocator allocator;
+            SkBlitter* blitter = SkBlitter::Choose(fScanDst, SkMatrix::I(), paint, &allocator);
+            for (int i = 0; i < loops; i++) {
+                SkScan::AntiFillPath(fPath, clip, blitter, kAnalytic_Scan == fScan);
+            }
+            return;
+        }
+
+        canvas->translate(this->alignDX(), 0);
+        for (int i = 0; i < loops; i++) {
+            canvas->drawPath(fPath, paint);
+        }
+    }
+
+private:
+    void setupStroke(SkPaint* paint) const {
+        paint->setAntiAlias(true);
+        paint->setStyle(SkPaint::kStroke_Style);
+        paint->setStrokeWidth(2);
         if (fRound) {
-            paint.setStrokeJoin(SkPaint::kRound_Join);
+            paint->setStrokeJoin(SkPaint::kRound_Join);
         }
-        this->setupPaint(&paint);
+    }
 
+    SkScalar alignDX() const {
         const SkRect r = fPath.getBounds();
         switch (fAlign) {
             case kLeft_Align:
-                canvas->translate(-r.left(), 0);
-                break;
+                return -r.left();
             case kMiddle_Align:
-                break;
+                return 0;
             case kRight_Align:
-                canvas->translate(640 - r.right(), 0);
-                break;
-        }
-
-        for (int i = 0; i < loops; i++) {
-            canvas->drawPath(fPath, paint);
+                return 640 - r.right();
         }
+        SkASSERT(false);
+        return 0;
     }
 
-private:
     typedef Benchmark INHERITED;
 };
 
@@ -89,3 +140,19 @@ DEF_BENCH( return new BigPathBench(kLeft_Align,     true); )
 DEF_BENCH( return new BigPathBench(kMiddle_Align,   true); )
 DEF_BENCH( return new BigPathBench(kRight_Align,    true); )
 
+
+DEF_BENCH( return new BigPathBench(kLeft_Align,     false, kSupersample_Scan); )
+DEF_BENCH( return new BigPathBench(kMiddle_Align,   false, kSupersample_Scan); )
+DEF_BENCH( return new BigPathBench(kRight_Align,    false, kSupersample_Scan); )
+
+DEF_BENCH( return new BigPathBench(kLeft_Align,     true, kSupersample_Scan); )
+DEF_BENCH( return new BigPathBench(kMiddle_Align,   true, kSupersample_Scan); )
+DEF_BENCH( return new BigPathBench(kRight_Align,    true, kSupersample_Scan); )
+
+DEF_BENCH( return new BigPathBench(kLeft_Align,     false, kAnalytic_Scan); )
+DEF_BENCH( return new BigPathBench(kMiddle_Align,   false, kAnalytic_Scan); )
+DEF_BENCH( return new BigPathBench(kRight_Align,    false, kAnalytic_Scan); )
+
+DEF_BENCH( return new BigPathBench(kLeft_Align,     true, kAnalytic_Scan); )
+DEF_BENCH( return new BigPathBench(kMiddle_Align,   true, kAnalytic_Scan); )
+DEF_BENCH( return new BigPathBench(kRight_Align,    true, kAnalytic_Scan); )
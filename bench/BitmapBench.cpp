@@ -7,6 +7,7 @@
 
 #include "Benchmark.h"
 #include "SkBitmap.h"
+#include "SkBitmapProcState.h"
 #include "SkCanvas.h"
 #include "SkColorPriv.h"
 #include "SkPaint.h"
@@ -270,6 +271,98 @@ private:
     typedef BitmapBench INHERITED;
 };
 
+/** Bilerps an N32 bitmap through the scale (and rotate) FilterBitmapBench uses, calling the
+    matrix and sample procs SkBitmapProcShader would use without gSkUse4fBilerp, or the SkPMFloat
+    shader procs it would use with it.  We call the procs ourselves rather than set
+    gSkUse4fBilerp, which other threads may be drawing with. */
+
+class BilerpProcsBench : public Benchmark {
+    enum { W = 128 };
+    enum { H = 128 };
+
+    const SkAlphaType   fAlphaType;
+    const bool          fRotate;
+    const bool          fUse4f;
+    SkString            fName;
+    SkBitmap            fSrc;
+    SkBitmap            fDst;
+    SkBitmapProcState   fState;
+
+public:
+    BilerpProcsBench(SkAlphaType at, bool rotate, bool use4f)
+        : fAlphaType(at)
+        , fRotate(rotate)
+        , fUse4f(use4f) {
+        fName.printf("bitmap_procs_8888%s_scale%s_bilerp%s",
+                     kOpaque_SkAlphaType == at ? "" : "_A",
+                     rotate ? "_rotate" : "",
+                     use4f ? "_4f" : "");
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override {
+        return kNonRendering_Backend == backend;
+    }
+
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onPreDraw() override {
+        SkRandom rand;
+        fSrc.allocPixels(SkImageInfo::MakeN32(W, H, fAlphaType));
+        for (int y = 0; y < H; ++y) {
+            for (int x = 0; x < W; ++x) {
+                *fSrc.getAddr32(x, y) = kOpaque_SkAlphaType == fAlphaType
+                                      ? rand.nextU() | 0xFF000000
+                                      : SkPreMultiplyColor(rand.nextU());
+            }
+        }
+        fDst.allocN32Pixels(W, H);
+
+        const SkScalar cx = SkIntToScalar(W) / 2,
+                       cy = SkIntToScalar(H) / 2;
+        SkMatrix matrix;
+        matrix.setScale(.99f, .99f, cx, cy);
+        if (fRotate) {
+            matrix.postRotate(35, cx, cy);
+        }
+        SkMatrix inv;
+        SkAssertResult(matrix.invert(&inv));
+        SkPaint paint;
+        paint.setFilterQuality(kLow_SkFilterQuality);
+        SkAssertResult(fState.setupForTesting(fSrc, SkShader::kClamp_TileMode,
+                                              SkShader::kClamp_TileMode, inv, paint));
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        static const unsigned kScaleTranslate = SkMatrix::kTranslate_Mask | SkMatrix::kScale_Mask;
+        const SkBitmapProcState::ShaderProc32 proc4f =
+                0 == (fState.fInvType & ~kScaleTranslate) ? S32_D32_filter_DX_4f_shaderproc
+                                                          : S32_D32_filter_DXDY_4f_shaderproc;
+        uint32_t xy[W * 2 + 1];
+        const int max = fState.maxCountForBufferSize(sizeof(xy));
+
+        for (int i = 0; i < loops; i++) {
+            for (int y = 0; y < H; ++y) {
+                SkPMColor* row = fDst.getAddr32(0, y);
+                if (fUse4f) {
+                    proc4f(fState, 0, y, row, W);
+                    continue;
+                }
+                for (int x = 0; x < W; x += max) {
+                    const int n = SkTMin(max, W - x);
+                    fState.getMatrixProc()(fState, xy, n, x, y);
+                    fState.getSampleProc32()(fState, xy, n, row + x);
+                }
+            }
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
 /** Verify optimizations that test source alpha values. */
 
 class SourceAlphaBitmapBench : public BitmapBench {
@@ -380,6 +473,16 @@ DEF_BENCH( return new FilterBitmapBench(kN32_SkColorType, kOpaque_SkAlphaType, f
 DEF_BENCH( return new FilterBitmapBench(kN32_SkColorType, kOpaque_SkAlphaType, true, true, kScale_Flag | kRotate_Flag | kBilerp_Flag); )
 DEF_BENCH( return new FilterBitmapBench(kN32_SkColorType, kOpaque_SkAlphaType, true, false, kScale_Flag | kRotate_Flag | kBilerp_Flag); )
 
+// scale (rotate) filter, sample procs vs. S32_D32_filter_{DX,DXDY}_4f_shaderproc
+DEF_BENCH( return new BilerpProcsBench(kPremul_SkAlphaType, false, false); )
+DEF_BENCH( return new BilerpProcsBench(kPremul_SkAlphaType, false, true); )
+DEF_BENCH( return new BilerpProcsBench(kOpaque_SkAlphaType, false, false); )
+DEF_BENCH( return new BilerpProcsBench(kOpaque_SkAlphaType, false, true); )
+DEF_BENCH( return new BilerpProcsBench(kPremul_SkAlphaType, true, false); )
+DEF_BENCH( return new BilerpProcsBench(kPremul_SkAlphaType, true, true); )
+DEF_BENCH( return new BilerpProcsBench(kOpaque_SkAlphaType, true, false); )
+DEF_BENCH( return new BilerpProcsBench(kOpaque_SkAlphaType, true, true); )
+
 DEF_BENCH( return new FilterBitmapBench(kN32_SkColorType, kPremul_SkAlphaType, false, false, kScale_Flag | kBilerp_Flag | kBicubic_Flag); )
 DEF_BENCH( return new FilterBitmapBench(kN32_SkColorType, kPremul_SkAlphaType, false, false, kScale_Flag | kRotate_Flag | kBilerp_Flag | kBicubic_Flag); )
 
@@ -6,12 +6,14 @@
  */
 
 #include "Benchmark.h"
+#include "SkBitmapProcState.h"
 #include "SkBlurMask.h"
 #include "SkCanvas.h"
 #include "SkPaint.h"
 #include "SkRandom.h"
 #include "SkShader.h"
 #include "SkString.h"
+#include "SkTemplates.h"
 
 class BitmapScaleBench: public Benchmark {
     int         fLoopCount;
@@ -101,6 +103,49 @@ private:
     typedef BitmapScaleBench INHERITED;
 };
 
+// Bilerp, with the matrix and sample procs SkBitmapProcShader would use without gSkUse4fBilerp,
+// or the SkPMFloat shader procs it would use with it.  We call the procs ourselves rather than
+// set gSkUse4fBilerp, which other threads may be drawing with.
+class BitmapBilerpScaleBench: public BitmapScaleBench {
+ public:
+    BitmapBilerpScaleBench( int is, int os, bool use4f) : INHERITED(is, os), fUse4f(use4f) {
+        setName( use4f ? "bilerp_4f" : "bilerp" );
+    }
+protected:
+    void preBenchSetup() override {
+        SkMatrix inv;
+        SkAssertResult(fMatrix.invert(&inv));
+        SkPaint paint;
+        paint.setFilterQuality(kLow_SkFilterQuality);
+        SkAssertResult(fState.setupForTesting(fInputBitmap, SkShader::kClamp_TileMode,
+                                              SkShader::kClamp_TileMode, inv, paint));
+        fXY.reset(2 * this->outputSize() + 1);
+    }
+
+    void doScaleImage() override {
+        const int size = this->outputSize();
+        const int max = fState.maxCountForBufferSize(sizeof(uint32_t) * (2 * size + 1));
+        for (int y = 0; y < size; ++y) {
+            SkPMColor* row = fOutputBitmap.getAddr32(0, y);
+            if (fUse4f) {
+                S32_D32_filter_DX_4f_shaderproc(fState, 0, y, row, size);
+                continue;
+            }
+            for (int x = 0; x < size; x += max) {
+                const int n = SkTMin(max, size - x);
+                fState.getMatrixProc()(fState, fXY.get(), n, x, y);
+                fState.getSampleProc32()(fState, fXY.get(), n, row + x);
+            }
+        }
+    }
+private:
+    bool fUse4f;
+    SkBitmapProcState fState;
+    SkAutoTMalloc<uint32_t> fXY;
+
+    typedef BitmapScaleBench INHERITED;
+};
+
 DEF_BENCH(return new BitmapFilterScaleBench(10, 90);)
 DEF_BENCH(return new BitmapFilterScaleBench(30, 90);)
 DEF_BENCH(return new BitmapFilterScaleBench(80, 90);)
@@ -110,3 +155,10 @@ DEF_BENCH(return new BitmapFilterScaleBench(90, 30);)
 DEF_BENCH(return new BitmapFilterScaleBench(90, 10);)
 DEF_BENCH(return new BitmapFilterScaleBench(256, 64);)
 DEF_BENCH(return new BitmapFilterScaleBench(64, 256);)
+
+DEF_BENCH(return new BitmapBilerpScaleBench(30, 90, false);)
+DEF_BENCH(return new BitmapBilerpScaleBench(30, 90, true);)
+DEF_BENCH(return new BitmapBilerpScaleBench(90, 30, false);)
+DEF_BENCH(return new BitmapBilerpScaleBench(90, 30, true);)
+DEF_BENCH(return new BitmapBilerpScaleBench(64, 256, false);)
+DEF_BENCH(return new BitmapBilerpScaleBench(64, 256, true);)
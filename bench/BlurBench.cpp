@@ -6,6 +6,7 @@
  * found in the LICENSE file.
  */
 #include "Benchmark.h"
+#include "SkBitmap.h"
 #include "SkBlurMask.h"
 #include "SkBlurMaskFilter.h"
 #include "SkCanvas.h"
@@ -27,17 +28,30 @@ static const char* gStyleName[] = {
     "inner"
 };
 
+// Name suffixes for forcing SkBlurMask's box blurs to one implementation or the other.  Those
+// benches blur an oval mask with SkBlurMask::BoxBlur directly, passing the policy explicitly
+// rather than changing gSkBlurMaskSk4Policy while other threads may be blurring.
+static const char* gSk4PolicySuffix[] = {
+    "_scalar",
+    "",
+    "_sk4",
+};
+
 class BlurBench : public Benchmark {
     SkScalar    fRadius;
     SkBlurStyle fStyle;
     uint32_t    fFlags;
+    SkBlurMaskSk4Policy fSk4Policy;
     SkString    fName;
+    SkBitmap    fOval;
 
 public:
-    BlurBench(SkScalar rad, SkBlurStyle bs, uint32_t flags = 0) {
+    BlurBench(SkScalar rad, SkBlurStyle bs, uint32_t flags = 0,
+              SkBlurMaskSk4Policy sk4Policy = kWhenFaster_SkBlurMaskSk4Policy) {
         fRadius = rad;
         fStyle = bs;
         fFlags = flags;
+        fSk4Policy = sk4Policy;
         const char* name = rad > 0 ? gStyleName[bs] : "none";
         const char* quality = flags & SkBlurMaskFilter::kHighQuality_BlurFlag ? "high_quality"
                                                                               : "low_quality";
@@ -46,14 +60,52 @@ public:
         } else {
             fName.printf("blur_%d_%s_%s", SkScalarRoundToInt(rad), name, quality);
         }
+        fName.append(gSk4PolicySuffix[sk4Policy]);
     }
 
 protected:
-    virtual const char* onGetName() {
+    bool forcesSk4Policy() const {
+        return kWhenFaster_SkBlurMaskSk4Policy != fSk4Policy;
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return this->forcesSk4Policy() == (kNonRendering_Backend == backend);
+    }
+
+    const char* onGetName() override {
         return fName.c_str();
     }
 
-    virtual void onDraw(const int loops, SkCanvas* canvas) {
+    void onPreDraw() override {
+        if (this->forcesSk4Policy()) {
+            fOval.allocPixels(SkImageInfo::MakeA8(200, 200));
+            fOval.eraseColor(SK_ColorTRANSPARENT);
+            SkCanvas canvas(fOval);
+            SkPaint paint;
+            paint.setAntiAlias(true);
+            canvas.drawOval(SkRect::MakeWH(200, 200), paint);
+        }
+    }
+
+    void onDraw(const int loops, SkCanvas* canvas) override {
+        if (this->forcesSk4Policy()) {
+            SkMask src;
+            src.fImage = fOval.getAddr8(0, 0);
+            src.fBounds = fOval.bounds();
+            src.fRowBytes = SkToU32(fOval.rowBytes());
+            src.fFormat = SkMask::kA8_Format;
+
+            const SkScalar sigma = SkBlurMask::ConvertRadiusToSigma(fRadius);
+            const SkBlurQuality quality = fFlags & SkBlurMaskFilter::kHighQuality_BlurFlag
+                                        ? kHigh_SkBlurQuality : kLow_SkBlurQuality;
+            for (int i = 0; i < loops; i++) {
+                SkMask dst;
+                SkBlurMask::BoxBlur(&dst, src, sigma, fStyle, quality, fSk4Policy);
+                SkMask::FreeImage(dst.fImage);
+            }
+            return;
+        }
+
         SkPaint paint;
         this->setupPaint(&paint);
 
@@ -115,3 +167,18 @@ DEF_BENCH(return new BlurBench(REALBIG, kNormal_SkBlurStyle, SkBlurMaskFilter::k
 DEF_BENCH(return new BlurBench(REAL, kNormal_SkBlurStyle, SkBlurMaskFilter::kHighQuality_BlurFlag);)
 
 DEF_BENCH(return new BlurBench(0, kNormal_SkBlurStyle);)
+
+DEF_BENCH(return new BlurBench(BIG, kNormal_SkBlurStyle, 0, kNever_SkBlurMaskSk4Policy);)
+DEF_BENCH(return new BlurBench(BIG, kNormal_SkBlurStyle, 0, kAlways_SkBlurMaskSk4Policy);)
+DEF_BENCH(return new BlurBench(REALBIG, kNormal_SkBlurStyle, 0, kNever_SkBlurMaskSk4Policy);)
+DEF_BENCH(return new BlurBench(REALBIG, kNormal_SkBlurStyle, 0, kAlways_SkBlurMaskSk4Policy);)
+DEF_BENCH(return new BlurBench(BIG, kNormal_SkBlurStyle, SkBlurMaskFilter::kHighQuality_BlurFlag,
+                               kNever_SkBlurMaskSk4Policy);)
+DEF_BENCH(return new BlurBench(BIG, kNormal_SkBlurStyle, SkBlurMaskFilter::kHighQuality_BlurFlag,
+                               kAlways_SkBlurMaskSk4Policy);)
+DEF_BENCH(return new BlurBench(REALBIG, kNormal_SkBlurStyle,
+                               SkBlurMaskFilter::kHighQuality_BlurFlag,
+                               kNever_SkBlurMaskSk4Policy);)
+DEF_BENCH(return new BlurBench(REALBIG, kNormal_SkBlurStyle,
+                               SkBlurMaskFilter::kHighQuality_BlurFlag,
+                               kAlways_SkBlurMaskSk4Policy);)
@@ -6,19 +6,27 @@
 */
 
 #include "Benchmark.h"
+#include "SkBlurMask.h"
 #include "SkBlurMaskFilter.h"
 #include "SkCanvas.h"
 #include "SkPaint.h"
 #include "SkPath.h"
 #include "SkRect.h"
 #include "SkString.h"
+#include "SkTemplates.h"
 
 class BlurRectsBench : public Benchmark {
 public:
-    BlurRectsBench(SkRect outer, SkRect inner, SkScalar radius) {
+    BlurRectsBench(SkRect outer, SkRect inner, SkScalar radius,
+                   SkBlurMaskSk4Policy sk4Policy) {
         fRadius = radius;
         fOuter = outer;
         fInner = inner;
+        fSk4Policy = sk4Policy;
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return this->forcesSk4Policy() == (kNonRendering_Backend == backend);
     }
 
     const char* onGetName() override {
@@ -27,9 +35,42 @@ public:
 
     void setName(const SkString& name) {
         fName = name;
+        switch (fSk4Policy) {
+            case kNever_SkBlurMaskSk4Policy:  fName.append("_scalar"); break;
+            case kAlways_SkBlurMaskSk4Policy: fName.append("_sk4");    break;
+            default: break;
+        }
+    }
+
+    // Benches forcing an Sk4 policy blur the mask of the rects with SkBlurMask::BoxBlur
+    // directly, passing the policy explicitly rather than changing gSkBlurMaskSk4Policy while
+    // other threads may be blurring.
+    void onPreDraw() override {
+        if (this->forcesSk4Policy()) {
+            // Both rects wind the same way, so the path covers all of fOuter.
+            SkIRect bounds;
+            fOuter.roundOut(&bounds);
+            fMask.fBounds = bounds;
+            fMask.fRowBytes = bounds.width();
+            fMask.fFormat = SkMask::kA8_Format;
+            fMaskImage.reset(fMask.computeImageSize());
+            fMask.fImage = fMaskImage.get();
+            memset(fMask.fImage, 0xFF, fMask.computeImageSize());
+        }
     }
 
     void onDraw(const int loops, SkCanvas* canvas) override {
+        if (this->forcesSk4Policy()) {
+            // The blur mask filter below takes fRadius as its sigma.
+            for (int i = 0; i < loops; i++) {
+                SkMask dst;
+                SkBlurMask::BoxBlur(&dst, fMask, fRadius, kNormal_SkBlurStyle,
+                                    kLow_SkBlurQuality, fSk4Policy);
+                SkMask::FreeImage(dst.fImage);
+            }
+            return;
+        }
+
         SkPaint paint;
         paint.setMaskFilter(SkBlurMaskFilter::Create(kNormal_SkBlurStyle, fRadius))->unref();
 
@@ -47,14 +88,22 @@ private:
     SkRect      fOuter;
     SkRect      fInner;
     SkScalar    fRadius;
+    SkBlurMaskSk4Policy fSk4Policy;
+    SkMask      fMask;
+    SkAutoTMalloc<uint8_t> fMaskImage;
+
+    bool forcesSk4Policy() const {
+        return kWhenFaster_SkBlurMaskSk4Policy != fSk4Policy;
+    }
 
     typedef     Benchmark INHERITED;
 };
 
 class BlurRectsNinePatchBench: public BlurRectsBench {
 public:
-    BlurRectsNinePatchBench(SkRect outer, SkRect inner, SkScalar radius)
-        : INHERITED(outer, inner, radius) {
+    BlurRectsNinePatchBench(SkRect outer, SkRect inner, SkScalar radius,
+                            SkBlurMaskSk4Policy sk4Policy = kWhenFaster_SkBlurMaskSk4Policy)
+        : INHERITED(outer, inner, radius, sk4Policy) {
         this->setName(SkString("blurrectsninepatch"));
     }
 private:
@@ -63,8 +112,9 @@ private:
 
 class BlurRectsNonNinePatchBench: public BlurRectsBench {
 public:
-    BlurRectsNonNinePatchBench(SkRect outer, SkRect inner, SkScalar radius)
-        : INHERITED(outer, inner, radius) {
+    BlurRectsNonNinePatchBench(SkRect outer, SkRect inner, SkScalar radius,
+                               SkBlurMaskSk4Policy sk4Policy = kWhenFaster_SkBlurMaskSk4Policy)
+        : INHERITED(outer, inner, radius, sk4Policy) {
         SkString name;
         this->setName(SkString("blurrectsnonninepatch"));
     }
@@ -78,3 +128,25 @@ DEF_BENCH(return new BlurRectsNinePatchBench(SkRect::MakeXYWH(10, 10, 100, 100),
 DEF_BENCH(return new BlurRectsNonNinePatchBench(SkRect::MakeXYWH(10, 10, 100, 100),
                                                 SkRect::MakeXYWH(50, 50, 10, 10),
                                                 4.3f);)
+
+class BlurRectsLargeBench: public BlurRectsBench {
+public:
+    BlurRectsLargeBench(SkRect outer, SkRect inner, SkScalar radius,
+                        SkBlurMaskSk4Policy sk4Policy = kWhenFaster_SkBlurMaskSk4Policy)
+        : INHERITED(outer, inner, radius, sk4Policy) {
+        this->setName(SkString("blurrectslarge"));
+    }
+private:
+    typedef BlurRectsBench INHERITED;
+};
+
+// The mask is 256 rows tall, where BoxBlur's transposing passes switch to Sk4i by default.
+DEF_BENCH(return new BlurRectsLargeBench(SkRect::MakeXYWH(10, 10, 320, 256),
+                                         SkRect::MakeXYWH(60, 60, 40, 40),
+                                         4.3f);)
+DEF_BENCH(return new BlurRectsLargeBench(SkRect::MakeXYWH(10, 10, 320, 256),
+                                         SkRect::MakeXYWH(60, 60, 40, 40),
+                                         4.3f, kNever_SkBlurMaskSk4Policy);)
+DEF_BENCH(return new BlurRectsLargeBench(SkRect::MakeXYWH(10, 10, 320, 256),
+                                         SkRect::MakeXYWH(60, 60, 40, 40),
+                                         4.3f, kAlways_SkBlurMaskSk4Policy);)
@@ -8,6 +8,8 @@
 #include "Benchmark.h"
 #include "SkCanvas.h"
 #include "SkPaint.h"
+#include "SkPicture.h"
+#include "SkPictureRecorder.h"
 #include "SkRandom.h"
 
 /**
@@ -190,3 +192,110 @@ private:
 
 DEF_BENCH( return new ChartBench(true); )
 DEF_BENCH( return new ChartBench(false); )
+
+//////////////////////////////////////////////////////////////////////////////
+
+// Stacked bar charts: one bar per tick for each series, all the bars of a series in one paint.
+// Compares drawing them one drawRect() at a time with drawing them through drawRects(), and with
+// playing back a picture of the one-at-a-time draws, which SkRecordOptimize() batches.
+class BarChartBench : public Benchmark {
+public:
+    enum Mode {
+        kDrawRect_Mode,
+        kDrawRects_Mode,
+        kPicture_Mode,
+    };
+
+    BarChartBench(Mode mode) : fMode(mode) {
+        fSize.fWidth = -1;
+        fSize.fHeight = -1;
+    }
+
+protected:
+    const char* onGetName() override {
+        switch (fMode) {
+            case kDrawRect_Mode:  return "chart_bars_rect";
+            case kDrawRects_Mode: return "chart_bars_rects";
+            case kPicture_Mode:   return "chart_bars_picture";
+        }
+        SkFAIL("Unknown mode");
+        return NULL;
+    }
+
+    void onDraw(const int loops, SkCanvas* canvas) override {
+        if (canvas->getDeviceSize() != fSize) {
+            fSize = canvas->getDeviceSize();
+            this->makeBars();
+        }
+
+        for (int frame = 0; frame < loops; ++frame) {
+            canvas->clear(0xFFE0F0E0);
+            if (kPicture_Mode == fMode) {
+                canvas->drawPicture(fPicture);
+            } else {
+                this->drawBars(canvas);
+            }
+        }
+    }
+
+private:
+    enum {
+        kNumSeries = 5,
+        kPixelsPerBar = 4,
+    };
+
+    void makeBars() {
+        int barCount = SkMax32(fSize.fWidth / kPixelsPerBar, 1);
+        SkScalar height = SkIntToScalar(fSize.fHeight);
+        SkScalar maxBar = height / kNumSeries;
+
+        SkRandom random;
+        SkTDArray<SkScalar> bottoms;
+        bottoms.setCount(barCount);
+        for (int j = 0; j < barCount; ++j) {
+            bottoms[j] = height;
+        }
+        for (int i = 0; i < kNumSeries; ++i) {
+            fBars[i].setCount(barCount);
+            for (int j = 0; j < barCount; ++j) {
+                SkScalar top = bottoms[j] - random.nextRangeScalar(0, maxBar);
+                fBars[i][j].setLTRB(SkIntToScalar(j * kPixelsPerBar), top,
+                                    SkIntToScalar((j + 1) * kPixelsPerBar - 1), bottoms[j]);
+                bottoms[j] = top;
+            }
+            fColors[i] = random.nextU() | 0xff000000;
+        }
+
+        if (kPicture_Mode == fMode) {
+            SkPictureRecorder recorder;
+            this->drawBars(recorder.beginRecording(SkIntToScalar(fSize.fWidth), height));
+            fPicture.reset(recorder.endRecording());
+        }
+    }
+
+    void drawBars(SkCanvas* canvas) const {
+        SkPaint paint;
+        for (int i = 0; i < kNumSeries; ++i) {
+            paint.setColor(fColors[i]);
+            if (kDrawRects_Mode == fMode) {
+                canvas->drawRects(fBars[i].begin(), fBars[i].count(), paint);
+            } else {
+                for (int j = 0; j < fBars[i].count(); ++j) {
+                    canvas->drawRect(fBars[i][j], paint);
+                }
+            }
+        }
+    }
+
+    Mode                    fMode;
+    SkISize                 fSize;
+    SkTDArray<SkRect>       fBars[kNumSeries];
+    SkColor                 fColors[kNumSeries];
+    SkAutoTUnref<SkPicture> fPicture;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new BarChartBench(BarChartBench::kDrawRect_Mode); )
+DEF_BENCH( return new BarChartBench(BarChartBench::kDrawRects_Mode); )
+DEF_BENCH( return new BarChartBench(BarChartBench::kPicture_Mode); )
@@ -0,0 +1,73 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "CodecBench.h"
+#include "SkBitmap.h"
+#include "SkCodec.h"
+#include "SkOSFile.h"
+#include "SkScanlineDecoder.h"
+
+CodecBench::CodecBench(SkString path, SkColorType colorType, float scale)
+    : fColorType(colorType)
+    , fScale(scale)
+{
+    // Parse filename and the color type to give the benchmark a useful name
+    SkString baseName = SkOSPath::Basename(path.c_str());
+    const char* colorName;
+    switch(colorType) {
+        case kN32_SkColorType:
+            colorName = "N32";
+            break;
+        case kRGB_565_SkColorType:
+            colorName = "565";
+            break;
+        case kGray_8_SkColorType:
+            colorName = "Gray8";
+            break;
+        default:
+            colorName = "Unknown";
+    }
+    fName.printf("Codec_%s_%s", baseName.c_str(), colorName);
+    if (scale < 1.0f) {
+        fName.appendf("_%.3f", scale);
+    }
+
+    fData.reset(SkData::NewFromFileName(path.c_str()));
+}
+
+const char* CodecBench::onGetName() {
+    return fName.c_str();
+}
+
+bool CodecBench::isSuitableFor(Backend backend) {
+    return kNonRendering_Backend == backend;
+}
+
+void CodecBench::onDraw(const int n, SkCanvas* canvas) {
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(fData));
+    if (!codec) {
+        return;
+    }
+    const SkISize size = codec->getScaledDimensions(fScale);
+    const SkImageInfo info = codec->getInfo().makeWH(size.width(), size.height())
+                                             .makeColorType(fColorType);
+    SkBitmap bitmap;
+    if (!bitmap.tryAllocPixels(info)) {
+        return;
+    }
+
+    for (int i = 0; i < n; i++) {
+        // The scanline decoder is owned by codec, and replaced by the next call.
+        SkScanlineDecoder* scanlineDecoder = codec->getScanlineDecoder(info);
+        if (!scanlineDecoder) {
+            return;
+        }
+        for (int y = 0; y < info.height(); y++) {
+            scanlineDecoder->getScanlines(bitmap.getAddr(0, y), 1, bitmap.rowBytes());
+        }
+    }
+}
@@ -0,0 +1,36 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkData.h"
+#include "SkImageInfo.h"
+#include "SkString.h"
+
+/*
+ *
+ * This benchmark is designed to test the performance of image decoding through
+ * SkCodec, one scanline at a time, optionally scaling down as it decodes.
+ * It is invoked from the nanobench.cpp file.
+ *
+ */
+class CodecBench : public Benchmark {
+public:
+    // scale is passed to SkCodec::getScaledDimensions to pick the output size.
+    CodecBench(SkString path, SkColorType colorType, float scale);
+
+protected:
+    const char* onGetName() override;
+    bool isSuitableFor(Backend backend) override;
+    void onDraw(const int n, SkCanvas* canvas) override;
+
+private:
+    SkString                fName;
+    SkColorType             fColorType;
+    float                   fScale;
+    SkAutoTUnref<SkData>    fData;
+    typedef Benchmark INHERITED;
+};
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkDistanceFieldGen.h"
+#include "SkPath.h"
+#include "SkString.h"
+#include "SkTemplates.h"
+
+// Generates the distance field of a glyph-sized mask, as distance field text does for every new
+// glyph, with either the exact distance transform or the 8SSEDT sweeps.
+class DistanceFieldBench : public Benchmark {
+public:
+    DistanceFieldBench(int size, bool exact) : fSize(size), fExact(exact) {
+        fName.printf("distance_field_%d_%s", size, exact ? "exact" : "8ssedt");
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onPreDraw() override {
+        // Something glyph-like: a ring with a slanted stem through it.
+        fMask.allocPixels(SkImageInfo::MakeA8(fSize, fSize));
+        fMask.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas canvas(fMask);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        paint.setStyle(SkPaint::kStroke_Style);
+        paint.setStrokeWidth(fSize * 0.12f);
+        canvas.drawOval(SkRect::MakeLTRB(fSize * 0.2f, fSize * 0.25f,
+                                         fSize * 0.8f, fSize * 0.85f), paint);
+        SkPath stem;
+        stem.moveTo(fSize * 0.65f, fSize * 0.1f);
+        stem.lineTo(fSize * 0.45f, fSize * 0.9f);
+        canvas.drawPath(stem, paint);
+
+        const int dfSize = fSize + 2*SK_DistanceFieldPad;
+        fDistanceField.reset(dfSize * dfSize);
+
+        // Report how far this transform's output is from the other's.
+        SkAutoTMalloc<unsigned char> other(dfSize * dfSize);
+        this->generate(fDistanceField.get(), fExact);
+        this->generate(other.get(), !fExact);
+        int sum = 0, max = 0;
+        for (int i = 0; i < dfSize * dfSize; ++i) {
+            const int diff = SkTAbs(fDistanceField[i] - other[i]);
+            sum += diff;
+            max = SkTMax(max, diff);
+        }
+        SkDebugf("%s: differs from %s by %g on average, %d at most\n", fName.c_str(),
+                 fExact ? "8ssedt" : "exact", (double)sum / (dfSize * dfSize), max);
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; ++i) {
+            this->generate(fDistanceField.get(), fExact);
+        }
+    }
+
+private:
+    void generate(unsigned char* distanceField, bool exact) {
+        SkAutoLockPixels alp(fMask);
+        const unsigned char* image = (const unsigned char*)fMask.getPixels();
+        if (exact) {
+            SkGenerateDistanceFieldFromA8ImageExact(distanceField, image, fMask.width(),
+                                                    fMask.height(), fMask.rowBytes());
+        } else {
+            SkGenerateDistanceFieldFromA8Image8SSEDT(distanceField, image, fMask.width(),
+                                                     fMask.height(), fMask.rowBytes());
+        }
+    }
+
+    int                          fSize;
+    bool                         fExact;
+    SkString                     fName;
+    SkBitmap                     fMask;
+    SkAutoTMalloc<unsigned char> fDistanceField;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return SkNEW_ARGS(DistanceFieldBench, (32, true)); )
+DEF_BENCH( return SkNEW_ARGS(DistanceFieldBench, (32, false)); )
+DEF_BENCH( return SkNEW_ARGS(DistanceFieldBench, (160, true)); )
+DEF_BENCH( return SkNEW_ARGS(DistanceFieldBench, (160, false)); )
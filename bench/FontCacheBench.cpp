@@ -10,6 +10,7 @@
 #include "SkChecksum.h"
 #include "SkPaint.h"
 #include "SkString.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 
 #include "gUniqueGlyphIDs.h"
@@ -53,6 +54,63 @@ private:
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// Measures the same glyphs at many text sizes from many threads at once.  Each size gets its own
+// glyph cache, so this stresses contention on the shared font cache rather than glyph lookup.
+class FontCacheThreadedBench : public Benchmark {
+public:
+    FontCacheThreadedBench(int tasks) : fTasks(tasks) {
+        fName.printf("fontcache_mt_%d", tasks);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    struct Task {
+        int fLoops;
+        SkScalar fTextSize;
+    };
+
+    static void MeasureText(Task* task) {
+        SkPaint paint;
+        paint.setTextSize(task->fTextSize);
+        paint.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+
+        for (int i = 0; i < task->fLoops; ++i) {
+            const uint16_t* array = gUniqueGlyphIDs;
+            while (*array != gUniqueGlyphIDs_Sentinel) {
+                int count = count_glyphs(array);
+                paint.measureText(array, count * sizeof(uint16_t));
+                array += count + 1;    // skip the sentinel
+            }
+        }
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        SkAutoTMalloc<Task> tasks(fTasks);
+        for (int i = 0; i < fTasks; ++i) {
+            tasks[i].fLoops = loops;
+            tasks[i].fTextSize = SkIntToScalar(8 + i);
+        }
+        SkTaskGroup tg;
+        tg.batch(MeasureText, tasks.get(), fTasks);
+        tg.wait();
+    }
+
+private:
+    int      fTasks;
+    SkString fName;
+
+    typedef Benchmark INHERITED;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
 static uint32_t rotr(uint32_t value, unsigned bits) {
     return (value >> bits) | (value << (32 - bits));
 }
@@ -142,6 +200,9 @@ private:
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new FontCacheBench(); )
+DEF_BENCH( return new FontCacheThreadedBench(1); )
+DEF_BENCH( return new FontCacheThreadedBench(8); )
+DEF_BENCH( return new FontCacheThreadedBench(32); )
 
 // undefine this to run the efficiency test
 //DEF_BENCH( return new FontCacheEfficiency(); )
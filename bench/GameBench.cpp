@@ -29,12 +29,13 @@ public:
 
     GameBench(Type type, Clear clear,
               bool aligned = false, bool useAtlas = false,
-              bool useDrawVertices = false)
+              bool useDrawVertices = false, bool useBatch = false)
         : fType(type)
         , fClear(clear)
         , fAligned(aligned)
         , fUseAtlas(useAtlas)
         , fUseDrawVertices(useDrawVertices)
+        , fUseBatch(useBatch)
         , fName("game")
         , fNumSaved(0)
         , fInitialized(false) {
@@ -69,6 +70,12 @@ public:
             fName.append("_drawVerts");
         }
 
+        // Batching folds the translation into each sprite's dst rect.
+        SkASSERT(!useBatch || (useAtlas && !useDrawVertices && kTranslate_Type == type));
+        if (useBatch) {
+            fName.append("_batch");
+        }
+
         // It's HTML 5 canvas, so always AA
         fName.append("_aa");
     }
@@ -132,6 +139,10 @@ protected:
         };
         uint16_t indices[6] = { 0, 1, 2, 0, 2, 3 };
 
+        // for drawBitmapRects path, the sprites drawn since the last clear
+        SkRect batchSrc[kNumBeforeClear], batchDst[kNumBeforeClear];
+        int numBatched = 0;
+
         SkPaint p;
         p.setColor(0xFF000000);
         p.setFilterQuality(kLow_SkFilterQuality);
@@ -145,6 +156,12 @@ protected:
 
         for (int i = 0; i < loops; ++i, ++fNumSaved) {
             if (0 == i % kNumBeforeClear) {
+                if (numBatched > 0) {
+                    canvas->setMatrix(SkMatrix::I());
+                    canvas->drawBitmapRects(fAtlas, batchSrc, batchDst, numBatched, &p);
+                    numBatched = 0;
+                }
+
                 if (kPartial_Clear == fClear) {
                     for (int j = 0; j < fNumSaved; ++j) {
                         canvas->setMatrix(SkMatrix::I());
@@ -193,7 +210,12 @@ protected:
                 const int curCell = i % (kNumAtlasedX * kNumAtlasedY);
                 SkIRect src = fAtlasRects[curCell % (kNumAtlasedX)][curCell / (kNumAtlasedX)];
 
-                if (fUseDrawVertices) {
+                if (fUseBatch) {
+                    batchSrc[numBatched].set(src);
+                    batchDst[numBatched] = dst.makeOffset(fSaved[fNumSaved][0],
+                                                          fSaved[fNumSaved][1]);
+                    numBatched++;
+                } else if (fUseDrawVertices) {
                     SkPoint uvs[4] = {
                         { SkIntToScalar(src.fLeft),  SkIntToScalar(src.fBottom) },
                         { SkIntToScalar(src.fLeft),  SkIntToScalar(src.fTop) },
@@ -211,6 +233,11 @@ protected:
                 canvas->drawBitmapRect(fCheckerboard, NULL, dst, &p);
             }
         }
+
+        if (numBatched > 0) {
+            canvas->setMatrix(SkMatrix::I());
+            canvas->drawBitmapRects(fAtlas, batchSrc, batchDst, numBatched, &p);
+        }
     }
 
 private:
@@ -233,6 +260,7 @@ private:
     bool     fAligned;
     bool     fUseAtlas;
     bool     fUseDrawVertices;
+    bool     fUseBatch;
     SkString fName;
     int      fNumSaved; // num draws stored in 'fSaved'
     bool     fInitialized;
@@ -332,3 +360,5 @@ DEF_BENCH( return SkNEW_ARGS(GameBench, (GameBench::kTranslate_Type,
                                             GameBench::kFull_Clear, false, true)); )
 DEF_BENCH( return SkNEW_ARGS(GameBench, (GameBench::kTranslate_Type,
                                             GameBench::kFull_Clear, false, true, true)); )
+DEF_BENCH( return SkNEW_ARGS(GameBench, (GameBench::kTranslate_Type,
+                                            GameBench::kFull_Clear, false, true, false, true)); )
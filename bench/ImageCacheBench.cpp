@@ -7,6 +7,10 @@
 
 #include "Benchmark.h"
 #include "SkResourceCache.h"
+#include "SkShardedResourceCache.h"
+#include "SkString.h"
+#include "SkTaskGroup.h"
+#include "SkTemplates.h"
 
 namespace {
 static void* gGlobalAddress;
@@ -70,6 +74,74 @@ private:
     typedef Benchmark INHERITED;
 };
 
+// Many threads hitting one thread-safe cache at once, the way raster threads share the global
+// cache.  The cache is filled up front, outside the timed loop, and each thread looks up its own
+// keys, adding back any that have been purged.
+class ImageCacheContentionBench : public Benchmark {
+    enum {
+        CACHE_COUNT = 500,
+        THREADS     = 8,
+    };
+
+    struct Work {
+        SkShardedResourceCache* fCache;
+        int                     fThread;
+        int                     fLoops;
+    };
+
+    const int                              fShards;
+    SkString                               fName;
+    SkAutoTDelete<SkShardedResourceCache>  fCache;
+
+public:
+    explicit ImageCacheContentionBench(int shards) : fShards(shards) {
+        fName.printf("imagecache_contention_%dshards", shards);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    static void Hammer(Work* work) {
+        for (int i = 0; i < work->fLoops; ++i) {
+            TestKey key(work->fThread * CACHE_COUNT + (i % CACHE_COUNT));
+            if (!work->fCache->find(key, TestRec::Visitor, NULL)) {
+                work->fCache->add(SkNEW_ARGS(TestRec, (key, i)));
+            }
+        }
+    }
+
+    void onPreDraw() override {
+        fCache.reset(SkNEW_ARGS(SkShardedResourceCache, (fShards, THREADS * CACHE_COUNT * 100)));
+        for (int i = 0; i < THREADS * CACHE_COUNT; ++i) {
+            fCache->add(SkNEW_ARGS(TestRec, (TestKey(i), i)));
+        }
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        Work work[THREADS];
+        for (int i = 0; i < THREADS; ++i) {
+            work[i].fCache  = fCache.get();
+            work[i].fThread = i;
+            work[i].fLoops  = loops;
+        }
+        SkTaskGroup tg;
+        tg.batch(Hammer, work, THREADS);
+        tg.wait();
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new ImageCacheBench(); )
+DEF_BENCH( return new ImageCacheContentionBench(1); )
+DEF_BENCH( return new ImageCacheContentionBench(8); )
+DEF_BENCH( return new ImageCacheContentionBench(32); )
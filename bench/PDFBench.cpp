@@ -0,0 +1,101 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkCanvas.h"
+#include "SkColorPriv.h"
+#include "SkDocument.h"
+#include "SkRandom.h"
+#include "SkStream.h"
+#include "SkString.h"
+#include "SkTArray.h"
+
+namespace {
+// Counts the bytes written to it, and throws them away.
+class NullWStream : public SkWStream {
+public:
+    NullWStream() : fBytesWritten(0) {}
+    bool write(const void*, size_t size) override {
+        fBytesWritten += size;
+        return true;
+    }
+    size_t bytesWritten() const override { return fBytesWritten; }
+
+private:
+    size_t fBytesWritten;
+};
+}  // namespace
+
+// Writes a PDF of pages pages, each with a different image and a few hundred shapes, so that
+// most of the time goes to deflating content streams and images.
+class PDFBench : public Benchmark {
+public:
+    PDFBench(int pages, bool streaming) : fPages(pages), fStreaming(streaming) {
+        fName.printf("pdf_document_%d_%s", pages, streaming ? "streaming" : "at_close");
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onPreDraw() override {
+        SkRandom rand;
+        for (int i = 0; i < fPages; ++i) {
+            SkBitmap& bitmap = fBitmaps.push_back();
+            bitmap.allocN32Pixels(256, 256, true);
+            for (int y = 0; y < 256; ++y) {
+                for (int x = 0; x < 256; ++x) {
+                    // Smooth, with a little noise: about as compressible as a photo.
+                    *bitmap.getAddr32(x, y) = SkPackARGB32(0xFF, x & 0xF8, y & 0xF8,
+                                                           ((x + y) / 2 + 8 * i) & 0xF8) +
+                                              (rand.nextU() & 0x070707);
+                }
+            }
+            bitmap.setImmutable();
+        }
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; ++i) {
+            NullWStream stream;
+            SkAutoTUnref<SkDocument> doc(fStreaming ? SkDocument::CreateStreamingPDF(&stream)
+                                                    : SkDocument::CreatePDF(&stream));
+            SkRandom rand;
+            for (int page = 0; page < fPages; ++page) {
+                SkCanvas* canvas = doc->beginPage(612, 792);
+                canvas->drawBitmap(fBitmaps[page], 50, 50);
+                SkPaint paint;
+                for (int j = 0; j < 300; ++j) {
+                    paint.setColor(rand.nextU() | 0xFF000000);
+                    canvas->drawRect(SkRect::MakeXYWH(rand.nextRangeScalar(0, 560),
+                                                      rand.nextRangeScalar(0, 740),
+                                                      rand.nextRangeScalar(1, 50),
+                                                      rand.nextRangeScalar(1, 50)), paint);
+                }
+                doc->endPage();
+            }
+            doc->close();
+        }
+    }
+
+private:
+    int                fPages;
+    bool               fStreaming;
+    SkTArray<SkBitmap> fBitmaps;
+    SkString           fName;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return SkNEW_ARGS(PDFBench, (1, false)); )
+DEF_BENCH( return SkNEW_ARGS(PDFBench, (8, false)); )
+DEF_BENCH( return SkNEW_ARGS(PDFBench, (8, true)); )
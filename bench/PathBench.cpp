@@ -7,17 +7,25 @@
  */
 #include "Benchmark.h"
 #include "SkBitmap.h"
+#include "SkBitmapProcShader.h"
+#include "SkBlitter.h"
 #include "SkCanvas.h"
 #include "SkColorPriv.h"
 #include "SkPaint.h"
 #include "SkRandom.h"
+#include "SkRasterClip.h"
+#include "SkScan.h"
 #include "SkShader.h"
 #include "SkString.h"
 #include "SkTArray.h"
 
 enum Flags {
-    kStroke_Flag = 1 << 0,
-    kBig_Flag    = 1 << 1
+    kStroke_Flag   = 1 << 0,
+    kBig_Flag      = 1 << 1,
+    // Scan-convert fills straight into an offscreen bitmap, choosing the anti-aliasing
+    // algorithm explicitly rather than through the process-wide gSkUseAnalyticAA.
+    kAnalytic_Flag    = 1 << 2,
+    kSupersample_Flag = 1 << 3,
 };
 
 #define FLAGS00  Flags(0)
@@ -25,12 +33,19 @@ enum Flags {
 #define FLAGS10  Flags(kBig_Flag)
 #define FLAGS11  Flags(kStroke_Flag | kBig_Flag)
 
+#define FLAGS00A Flags(kAnalytic_Flag)
+#define FLAGS10A Flags(kBig_Flag | kAnalytic_Flag)
+#define FLAGS00S Flags(kSupersample_Flag)
+#define FLAGS10S Flags(kBig_Flag | kSupersample_Flag)
+
 class PathBench : public Benchmark {
     SkPaint     fPaint;
     SkString    fName;
     Flags       fFlags;
+    SkBitmap    fScanDst;
 public:
     PathBench(Flags flags) : fFlags(flags) {
+        SkASSERT(!this->isScan() || !(flags & kStroke_Flag));
         fPaint.setStyle(flags & kStroke_Flag ? SkPaint::kStroke_Style :
                         SkPaint::kFill_Style);
         fPaint.setStrokeWidth(SkIntToScalar(5));
@@ -42,14 +57,34 @@ public:
     virtual int complexity() { return 0; }
 
 protected:
+    bool isScan() const {
+        return SkToBool(fFlags & (kAnalytic_Flag | kSupersample_Flag));
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return this->isScan() == (kNonRendering_Backend == backend);
+    }
+
     const char* onGetName() override {
         fName.printf("path_%s_%s_",
                      fFlags & kStroke_Flag ? "stroke" : "fill",
                      fFlags & kBig_Flag ? "big" : "small");
         this->appendName(&fName);
+        if (fFlags & kAnalytic_Flag) {
+            fName.append("_aaa");
+        } else if (fFlags & kSupersample_Flag) {
+            fName.append("_ssaa");
+        }
         return fName.c_str();
     }
 
+    void onPreDraw() override {
+        if (this->isScan()) {
+            const SkIPoint size = this->getSize();
+            fScanDst.allocN32Pixels(size.fX, size.fY);
+        }
+    }
+
     void onDraw(const int loops, SkCanvas* canvas) override {
         SkPaint paint(fPaint);
         this->setupPaint(&paint);
@@ -68,6 +103,17 @@ protected:
         }
         count >>= (3 * complexity());
 
+        if (this->isScan()) {
+            const bool analytic = SkToBool(fFlags & kAnalytic_Flag);
+            const SkRasterClip clip(SkIRect::MakeWH(fScanDst.width(), fScanDst.height()));
+            SkTBlitterAllocator allocator;
+            SkBlitter* blitter = SkBlitter::Choose(fScanDst, SkMatrix::I(), paint, &allocator);
+            for (int i = 0; i < count; i++) {
+                SkScan::AntiFillPath(path, clip, blitter, analytic);
+            }
+            return;
+        }
+
         for (int i = 0; i < count; i++) {
             canvas->drawPath(path, paint);
         }
@@ -383,11 +429,14 @@ private:
 
 class PathTransformBench : public RandomPathBench {
 public:
-    PathTransformBench(bool inPlace) : fInPlace(inPlace) {}
+    // If getBounds, the copies are only asked for their bounds, as a layout pass might do.
+    PathTransformBench(bool inPlace, bool getBounds = false)
+        : fInPlace(inPlace), fGetBounds(getBounds) {}
 
 protected:
     const char* onGetName() override {
-        return fInPlace ? "path_transform_in_place" : "path_transform_copy";
+        return fInPlace ? "path_transform_in_place"
+                        : fGetBounds ? "path_transform_copy_bounds" : "path_transform_copy";
     }
 
     void onPreDraw() override {
@@ -401,6 +450,7 @@ protected:
         if (!fInPlace) {
             fTransformed.reset(kPathCnt);
         }
+        fBounds.setEmpty();
     }
 
     void onDraw(const int loops, SkCanvas*) override {
@@ -412,6 +462,9 @@ protected:
             for (int i = 0; i < loops; ++i) {
                 int idx = i & (kPathCnt - 1);
                 fPaths[idx].transform(fMatrix, &fTransformed[idx]);
+                if (fGetBounds) {
+                    fBounds.join(fTransformed[idx].getBounds());
+                }
             }
         }
     }
@@ -425,7 +478,9 @@ private:
     SkAutoTArray<SkPath> fTransformed;
 
     SkMatrix fMatrix;
+    SkRect fBounds;
     bool fInPlace;
+    bool fGetBounds;
     typedef RandomPathBench INHERITED;
 };
 
@@ -1054,10 +1109,31 @@ DEF_BENCH( return new LongCurvedPathBench(FLAGS01); )
 DEF_BENCH( return new LongLinePathBench(FLAGS00); )
 DEF_BENCH( return new LongLinePathBench(FLAGS01); )
 
+DEF_BENCH( return new TrianglePathBench(FLAGS00A); )
+DEF_BENCH( return new TrianglePathBench(FLAGS10A); )
+DEF_BENCH( return new OvalPathBench(FLAGS00A); )
+DEF_BENCH( return new OvalPathBench(FLAGS10A); )
+DEF_BENCH( return new CirclePathBench(FLAGS00A); )
+DEF_BENCH( return new CirclePathBench(FLAGS10A); )
+DEF_BENCH( return new SawToothPathBench(FLAGS00A); )
+DEF_BENCH( return new LongCurvedPathBench(FLAGS00A); )
+DEF_BENCH( return new LongLinePathBench(FLAGS00A); )
+
+DEF_BENCH( return new TrianglePathBench(FLAGS00S); )
+DEF_BENCH( return new TrianglePathBench(FLAGS10S); )
+DEF_BENCH( return new OvalPathBench(FLAGS00S); )
+DEF_BENCH( return new OvalPathBench(FLAGS10S); )
+DEF_BENCH( return new CirclePathBench(FLAGS00S); )
+DEF_BENCH( return new CirclePathBench(FLAGS10S); )
+DEF_BENCH( return new SawToothPathBench(FLAGS00S); )
+DEF_BENCH( return new LongCurvedPathBench(FLAGS00S); )
+DEF_BENCH( return new LongLinePathBench(FLAGS00S); )
+
 DEF_BENCH( return new PathCreateBench(); )
 DEF_BENCH( return new PathCopyBench(); )
 DEF_BENCH( return new PathTransformBench(true); )
 DEF_BENCH( return new PathTransformBench(false); )
+DEF_BENCH( return new PathTransformBench(false, true); )
 DEF_BENCH( return new PathEqualityBench(); )
 
 DEF_BENCH( return new SkBench_AddPathTest(SkBench_AddPathTest::kAdd_AddType); )
@@ -0,0 +1,121 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkPath.h"
+#include "SkPathOps.h"
+#include "SkRandom.h"
+#include "SkString.h"
+
+// A large input: a grid of small, overlapping shapes, each its own contour. This is the
+// sort of path (many contours, mostly far apart) that pathops can split across threads.
+static void make_grid(int n, SkScalar offset, SkPath* path) {
+    SkRandom rand(n);
+    const SkScalar kCell = 10;
+    for (int y = 0; y < n; ++y) {
+        for (int x = 0; x < n; ++x) {
+            SkScalar l = x * kCell + offset + rand.nextRangeScalar(0, 2),
+                     t = y * kCell + offset + rand.nextRangeScalar(0, 2);
+            path->moveTo(l, t);
+            path->lineTo(l + 12, t + rand.nextRangeScalar(0, 3));
+            path->quadTo(l + 14, t + 8, l + 8 + rand.nextRangeScalar(0, 3), t + 12);
+            path->lineTo(l + rand.nextRangeScalar(0, 3), t + 10);
+            path->close();
+        }
+    }
+}
+
+class PathOpsBench : public Benchmark {
+public:
+    // Simplifies a grid of n * n contours, or unions two of them if union is set.
+    PathOpsBench(int n, bool unionOp) : fUnion(unionOp) {
+        make_grid(n, 0, &fOne);
+        make_grid(n, 5, &fTwo);
+        fName.printf("pathops_%s_grid_%d", unionOp ? "union" : "simplify", n);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        SkPath result;
+        for (int i = 0; i < loops; ++i) {
+            if (fUnion) {
+                Op(fOne, fTwo, kUnion_PathOp, &result);
+            } else {
+                Simplify(fOne, &result);
+            }
+        }
+    }
+
+private:
+    SkPath   fOne, fTwo;
+    bool     fUnion;
+    SkString fName;
+
+    typedef Benchmark INHERITED;
+};
+
+// Unions n * n overlapping shapes with an SkOpBuilder, each shape a separate operand.
+class OpBuilderBench : public Benchmark {
+public:
+    OpBuilderBench(int n, SkOpBuilder::Reduction reduction) : fReduction(reduction) {
+        static const char* kNames[] = { "sequential", "balanced", "parallel" };
+        SkRandom rand;
+        for (int y = 0; y < n; ++y) {
+            for (int x = 0; x < n; ++x) {
+                SkPath& path = fPaths.push_back();
+                path.addCircle(x * 10 + rand.nextRangeScalar(0, 2),
+                               y * 10 + rand.nextRangeScalar(0, 2), 7);
+                // Not convex, so the builder has to do the ops.
+                path.addRect(x * 10.f, y * 10.f, x * 10.f + 4, y * 10.f + 4);
+            }
+        }
+        fName.printf("pathops_builder_union_%s_%d", kNames[reduction], n);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        SkPath result;
+        for (int i = 0; i < loops; ++i) {
+            SkOpBuilder builder(fReduction);
+            for (int j = 0; j < fPaths.count(); ++j) {
+                builder.add(fPaths[j], kUnion_PathOp);
+            }
+            builder.resolve(&result);
+        }
+    }
+
+private:
+    SkTArray<SkPath>       fPaths;
+    SkOpBuilder::Reduction fReduction;
+    SkString               fName;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return SkNEW_ARGS(PathOpsBench, (8, false)); )
+DEF_BENCH( return SkNEW_ARGS(PathOpsBench, (32, false)); )
+DEF_BENCH( return SkNEW_ARGS(PathOpsBench, (32, true)); )
+
+DEF_BENCH( return SkNEW_ARGS(OpBuilderBench, (8, SkOpBuilder::kSequential_Reduction)); )
+DEF_BENCH( return SkNEW_ARGS(OpBuilderBench, (8, SkOpBuilder::kBalanced_Reduction)); )
+DEF_BENCH( return SkNEW_ARGS(OpBuilderBench, (8, SkOpBuilder::kParallel_Reduction)); )
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkData.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkPicture.h"
+#include "SkPictureRecorder.h"
+#include "SkRandom.h"
+#include "SkStream.h"
+#include "SkString.h"
+
+// Measures how long it takes to load a serialized picture with lots of paths and raw bitmaps,
+// either through a stream (copying) or straight from its SkData (sharing, as for an mmapped SKP).
+class PictureLoadBench : public Benchmark {
+public:
+    explicit PictureLoadBench(bool fromData) : fFromData(fromData) {
+        fName.printf("picture_load_%s", fromData ? "data" : "stream");
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onPreDraw() override {
+        SkRandom rand;
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(1024, 1024);
+
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int i = 0; i < 500; ++i) {
+            SkPath path;
+            path.moveTo(rand.nextRangeF(0, 1024), rand.nextRangeF(0, 1024));
+            for (int j = 0; j < 20; ++j) {
+                path.quadTo(rand.nextRangeF(0, 1024), rand.nextRangeF(0, 1024),
+                            rand.nextRangeF(0, 1024), rand.nextRangeF(0, 1024));
+            }
+            paint.setColor(rand.nextU() | 0xFF000000);
+            canvas->drawPath(path, paint);
+        }
+
+        for (int i = 0; i < 16; ++i) {
+            SkBitmap bm;
+            bm.allocN32Pixels(256, 256);
+            bm.eraseColor(rand.nextU() | 0xFF000000);
+            bm.setImmutable();
+            canvas->drawBitmap(bm, rand.nextRangeF(0, 768), rand.nextRangeF(0, 768));
+        }
+
+        SkAutoTUnref<SkPicture> picture(recorder.endRecording());
+        SkDynamicMemoryWStream stream;
+        picture->serialize(&stream);
+        fData.reset(stream.copyToData());
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; ++i) {
+            SkAutoTUnref<SkPicture> picture;
+            if (fFromData) {
+                picture.reset(SkPicture::CreateFromData(fData));
+            } else {
+                SkMemoryStream stream(fData);
+                picture.reset(SkPicture::CreateFromStream(&stream));
+            }
+            SkASSERT(picture.get());
+        }
+    }
+
+private:
+    const bool           fFromData;
+    SkString             fName;
+    SkAutoTUnref<SkData> fData;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return SkNEW_ARGS(PictureLoadBench, (false)); )
+DEF_BENCH( return SkNEW_ARGS(PictureLoadBench, (true)); )
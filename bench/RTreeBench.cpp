@@ -19,11 +19,44 @@ static const int GRID_WIDTH = 100;
 
 typedef SkRect (*MakeRectProc)(SkRandom&, int, int);
 
+// How the benches below build their trees.
+enum BuildMode {
+    kSTR_Build,
+    kHilbert_Build,
+    kIncremental_Build,     // One rect at a time, with insert(unsigned, const SkRect&).
+};
+
+static const char* build_mode_prefix(BuildMode mode) {
+    switch (mode) {
+        case kSTR_Build:         return "";
+        case kHilbert_Build:     return "hilbert_";
+        case kIncremental_Build: return "incremental_";
+    }
+    SkFAIL("Unknown BuildMode");
+    return "";
+}
+
+static SkRTree* new_tree(BuildMode mode) {
+    return SkNEW_ARGS(SkRTree, (1, kHilbert_Build == mode ? SkRTreeFactory::kHilbert_BulkLoad
+                                                          : SkRTreeFactory::kSTR_BulkLoad));
+}
+
+static void build_tree(BuildMode mode, const SkRect rects[], int N, SkRTree* tree) {
+    if (kIncremental_Build == mode) {
+        for (int i = 0; i < N; ++i) {
+            tree->insert(i, rects[i]);
+        }
+    } else {
+        tree->insert(rects, N);
+    }
+}
+
 // Time how long it takes to build an R-Tree.
 class RTreeBuildBench : public Benchmark {
 public:
-    RTreeBuildBench(const char* name, MakeRectProc proc) : fProc(proc) {
-        fName.printf("rtree_%s_build", name);
+    RTreeBuildBench(const char* name, MakeRectProc proc, BuildMode mode = kSTR_Build)
+        : fProc(proc), fMode(mode) {
+        fName.printf("rtree_%s%s_build", build_mode_prefix(mode), name);
     }
 
     bool isSuitableFor(Backend backend) override {
@@ -42,13 +75,14 @@ protected:
         }
 
         for (int i = 0; i < loops; ++i) {
-            SkRTree tree;
-            tree.insert(rects.get(), NUM_BUILD_RECTS);
+            SkAutoTDelete<SkRTree> tree(new_tree(fMode));
+            build_tree(fMode, rects.get(), NUM_BUILD_RECTS, tree);
             SkASSERT(rects != NULL);  // It'd break this bench if the tree took ownership of rects.
         }
     }
 private:
     MakeRectProc fProc;
+    BuildMode fMode;
     SkString fName;
     typedef Benchmark INHERITED;
 };
@@ -56,8 +90,9 @@ private:
 // Time how long it takes to perform queries on an R-Tree.
 class RTreeQueryBench : public Benchmark {
 public:
-    RTreeQueryBench(const char* name, MakeRectProc proc) : fProc(proc) {
-        fName.printf("rtree_%s_query", name);
+    RTreeQueryBench(const char* name, MakeRectProc proc, BuildMode mode = kSTR_Build)
+        : fProc(proc), fMode(mode) {
+        fName.printf("rtree_%s%s_query", build_mode_prefix(mode), name);
     }
 
     bool isSuitableFor(Backend backend) override {
@@ -73,7 +108,8 @@ protected:
         for (int i = 0; i < NUM_QUERY_RECTS; ++i) {
             rects[i] = fProc(rand, i, NUM_QUERY_RECTS);
         }
-        fTree.insert(rects.get(), NUM_QUERY_RECTS);
+        fTree.reset(new_tree(fMode));
+        build_tree(fMode, rects.get(), NUM_QUERY_RECTS, fTree);
     }
 
     void onDraw(const int loops, SkCanvas* canvas) override {
@@ -85,12 +121,58 @@ protected:
             query.fTop    = rand.nextRangeF(0, GENERATE_EXTENTS);
             query.fRight  = query.fLeft + 1 + rand.nextRangeF(0, GENERATE_EXTENTS/2);
             query.fBottom = query.fTop  + 1 + rand.nextRangeF(0, GENERATE_EXTENTS/2);
-            fTree.search(query, &hits);
+            fTree->search(query, &hits);
         }
     }
 private:
-    SkRTree fTree;
+    SkAutoTDelete<SkRTree> fTree;
     MakeRectProc fProc;
+    BuildMode fMode;
+    SkString fName;
+    typedef Benchmark INHERITED;
+};
+
+// Time how long it takes to move rects around an R-Tree, as a long-lived display list would:
+// each loop removes a rect and puts it back somewhere else.
+class RTreeUpdateBench : public Benchmark {
+public:
+    RTreeUpdateBench(const char* name, MakeRectProc proc, BuildMode mode)
+        : fProc(proc), fMode(mode) {
+        fName.printf("rtree_%s%s_update", build_mode_prefix(mode), name);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+    void onPreDraw() override {
+        SkRandom rand;
+        fRects.reset(NUM_QUERY_RECTS);
+        for (int i = 0; i < NUM_QUERY_RECTS; ++i) {
+            fRects[i] = fProc(rand, i, NUM_QUERY_RECTS);
+        }
+        fTree.reset(new_tree(fMode));
+        build_tree(fMode, fRects.get(), NUM_QUERY_RECTS, fTree);
+    }
+
+    void onDraw(const int loops, SkCanvas* canvas) override {
+        SkRandom rand;
+        for (int i = 0; i < loops; ++i) {
+            int index = rand.nextULessThan(NUM_QUERY_RECTS);
+            SkAssertResult(fTree->remove(index, fRects[index]));
+            fRects[index].offsetTo(rand.nextRangeF(0, GENERATE_EXTENTS),
+                                   rand.nextRangeF(0, GENERATE_EXTENTS));
+            fTree->insert(index, fRects[index]);
+        }
+    }
+private:
+    SkAutoTDelete<SkRTree> fTree;
+    SkAutoTMalloc<SkRect> fRects;
+    MakeRectProc fProc;
+    BuildMode fMode;
     SkString fName;
     typedef Benchmark INHERITED;
 };
@@ -136,3 +218,21 @@ DEF_BENCH(return SkNEW_ARGS(RTreeQueryBench, ("XY",         &make_XYordered_rect
 DEF_BENCH(return SkNEW_ARGS(RTreeQueryBench, ("YX",         &make_YXordered_rects)));
 DEF_BENCH(return SkNEW_ARGS(RTreeQueryBench, ("random",     &make_random_rects)));
 DEF_BENCH(return SkNEW_ARGS(RTreeQueryBench, ("concentric", &make_concentric_rects)));
+
+DEF_BENCH(return SkNEW_ARGS(RTreeBuildBench, ("XY", &make_XYordered_rects, kHilbert_Build)));
+DEF_BENCH(return SkNEW_ARGS(RTreeBuildBench, ("random", &make_random_rects, kHilbert_Build)));
+DEF_BENCH(return SkNEW_ARGS(RTreeBuildBench, ("concentric", &make_concentric_rects,
+                                              kHilbert_Build)));
+DEF_BENCH(return SkNEW_ARGS(RTreeBuildBench, ("XY", &make_XYordered_rects, kIncremental_Build)));
+DEF_BENCH(return SkNEW_ARGS(RTreeBuildBench, ("random", &make_random_rects, kIncremental_Build)));
+
+DEF_BENCH(return SkNEW_ARGS(RTreeQueryBench, ("XY", &make_XYordered_rects, kHilbert_Build)));
+DEF_BENCH(return SkNEW_ARGS(RTreeQueryBench, ("random", &make_random_rects, kHilbert_Build)));
+DEF_BENCH(return SkNEW_ARGS(RTreeQueryBench, ("concentric", &make_concentric_rects,
+                                              kHilbert_Build)));
+DEF_BENCH(return SkNEW_ARGS(RTreeQueryBench, ("XY", &make_XYordered_rects, kIncremental_Build)));
+DEF_BENCH(return SkNEW_ARGS(RTreeQueryBench, ("random", &make_random_rects, kIncremental_Build)));
+
+DEF_BENCH(return SkNEW_ARGS(RTreeUpdateBench, ("XY", &make_XYordered_rects, kSTR_Build)));
+DEF_BENCH(return SkNEW_ARGS(RTreeUpdateBench, ("random", &make_random_rects, kSTR_Build)));
+DEF_BENCH(return SkNEW_ARGS(RTreeUpdateBench, ("random", &make_random_rects, kHilbert_Build)));
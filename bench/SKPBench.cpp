@@ -12,16 +12,20 @@
 
 DEFINE_int32(benchTileW, 1600, "Tile width  used for SKP playback.");
 DEFINE_int32(benchTileH, 512, "Tile height used for SKP playback.");
+DEFINE_int32(parallelTileSize, 256, "Tile width and height used for parallel SKP playback.");
 
 SKPBench::SKPBench(const char* name, const SkPicture* pic, const SkIRect& clip, SkScalar scale,
-                   bool useMultiPictureDraw)
+                   bool useMultiPictureDraw, bool useParallelTiles)
     : fPic(SkRef(pic))
     , fClip(clip)
     , fScale(scale)
     , fName(name)
-    , fUseMultiPictureDraw(useMultiPictureDraw) {
+    , fUseMultiPictureDraw(useMultiPictureDraw)
+    , fUseParallelTiles(useParallelTiles) {
     fUniqueName.printf("%s_%.2g", name, scale);  // Scale makes this unqiue for perf.skia.org traces.
-    if (useMultiPictureDraw) {
+    if (useParallelTiles) {
+        fUniqueName.append("_mpdtiled");
+    } else if (useMultiPictureDraw) {
         fUniqueName.append("_mpd");
     }
 }
@@ -41,6 +45,10 @@ const char* SKPBench::onGetUniqueName() {
 }
 
 void SKPBench::onPerCanvasPreDraw(SkCanvas* canvas) {
+    if (fUseParallelTiles) {
+        return;  // We draw straight into canvas.
+    }
+
     SkIRect bounds;
     SkAssertResult(canvas->getClipDeviceBounds(&bounds));
 
@@ -96,7 +104,17 @@ SkIPoint SKPBench::onGetSize() {
 }
 
 void SKPBench::onDraw(const int loops, SkCanvas* canvas) {
-    if (fUseMultiPictureDraw) {
+    if (fUseParallelTiles) {
+        SkMatrix scale;
+        scale.setScale(fScale, fScale);
+        const SkISize tileSize = SkISize::Make(FLAGS_parallelTileSize, FLAGS_parallelTileSize);
+        for (int i = 0; i < loops; i++) {
+            SkMultiPictureDraw mpd;
+            mpd.addTiled(canvas, fPic, tileSize, &scale);
+            mpd.draw();
+            canvas->flush();
+        }
+    } else if (fUseMultiPictureDraw) {
         for (int i = 0; i < loops; i++) {
             SkMultiPictureDraw mpd;
 
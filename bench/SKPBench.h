@@ -18,7 +18,7 @@
 class SKPBench : public Benchmark {
 public:
     SKPBench(const char* name, const SkPicture*, const SkIRect& devClip, SkScalar scale,
-             bool useMultiPictureDraw);
+             bool useMultiPictureDraw, bool useParallelTiles = false);
     ~SKPBench() override;
 
 protected:
@@ -38,6 +38,7 @@ private:
     SkString fUniqueName;
 
     const bool fUseMultiPictureDraw;
+    const bool fUseParallelTiles;      // draw straight into the canvas with MPD::addTiled()
     SkTDArray<SkSurface*> fSurfaces;   // for MultiPictureDraw
     SkTDArray<SkIRect> fTileRects;     // for MultiPictureDraw
 
@@ -0,0 +1,143 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkGPipe.h"
+#include "SkSharedMemoryPipe.h"
+#include "SkString.h"
+#include "SkTemplates.h"
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Pipes frames of new 256x256 bitmaps to a forked process that rasterizes them, with the bitmaps'
+// pixels either shared with it or flattened through the ring buffer.
+class SharedMemoryPipeBench : public Benchmark {
+public:
+    SharedMemoryPipeBench(bool sharePixels)
+        : fSharePixels(sharePixels)
+        , fReaderPid(-1)
+        , fPipeCanvas(NULL) {
+        fName.printf("shared_memory_pipe_%s", sharePixels ? "shared_pixels" : "flattened_pixels");
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onPreDraw() override {
+        fSegmentName.printf("/skia-%s-%d", fName.c_str(), getpid());
+        fController.reset(SkSharedMemoryPipeController::Create(fSegmentName.c_str(), 1 << 20,
+                                                               kBitmapCount * kBitmapBytes));
+        if (NULL == fController.get()) {
+            SkDebugf("SharedMemoryPipeBench could not create shared memory, results are "
+                     "meaningless\n");
+            return;
+        }
+        const SkImageInfo info = SkImageInfo::MakeN32Premul(kBitmapSize, kBitmapSize);
+        for (int i = 0; i < kBitmapCount; ++i) {
+            if (fSharePixels) {
+                SkAssertResult(fController->allocSharedPixels(&fBitmaps[i], info));
+            } else {
+                fBitmaps[i].allocPixels(info);
+            }
+            fBitmaps[i].eraseColor(SK_ColorBLUE);
+        }
+    }
+
+    // The reader runs for as long as the canvas does, so forking and ending it stay out of the
+    // timed onDraw().
+    void onPerCanvasPreDraw(SkCanvas*) override {
+        fReaderPid = -1;
+        if (NULL == fController.get()) {
+            return;
+        }
+
+        fReaderPid = fork();
+        if (0 == fReaderPid) {
+            // The rasterizing process. fork() only copied this thread, not the SkTaskGroup pool
+            // nanobench enabled, whose threads (and any locks they held) are gone here. So the
+            // child must never use SkTaskGroup: it just plays back on this thread, rasterizing
+            // serially, and _exit()s without running destructors or atexit handlers.
+            SkBitmap dst;
+            dst.allocN32Pixels(2 * kBitmapSize, 2 * kBitmapSize);
+            SkCanvas canvas(dst);
+            SkAutoTDelete<SkSharedMemoryPipeReader> reader(
+                    SkSharedMemoryPipeReader::Open(fSegmentName.c_str(), &canvas));
+            bool done = reader.get() &&
+                        SkGPipeReader::kDone_Status == reader->playbackUntilDone();
+            _exit(done ? 0 : 1);
+        }
+        if (fReaderPid < 0) {
+            SkDebugf("SharedMemoryPipeBench could not fork\n");
+            return;
+        }
+
+        fPipeCanvas = fWriter.startRecording(fController.get(), SkGPipeWriter::kCrossProcess_Flag,
+                                             2 * kBitmapSize, 2 * kBitmapSize);
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        if (fReaderPid <= 0) {
+            return;
+        }
+
+        for (int i = 0; i < loops; ++i) {
+            for (int j = 0; j < kBitmapCount; ++j) {
+                // A new frame's contents, which the reader hasn't seen yet.
+                fBitmaps[j].notifyPixelsChanged();
+                fPipeCanvas->drawBitmap(fBitmaps[j], SkIntToScalar(j % 2 * kBitmapSize),
+                                        SkIntToScalar(j / 2 * kBitmapSize));
+            }
+        }
+        // Time until the reader has drawn every frame.
+        fWriter.flushRecording(false);
+        fController->waitForReader();
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        if (fReaderPid <= 0) {
+            return;
+        }
+
+        fWriter.endRecording();
+        int status;
+        if (waitpid(fReaderPid, &status, 0) != fReaderPid || !WIFEXITED(status) ||
+            WEXITSTATUS(status)) {
+            SkDebugf("SharedMemoryPipeBench's reader failed\n");
+        }
+        fReaderPid = -1;
+    }
+
+private:
+    enum {
+        kBitmapCount = 4,
+        kBitmapSize = 256,
+        kBitmapBytes = kBitmapSize * kBitmapSize * 4,
+    };
+
+    bool                                        fSharePixels;
+    SkString                                    fName;
+    SkString                                    fSegmentName;
+    SkAutoTDelete<SkSharedMemoryPipeController> fController;
+    SkBitmap                                    fBitmaps[kBitmapCount];
+    pid_t                                       fReaderPid;
+    SkGPipeWriter                               fWriter;
+    SkCanvas*                                   fPipeCanvas;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return SkNEW_ARGS(SharedMemoryPipeBench, (true)); )
+DEF_BENCH( return SkNEW_ARGS(SharedMemoryPipeBench, (false)); )
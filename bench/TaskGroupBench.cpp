@@ -0,0 +1,147 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "Benchmark.h"
+#include "SkAtomics.h"
+#include "SkString.h"
+#include "SkTaskGroup.h"
+
+// These benches run on whatever thread pool nanobench set up with its SkTaskGroup::Enabler.
+//   taskgroup_add, taskgroup_batch: per-task overhead of add() and batch() for empty tasks.
+//   taskgroup_nested:               a binary tree of tasks that add() and wait() on subtasks.
+//   taskgroup_split_N:              a fixed amount of work split into N tasks, to show how
+//                                   the pool scales from 1 to N cores.
+
+static void noop(int*) {}
+
+static void spin(int* iterations) {
+    volatile int x = 0;
+    for (int i = 0; i < *iterations; i++) {
+        x = x + i;
+    }
+}
+
+class TaskGroupAddBench : public Benchmark {
+public:
+    explicit TaskGroupAddBench(bool batch) : fBatch(batch) {}
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fBatch ? "taskgroup_batch" : "taskgroup_add";
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        static const int kTasks = 1000;
+        int args[kTasks];
+
+        SkTaskGroup tg;
+        for (int i = 0; i < loops; i++) {
+            if (fBatch) {
+                tg.batch(noop, args, kTasks);
+            } else {
+                for (int j = 0; j < kTasks; j++) {
+                    tg.add(noop, &args[j]);
+                }
+            }
+            tg.wait();
+        }
+    }
+
+private:
+    bool fBatch;
+    typedef Benchmark INHERITED;
+};
+
+struct NestedTask {
+    int32_t* fCount;
+    int      fDepth;
+};
+
+static void nested(NestedTask* task) {
+    sk_atomic_inc(task->fCount);
+    if (task->fDepth > 0) {
+        NestedTask kids[2] = {
+            { task->fCount, task->fDepth - 1 },
+            { task->fCount, task->fDepth - 1 },
+        };
+        SkTaskGroup tg;
+        tg.batch(nested, kids, 2);
+        tg.wait();
+    }
+}
+
+class TaskGroupNestedBench : public Benchmark {
+public:
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return "taskgroup_nested";
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            int32_t count = 0;
+            NestedTask root = { &count, 9 };  // 1023 tasks.
+            nested(&root);
+            SkASSERT(1023 == count);
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
+class TaskGroupSplitBench : public Benchmark {
+public:
+    explicit TaskGroupSplitBench(int tasks) : fTasks(tasks) {
+        fName.printf("taskgroup_split_%d", tasks);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        static const int kTotalWork = 1 << 20;
+        SkAutoTMalloc<int> iterations(fTasks);
+        for (int i = 0; i < fTasks; i++) {
+            iterations[i] = kTotalWork / fTasks;
+        }
+
+        SkTaskGroup tg;
+        for (int i = 0; i < loops; i++) {
+            tg.batch(spin, iterations.get(), fTasks);
+            tg.wait();
+        }
+    }
+
+private:
+    SkString fName;
+    int      fTasks;
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new TaskGroupAddBench(false); )
+DEF_BENCH( return new TaskGroupAddBench(true); )
+DEF_BENCH( return new TaskGroupNestedBench; )
+DEF_BENCH( return new TaskGroupSplitBench(1); )
+DEF_BENCH( return new TaskGroupSplitBench(2); )
+DEF_BENCH( return new TaskGroupSplitBench(4); )
+DEF_BENCH( return new TaskGroupSplitBench(8); )
+DEF_BENCH( return new TaskGroupSplitBench(16); )
+DEF_BENCH( return new TaskGroupSplitBench(32); )
@@ -14,6 +14,7 @@
 #include "SkStream.h"
 #include "SkString.h"
 #include "SkTemplates.h"
+#include "SkTextBlob.h"
 #include "SkTypeface.h"
 
 enum FontQuality {
@@ -152,6 +153,82 @@ private:
     typedef Benchmark INHERITED;
 };
 
+/*  A paragraph of positioned text, scrolled a pixel per draw, as a text blob or as the
+    same runs of positioned text. Repeat blob draws come from the raster glyph run cache.
+ */
+class TextBlobBench : public Benchmark {
+    SkPaint                         fPaint;
+    SkAutoTUnref<const SkTextBlob>  fBlob;
+    SkTDArray<uint16_t>             fGlyphs;
+    SkTDArray<SkScalar>             fXPos;
+    bool                            fUseBlob;
+    SkString                        fName;
+
+    enum {
+        kLines = 30,
+        kLineHeight = 16,
+    };
+
+public:
+    TextBlobBench(const char text[], FontQuality fq, bool useBlob) : fUseBlob(useBlob) {
+        fPaint.setAntiAlias(kBW != fq);
+        fPaint.setLCDRenderText(kLCD == fq);
+        fPaint.setTextSize(SkIntToScalar(13));
+
+        int count = fPaint.textToGlyphs(text, strlen(text), NULL);
+        fGlyphs.setCount(count);
+        fXPos.setCount(count);
+        fPaint.textToGlyphs(text, strlen(text), fGlyphs.begin());
+        fPaint.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+        fPaint.getTextWidths(fGlyphs.begin(), count * sizeof(uint16_t), fXPos.begin());
+        SkScalar x = 0;
+        for (int i = 0; i < count; ++i) {
+            SkScalar advance = fXPos[i];
+            fXPos[i] = x;
+            x += advance;
+        }
+
+        SkTextBlobBuilder builder;
+        for (int line = 0; line < kLines; ++line) {
+            const SkTextBlobBuilder::RunBuffer& run =
+                builder.allocRunPosH(fPaint, count, SkIntToScalar(line * kLineHeight));
+            memcpy(run.glyphs, fGlyphs.begin(), count * sizeof(uint16_t));
+            memcpy(run.pos, fXPos.begin(), count * sizeof(SkScalar));
+        }
+        fBlob.reset(builder.build());
+
+        fName.printf("text_paragraph_%s_%s", useBlob ? "blob" : "pos", fontQualityName(fPaint));
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDraw(const int loops, SkCanvas* canvas) override {
+        SkPaint paint(fPaint);
+        this->setupPaint(&paint);
+        paint.setAntiAlias(fPaint.isAntiAlias());
+        paint.setLCDRenderText(fPaint.isLCDRenderText());
+
+        size_t len = fGlyphs.count() * sizeof(uint16_t);
+        for (int i = 0; i < loops; i++) {
+            SkScalar y = SkIntToScalar(kLineHeight + i % kLineHeight);
+            if (fUseBlob) {
+                canvas->drawTextBlob(fBlob, SkIntToScalar(4), y, paint);
+            } else {
+                for (int line = 0; line < kLines; ++line) {
+                    canvas->drawPosTextH(fGlyphs.begin(), len, fXPos.begin(),
+                                         y + line * kLineHeight, paint);
+                }
+            }
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #define STR     "Hamburgefons"
@@ -174,3 +251,10 @@ DEF_BENCH( return new TextBench(STR, 16, 0x88FF0000, kBW, true); )
 
 DEF_BENCH( return new TextBench(STR, 16, 0xFF000000, kBW, true, true); )
 DEF_BENCH( return new TextBench(STR, 16, 0xFF000000, kAA, false, true); )
+
+#define PARAGRAPH_STR   "The quick brown fox jumps over the lazy dog, again and again."
+
+DEF_BENCH( return new TextBlobBench(PARAGRAPH_STR, kAA, true); )
+DEF_BENCH( return new TextBlobBench(PARAGRAPH_STR, kAA, false); )
+DEF_BENCH( return new TextBlobBench(PARAGRAPH_STR, kLCD, true); )
+DEF_BENCH( return new TextBlobBench(PARAGRAPH_STR, kLCD, false); )
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkRandom.h"
+#include "SkString.h"
+#include "SkTemplates.h"
+#include "SkTextureCompressor.h"
+
+// Compresses a coverage mask, like an atlas of antialiased paths, about 1024 pixels square.
+class TextureCompressionBench : public Benchmark {
+public:
+    TextureCompressionBench(SkTextureCompressor::Format format, const char* formatName, bool opt)
+        : fFormat(format), fOpt(opt) {
+        fName.printf("texture_compress_%s%s", formatName, opt ? "" : "_portable");
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onPreDraw() override {
+        static const int kSize = 1056;  // A multiple of every block size we compress to.
+        fMask.allocPixels(SkImageInfo::MakeA8(kSize, kSize));
+        fMask.eraseColor(SK_ColorTRANSPARENT);
+
+        SkCanvas canvas(fMask);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        SkRandom rand;
+        for (int i = 0; i < 200; ++i) {
+            paint.setAlpha(rand.nextRangeU(0x40, 0xFF));
+            canvas.drawCircle(rand.nextRangeScalar(0, kSize), rand.nextRangeScalar(0, kSize),
+                              rand.nextRangeScalar(4, 64), paint);
+        }
+
+        fCompressed.reset(SkTextureCompressor::GetCompressedDataSize(fFormat, kSize, kSize));
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        SkAutoLockPixels alp(fMask);
+        for (int i = 0; i < loops; ++i) {
+            SkTextureCompressor::CompressBufferToFormat(fCompressed.get(),
+                                                        (const uint8_t*)fMask.getPixels(),
+                                                        fMask.colorType(),
+                                                        fMask.width(), fMask.height(),
+                                                        fMask.rowBytes(), fFormat, fOpt);
+        }
+    }
+
+private:
+    SkTextureCompressor::Format fFormat;
+    bool                        fOpt;
+    SkString                    fName;
+    SkBitmap                    fMask;
+    SkAutoTMalloc<uint8_t>      fCompressed;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return SkNEW_ARGS(TextureCompressionBench,
+                             (SkTextureCompressor::kLATC_Format, "latc", true)); )
+DEF_BENCH( return SkNEW_ARGS(TextureCompressionBench,
+                             (SkTextureCompressor::kLATC_Format, "latc", false)); )
+DEF_BENCH( return SkNEW_ARGS(TextureCompressionBench,
+                             (SkTextureCompressor::kR11_EAC_Format, "r11eac", true)); )
+DEF_BENCH( return SkNEW_ARGS(TextureCompressionBench,
+                             (SkTextureCompressor::kR11_EAC_Format, "r11eac", false)); )
+DEF_BENCH( return SkNEW_ARGS(TextureCompressionBench,
+                             (SkTextureCompressor::kASTC_12x12_Format, "astc12x12", true)); )
@@ -8,6 +8,7 @@
 #include <ctype.h>
 
 #include "Benchmark.h"
+#include "CodecBench.h"
 #include "CrashHandler.h"
 #include "DecodingBench.h"
 #include "DecodingSubsetBench.h"
@@ -21,11 +22,13 @@
 
 #include "SkBBoxHierarchy.h"
 #include "SkCanvas.h"
+#include "SkCodec.h"
 #include "SkCommonFlags.h"
 #include "SkData.h"
 #include "SkForceLinking.h"
 #include "SkGraphics.h"
 #include "SkOSFile.h"
+#include "SkScan.h"
 #include "SkPictureRecorder.h"
 #include "SkPictureUtils.h"
 #include "SkString.h"
@@ -76,6 +79,7 @@ DEFINE_string(clip, "0,0,1000,1000", "Clip for SKPs.");
 DEFINE_string(scales, "1.0", "Space-separated scales for SKPs.");
 DEFINE_bool(bbh, true, "Build a BBH for SKPs?");
 DEFINE_bool(mpd, true, "Use MultiPictureDraw for the SKPs?");
+DEFINE_bool(mpdTiled, false, "Also play SKPs back into one canvas as parallel tiles?");
 DEFINE_int32(flushEvery, 10, "Flush --outResultsFile every Nth run.");
 DEFINE_bool(resetGpuContext, true, "Reset the GrContext before running each test.");
 DEFINE_bool(gpuStats, false, "Print GPU stats after each gpu benchmark?");
@@ -444,6 +448,8 @@ public:
                       , fCurrentSKP(0)
                       , fCurrentUseMPD(0)
                       , fCurrentImage(0)
+                      , fCurrentCodecImage(0)
+                      , fCurrentCodecScale(0)
                       , fCurrentSubsetImage(0)
                       , fCurrentColorType(0)
                       , fDivisor(2) {
@@ -473,8 +479,14 @@ public:
         }
 
         fUseMPDs.push_back() = false;
+        fUseParallelTiles.push_back() = false;
         if (FLAGS_mpd) {
             fUseMPDs.push_back() = true;
+            fUseParallelTiles.push_back() = false;
+        }
+        if (FLAGS_mpdTiled) {
+            fUseMPDs.push_back() = true;
+            fUseParallelTiles.push_back() = true;
         }
 
         // Prepare the images for decoding
@@ -506,13 +518,14 @@ public:
             return false;
         }
 
-        SkAutoTDelete<SkStream> stream(SkStream::NewFromFile(path));
-        if (stream.get() == NULL) {
+        // Mapped, so the picture can use the file's ops and pixels in place.
+        SkAutoTUnref<SkData> data(SkData::NewFromFileName(path));
+        if (data.get() == NULL) {
             SkDebugf("Could not read %s.\n", path);
             return false;
         }
 
-        pic->reset(SkPicture::CreateFromStream(stream.get()));
+        pic->reset(SkPicture::CreateFromData(data));
         if (pic->get() == NULL) {
             SkDebugf("Could not read %s as an SkPicture.\n", path);
             return false;
@@ -550,6 +563,7 @@ public:
             fSourceType = "skp";
             fBenchType  = "recording";
             fSKPBytes = static_cast<double>(SkPictureUtils::ApproximateBytesUsed(pic));
+            fSKPBytesShared = static_cast<double>(SkPictureUtils::ApproximateBytesShared(pic));
             fSKPOps   = pic->approximateOpCount();
             return SkNEW_ARGS(RecordingBench, (name.c_str(), pic.get(), FLAGS_bbh));
         }
@@ -579,9 +593,11 @@ public:
                     SkString name = SkOSPath::Basename(path.c_str());
                     fSourceType = "skp";
                     fBenchType = "playback";
+                    const bool useParallelTiles = fUseParallelTiles[fCurrentUseMPD];
                     return SkNEW_ARGS(SKPBench,
                             (name.c_str(), pic.get(), fClip,
-                             fScales[fCurrentScale], fUseMPDs[fCurrentUseMPD++]));
+                             fScales[fCurrentScale], fUseMPDs[fCurrentUseMPD++],
+                             useParallelTiles));
                 }
                 fCurrentUseMPD = 0;
                 fCurrentSKP++;
@@ -607,6 +623,33 @@ public:
             fCurrentImage++;
         }
 
+        // Run the CodecBenches, both at full size and scaled down as for a thumbnail.
+        static const float kCodecScales[] = { 1.0f, 0.125f };
+        while (fCurrentCodecImage < fImages.count()) {
+            SkAutoTUnref<SkData> encoded(
+                    SkData::NewFromFileName(fImages[fCurrentCodecImage].c_str()));
+            SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(encoded));
+            while (codec && fCurrentCodecScale < (int) SK_ARRAY_COUNT(kCodecScales)) {
+                while (fCurrentColorType < fColorTypes.count()) {
+                    const SkString& path = fImages[fCurrentCodecImage];
+                    const float scale = kCodecScales[fCurrentCodecScale];
+                    SkColorType colorType = fColorTypes[fCurrentColorType];
+                    fCurrentColorType++;
+                    // Check if the image decodes before creating the benchmark
+                    const SkISize size = codec->getScaledDimensions(scale);
+                    const SkImageInfo info = codec->getInfo()
+                            .makeWH(size.width(), size.height()).makeColorType(colorType);
+                    if (codec->getScanlineDecoder(info)) {
+                        return new CodecBench(path, colorType, scale);
+                    }
+                }
+                fCurrentColorType = 0;
+                fCurrentCodecScale++;
+            }
+            fCurrentCodecScale = 0;
+            fCurrentCodecImage++;
+        }
+
         // Run the DecodingSubsetBenches
         while (fCurrentSubsetImage < fImages.count()) {
             while (fCurrentColorType < fColorTypes.count()) {
@@ -671,12 +714,15 @@ public:
                                                   fClip.fRight, fClip.fBottom).c_str());
             log->configOption("scale", SkStringPrintf("%.2g", fScales[fCurrentScale]).c_str());
             if (fCurrentUseMPD > 0) {
-                SkASSERT(1 == fCurrentUseMPD || 2 == fCurrentUseMPD);
+                SkASSERT(fCurrentUseMPD >= 1 && fCurrentUseMPD <= 3);
                 log->configOption("multi_picture_draw", fUseMPDs[fCurrentUseMPD-1] ? "true" : "false");
+                log->configOption("parallel_tiles",
+                                  fUseParallelTiles[fCurrentUseMPD-1] ? "true" : "false");
             }
         }
         if (0 == strcmp(fBenchType, "recording")) {
             log->metric("bytes", fSKPBytes);
+            log->metric("bytes_shared", fSKPBytesShared);
             log->metric("ops",   fSKPOps);
         }
     }
@@ -688,10 +734,11 @@ private:
     SkTArray<SkScalar> fScales;
     SkTArray<SkString> fSKPs;
     SkTArray<bool>     fUseMPDs;
+    SkTArray<bool>     fUseParallelTiles;
     SkTArray<SkString> fImages;
     SkTArray<SkColorType> fColorTypes;
 
-    double fSKPBytes, fSKPOps;
+    double fSKPBytes, fSKPBytesShared, fSKPOps;
 
     const char* fSourceType;  // What we're benching: bench, GM, SKP, ...
     const char* fBenchType;   // How we bench it: micro, recording, playback, ...
@@ -700,6 +747,8 @@ private:
     int fCurrentSKP;
     int fCurrentUseMPD;
     int fCurrentImage;
+    int fCurrentCodecImage;
+    int fCurrentCodecScale;
     int fCurrentSubsetImage;
     int fCurrentColorType;
     const int fDivisor;
@@ -709,6 +758,7 @@ int nanobench_main();
 int nanobench_main() {
     SetupCrashHandler();
     SkAutoGraphics ag;
+    gSkUseAnalyticAA = FLAGS_analyticAA;
     SkTaskGroup::Enabler enabled;
 
 #if SK_SUPPORT_GPU
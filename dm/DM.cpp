@@ -19,6 +19,7 @@
 #include "SkInstCnt.h"
 #include "SkMD5.h"
 #include "SkOSFile.h"
+#include "SkScan.h"
 #include "SkTHash.h"
 #include "SkTaskGroup.h"
 #include "SkThreadUtils.h"
@@ -155,7 +156,9 @@ static bool codec_supported(const char* ext) {
     // list (and eventually we can remove this check once they are all supported).
     return strcmp(ext, "png") == 0 || strcmp(ext, "PNG") == 0 || 
            strcmp(ext, "bmp") == 0 || strcmp(ext, "BMP") == 0 ||
-           strcmp(ext, "ico") == 0 || strcmp(ext, "ICO") == 0;
+           strcmp(ext, "ico") == 0 || strcmp(ext, "ICO") == 0 ||
+           strcmp(ext, "jpg") == 0 || strcmp(ext, "JPG") == 0 ||
+           strcmp(ext, "jpeg") == 0 || strcmp(ext, "JPEG") == 0;
 }
 
 static void gather_srcs() {
@@ -189,6 +192,7 @@ static void gather_srcs() {
                     if (codec_supported(exts[j])) {
                         push_src("codec", new CodecSrc(path, CodecSrc::kNormal_Mode));
                         push_src("scanline", new CodecSrc(path, CodecSrc::kScanline_Mode));
+                        push_src("region", new CodecSrc(path, CodecSrc::kRegion_Mode));
                     }
                 }
             }
@@ -286,6 +290,7 @@ static Sink* create_via(const char* tag, Sink* wrapped) {
     VIA("serialize", ViaSerialization, wrapped);
     VIA("tiles",     ViaTiles, 256, 256,               NULL, wrapped);
     VIA("tiles_rt",  ViaTiles, 256, 256, new SkRTreeFactory, wrapped);
+    VIA("tiles_mt",  ViaParallelTiles, 256, 256, new SkRTreeFactory, wrapped);
 
     if (FLAGS_matrix.count() == 4) {
         SkMatrix m;
@@ -587,6 +592,7 @@ int dm_main();
 int dm_main() {
     SetupCrashHandler();
     SkAutoGraphics ag;
+    gSkUseAnalyticAA = FLAGS_analyticAA;
     SkTaskGroup::Enabler enabled(FLAGS_threads);
     if (FLAGS_leaks) {
         SkInstCountPrintLeaksOnExit();
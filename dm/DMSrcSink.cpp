@@ -118,6 +118,36 @@ Error CodecSrc::draw(SkCanvas* canvas) const {
             }
             break;
         }
+        case kRegion_Mode: {
+            // Decode a grid of tiles, each from a fresh codec, as a tile server would.
+            const int kDivisor = 3;
+            const int w = decodeInfo.width();
+            const int h = decodeInfo.height();
+            for (int row = 0; row < kDivisor; row++) {
+                for (int col = 0; col < kDivisor; col++) {
+                    SkIRect region = SkIRect::MakeLTRB(w * col / kDivisor, h * row / kDivisor,
+                                                       w * (col + 1) / kDivisor,
+                                                       h * (row + 1) / kDivisor);
+                    if (region.isEmpty()) {
+                        continue;
+                    }
+                    const SkImageGenerator::Result result = SkCodec::GetRegionInParallel(
+                            encoded, decodeInfo, region,
+                            bitmap.getAddr(region.left(), region.top()), bitmap.rowBytes());
+                    switch (result) {
+                        case SkImageGenerator::kSuccess:
+                        case SkImageGenerator::kIncompleteInput:
+                            break;
+                        case SkImageGenerator::kInvalidConversion:
+                            return Error::Nonfatal("Incompatible colortype conversion");
+                        default:
+                            return SkStringPrintf("Couldn't getRegion %s with error %d.",
+                                                  fPath.c_str(), (int) result);
+                    }
+                }
+            }
+            break;
+        }
     }
     canvas->drawBitmap(bitmap, 0, 0);
     return "";
@@ -622,4 +652,44 @@ Error ViaTiles::draw(const Src& src, SkBitmap* bitmap, SkWStream* stream, SkStri
     return fSink->draw(proxy, bitmap, stream, log);
 }
 
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+ViaParallelTiles::ViaParallelTiles(int w, int h, SkBBHFactory* factory, Sink* sink)
+    : fW(w)
+    , fH(h)
+    , fFactory(factory)
+    , fSink(sink) {}
+
+Error ViaParallelTiles::draw(const Src& src, SkBitmap* bitmap, SkWStream* stream,
+                             SkString* log) const {
+    // Record our Src into a picture.
+    SkSize size;
+    size = src.size();
+    SkPictureRecorder recorder;
+    Error err = src.draw(recorder.beginRecording(size.width(), size.height(), fFactory.get()));
+    if (!err.isEmpty()) {
+        return err;
+    }
+    SkAutoTUnref<SkPicture> pic(recorder.endRecording());
+
+    // Turn that picture into a Src that draws straight into our Sink's canvas, one tile per thread.
+    struct ProxySrc : public Src {
+        const SkISize fTileSize;
+        const SkPicture* fPic;
+        const SkISize fSize;
+        ProxySrc(int w, int h, const SkPicture* pic, SkISize size)
+            : fTileSize(SkISize::Make(w, h)), fPic(pic), fSize(size) {}
+
+        Error draw(SkCanvas* canvas) const override {
+            SkMultiPictureDraw mpd;
+            mpd.addTiled(canvas, fPic, fTileSize);
+            mpd.draw();
+            return "";
+        }
+        SkISize size() const override { return fSize; }
+        Name name() const override { sk_throw(); return ""; }  // No one should be calling this.
+    } proxy(fW, fH, pic, src.size());
+    return fSink->draw(proxy, bitmap, stream, log);
+}
+
 }  // namespace DM
@@ -93,6 +93,7 @@ public:
     enum Mode {
         kNormal_Mode,
         kScanline_Mode,
+        kRegion_Mode,
     };
     CodecSrc(Path, Mode);
 
@@ -266,6 +267,20 @@ private:
     SkAutoTDelete<Sink>         fSink;
 };
 
+// Plays the Src back into one canvas from many threads at once with SkMultiPictureDraw::addTiled().
+class ViaParallelTiles : public Sink {
+public:
+    ViaParallelTiles(int w, int h, SkBBHFactory*, Sink*);
+
+    Error draw(const Src&, SkBitmap*, SkWStream*, SkString*) const override;
+    int enclave() const override { return fSink->enclave(); }
+    const char* fileExtension() const override { return fSink->fileExtension(); }
+private:
+    const int                   fW, fH;
+    SkAutoTDelete<SkBBHFactory> fFactory;
+    SkAutoTDelete<Sink>         fSink;
+};
+
 }  // namespace DM
 
 #endif//DMSrcSink_DEFINED
@@ -79,6 +79,7 @@ protected:
     void onDrawPoints(PointMode mode, size_t count, const SkPoint pts[],
                       const SkPaint& paint) override {}
     void onDrawRect(const SkRect& rect, const SkPaint& paint) override {}
+    void onDrawRects(const SkRect[], int count, const SkPaint&) override {}
     void onDrawOval(const SkRect& oval, const SkPaint&) override {}
     void onDrawRRect(const SkRRect& rrect, const SkPaint& paint) override {}
     void onDrawPath(const SkPath& path, const SkPaint& paint) override {}
@@ -88,6 +89,8 @@ protected:
                           const SkRect& dst,
                           const SkPaint* paint,
                           DrawBitmapRectFlags flags) override {}
+    void onDrawBitmapRects(const SkBitmap&, const SkRect src[], const SkRect dst[],
+                           int count, const SkPaint*) override {}
     void onDrawImage(const SkImage*, SkScalar left, SkScalar top, const SkPaint*) override {}
     void onDrawImageRect(const SkImage*, const SkRect* src, const SkRect& dst,
                          const SkPaint*) override{}
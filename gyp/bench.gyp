@@ -14,6 +14,7 @@
       'type': 'executable',
       'sources': [
         '../gm/gm.cpp',
+        '../bench/CodecBench.cpp',
         '../bench/DecodingBench.cpp',
         '../bench/DecodingSubsetBench.cpp',
         '../bench/GMBench.cpp',
@@ -17,6 +17,7 @@
       'standalone_static_library': 1,
       'dependencies': [
         'core.gyp:*',
+        'libjpeg.gyp:*',
         'libpng.gyp:libpng',
       ],
       'cflags':[
@@ -33,6 +34,7 @@
         '../src/codec/SkCodec.cpp',
         '../src/codec/SkCodec_libbmp.cpp',
         '../src/codec/SkCodec_libico.cpp',
+        '../src/codec/SkCodec_libjpeg.cpp',
         '../src/codec/SkCodec_libpng.cpp',
         '../src/codec/SkMaskSwizzler.cpp',
         '../src/codec/SkMasks.cpp',
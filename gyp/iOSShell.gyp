@@ -22,6 +22,7 @@
             'xml.gyp:xml',
           ],
           'sources': [
+            '../bench/CodecBench.cpp',
             '../bench/DecodingBench.cpp',
             '../bench/DecodingSubsetBench.cpp',
             '../bench/GMBench.cpp',
@@ -11,6 +11,7 @@
 #include "SkEncodedFormat.h"
 #include "SkImageGenerator.h"
 #include "SkImageInfo.h"
+#include "SkRect.h"
 #include "SkScanlineDecoder.h"
 #include "SkSize.h"
 #include "SkStream.h"
@@ -80,6 +81,34 @@ public:
      */
     SkScanlineDecoder* getScanlineDecoder(const SkImageInfo& dstInfo);
 
+    /**
+     *  Decode only the pixels inside subset.
+     *
+     *  @param scaledInfo Describes the whole image as it would be decoded by
+     *      getPixels. If its dimensions do not match those of getInfo, this
+     *      implies a scale; they should come from getScaledDimensions.
+     *  @param subset The region to decode, in the coordinates of scaledInfo.
+     *      Must be non-empty and inside scaledInfo's bounds.
+     *  @param dst Receives subset.width() x subset.height() pixels of
+     *      scaledInfo's color and alpha type.
+     *  @param rowBytes rowBytes for dst.
+     *
+     *  NOTE: This requires rewinding the SkStream if anything was previously
+     *  decoded.
+     */
+    Result getRegion(const SkImageInfo& scaledInfo, const SkIRect& subset, void* dst,
+                     size_t rowBytes);
+
+    /**
+     *  Like getRegion, but for an encoded image held in memory. Where the
+     *  format can begin decoding partway down the image (currently jpegs with
+     *  restart markers), subset is split into bands of rows which are decoded
+     *  concurrently on an SkTaskGroup. Otherwise this decodes on the calling
+     *  thread.
+     */
+    static Result GetRegionInParallel(SkData*, const SkImageInfo& scaledInfo,
+                                      const SkIRect& subset, void* dst, size_t rowBytes);
+
     /**
      *  Some images may initially report that they have alpha due to the format
      *  of the encoded data, but then never use any colors which have alpha
@@ -133,6 +162,35 @@ protected:
         return NULL;
     }
 
+    /**
+     *  Override if your codec can decode a subset more cheaply than the default,
+     *  which runs the scanline decoder (or, lacking one, decodes the whole
+     *  image) and copies out the subset.
+     *
+     *  The arguments have already been checked by getRegion. Subclasses MUST
+     *  call rewindIfNeeded() before reading the stream.
+     */
+    virtual Result onGetRegion(const SkImageInfo& scaledInfo, const SkIRect& subset,
+                               void* dst, size_t rowBytes);
+
+    /**
+     *  Override if your format can begin decoding partway down the image, given
+     *  all of its encoded data.
+     *
+     *  @param data The encoded data this codec was created from.
+     *  @param scaledInfo As in getRegion.
+     *  @param y A row of scaledInfo which the new codec must be able to decode.
+     *  @param firstRow Set to the row of scaledInfo which will be row 0 of the
+     *      new codec. Never greater than y.
+     *  @return A new codec, which decodes scaledInfo's rows from *firstRow on
+     *      when asked for an image scaledInfo.height() - *firstRow rows tall, or
+     *      NULL if this is not possible (the default).
+     */
+    virtual SkCodec* onNewCodecForRows(SkData* data, const SkImageInfo& scaledInfo, int y,
+                                       int* firstRow) {
+        return NULL;
+    }
+
     virtual bool onReallyHasAlpha() const { return false; }
 
     /**
@@ -23,8 +23,23 @@ public:
 
 class SK_API SkRTreeFactory : public SkBBHFactory {
 public:
+    // How the R-tree groups the bounding boxes it is given all at once.
+    enum BulkLoad {
+        // Sort-tile-recursive: tiles the boxes in the order given, in strips proportioned to
+        // the picture.  Fastest to build when boxes come in a sensible x,y order.
+        kSTR_BulkLoad,
+        // Sorts the boxes by the position of their centers along a Hilbert curve, then packs
+        // them in that order.  Slower to build, but makes tighter nodes when boxes come in no
+        // particular order.
+        kHilbert_BulkLoad,
+    };
+
+    explicit SkRTreeFactory(BulkLoad bulkLoad = kSTR_BulkLoad) : fBulkLoad(bulkLoad) {}
+
     SkBBoxHierarchy* operator()(const SkRect& bounds) const override;
 private:
+    BulkLoad fBulkLoad;
+
     typedef SkBBHFactory INHERITED;
 };
 
@@ -50,6 +50,7 @@ protected:
                             const SkPoint[], const SkPaint& paint) override;
     virtual void drawRect(const SkDraw&, const SkRect& r,
                           const SkPaint& paint) override;
+    void drawRects(const SkDraw&, const SkRect rects[], int count, const SkPaint&) override;
     virtual void drawOval(const SkDraw&, const SkRect& oval,
                           const SkPaint& paint) override;
     virtual void drawRRect(const SkDraw&, const SkRRect& rr,
@@ -93,6 +94,12 @@ protected:
     virtual void drawPosText(const SkDraw&, const void* text, size_t len,
                              const SkScalar pos[], int scalarsPerPos,
                              const SkPoint& offset, const SkPaint& paint) override;
+    /**
+     *  Draws from the glyph masks of the blob cached by SkGlyphRunCache, when possible, rather
+     *  than calling drawText() and drawPosText() for each run.
+     */
+    virtual void drawTextBlob(const SkDraw&, const SkTextBlob*, SkScalar x, SkScalar y,
+                              const SkPaint& paint, SkDrawFilter* drawFilter) override;
     virtual void drawVertices(const SkDraw&, SkCanvas::VertexMode, int vertexCount,
                               const SkPoint verts[], const SkPoint texs[],
                               const SkColor colors[], SkXfermode* xmode,
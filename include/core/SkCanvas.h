@@ -681,6 +681,15 @@ public:
     */
     void drawRect(const SkRect& rect, const SkPaint& paint);
 
+    /** Draw each of the rectangles using the specified paint, in order. This
+        is the same as calling drawRect() for each, but lets the device set up
+        for the paint once rather than once per rectangle.
+        @param rects    The rects to be drawn
+        @param count    The number of rects
+        @param paint    The paint used to draw the rects
+    */
+    void drawRects(const SkRect rects[], int count, const SkPaint& paint);
+
     /** Draw the specified rectangle using the specified paint. The rectangle
         will be filled or framed based on the Style in the paint.
         @param rect     The rect to be drawn
@@ -829,6 +838,18 @@ public:
                               const SkPaint* paint = NULL,
                               DrawBitmapRectFlags flags = kNone_DrawBitmapRectFlag);
 
+    /** Draw count subsets of the bitmap, in order. This is the same as calling
+        drawBitmapRectToRect(bitmap, &src[i], dst[i], paint) for each, but lets
+        the device set up for the bitmap and paint once.
+        @param bitmap   The bitmap to be drawn
+        @param src      The subsets of the bitmap to be drawn
+        @param dst      The destination rectangles, one per subset
+        @param count    The number of src/dst pairs
+        @param paint    The paint used to draw the bitmap, or NULL
+    */
+    void drawBitmapRects(const SkBitmap& bitmap, const SkRect src[], const SkRect dst[],
+                         int count, const SkPaint* paint = NULL);
+
     void drawBitmapRect(const SkBitmap& bitmap, const SkRect& dst,
                         const SkPaint* paint = NULL) {
         this->drawBitmapRectToRect(bitmap, NULL, dst, paint, kNone_DrawBitmapRectFlag);
@@ -1200,6 +1221,7 @@ protected:
 
     virtual void onDrawPaint(const SkPaint&);
     virtual void onDrawRect(const SkRect&, const SkPaint&);
+    virtual void onDrawRects(const SkRect[], int count, const SkPaint&);
     virtual void onDrawOval(const SkRect&, const SkPaint&);
     virtual void onDrawRRect(const SkRRect&, const SkPaint&);
     virtual void onDrawPoints(PointMode, size_t count, const SkPoint pts[], const SkPaint&);
@@ -1212,6 +1234,8 @@ protected:
     virtual void onDrawBitmap(const SkBitmap&, SkScalar dx, SkScalar dy, const SkPaint*);
     virtual void onDrawBitmapRect(const SkBitmap&, const SkRect*, const SkRect&, const SkPaint*,
                                   DrawBitmapRectFlags);
+    virtual void onDrawBitmapRects(const SkBitmap&, const SkRect src[], const SkRect dst[],
+                                   int count, const SkPaint*);
     virtual void onDrawBitmapNine(const SkBitmap&, const SkIRect& center, const SkRect& dst,
                                   const SkPaint*);
     virtual void onDrawSprite(const SkBitmap&, int left, int top, const SkPaint*);
@@ -1287,6 +1311,7 @@ private:
     friend class SkRecorder;        // InitFlags
     friend class SkNoSaveLayerCanvas;   // InitFlags
     friend class SkPictureImageFilter;  // SkCanvas(SkBaseDevice*, SkSurfaceProps*, InitFlags)
+    friend class SkMultiPictureDraw;    // needs predrawNotify() and fProps for tiled draws
 
     enum InitFlags {
         kDefault_InitFlags                  = 0,
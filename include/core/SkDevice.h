@@ -180,6 +180,10 @@ protected:
     virtual void drawDRRect(const SkDraw&, const SkRRect& outer,
                             const SkRRect& inner, const SkPaint&);
 
+    // Default impl calls drawRect() for each rect. Devices which can set up for a paint once
+    // and then draw many rects with it should override this.
+    virtual void drawRects(const SkDraw&, const SkRect rects[], int count, const SkPaint&);
+
     /**
      *  If pathIsMutable, then the implementation is allowed to cast path to a
      *  non-const pointer and modify it in place (as an optimization). Canvas
@@ -209,6 +213,10 @@ protected:
                                 const SkPaint& paint,
                                 SkCanvas::DrawBitmapRectFlags flags) = 0;
 
+    // Default impl calls drawBitmapRect() for each src/dst pair.
+    virtual void drawBitmapRects(const SkDraw&, const SkBitmap&, const SkRect src[],
+                                 const SkRect dst[], int count, const SkPaint&);
+
     /**
      *  Does not handle text decoration.
      *  Decorations (underline and stike-thru) will be handled by SkCanvas.
@@ -359,6 +367,7 @@ private:
     friend class SkDeviceFilteredPaint;
     friend class SkDeviceImageFilterProxy;
     friend class SkDeferredDevice;    // for newSurface
+    friend class SkGlyphRunCache;     // for filterTextFlags and getLeakyProperties
     friend class SkNoPixelsBitmapDevice;
 
     friend class SkSurface_Raster;
@@ -63,6 +63,17 @@ public:
     static SkDocument* CreatePDF(const char outputFilePath[],
                                  SkScalar dpi = SK_ScalarDefaultRasterDPI);
 
+    /**
+     *  Create a PDF-backed document like CreatePDF(), but one that writes
+     *  each page's content, and any images first drawn on it, to the stream
+     *  by the following endPage() or close(), compressing them on other
+     *  threads while the next page is drawn.  This keeps less of the
+     *  document in memory.  The pages, fonts and other shared resources
+     *  are still written once, by close().
+     */
+    static SkDocument* CreateStreamingPDF(SkWStream*,
+                                          SkScalar dpi = SK_ScalarDefaultRasterDPI);
+
     /**
      *  Create a XPS-backed document, writing the results into the stream.
      *  Returns NULL if XPS is not supported.
@@ -39,6 +39,8 @@ public:
     void    drawRect(const SkRect& rect, const SkPaint& paint) const {
         this->drawRect(rect, paint, NULL, NULL);
     }
+    // Like calling drawRect() for each rect, but fills share one blitter.
+    void    drawRects(const SkRect rects[], int count, const SkPaint&) const;
     void    drawRRect(const SkRRect&, const SkPaint&) const;
     /**
      *  To save on mallocs, we allow a flag that tells us that srcPath is
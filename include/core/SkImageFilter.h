@@ -51,6 +51,8 @@ public:
         uint32_t fFlags;
     };
 
+    class Context;
+
     // This cache maps from (filter's unique ID + CTM + clipBounds + src bitmap generation ID) to
     // (result, offset).
     class Cache : public SkRefCnt {
@@ -61,6 +63,19 @@ public:
         static Cache* Get();
         virtual bool get(const Key& key, SkBitmap* result, SkIPoint* offset) const = 0;
         virtual void set(const Key& key, const SkBitmap& result, const SkIPoint& offset) = 0;
+
+        // filterImage() calls these, which also see what Key was built from. A cache that
+        // outlives the process needs them, since Key's IDs are only unique within it (see
+        // SkPersistentImageFilterCache). src is NULL if the result does not depend on it.
+        // By default they forward to get() and set().
+        virtual bool find(const Key& key, const SkImageFilter*, const SkBitmap* src,
+                          const Context&, SkBitmap* result, SkIPoint* offset) const {
+            return this->get(key, result, offset);
+        }
+        virtual void add(const Key& key, const SkImageFilter*, const SkBitmap* src,
+                         const Context&, const SkBitmap& result, const SkIPoint& offset) {
+            this->set(key, result, offset);
+        }
     };
 
     class Context {
@@ -190,6 +205,11 @@ public:
      */
     bool cropRectIsSet() const { return fCropRect.flags() != 0x0; }
 
+    /**
+     *  Returns an ID unique to this filter within the process.
+     */
+    uint32_t uniqueID() const { return fUniqueID; }
+
     // Default impl returns union of all input bounds.
     virtual void computeFastBounds(const SkRect&, SkRect*) const;
 
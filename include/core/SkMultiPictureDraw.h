@@ -43,6 +43,26 @@ public:
              const SkMatrix* matrix = NULL,
              const SkPaint* paint = NULL);
 
+    /**
+     *  Add a picture to be drawn into a raster canvas by several threads at once.
+     *  draw() splits the canvas' pixels into tiles of tileSize and plays the picture
+     *  back into all the tiles concurrently, each clipped to its tile. If the picture
+     *  has a bounding box hierarchy, each tile only visits the ops that touch it.
+     *
+     *  If the canvas' pixels are not directly accessible (e.g. it's GPU-backed) or
+     *  its clip is not a rectangle, this behaves just like add(canvas, picture, matrix).
+     *  The canvas must not be drawn into by anyone else until draw() returns.
+     *
+     *  @param canvas   the raster canvas in which to draw picture
+     *  @param picture  the picture to draw into canvas
+     *  @param tileSize the size of the tiles, in device pixels
+     *  @param matrix   if non-NULL, applied to the CTM when drawing
+     */
+    void addTiled(SkCanvas* canvas,
+                  const SkPicture* picture,
+                  const SkISize& tileSize,
+                  const SkMatrix* matrix = NULL);
+
     /**
      *  Perform all the previously added draws. This will reset the state
      *  of this object. If flush is true, all canvases are flushed after
@@ -61,6 +81,7 @@ private:
         const SkPicture* fPicture; // reffed
         SkMatrix         fMatrix;
         SkPaint*         fPaint;   // owned
+        SkISize          fTileSize; // only used by fTiledDrawData
 
         void init(SkCanvas*, const SkPicture*, const SkMatrix*, const SkPaint*);
         void draw();
@@ -70,8 +91,12 @@ private:
         static void Draw(DrawData* d) { d->draw(); }
     };
 
+    // Splits a DrawData from fTiledDrawData into per-tile DrawData in fThreadSafeDrawData.
+    void splitIntoTiles(const DrawData&);
+
     SkTDArray<DrawData> fThreadSafeDrawData;
     SkTDArray<DrawData> fGPUDrawData;
+    SkTDArray<DrawData> fTiledDrawData;
 };
 
 #endif
@@ -88,6 +88,13 @@ int sk_feof(SkFILE *);
 // Description of the error, if any, will be written to stderr.
 bool    sk_mkdir(const char* path);
 
+// Delete the file at this path; returns true if successful.
+bool    sk_remove(const char* path);
+
+// Move the file at oldPath to newPath; returns true if successful. On some
+// platforms this fails if newPath already exists.
+bool    sk_rename(const char* oldPath, const char* newPath);
+
 class SkOSFile {
 public:
     class Iter {
@@ -10,6 +10,7 @@
 #define SkPathRef_DEFINED
 
 #include "SkMatrix.h"
+#include "SkMutex.h"
 #include "SkPoint.h"
 #include "SkRect.h"
 #include "SkRefCnt.h"
@@ -32,6 +33,11 @@ class SkWBuffer;
  * and verbs both grow into the middle of the allocation until the meet. To access verb i in the
  * verb array use ref.verbs()[~i] (because verbs() returns a pointer just beyond the first
  * logical verb or the last verb in memory).
+ *
+ * A path ref made by CreateTransformedCopy() may instead be a transformed view of its source: it
+ * holds the source and the matrix, and only allocates and maps its points when something first
+ * asks for them (or for its verbs). Counts, segment masks and, when the matrix keeps rects rects,
+ * bounds are known without doing so.
  */
 
 class SK_API SkPathRef : public ::SkRefCnt {
@@ -167,7 +173,9 @@ public:
     }
 
     /**
-     * Transforms a path ref by a matrix, allocating a new one only if necessary.
+     * Transforms a path ref by a matrix, allocating a new one only if necessary. Unless it
+     * transforms src in place, this defers mapping the points of larger paths until they are
+     * needed.
      */
     static void CreateTransformedCopy(SkAutoTUnref<SkPathRef>* dst,
                                       const SkPathRef& src,
@@ -185,6 +193,8 @@ public:
     virtual ~SkPathRef() {
         SkDEBUGCODE(this->validate();)
         sk_free(fPoints);
+        this->freeLazy();
+        this->callGenIDChangeListeners();
 
         SkDEBUGCODE(fPoints = NULL;)
         SkDEBUGCODE(fVerbs = NULL;)
@@ -202,7 +212,11 @@ public:
     /**
      * Returns a pointer one beyond the first logical verb (last verb in memory order).
      */
-    const uint8_t* verbs() const { SkDEBUGCODE(this->validate();) return fVerbs; }
+    const uint8_t* verbs() const {
+        this->materialize();
+        SkDEBUGCODE(this->validate();)
+        return fVerbs;
+    }
 
     /**
      * Returns a const pointer to the first verb in memory (which is the last logical verb).
@@ -212,7 +226,11 @@ public:
     /**
      * Returns a const pointer to the first point.
      */
-    const SkPoint* points() const { SkDEBUGCODE(this->validate();) return fPoints; }
+    const SkPoint* points() const {
+        this->materialize();
+        SkDEBUGCODE(this->validate();)
+        return fPoints;
+    }
 
     /**
      * Shortcut for this->points() + this->countPoints()
@@ -255,6 +273,24 @@ public:
 
     SkDEBUGCODE(void validate() const;)
 
+    // Register a listener that may be called the next time our generation ID changes: when we
+    // are edited or deleted. Each listener is called at most once, so a cache keyed by our
+    // generation ID must add a new listener for each generation ID it sees. Listeners are not
+    // added to (and so never called for) empty path refs, which keep the same ID forever.
+    struct GenIDChangeListener {
+        virtual ~GenIDChangeListener() {}
+        virtual void onChange() = 0;
+
+        // A listener is not added if it equals() one we already have, so a cache may add one
+        // each time it (re)fills an entry. Listeners of different kind()s are never compared;
+        // the default NULL kind compares unequal to everything.
+        virtual const void* kind() const { return NULL; }
+        virtual bool equals(const GenIDChangeListener& other) const { return false; }
+    };
+
+    // Takes ownership of listener. Safe to call on a path ref shared across threads.
+    void addGenIDChangeListener(GenIDChangeListener* listener);
+
 private:
     enum SerializationOffsets {
         kIsFinite_SerializationShift = 25,  // requires 1 bit
@@ -272,10 +308,33 @@ private:
         fGenerationID = kEmptyGenID;
         fSegmentMask = 0;
         fIsOval = false;
+        fLazy = NULL;
         SkDEBUGCODE(fEditorsAttached = 0;)
         SkDEBUGCODE(this->validate();)
     }
 
+    /**
+     * The source and matrix of a path ref whose points have yet to be mapped. Defined in
+     * SkPathRef.cpp.
+     */
+    struct Lazy;
+
+    /** If this is a transformed view of another path ref, maps its points now (just once). */
+    void materialize() const {
+        if (fLazy) {
+            this->materializeSlow();
+        }
+    }
+    void materializeSlow() const;
+    static void Materialize(SkPathRef*);
+
+    // Called before our contents (and so our generation ID) change.
+    void callGenIDChangeListeners();
+
+    /** Makes this an ordinary path ref. Unless its points are about to be discarded, it must
+        be unique and have been materialized. */
+    void freeLazy();
+
     void copy(const SkPathRef& ref, int additionalReserveVerbs, int additionalReservePoints);
 
     // Return true if the computed bounds are finite.
@@ -425,6 +484,7 @@ private:
     void setIsOval(bool isOval) { fIsOval = isOval; }
 
     SkPoint* getPoints() {
+        SkASSERT(NULL == fLazy);
         SkDEBUGCODE(this->validate();)
         fIsOval = false;
         return fPoints;
@@ -447,6 +507,9 @@ private:
     int                 fPointCnt;
     size_t              fFreeSpace; // redundant but saves computation
     SkTDArray<SkScalar> fConicWeights;
+    Lazy*               fLazy;  // Non-NULL if fPoints and fVerbs may be yet to be allocated.
+    SkTDArray<GenIDChangeListener*> fGenIDChangeListeners;  // pointers are owned
+    SkMutex             fGenIDChangeListenersMutex;  // guards fGenIDChangeListeners
 
     enum {
         kEmptyGenID = 1, // GenID reserved for path ref with zero points and zero verbs.
@@ -89,6 +89,20 @@ public:
     static SkPicture* CreateFromStream(SkStream*,
                                        InstallPixelRefProc proc = &SkImageDecoder::DecodeMemory);
 
+    /**
+     *  Recreate a picture that was serialized into data, e.g. an SKP file mapped with
+     *  SkData::NewFromFileName(). Rather than being copied, the recorded ops and the pixels of
+     *  unencoded bitmaps refer directly to data where the layout allows it, so it is kept alive
+     *  by the picture.
+     *  @param SkData Serialized picture data. Ownership is unchanged by this call.
+     *  @param proc Function pointer for installing pixelrefs on SkBitmaps representing the
+     *              encoded bitmap data.
+     *  @return A new SkPicture representing the serialized data, or NULL if the data is
+     *          invalid.
+     */
+    static SkPicture* CreateFromData(SkData*,
+                                     InstallPixelRefProc proc = &SkImageDecoder::DecodeMemory);
+
     /**
      *  Recreate a picture that was serialized into a buffer. If the creation requires bitmap
      *  decoding, the decoder must be set on the SkReadBuffer parameter by calling
@@ -244,13 +258,14 @@ private:
     // V38: Added PictureResolution option to SkPictureImageFilter
     // V39: Added FilterLevel option to SkPictureImageFilter
     // V40: Remove UniqueID serialization from SkImageFilter.
+    // V41: Align the op data and buffer within streams, and prefix flattened paths with their size.
 
     // Note: If the picture version needs to be increased then please follow the
     // steps to generate new SKPs in (only accessible to Googlers): http://goo.gl/qATVcw
 
     // Only SKPs within the min/current picture version range (inclusive) can be read.
     static const uint32_t MIN_PICTURE_VERSION = 35;     // Produced by Chrome M39.
-    static const uint32_t CURRENT_PICTURE_VERSION = 40;
+    static const uint32_t CURRENT_PICTURE_VERSION = 41;
 
     void createHeader(SkPictInfo* info) const;
     static bool IsValidPictInfo(const SkPictInfo& info);
@@ -258,6 +273,9 @@ private:
     // Takes ownership of the SkRecord and (optional) SnapshotArray, refs the (optional) BBH.
     SkPicture(const SkRect& cullRect, SkRecord*, SnapshotArray*, SkBBoxHierarchy*);
 
+    // backing, if not NULL, is the SkData the SkMemoryStream reads from.
+    static SkPicture* CreateFromStream(SkStream*, InstallPixelRefProc, SkData* backing);
+
     static SkPicture* Forwardport(const SkPictInfo&, const SkPictureData*);
     static SkPictureData* Backport(const SkRecord&, const SkPictInfo&,
                                    SkPicture const* const drawablePics[], int drawableCount);
@@ -293,6 +311,7 @@ private:
     } fAnalysis;
 
     friend class SkPictureRecorder;            // SkRecord-based constructor.
+    friend class SkPictureData;                // nested pictures share our backing SkData
     friend class GrLayerHoister;               // access to fRecord
     friend class ReplaceDraw;
     friend class SkPictureUtils;
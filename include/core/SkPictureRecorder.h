@@ -32,7 +32,12 @@ public:
     enum RecordFlags {
         // This flag indicates that, if some BHH is being computed, saveLayer
         // information should also be extracted at the same time.
-        kComputeSaveLayerInfo_RecordFlag = 0x01
+        kComputeSaveLayerInfo_RecordFlag = 0x01,
+
+        // This flag turns draws which later opaque draws paint right over into no-ops.  The
+        // picture then only draws the same pixels when played back with no anti-aliased clip
+        // and a matrix that doesn't scale it down, so only set it for pictures drawn that way.
+        kNoopOccludedDraws_RecordFlag = 0x02
     };
 
     /** Returns the canvas that records the drawing commands.
@@ -8,6 +8,7 @@
 #ifndef SkTextBlob_DEFINED
 #define SkTextBlob_DEFINED
 
+#include "SkAtomics.h"
 #include "SkPaint.h"
 #include "SkRefCnt.h"
 #include "SkTArray.h"
@@ -91,14 +92,22 @@ private:
 
     static unsigned ScalarsPerGlyph(GlyphPositioning pos);
 
+    // Call when this blob is part of the key to a resourcecache entry, so that the entry is
+    // purged when this blob is deleted.
+    void notifyAddedToCache() const {
+        fAddedToCache.store(true);
+    }
+
     friend class GrTextContext;
     friend class SkBaseDevice;
+    friend class SkGlyphRunCache;
     friend class SkTextBlobBuilder;
     friend class TextBlobTester;
 
     const int        fRunCount;
     const SkRect     fBounds;
     const uint32_t fUniqueID;
+    mutable SkAtomic<bool> fAddedToCache;
 
     SkDEBUGCODE(size_t fStorageSize;)
 
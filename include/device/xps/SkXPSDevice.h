@@ -120,6 +120,13 @@ protected:
         const SkScalar pos[], int scalarsPerPos,
         const SkPoint& offset, const SkPaint& paint) override;
 
+    virtual void drawTextBlob(
+        const SkDraw&,
+        const SkTextBlob* blob,
+        SkScalar x, SkScalar y,
+        const SkPaint& paint,
+        SkDrawFilter* drawFilter) override;
+
     virtual void drawVertices(
         const SkDraw&,
         SkCanvas::VertexMode,
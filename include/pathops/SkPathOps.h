@@ -8,6 +8,8 @@
 #define SkPathOps_DEFINED
 
 #include "SkPreConfig.h"
+#include "SkTArray.h"
+#include "SkTDArray.h"
 
 class SkPath;
 struct SkRect;
@@ -63,4 +65,47 @@ bool SK_API Simplify(const SkPath& path, SkPath* result);
   */
 bool SK_API TightBounds(const SkPath& path, SkRect* result);
 
+/** Perform a series of path operations, optimized for unioning many paths together.
+  */
+class SK_API SkOpBuilder {
+public:
+    /** How resolve() combines a run of consecutive union (or intersect) operands.
+      */
+    enum Reduction {
+        kSequential_Reduction,  //!< one operand at a time, in the order added
+        kBalanced_Reduction,    //!< pairwise, as a balanced tree: N log N rather than N^2
+        kParallel_Reduction,    //!< as kBalanced, with each level's pairs on SkTaskGroup threads
+    };
+
+    explicit SkOpBuilder(Reduction reduction = kSequential_Reduction)
+        : fReduction(reduction) {}
+
+    /** Add one or more paths and their operand. The builder is empty before the first
+        path is added, so the result of a single add is (emptyPath OP path).
+
+        @param path The second operand.
+        @param _operator The operator to apply to the existing and supplied paths.
+     */
+    void add(const SkPath& path, SkPathOp _operator);
+
+    /** Computes the sum of all paths and operands, and resets the builder to its
+        initial state.
+
+        Unless the reduction is kSequential_Reduction, each run of two or more union (or
+        intersect) operands is first combined on its own, pairwise. Pairs of operands whose
+        bounds do not intersect are combined without a full path operation.
+
+        @param result The product of the operands.
+        @return True if the operation succeeded.
+      */
+    bool resolve(SkPath* result);
+
+private:
+    SkTArray<SkPath> fPathRefs;
+    SkTDArray<SkPathOp> fOps;
+    Reduction fReduction;
+
+    void reset();
+};
+
 #endif
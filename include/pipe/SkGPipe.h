@@ -46,6 +46,19 @@ public:
      */
     void setBitmapDecoder(SkPicture::InstallPixelRefProc proc) { fProc = proc; }
 
+    /**
+     *  Function for finding the pixels of a bitmap that the writer's controller shared with this
+     *  reader out of band (see SkGPipeController::shareBitmap). Given the id the controller
+     *  chose and the size of the pixels, it returns where this reader can read them, or NULL.
+     *  The pixels must stay there for as long as the reader may draw them.
+     */
+    typedef void* (*SharedPixelsProc)(uint32_t id, size_t bytes, void* context);
+
+    void setSharedPixelsProc(SharedPixelsProc proc, void* context) {
+        fSharedPixelsProc = proc;
+        fSharedPixelsContext = context;
+    }
+
     // data must be 4-byte aligned
     // length must be a multiple of 4
     Status playback(const void* data, size_t length, uint32_t playbackFlags = 0,
@@ -54,6 +67,8 @@ private:
     SkCanvas*                       fCanvas;
     class SkGPipeState*             fState;
     SkPicture::InstallPixelRefProc  fProc;
+    SharedPixelsProc                fSharedPixelsProc;
+    void*                           fSharedPixelsContext;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -87,6 +102,15 @@ public:
     virtual void notifyWritten(size_t bytes) = 0;
     virtual int numberOfReaders() const { return 1; }
 
+    /**
+     *  Called by a cross process writer without a shared address space before it flattens a
+     *  bitmap's pixels into the stream. If the reader can already read those pixels, because
+     *  they are in memory shared with it, return true and set id to what the reader's
+     *  SkGPipeReader::SharedPixelsProc needs to find them: then only the id and the bitmap's
+     *  SkImageInfo go into the stream. By default nothing is shared.
+     */
+    virtual bool shareBitmap(const SkBitmap&, uint32_t* id) { return false; }
+
 private:
     friend class SkGPipeWriter;
     void setCanvas(SkGPipeCanvas*);
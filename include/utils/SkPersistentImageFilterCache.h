@@ -0,0 +1,102 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPersistentImageFilterCache_DEFINED
+#define SkPersistentImageFilterCache_DEFINED
+
+#include "SkImageFilter.h"
+#include "SkTemplates.h"
+
+/**
+ *  An SkImageFilter::Cache with two levels: any in-memory cache (e.g. one from
+ *  SkImageFilter::Cache::Create()) in front of a directory of files, which outlives the
+ *  process.
+ *
+ *  The memory level is keyed as usual, by IDs which mean nothing to another process. The disk
+ *  level is keyed by content: an MD5 of the serialized filter DAG, of the source's pixels (if
+ *  the filter uses them), of the CTM and of the clip bounds. So a process that redraws a
+ *  filtered layer some earlier process drew will find the result on disk.
+ *
+ *  Only raster results are stored on disk. Several processes may share a directory: each
+ *  entry is written to a temporary file and then renamed into place, and entries written by
+ *  other processes are picked up when looked up.
+ */
+class SK_API SkPersistentImageFilterCache : public SkImageFilter::Cache {
+public:
+    struct Options {
+        Options()
+            : fMaxDiskBytes(256 * 1024 * 1024)
+            , fMaxAgeSeconds(0)
+            , fClock(NULL)
+            , fClockContext(NULL) {}
+
+        // The least recently used entries are evicted to keep the directory below this.
+        size_t      fMaxDiskBytes;
+        // Entries written longer ago than this are evicted. 0 means no limit.
+        uint32_t    fMaxAgeSeconds;
+        // Returns the time in seconds since the epoch, which entries' ages are measured by,
+        // given fClockContext. NULL means the system clock; tests substitute their own.
+        uint32_t    (*fClock)(void* context);
+        void*       fClockContext;
+    };
+
+    struct Stats {
+        int32_t     fMemoryHits;
+        int32_t     fDiskHits;
+        int32_t     fMisses;
+        int32_t     fDiskWrites;
+        int32_t     fDiskEvictions;
+        int32_t     fDiskEntries;   // Currently on disk.
+        size_t      fDiskBytes;     // Currently on disk.
+    };
+
+    /**
+     *  Returns a cache keeping its files in dir, which is created if necessary, or NULL if it
+     *  cannot be. memoryCache is the level in front; the new cache takes a ref on it. Entries
+     *  already in dir are indexed, and those past their age evicted.
+     */
+    static SkPersistentImageFilterCache* Create(const char dir[],
+                                                SkImageFilter::Cache* memoryCache,
+                                                const Options& = Options());
+
+    virtual ~SkPersistentImageFilterCache();
+
+    /**
+     *  Fill out stats: counts of lookups and writes since this cache was created, and the
+     *  current size of the disk level. Meant to be polled and exported by the client.
+     */
+    void getStats(Stats*) const;
+
+    /**
+     *  Evict the disk entries which are past their age. This is also done on creation, and to
+     *  any entry found past its age when it is looked up.
+     */
+    void purgeExpired();
+
+    // get() and set() only reach the memory level, since Key alone cannot identify a result
+    // to another process. filterImage() calls find() and add(), which reach both.
+    bool get(const Key&, SkBitmap* result, SkIPoint* offset) const override;
+    void set(const Key&, const SkBitmap& result, const SkIPoint& offset) override;
+    bool find(const Key&, const SkImageFilter*, const SkBitmap* src,
+              const SkImageFilter::Context&, SkBitmap* result, SkIPoint* offset) const override;
+    void add(const Key&, const SkImageFilter*, const SkBitmap* src,
+             const SkImageFilter::Context&, const SkBitmap& result,
+             const SkIPoint& offset) override;
+
+private:
+    class DiskLevel;
+
+    SkPersistentImageFilterCache(SkImageFilter::Cache* memoryCache, DiskLevel*);
+
+    SkAutoTUnref<SkImageFilter::Cache>  fMemory;
+    SkAutoTDelete<DiskLevel>            fDisk;
+    mutable int32_t                     fMemoryHits;
+
+    typedef SkImageFilter::Cache INHERITED;
+};
+
+#endif
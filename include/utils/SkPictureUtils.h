@@ -19,6 +19,14 @@ public:
      *  SkRecord holds a reference to (e.g. paths, or pixels backing bitmaps).
      */
     static size_t ApproximateBytesUsed(const SkPicture* pict);
+
+    /**
+     *  How many bytes the SkPicture saves by having operations with equal
+     *  paints or matrices share one copy, rather than each holding its own.
+     *  ApproximateBytesUsed() would be about this much larger without sharing.
+     *  Includes nested SkPictures.
+     */
+    static size_t ApproximateBytesShared(const SkPicture* pict);
 };
 
 #endif
@@ -9,8 +9,10 @@
 #include "SkData.h"
 #include "SkCodec_libbmp.h"
 #include "SkCodec_libico.h"
+#include "SkCodec_libjpeg.h"
 #include "SkCodec_libpng.h"
 #include "SkStream.h"
+#include "SkTaskGroup.h"
 
 struct DecoderProc {
     bool (*IsFormat)(SkStream*);
@@ -19,6 +21,7 @@ struct DecoderProc {
 
 static const DecoderProc gDecoderProcs[] = {
     { SkPngCodec::IsPng, SkPngCodec::NewFromStream },
+    { SkJpegCodec::IsJpeg, SkJpegCodec::NewFromStream },
     { SkIcoCodec::IsIco, SkIcoCodec::NewFromStream },
     { SkBmpCodec::IsBmp, SkBmpCodec::NewFromStream }
 };
@@ -66,9 +69,164 @@ bool SkCodec::rewindIfNeeded() {
 
 SkScanlineDecoder* SkCodec::getScanlineDecoder(const SkImageInfo& dstInfo) {
     fScanlineDecoder.reset(NULL);
+    const bool neededRewind = fNeedsRewind;
     if (!rewindIfNeeded()) {
         return NULL;
     }
+    const size_t position = fStream->hasPosition() ? fStream->getPosition() : 0;
     fScanlineDecoder.reset(this->onGetScanlineDecoder(dstInfo));
+    if (!fScanlineDecoder && !neededRewind && fStream->hasPosition() &&
+            fStream->getPosition() == position) {
+        // Codecs without a scanline decoder (e.g. BMP) return NULL without touching the
+        // stream. onGetRegion then falls back to getPixels, and since the stream is still
+        // where NewFromStream left it, that must not rewind: BMP reads its header only once,
+        // when it is created, so it cannot decode after a rewind. If anything was read, or
+        // we can't tell, the next decode rewinds as usual.
+        fNeedsRewind = false;
+    }
     return fScanlineDecoder.get();
 }
+
+static bool valid_region(const SkImageInfo& scaledInfo, const SkIRect& subset, const void* dst,
+                         size_t rowBytes) {
+    if (NULL == dst || subset.isEmpty()) {
+        return false;
+    }
+    if (!SkIRect::MakeWH(scaledInfo.width(), scaledInfo.height()).contains(subset)) {
+        return false;
+    }
+    return rowBytes >= (size_t) subset.width() * scaledInfo.bytesPerPixel();
+}
+
+SkCodec::Result SkCodec::getRegion(const SkImageInfo& scaledInfo, const SkIRect& subset,
+                                   void* dst, size_t rowBytes) {
+    // FIXME: Support kIndex_8 by taking a color table, as getPixels does.
+    if (kUnknown_SkColorType == scaledInfo.colorType() ||
+            kIndex_8_SkColorType == scaledInfo.colorType()) {
+        return kInvalidConversion;
+    }
+    if (!valid_region(scaledInfo, subset, dst, rowBytes)) {
+        return kInvalidParameters;
+    }
+    return this->onGetRegion(scaledInfo, subset, dst, rowBytes);
+}
+
+SkCodec::Result SkCodec::onGetRegion(const SkImageInfo& scaledInfo, const SkIRect& subset,
+                                     void* dst, size_t rowBytes) {
+    const size_t bpp = scaledInfo.bytesPerPixel();
+    const size_t srcOffset = subset.left() * bpp;
+    const size_t bytesToCopy = subset.width() * bpp;
+
+    SkScanlineDecoder* scanlineDecoder = this->getScanlineDecoder(scaledInfo);
+    if (NULL == scanlineDecoder) {
+        // Decode everything, then copy out the subset.
+        const size_t srcRowBytes = scaledInfo.minRowBytes();
+        SkAutoMalloc storage(scaledInfo.getSafeSize(srcRowBytes));
+        const Result result = this->getPixels(scaledInfo, storage.get(), srcRowBytes);
+        if (kSuccess != result && kIncompleteInput != result) {
+            return result;
+        }
+        const uint8_t* src = SkTAddOffset<const uint8_t>(storage.get(),
+                                                         subset.top() * srcRowBytes + srcOffset);
+        for (int y = 0; y < subset.height(); y++) {
+            memcpy(dst, src, bytesToCopy);
+            dst = SkTAddOffset<void>(dst, rowBytes);
+            src += srcRowBytes;
+        }
+        return result;
+    }
+
+    Result result = scanlineDecoder->skipScanlines(subset.top());
+    if (kSuccess != result) {
+        return result;
+    }
+    SkAutoMalloc storage(scaledInfo.minRowBytes());
+    const uint8_t* src = SkTAddOffset<const uint8_t>(storage.get(), srcOffset);
+    for (int y = 0; y < subset.height(); y++) {
+        const Result rowResult = scanlineDecoder->getScanlines(storage.get(), 1, 0);
+        if (kIncompleteInput == rowResult) {
+            // The decoder still filled in the row.
+            result = rowResult;
+        } else if (kSuccess != rowResult) {
+            return rowResult;
+        }
+        memcpy(dst, src, bytesToCopy);
+        dst = SkTAddOffset<void>(dst, rowBytes);
+    }
+    return result;
+}
+
+namespace {
+
+// One band of rows for GetRegionInParallel.
+struct RegionBand {
+    SkCodec*            fCodec;
+    SkImageInfo         fScaledInfo;    // Of fCodec's rows.
+    SkIRect             fSubset;        // In fCodec's rows.
+    void*               fDst;
+    size_t              fRowBytes;
+    SkCodec::Result     fResult;
+};
+
+}  // namespace
+
+static void decode_band(RegionBand* band) {
+    band->fResult = band->fCodec->getRegion(band->fScaledInfo, band->fSubset, band->fDst,
+                                            band->fRowBytes);
+}
+
+// Bands must be tall enough to pay for their codec's setup, and for the rows above them
+// which a codec may have to decode and throw away.
+static const int kMinRowsPerBand = 128;
+static const int kMaxBands = 32;
+
+SkCodec::Result SkCodec::GetRegionInParallel(SkData* data, const SkImageInfo& scaledInfo,
+                                             const SkIRect& subset, void* dst,
+                                             size_t rowBytes) {
+    SkAutoTDelete<SkCodec> codec(NewFromData(data));
+    if (!codec) {
+        return kInvalidInput;
+    }
+    const int bandCount = SkTMin(kMaxBands, subset.height() / kMinRowsPerBand);
+    if (bandCount <= 1 || !valid_region(scaledInfo, subset, dst, rowBytes)) {
+        return codec->getRegion(scaledInfo, subset, dst, rowBytes);
+    }
+
+    SkAutoTDelete<SkCodec> bandCodecs[kMaxBands];
+    SkAutoSTArray<kMaxBands, RegionBand> bands(bandCount);
+    for (int i = 0; i < bandCount; i++) {
+        const int top = subset.top() + subset.height() * i / bandCount;
+        const int bottom = subset.top() + subset.height() * (i + 1) / bandCount;
+        int firstRow;
+        bandCodecs[i].reset(codec->onNewCodecForRows(data, scaledInfo, top, &firstRow));
+        if (!bandCodecs[i]) {
+            // Every band would have to decode from the top of the image, so there is
+            // nothing to gain.
+            return codec->getRegion(scaledInfo, subset, dst, rowBytes);
+        }
+        SkASSERT(firstRow <= top);
+
+        RegionBand& band = bands[i];
+        band.fCodec = bandCodecs[i].get();
+        band.fScaledInfo = scaledInfo.makeWH(scaledInfo.width(),
+                                             scaledInfo.height() - firstRow);
+        band.fSubset.setLTRB(subset.left(), top - firstRow, subset.right(), bottom - firstRow);
+        band.fDst = SkTAddOffset<void>(dst, (top - subset.top()) * rowBytes);
+        band.fRowBytes = rowBytes;
+        band.fResult = kSuccess;
+    }
+
+    SkTaskGroup tg;
+    tg.batch(decode_band, bands.get(), bandCount);
+    tg.wait();
+
+    Result result = kSuccess;
+    for (int i = 0; i < bandCount; i++) {
+        if (kIncompleteInput == bands[i].fResult) {
+            result = kIncompleteInput;
+        } else if (kSuccess != bands[i].fResult) {
+            return bands[i].fResult;
+        }
+    }
+    return result;
+}
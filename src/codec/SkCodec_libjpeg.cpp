@@ -0,0 +1,817 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCodec_libjpeg.h"
+#include "SkCodecPriv.h"
+#include "SkColorPriv.h"
+#include "SkData.h"
+#include "SkMath.h"
+#include "SkScanlineDecoder.h"
+#include "SkStream.h"
+
+#include <stdio.h>
+extern "C" {
+    #include "jpeglib.h"
+}
+#include <setjmp.h>
+
+///////////////////////////////////////////////////////////////////////////////
+// Callback functions
+///////////////////////////////////////////////////////////////////////////////
+
+struct JpegErrorMgr : jpeg_error_mgr {
+    jmp_buf fJmpBuf;
+};
+
+static void sk_error_exit(j_common_ptr dinfo) {
+    JpegErrorMgr* error = static_cast<JpegErrorMgr*>(dinfo->err);
+    (*error->output_message)(dinfo);
+    longjmp(error->fJmpBuf, 1);
+}
+
+static void sk_output_message(j_common_ptr dinfo) {
+    char buffer[JMSG_LENGTH_MAX];
+    (*dinfo->err->format_message)(dinfo, buffer);
+    SkDebugf("------ jpeg error %s\n", buffer);
+}
+
+struct JpegSourceMgr : jpeg_source_mgr {
+    SkStream*   fStream;    // Unowned.
+    bool        fHitEnd;    // The stream ran out before the image did.
+    enum {
+        kBufferSize = 4096
+    };
+    JOCTET      fBuffer[kBufferSize];
+};
+
+static void sk_init_source(j_decompress_ptr dinfo) {
+    JpegSourceMgr* src = static_cast<JpegSourceMgr*>(dinfo->src);
+    src->next_input_byte = src->fBuffer;
+    src->bytes_in_buffer = 0;
+}
+
+static boolean sk_fill_input_buffer(j_decompress_ptr dinfo) {
+    JpegSourceMgr* src = static_cast<JpegSourceMgr*>(dinfo->src);
+    size_t bytes = src->fStream->read(src->fBuffer, JpegSourceMgr::kBufferSize);
+    if (0 == bytes) {
+        // Like libjpeg's own sources, insert a fake EOI marker so that a truncated image
+        // decodes as much as it can (the rest comes out gray) instead of failing.
+        src->fHitEnd = true;
+        src->fBuffer[0] = (JOCTET) 0xFF;
+        src->fBuffer[1] = (JOCTET) JPEG_EOI;
+        bytes = 2;
+    }
+    src->next_input_byte = src->fBuffer;
+    src->bytes_in_buffer = bytes;
+    return TRUE;
+}
+
+static void sk_skip_input_data(j_decompress_ptr dinfo, long numBytes) {
+    JpegSourceMgr* src = static_cast<JpegSourceMgr*>(dinfo->src);
+    if (numBytes <= 0) {
+        return;
+    }
+    if ((size_t) numBytes > src->bytes_in_buffer) {
+        // If this skips past the end, the next fill reports it.
+        (void) src->fStream->skip(numBytes - src->bytes_in_buffer);
+        src->next_input_byte = src->fBuffer;
+        src->bytes_in_buffer = 0;
+    } else {
+        src->next_input_byte += numBytes;
+        src->bytes_in_buffer -= numBytes;
+    }
+}
+
+static void sk_term_source(j_decompress_ptr) {}
+
+///////////////////////////////////////////////////////////////////////////////
+// Helpers
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ *
+ * Owns the libjpeg decompress struct, along with our error and source managers.
+ *
+ */
+class JpegDecoderMgr : SkNoncopyable {
+public:
+    explicit JpegDecoderMgr(SkStream* stream)
+        : fInitialized(false) {
+        fSrcMgr.init_source = sk_init_source;
+        fSrcMgr.fill_input_buffer = sk_fill_input_buffer;
+        fSrcMgr.skip_input_data = sk_skip_input_data;
+        fSrcMgr.resync_to_restart = jpeg_resync_to_restart;
+        fSrcMgr.term_source = sk_term_source;
+        fSrcMgr.next_input_byte = fSrcMgr.fBuffer;
+        fSrcMgr.bytes_in_buffer = 0;
+        fSrcMgr.fStream = stream;
+        fSrcMgr.fHitEnd = false;
+
+        fDInfo.err = jpeg_std_error(&fErrorMgr);
+        fErrorMgr.error_exit = sk_error_exit;
+        fErrorMgr.output_message = sk_output_message;
+    }
+
+    ~JpegDecoderMgr() {
+        if (fInitialized) {
+            jpeg_destroy_decompress(&fDInfo);
+        }
+    }
+
+    // Must be called with getJmpBuf() set, as libjpeg reports errors by jumping to it.
+    void init() {
+        SkASSERT(!fInitialized);
+        jpeg_create_decompress(&fDInfo);
+        fDInfo.src = &fSrcMgr;
+        fInitialized = true;
+    }
+
+    // Called after the stream has been rewound.
+    void resetSource() {
+        fSrcMgr.next_input_byte = fSrcMgr.fBuffer;
+        fSrcMgr.bytes_in_buffer = 0;
+        fSrcMgr.fHitEnd = false;
+    }
+
+    jpeg_decompress_struct* dinfo() { return &fDInfo; }
+    jmp_buf& getJmpBuf() { return fErrorMgr.fJmpBuf; }
+    bool hitEnd() const { return fSrcMgr.fHitEnd; }
+
+private:
+    jpeg_decompress_struct  fDInfo;
+    JpegSourceMgr           fSrcMgr;
+    JpegErrorMgr            fErrorMgr;
+    bool                    fInitialized;
+};
+
+// libjpeg can scale by 1/2, 1/4 and 1/8 while decoding, which is far cheaper than decoding
+// the full image and scaling afterwards.
+static const int kMaxScaleDenom = 8;
+
+static SkISize scaled_dimensions(const SkISize& dims, int denom) {
+    // Matches libjpeg's jdiv_round_up(image_width * scale_num, scale_denom).
+    return SkISize::Make((dims.width() + denom - 1) / denom,
+                         (dims.height() + denom - 1) / denom);
+}
+
+// Returns the scale denominator which decodes to dstDims, or 0 if there is none.
+static int scale_denom_for(const SkISize& dims, const SkISize& dstDims) {
+    for (int denom = 1; denom <= kMaxScaleDenom; denom *= 2) {
+        if (scaled_dimensions(dims, denom) == dstDims) {
+            return denom;
+        }
+    }
+    return 0;
+}
+
+static bool conversion_possible(const SkImageInfo& dst, const SkImageInfo& src,
+                                bool isGray) {
+    if (dst.profileType() != src.profileType()) {
+        return false;
+    }
+    // A jpeg is always opaque, so it can be drawn into any alpha type.
+    switch (dst.colorType()) {
+        case kN32_SkColorType:
+        case kRGB_565_SkColorType:
+            return true;
+        case kGray_8_SkColorType:
+            return isGray;
+        default:
+            return false;
+    }
+}
+
+// Convert a row of (Adobe-style, inverted) CMYK samples to RGBX in place.
+// See convert_CMYK_to_RGB in SkImageDecoder_libjpeg.cpp.
+static void convert_CMYK_to_RGBX(uint8_t* row, int width) {
+    for (int x = 0; x < width; ++x, row += 4) {
+        row[0] = SkMulDiv255Round(row[0], row[3]);
+        row[1] = SkMulDiv255Round(row[1], row[3]);
+        row[2] = SkMulDiv255Round(row[2], row[3]);
+        row[3] = 0xFF;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Creation
+///////////////////////////////////////////////////////////////////////////////
+
+bool SkJpegCodec::IsJpeg(SkStream* stream) {
+    static const uint8_t kJpegSig[] = { 0xFF, 0xD8, 0xFF };
+    uint8_t buffer[sizeof(kJpegSig)];
+    return stream->read(buffer, sizeof(kJpegSig)) == sizeof(kJpegSig) &&
+           !memcmp(buffer, kJpegSig, sizeof(kJpegSig));
+}
+
+SkCodec* SkJpegCodec::NewFromStream(SkStream* stream) {
+    SkAutoTDelete<SkStream> streamDeleter(stream);
+    SkAutoTDelete<JpegDecoderMgr> decoderMgr(SkNEW_ARGS(JpegDecoderMgr, (stream)));
+
+    // FIXME: Could we use the return value of setjmp to specify the type of
+    // error?
+    if (setjmp(decoderMgr->getJmpBuf())) {
+        return NULL;
+    }
+    decoderMgr->init();
+    if (JPEG_HEADER_OK != jpeg_read_header(decoderMgr->dinfo(), TRUE)) {
+        return NULL;
+    }
+
+    const jpeg_decompress_struct* dinfo = decoderMgr->dinfo();
+    // sanity check for size
+    const int64_t size = sk_64_mul(dinfo->image_width, dinfo->image_height);
+    if (0 == size || size > (0x7FFFFFFF >> 2)) {
+        return NULL;
+    }
+
+    // FIXME: Report grayscale images as kGray_8?
+    const SkImageInfo info = SkImageInfo::Make(dinfo->image_width, dinfo->image_height,
+                                               kN32_SkColorType, kOpaque_SkAlphaType);
+    return SkNEW_ARGS(SkJpegCodec, (info, streamDeleter.detach(), decoderMgr.detach()));
+}
+
+SkJpegCodec::SkJpegCodec(const SkImageInfo& info, SkStream* stream, JpegDecoderMgr* decoderMgr)
+    : INHERITED(info, stream)
+    , fDecoderMgr(decoderMgr)
+    , fNeedsHeader(false)
+    , fSrcRow(NULL)
+    , fSrcOffset(0)
+{}
+
+SkJpegCodec::~SkJpegCodec() {}
+
+SkISize SkJpegCodec::onGetScaledDimensions(float desiredScale) const {
+    // Pick the smallest size that is no smaller than requested.
+    int denom = 1;
+    while (denom < kMaxScaleDenom && desiredScale * (denom * 2) <= 1.0f) {
+        denom *= 2;
+    }
+    return scaled_dimensions(this->getInfo().dimensions(), denom);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Getting the pixels
+///////////////////////////////////////////////////////////////////////////////
+
+bool SkJpegCodec::readHeader() {
+    // The header read by NewFromStream is good for the first decode. rewindIfNeeded() will
+    // have rewound the stream for any later one.
+    if (!fNeedsHeader) {
+        fNeedsHeader = true;
+        return true;
+    }
+
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    if (setjmp(fDecoderMgr->getJmpBuf())) {
+        return false;
+    }
+    jpeg_abort_decompress(dinfo);
+    fDecoderMgr->resetSource();
+    return JPEG_HEADER_OK == jpeg_read_header(dinfo, TRUE);
+}
+
+SkCodec::Result SkJpegCodec::initializeDecode(const SkImageInfo& dstInfo, void* dst,
+                                              size_t rowBytes, const Options& options,
+                                              const SkIRect* subset) {
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+
+    // Reject what we cannot do before touching the stream. The color space is the same for
+    // every header we read.
+    const bool isGray = JCS_GRAYSCALE == dinfo->jpeg_color_space;
+    if (!conversion_possible(dstInfo, this->getInfo(), isGray)) {
+        return kInvalidConversion;
+    }
+    const int denom = scale_denom_for(this->getInfo().dimensions(), dstInfo.dimensions());
+    if (0 == denom) {
+        return kInvalidScale;
+    }
+
+    J_COLOR_SPACE outColorSpace;
+    SkSwizzler::SrcConfig srcConfig;
+    if (isGray) {
+        outColorSpace = JCS_GRAYSCALE;
+        srcConfig = SkSwizzler::kGray;
+    } else if (JCS_CMYK == dinfo->jpeg_color_space || JCS_YCCK == dinfo->jpeg_color_space) {
+        // We convert to RGBX ourselves in readRow().
+        outColorSpace = JCS_CMYK;
+        srcConfig = SkSwizzler::kRGBX;
+    } else {
+        outColorSpace = JCS_RGB;
+        srcConfig = SkSwizzler::kRGB;
+    }
+
+    SkImageInfo swizzleInfo = dstInfo;
+    fSrcOffset = 0;
+    if (subset) {
+        swizzleInfo = dstInfo.makeWH(subset->width(), subset->height());
+        fSrcOffset = subset->left() * SkSwizzler::BytesPerPixel(srcConfig);
+    }
+    fSwizzler.reset(SkSwizzler::CreateSwizzler(srcConfig, NULL, swizzleInfo, dst, rowBytes,
+                                               options.fZeroInitialized));
+    if (!fSwizzler) {
+        // FIXME: CreateSwizzler could fail for another reason.
+        return kUnimplemented;
+    }
+
+    // Reading the header resets the decompression parameters, so set them afterwards.
+    if (!this->readHeader()) {
+        return kInvalidInput;
+    }
+    dinfo->out_color_space = outColorSpace;
+    dinfo->scale_num = 1;
+    dinfo->scale_denom = denom;
+
+    if (setjmp(fDecoderMgr->getJmpBuf())) {
+        return kInvalidInput;
+    }
+    if (!jpeg_start_decompress(dinfo)) {
+        return kInvalidInput;
+    }
+    if ((int) dinfo->output_width != dstInfo.width() ||
+        (int) dinfo->output_height != dstInfo.height()) {
+        return kInvalidScale;
+    }
+
+    fStorage.reset(dinfo->output_width * dinfo->out_color_components);
+    fSrcRow = static_cast<uint8_t*>(fStorage.get());
+    return kSuccess;
+}
+
+bool SkJpegCodec::readRow() {
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    if (1 != jpeg_read_scanlines(dinfo, &fSrcRow, 1)) {
+        return false;
+    }
+    if (JCS_CMYK == dinfo->out_color_space) {
+        convert_CMYK_to_RGBX(fSrcRow, dinfo->output_width);
+    }
+    return true;
+}
+
+SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst,
+                                         size_t rowBytes, const Options& options,
+                                         SkPMColor*, int*) {
+    if (!this->rewindIfNeeded()) {
+        return kCouldNotRewind;
+    }
+    const Result result = this->initializeDecode(dstInfo, dst, rowBytes, options, NULL);
+    if (kSuccess != result) {
+        return result;
+    }
+
+    // FIXME: Could we use the return value of setjmp to specify the type of
+    // error?
+    if (setjmp(fDecoderMgr->getJmpBuf())) {
+        return kInvalidInput;
+    }
+    for (int y = 0; y < dstInfo.height(); y++) {
+        if (!this->readRow()) {
+            return kIncompleteInput;
+        }
+        fSwizzler->next(fSrcRow + fSrcOffset);
+    }
+    jpeg_finish_decompress(fDecoderMgr->dinfo());
+
+    return fDecoderMgr->hitEnd() ? kIncompleteInput : kSuccess;
+}
+
+class SkJpegScanlineDecoder : public SkScanlineDecoder {
+public:
+    SkJpegScanlineDecoder(const SkImageInfo& dstInfo, SkJpegCodec* codec)
+        : INHERITED(dstInfo)
+        , fCodec(codec)
+    {}
+
+    SkImageGenerator::Result onGetScanlines(void* dst, int count, size_t rowBytes) override {
+        if (setjmp(fCodec->fDecoderMgr->getJmpBuf())) {
+            return SkImageGenerator::kInvalidInput;
+        }
+
+        for (int i = 0; i < count; i++) {
+            if (!fCodec->readRow()) {
+                return SkImageGenerator::kIncompleteInput;
+            }
+            fCodec->fSwizzler->setDstRow(dst);
+            fCodec->fSwizzler->next(fCodec->fSrcRow + fCodec->fSrcOffset);
+            dst = SkTAddOffset<void>(dst, rowBytes);
+        }
+        return fCodec->fDecoderMgr->hitEnd() ? SkImageGenerator::kIncompleteInput
+                                              : SkImageGenerator::kSuccess;
+    }
+
+    SkImageGenerator::Result onSkipScanlines(int count) override {
+        if (setjmp(fCodec->fDecoderMgr->getJmpBuf())) {
+            return SkImageGenerator::kInvalidInput;
+        }
+
+        // libjpeg still has to decode skipped rows, but at least we need not swizzle them.
+        for (int i = 0; i < count; i++) {
+            if (!fCodec->readRow()) {
+                return SkImageGenerator::kIncompleteInput;
+            }
+        }
+        return SkImageGenerator::kSuccess;
+    }
+
+    void onFinish() override {
+        if (setjmp(fCodec->fDecoderMgr->getJmpBuf())) {
+            // We've already read all the scanlines. This is a success.
+            return;
+        }
+        jpeg_finish_decompress(fCodec->fDecoderMgr->dinfo());
+    }
+
+private:
+    SkJpegCodec*    fCodec;     // Unowned.
+
+    typedef SkScanlineDecoder INHERITED;
+};
+
+SkScanlineDecoder* SkJpegCodec::onGetScanlineDecoder(const SkImageInfo& dstInfo) {
+    // Note: We set dst to NULL since we do not know it yet. rowBytes is not needed,
+    // since we'll be manually updating the dstRow, but the SkSwizzler requires it to
+    // be at least dstInfo.minRowBytes.
+    Options opts;
+    // FIXME: Pass this in to getScanlineDecoder?
+    opts.fZeroInitialized = kNo_ZeroInitialized;
+    if (this->initializeDecode(dstInfo, NULL, dstInfo.minRowBytes(), opts, NULL) != kSuccess) {
+        SkDebugf("failed to initialize the jpeg decode.\n");
+        return NULL;
+    }
+    return SkNEW_ARGS(SkJpegScanlineDecoder, (dstInfo, this));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Regions
+///////////////////////////////////////////////////////////////////////////////
+
+SkCodec::Result SkJpegCodec::onGetRegion(const SkImageInfo& scaledInfo, const SkIRect& subset,
+                                         void* dst, size_t rowBytes) {
+    if (!this->rewindIfNeeded()) {
+        return kCouldNotRewind;
+    }
+    const Result result = this->initializeDecode(scaledInfo, dst, rowBytes, Options(), &subset);
+    if (kSuccess != result) {
+        return result;
+    }
+
+    if (setjmp(fDecoderMgr->getJmpBuf())) {
+        return kInvalidInput;
+    }
+    // libjpeg has to decode the rows above the subset, but we need not swizzle them, nor
+    // the columns to either side. We stop decoding after the last row we need.
+    for (int y = 0; y < subset.top(); y++) {
+        if (!this->readRow()) {
+            return kIncompleteInput;
+        }
+    }
+    for (int y = 0; y < subset.height(); y++) {
+        if (!this->readRow()) {
+            return kIncompleteInput;
+        }
+        fSwizzler->next(fSrcRow + fSrcOffset);
+    }
+    return fDecoderMgr->hitEnd() ? kIncompleteInput : kSuccess;
+}
+
+// Where the entropy coded data starts, and how it is divided by restart markers.
+struct JpegScanLayout {
+    size_t  fHeightOffset;      // Of the frame's height in the SOF segment.
+    size_t  fScanOffset;        // First byte after the SOS segment.
+    int     fHeight;
+    int     fRestartInterval;   // In MCUs.
+    int     fMCUsPerRow;
+    int     fMCUHeight;         // In pixels.
+};
+
+static int read_u16(const uint8_t* p) {
+    return (p[0] << 8) | p[1];
+}
+
+// Walks the markers up to the first scan. Returns false unless the image is sequential,
+// has a single interleaved scan and uses restart markers.
+static bool read_scan_layout(const uint8_t* data, size_t size, JpegScanLayout* layout) {
+    int width = 0;
+    int height = 0;
+    size_t heightOffset = 0;
+    int componentCount = 0;
+    int maxH = 1, maxV = 1;
+    int restartInterval = 0;
+    size_t pos = 2;     // Skip SOI.
+    for (;;) {
+        if (pos + 4 > size || 0xFF != data[pos]) {
+            return false;
+        }
+        while (pos < size && 0xFF == data[pos]) {
+            pos++;  // Fill bytes.
+        }
+        if (pos + 3 > size) {
+            return false;
+        }
+        const uint8_t marker = data[pos];
+        const size_t length = read_u16(data + pos + 1);
+        const uint8_t* segment = data + pos + 3;
+        pos += 1 + length;
+        if (length < 2 || pos > size) {
+            return false;
+        }
+        switch (marker) {
+            case 0xC0:  // Baseline.
+            case 0xC1:  // Extended sequential, Huffman coded.
+                if (length < 8) {
+                    return false;
+                }
+                heightOffset = segment + 1 - data;
+                height = read_u16(segment + 1);
+                width = read_u16(segment + 3);
+                componentCount = segment[5];
+                if (length < 8 + 3 * (size_t) componentCount) {
+                    return false;
+                }
+                for (int i = 0; i < componentCount; i++) {
+                    const uint8_t sampling = segment[6 + 3 * i + 1];
+                    maxH = SkTMax(maxH, sampling >> 4);
+                    maxV = SkTMax(maxV, sampling & 0xF);
+                }
+                break;
+            case 0xC2: case 0xC3: case 0xC5: case 0xC6: case 0xC7:
+            case 0xC9: case 0xCA: case 0xCB: case 0xCD: case 0xCE: case 0xCF:
+                // Progressive, lossless, hierarchical or arithmetic coded.
+                return false;
+            case 0xDD:  // DRI
+                if (length < 4) {
+                    return false;
+                }
+                restartInterval = read_u16(segment);
+                break;
+            case 0xDA:  // SOS
+                if (0 == width || 0 == height || 0 == restartInterval || length < 3 ||
+                        segment[0] != componentCount) {
+                    return false;
+                }
+                if (1 == componentCount) {
+                    // A non-interleaved scan's MCU is a single block.
+                    maxH = maxV = 1;
+                }
+                layout->fHeightOffset = heightOffset;
+                layout->fScanOffset = pos;
+                layout->fHeight = height;
+                layout->fRestartInterval = restartInterval;
+                layout->fMCUsPerRow = (width + maxH * DCTSIZE - 1) / (maxH * DCTSIZE);
+                layout->fMCUHeight = maxV * DCTSIZE;
+                return true;
+            default:
+                break;
+        }
+    }
+}
+
+SkCodec* SkJpegCodec::onNewCodecForRows(SkData* data, const SkImageInfo& scaledInfo, int y,
+                                        int* firstRow) {
+    const int denom = scale_denom_for(this->getInfo().dimensions(), scaledInfo.dimensions());
+    JpegScanLayout layout;
+    if (0 == denom || !read_scan_layout(data->bytes(), data->size(), &layout)) {
+        return NULL;
+    }
+
+    // The new codec starts right after a restart marker, with the same headers (but for
+    // the height), so libjpeg resets its predictions just as the encoder did. That requires:
+    //  - the marker begins a row of MCUs, since libjpeg will think it is at the top,
+    //  - the next marker is RST0, which is what a fresh decoder expects, and
+    //  - at least one MCU row above y, so upsampling has the same context as in a
+    //    full decode.
+    const int lastUsableRow = y * denom - layout.fMCUHeight;
+    const uint8_t* const start = data->bytes();
+    const uint8_t* const end = start + data->size();
+    const uint8_t* tail = NULL;
+    int tailRow = 0;
+    int markerCount = 0;
+    for (const uint8_t* p = start + layout.fScanOffset; p + 1 < end; ) {
+        p = static_cast<const uint8_t*>(memchr(p, 0xFF, end - p - 1));
+        if (NULL == p) {
+            break;
+        }
+        const uint8_t marker = p[1];
+        if (marker < 0xD0 || marker > 0xD7) {
+            if (0x00 != marker && 0xFF != marker) {
+                break;  // EOI or another marker ends the scan.
+            }
+            // A stuffed zero, or fill before a marker.
+            p += (0x00 == marker) ? 2 : 1;
+            continue;
+        }
+        p += 2;
+        markerCount++;
+        const int64_t mcu = (int64_t) markerCount * layout.fRestartInterval;
+        if (0 != markerCount % 8 || 0 != mcu % layout.fMCUsPerRow) {
+            continue;
+        }
+        const int64_t row = mcu / layout.fMCUsPerRow * layout.fMCUHeight;
+        if (row > lastUsableRow) {
+            break;
+        }
+        tail = p;
+        tailRow = (int) row;
+    }
+
+    SkAutoTUnref<SkData> newData;
+    if (NULL == tail) {
+        newData.reset(SkRef(data));
+    } else {
+        const size_t headerSize = layout.fScanOffset;
+        const size_t tailSize = end - tail;
+        newData.reset(SkData::NewUninitialized(headerSize + tailSize));
+        uint8_t* dst = static_cast<uint8_t*>(newData->writable_data());
+        memcpy(dst, start, headerSize);
+        memcpy(dst + headerSize, tail, tailSize);
+        // Tell libjpeg where the image really ends, so it treats the last rows as it would
+        // in a full decode.
+        const int height = layout.fHeight - tailRow;
+        dst[layout.fHeightOffset] = height >> 8;
+        dst[layout.fHeightOffset + 1] = height & 0xFF;
+    }
+
+    SkCodec* codec = NewFromStream(SkNEW_ARGS(SkMemoryStream, (newData)));
+    if (codec) {
+        SkASSERT(0 == tailRow % denom);
+        *firstRow = tailRow / denom;
+    }
+    return codec;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// YUV
+///////////////////////////////////////////////////////////////////////////////
+
+// These follow their counterparts in SkImageDecoder_libjpeg.cpp.
+
+enum SizeType {
+    kSizeForMemoryAllocation_SizeType,
+    kActualSize_SizeType
+};
+
+static SkISize compute_yuv_size(const jpeg_decompress_struct& dinfo, int component,
+                                SizeType sizeType) {
+    if (sizeType == kSizeForMemoryAllocation_SizeType) {
+        return SkISize::Make(dinfo.cur_comp_info[component]->width_in_blocks * DCTSIZE,
+                             dinfo.cur_comp_info[component]->height_in_blocks * DCTSIZE);
+    }
+    return SkISize::Make(dinfo.cur_comp_info[component]->downsampled_width,
+                         dinfo.cur_comp_info[component]->downsampled_height);
+}
+
+static bool appears_to_be_yuv(const jpeg_decompress_struct& dinfo) {
+    return (dinfo.jpeg_color_space == JCS_YCbCr)
+        && (DCTSIZE == 8)
+        && (dinfo.num_components == 3)
+        && (dinfo.comps_in_scan >= dinfo.num_components)
+        && (dinfo.scale_denom <= 8)
+        && (dinfo.cur_comp_info[0])
+        && (dinfo.cur_comp_info[1])
+        && (dinfo.cur_comp_info[2])
+        && (dinfo.cur_comp_info[1]->h_samp_factor == 1)
+        && (dinfo.cur_comp_info[1]->v_samp_factor == 1)
+        && (dinfo.cur_comp_info[2]->h_samp_factor == 1)
+        && (dinfo.cur_comp_info[2]->v_samp_factor == 1);
+}
+
+static void update_components_sizes(const jpeg_decompress_struct& dinfo, SkISize sizes[3],
+                                    SizeType sizeType) {
+    SkASSERT(appears_to_be_yuv(dinfo));
+    for (int i = 0; i < 3; ++i) {
+        sizes[i] = compute_yuv_size(dinfo, i, sizeType);
+    }
+}
+
+// Must be called with the decoder's jmp_buf set.
+static bool output_raw_data(jpeg_decompress_struct& dinfo, void* planes[3], size_t rowBytes[3]) {
+    SkASSERT(appears_to_be_yuv(dinfo));
+    // U size and V size have to be the same if we're calling output_raw_data()
+    SkISize uvSize = compute_yuv_size(dinfo, 1, kSizeForMemoryAllocation_SizeType);
+    SkASSERT(uvSize == compute_yuv_size(dinfo, 2, kSizeForMemoryAllocation_SizeType));
+
+    JSAMPARRAY bufferraw[3];
+    JSAMPROW bufferraw2[32];
+    bufferraw[0] = &bufferraw2[0]; // Y channel rows (8 or 16)
+    bufferraw[1] = &bufferraw2[16]; // U channel rows (8)
+    bufferraw[2] = &bufferraw2[24]; // V channel rows (8)
+    int yWidth = dinfo.output_width;
+    int yHeight = dinfo.output_height;
+    int yMaxH = yHeight - 1;
+    int v = dinfo.cur_comp_info[0]->v_samp_factor;
+    int uvMaxH = uvSize.height() - 1;
+    JSAMPROW outputY = static_cast<JSAMPROW>(planes[0]);
+    JSAMPROW outputU = static_cast<JSAMPROW>(planes[1]);
+    JSAMPROW outputV = static_cast<JSAMPROW>(planes[2]);
+    size_t rowBytesY = rowBytes[0];
+    size_t rowBytesU = rowBytes[1];
+    size_t rowBytesV = rowBytes[2];
+
+    int yScanlinesToRead = DCTSIZE * v;
+    SkAutoMalloc lastRowStorage(rowBytesY * 4);
+    JSAMPROW yLastRow = (JSAMPROW)lastRowStorage.get();
+    JSAMPROW uLastRow = yLastRow + rowBytesY;
+    JSAMPROW vLastRow = uLastRow + rowBytesY;
+    JSAMPROW dummyRow = vLastRow + rowBytesY;
+
+    while (dinfo.output_scanline < dinfo.output_height) {
+        // Request 8 or 16 scanlines: returns 0 or more scanlines.
+        bool hasYLastRow(false), hasUVLastRow(false);
+        // Assign 8 or 16 rows of memory to read the Y channel.
+        for (int i = 0; i < yScanlinesToRead; ++i) {
+            int scanline = (dinfo.output_scanline + i);
+            if (scanline < yMaxH) {
+                bufferraw2[i] = &outputY[scanline * rowBytesY];
+            } else if (scanline == yMaxH) {
+                bufferraw2[i] = yLastRow;
+                hasYLastRow = true;
+            } else {
+                bufferraw2[i] = dummyRow;
+            }
+        }
+        int scaledScanline = dinfo.output_scanline / v;
+        // Assign 8 rows of memory to read the U and V channels.
+        for (int i = 0; i < 8; ++i) {
+            int scanline = (scaledScanline + i);
+            if (scanline < uvMaxH) {
+                bufferraw2[16 + i] = &outputU[scanline * rowBytesU];
+                bufferraw2[24 + i] = &outputV[scanline * rowBytesV];
+            } else if (scanline == uvMaxH) {
+                bufferraw2[16 + i] = uLastRow;
+                bufferraw2[24 + i] = vLastRow;
+                hasUVLastRow = true;
+            } else {
+                bufferraw2[16 + i] = dummyRow;
+                bufferraw2[24 + i] = dummyRow;
+            }
+        }
+        JDIMENSION scanlinesRead = jpeg_read_raw_data(&dinfo, bufferraw, yScanlinesToRead);
+
+        if (scanlinesRead == 0) {
+            return false;
+        }
+
+        if (hasYLastRow) {
+            memcpy(&outputY[yMaxH * rowBytesY], yLastRow, yWidth);
+        }
+        if (hasUVLastRow) {
+            memcpy(&outputU[uvMaxH * rowBytesU], uLastRow, uvSize.width());
+            memcpy(&outputV[uvMaxH * rowBytesV], vLastRow, uvSize.width());
+        }
+    }
+
+    dinfo.output_scanline = SkMin32(dinfo.output_scanline, dinfo.output_height);
+
+    return true;
+}
+
+bool SkJpegCodec::onGetYUV8Planes(SkISize sizes[3], void* planes[3], size_t rowBytes[3],
+                                  SkYUVColorSpace* colorSpace) {
+    if (!this->rewindIfNeeded() || !this->readHeader()) {
+        return false;
+    }
+
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    if (setjmp(fDecoderMgr->getJmpBuf())) {
+        return false;
+    }
+
+    if (!appears_to_be_yuv(*dinfo)) {
+        // It's not an error to not be encoded in YUV.
+        return false;
+    }
+
+    if (!planes || !planes[0] || !rowBytes || !rowBytes[0]) { // Compute size only
+        update_components_sizes(*dinfo, sizes, kSizeForMemoryAllocation_SizeType);
+        return true;
+    }
+
+    dinfo->out_color_space = JCS_YCbCr;
+    dinfo->raw_data_out = TRUE;
+    // Neither is needed to hand back the planes as they are stored.
+    dinfo->do_fancy_upsampling = FALSE;
+    dinfo->do_block_smoothing = FALSE;
+
+    if (!jpeg_start_decompress(dinfo)) {
+        return false;
+    }
+    // jpeg_start_decompress may update our opinion of whether dinfo represents YUV.
+    if (!appears_to_be_yuv(*dinfo)) {
+        return false;
+    }
+    if (!output_raw_data(*dinfo, planes, rowBytes)) {
+        return false;
+    }
+
+    update_components_sizes(*dinfo, sizes, kActualSize_SizeType);
+    jpeg_finish_decompress(dinfo);
+
+    if (colorSpace) {
+        *colorSpace = kJPEG_SkYUVColorSpace;
+    }
+    return true;
+}
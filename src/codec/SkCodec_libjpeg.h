@@ -0,0 +1,74 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCodec.h"
+#include "SkEncodedFormat.h"
+#include "SkImageInfo.h"
+#include "SkSwizzler.h"
+#include "SkTemplates.h"
+
+class JpegDecoderMgr;
+class SkScanlineDecoder;
+class SkStream;
+
+/*
+ *
+ * Codec for jpeg, built on libjpeg. Decodes scanline by scanline, and can
+ * downscale by 1/2, 1/4 or 1/8 in the DCT domain.
+ *
+ */
+class SkJpegCodec : public SkCodec {
+public:
+    static bool IsJpeg(SkStream*);
+
+    // Assumes IsJpeg was called and returned true.
+    static SkCodec* NewFromStream(SkStream*);
+
+protected:
+    Result onGetPixels(const SkImageInfo&, void*, size_t, const Options&, SkPMColor*, int*)
+            override;
+    SkEncodedFormat onGetEncodedFormat() const override { return kJPEG_SkEncodedFormat; }
+    SkISize onGetScaledDimensions(float desiredScale) const override;
+    SkScanlineDecoder* onGetScanlineDecoder(const SkImageInfo& dstInfo) override;
+    bool onGetYUV8Planes(SkISize sizes[3], void* planes[3], size_t rowBytes[3],
+                         SkYUVColorSpace*) override;
+    Result onGetRegion(const SkImageInfo& scaledInfo, const SkIRect& subset, void* dst,
+                       size_t rowBytes) override;
+    SkCodec* onNewCodecForRows(SkData*, const SkImageInfo& scaledInfo, int y,
+                               int* firstRow) override;
+
+private:
+    SkJpegCodec(const SkImageInfo&, SkStream*, JpegDecoderMgr*);
+    ~SkJpegCodec();
+
+    // Rewinds the stream if a decode has already used it, and makes sure a fresh header has
+    // been read.
+    bool readHeader();
+
+    // Reads the header, then sets up scaling, the output color space and the swizzler for
+    // decoding into dstInfo, and starts the decompression. If subset is not NULL, only its
+    // columns will be swizzled, into a dst subset->width() pixels wide.
+    Result initializeDecode(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                            const Options&, const SkIRect* subset);
+
+    // Reads the next row into fSrcRow, converting CMYK if necessary. Returns false at the
+    // end of the input.
+    bool readRow();
+
+    SkAutoTDelete<JpegDecoderMgr>   fDecoderMgr;
+    bool                            fNeedsHeader;
+
+    // These are stored here so they can be used both by normal decoding and scanline decoding.
+    SkAutoTDelete<SkSwizzler>       fSwizzler;
+    SkAutoMalloc                    fStorage;
+    uint8_t*                        fSrcRow;
+    size_t                          fSrcOffset;     // of the first column to swizzle
+
+    friend class SkJpegScanlineDecoder;
+
+    typedef SkCodec INHERITED;
+};
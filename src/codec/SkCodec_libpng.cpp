@@ -526,7 +526,11 @@ public:
             return SkImageGenerator::kInvalidInput;
         }
 
-        png_read_rows(fCodec->fPng_ptr, png_bytepp_NULL, png_bytepp_NULL, count);
+        // png_read_rows reads nothing when given neither rows nor display rows,
+        // so read one row at a time, discarding each.
+        for (int i = 0; i < count; i++) {
+            png_read_row(fCodec->fPng_ptr, NULL, NULL);
+        }
         return SkImageGenerator::kSuccess;
     }
 
@@ -48,10 +48,14 @@ public:
     Sk4x   bitAnd(const Sk4x&) const;
     Sk4x    bitOr(const Sk4x&) const;
     // TODO: Sk4x bitAndNot(const Sk4x&) const; is efficient in SSE.
+    // For Sk4i, add(), subtract() and multiply() wrap around modulo 2^32.
     Sk4x      add(const Sk4x&) const;
     Sk4x subtract(const Sk4x&) const;
     Sk4x multiply(const Sk4x&) const;
     Sk4x   divide(const Sk4x&) const;
+    // Sk4i only.  shiftRight() is a logical (zero-filling) shift.
+    Sk4x  shiftLeft(int bits) const;
+    Sk4x shiftRight(int bits) const;
 
     // TODO: why doesn't MSVC like operator~() ?
     //Sk4x operator ~()              const { return this->bitNot(); }
@@ -1240,11 +1240,19 @@ bool SkBitmap::ReadRawPixels(SkReadBuffer* buffer, SkBitmap* bitmap) {
         return false;
     }
 
-    SkAutoDataUnref data(SkData::NewUninitialized(SkToSizeT(ramSize)));
-    char* dst = (char*)data->writable_data();
-    buffer->readByteArray(dst, SkToSizeT(snugSize));
+    SkAutoDataUnref data;
+    if (snugSize == ramSize) {
+        // Rows are already packed, so the pixels can share the buffer's backing data (e.g. a
+        // memory-mapped SKP) when it has some.
+        data.reset(buffer->readSharedByteArray(SkToSizeT(snugSize)));
+        if (NULL == data.get()) {
+            return false;
+        }
+    } else {
+        data.reset(SkData::NewUninitialized(SkToSizeT(ramSize)));
+        char* dst = (char*)data->writable_data();
+        buffer->readByteArray(dst, SkToSizeT(snugSize));
 
-    if (snugSize != ramSize) {
         const char* srcRow = dst + snugRB * (height - 1);
         char* dstRow = dst + ramRB * (height - 1);
         for (int y = height - 1; y >= 1; --y) {
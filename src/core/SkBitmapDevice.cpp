@@ -9,6 +9,7 @@
 #include "SkConfig8888.h"
 #include "SkDeviceProperties.h"
 #include "SkDraw.h"
+#include "SkGlyphRunCache.h"
 #include "SkRasterClip.h"
 #include "SkShader.h"
 #include "SkSurface.h"
@@ -179,6 +180,12 @@ void SkBitmapDevice::drawPoints(const SkDraw& draw, SkCanvas::PointMode mode, si
     draw.drawPoints(mode, count, pts, paint);
 }
 
+void SkBitmapDevice::drawRects(const SkDraw& draw, const SkRect rects[], int count,
+                               const SkPaint& paint) {
+    CHECK_FOR_ANNOTATION(paint);
+    draw.drawRects(rects, count, paint);
+}
+
 void SkBitmapDevice::drawRect(const SkDraw& draw, const SkRect& r, const SkPaint& paint) {
     CHECK_FOR_ANNOTATION(paint);
     draw.drawRect(r, paint);
@@ -329,6 +336,15 @@ void SkBitmapDevice::drawPosText(const SkDraw& draw, const void* text, size_t le
     draw.drawPosText((const char*)text, len, xpos, scalarsPerPos, offset, paint);
 }
 
+void SkBitmapDevice::drawTextBlob(const SkDraw& draw, const SkTextBlob* blob,
+                                  SkScalar x, SkScalar y,
+                                  const SkPaint& paint, SkDrawFilter* drawFilter) {
+    // A draw filter may change the paint of each run, so only unfiltered blobs are cached.
+    if (drawFilter || !SkGlyphRunCache::Draw(draw, blob, x, y, paint)) {
+        this->INHERITED::drawTextBlob(draw, blob, x, y, paint, drawFilter);
+    }
+}
+
 void SkBitmapDevice::drawVertices(const SkDraw& draw, SkCanvas::VertexMode vmode,
                                   int vertexCount,
                                   const SkPoint verts[], const SkPoint textures[],
@@ -354,6 +354,15 @@ bool SkBitmapProcState::chooseProcs(const SkMatrix& inv, const SkPaint& paint) {
     return this->chooseScanlineProcs(trivialMatrix, clampClamp, paint);
 }
 
+bool SkBitmapProcState::setupForTesting(const SkBitmap& bitmap, SkShader::TileMode tx,
+                                        SkShader::TileMode ty, const SkMatrix& inv,
+                                        const SkPaint& paint) {
+    fTileModeX = tx;
+    fTileModeY = ty;
+    fOrigBitmap = bitmap;
+    return this->chooseProcs(inv, paint);
+}
+
 bool SkBitmapProcState::chooseScanlineProcs(bool trivialMatrix, bool clampClamp,
                                             const SkPaint& paint) {
     fMatrixProc = this->chooseMatrixProc(trivialMatrix);
@@ -803,6 +812,11 @@ SkBitmapProcState::ShaderProc32 SkBitmapProcState::chooseShaderProc32() {
         return S32_D32_constX_shaderproc;
     }
 
+    if (gSkUse4fBilerp && kNone_SkFilterQuality != fFilterLevel) {
+        return 0 == (fInvType & ~kMask) ? S32_D32_filter_DX_4f_shaderproc
+                                        : S32_D32_filter_DXDY_4f_shaderproc;
+    }
+
     if (fAlphaScale < 256) {
         return NULL;
     }
@@ -13,6 +13,7 @@
 #include "SkMatrix.h"
 #include "SkMipMap.h"
 #include "SkPaint.h"
+#include "SkShader.h"
 
 typedef SkFixed3232    SkFractionalInt;
 #define SkScalarToFractionalInt(x)  SkScalarToFixed3232(x)
@@ -111,6 +112,13 @@ struct SkBitmapProcState {
     SampleProc32 getSampleProc32() const { return fSampleProc32; }
     SampleProc16 getSampleProc16() const { return fSampleProc16; }
 
+    /** Sets up to shade bitmap, tiled with tx and ty, through inv (device to bitmap space) with
+        paint, as SkBitmapProcShader does.  Returns false if it can't be drawn.  Tests use this
+        to call the chosen procs, or others, on the state directly.
+     */
+    bool setupForTesting(const SkBitmap&, SkShader::TileMode tx, SkShader::TileMode ty,
+                         const SkMatrix& inv, const SkPaint&);
+
 private:
     friend class SkBitmapProcShader;
 
@@ -194,4 +202,16 @@ void S32_D16_filter_DX(const SkBitmapProcState& s,
 void S32_D16_filter_DXDY(const SkBitmapProcState& s,
                          const uint32_t* xy, int count, uint16_t* colors);
 
+/** When true, bilerp of N32 bitmaps uses the SkPMFloat shader procs below in place of the
+    sample procs.  Defaults to false: when scaling up they beat the portable and SSE2 sample procs,
+    but not yet the SSSE3 ones.  Not thread safe: set it once, before drawing.
+*/
+extern bool gSkUse4fBilerp;
+
+// Bilinear filtering of N32 bitmaps in SkPMFloat, four pixels at a time, for every tile mode.
+void S32_D32_filter_DX_4f_shaderproc(const SkBitmapProcState& s, int x, int y,
+                                     SkPMColor colors[], int count);
+void S32_D32_filter_DXDY_4f_shaderproc(const SkBitmapProcState& s, int x, int y,
+                                       SkPMColor colors[], int count);
+
 #endif
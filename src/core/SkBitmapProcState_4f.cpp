@@ -0,0 +1,151 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmapProcState.h"
+#include "SkPMFloat.h"
+
+/*
+ *  Bilinear filtering of N32 bitmaps in SkPMFloat, four destination pixels at a time.
+ *
+ *  The matrix proc does the mapping and tiling, as it does for the sample procs, so these work
+ *  for every tile mode.  Its filter coordinates pack two source indices and a 4-bit subpixel
+ *  position into each uint32_t: (i0 << 18) | (sub << 14) | i1.
+ *
+ *  All the arithmetic before the final scale is on small integers, so it is exact in float:
+ *  a filtered channel can never exceed its filtered alpha, and four opaque pixels always filter
+ *  to an opaque one.
+ */
+
+bool gSkUse4fBilerp = false;
+
+static inline void unpack(uint32_t packed, unsigned* i0, unsigned* i1, float* sub) {
+    *i0 = packed >> 18;
+    *i1 = packed & 0x3FFF;
+    *sub = (float)((packed >> 14) & 0xF);
+}
+
+// Returns 16 * a + (b - a) * t, i.e. the lerp of a and b by t / 16, times 16.
+static inline Sk4f lerp16(const Sk4f& a, const Sk4f& b, const Sk4f& t) {
+    return a * Sk4f(16) + (b - a) * t;
+}
+
+static inline const SkPMColor* row(const SkBitmapProcState& s, unsigned y) {
+    return (const SkPMColor*)((const char*)s.fBitmap->getPixels() + y * s.fBitmap->rowBytes());
+}
+
+// Filters pixels between two rows.  It lerps each source column between the rows first, and
+// remembers the last two columns: scaling up, neighbouring pixels mostly share their columns.
+// The results are 256 times too large (16 for each lerp), like Filter_32_opaque's before >> 8.
+class ColumnCache {
+public:
+    ColumnCache(const SkPMColor* row0, const SkPMColor* row1, const Sk4f& fy)
+        : fRow0(row0), fRow1(row1), fY(fy), fX0(~0u), fX1(~0u) {}
+
+    Sk4f filter(uint32_t XX) {
+        unsigned x0, x1;
+        float subX;
+        unpack(XX, &x0, &x1, &subX);
+        if (x0 != fX0 || x1 != fX1) {
+            fC0 = x0 == fX1 ? fC1 : this->column(x0);
+            fC1 = this->column(x1);
+            fX0 = x0;
+            fX1 = x1;
+        }
+        return lerp16(fC0, fC1, Sk4f(subX));
+    }
+
+private:
+    Sk4f column(unsigned x) const {
+        return lerp16(SkPMFloat(fRow0[x]), SkPMFloat(fRow1[x]), fY);
+    }
+
+    const SkPMColor* fRow0;
+    const SkPMColor* fRow1;
+    const Sk4f fY;
+    unsigned fX0, fX1;
+    Sk4f fC0, fC1;
+};
+
+static void filter_DX(const SkBitmapProcState& s, const uint32_t* xy, int count,
+                      SkPMColor* colors) {
+    unsigned y0, y1;
+    float subY;
+    unpack(*xy++, &y0, &y1, &subY);
+    ColumnCache cache(row(s, y0), row(s, y1), Sk4f(subY));
+
+    const Sk4f scale(s.fAlphaScale * (1.0f / (256 * 256)));
+    while (count >= 4) {
+        Sk4f c0 = cache.filter(xy[0]) * scale,
+             c1 = cache.filter(xy[1]) * scale,
+             c2 = cache.filter(xy[2]) * scale,
+             c3 = cache.filter(xy[3]) * scale;
+        SkPMFloat::To4PMColors(c0, c1, c2, c3, colors);
+        xy += 4;
+        colors += 4;
+        count -= 4;
+    }
+    while (count --> 0) {
+        *colors++ = SkPMFloat(cache.filter(*xy++) * scale).get();
+    }
+}
+
+static inline Sk4f filter_XY(const SkBitmapProcState& s, const uint32_t* xy) {
+    unsigned y0, y1;
+    float subY;
+    unpack(xy[0], &y0, &y1, &subY);
+    return ColumnCache(row(s, y0), row(s, y1), Sk4f(subY)).filter(xy[1]);
+}
+
+static void filter_DXDY(const SkBitmapProcState& s, const uint32_t* xy, int count,
+                        SkPMColor* colors) {
+    const Sk4f scale(s.fAlphaScale * (1.0f / (256 * 256)));
+    while (count >= 4) {
+        SkPMFloat::To4PMColors(filter_XY(s, xy + 0) * scale,
+                               filter_XY(s, xy + 2) * scale,
+                               filter_XY(s, xy + 4) * scale,
+                               filter_XY(s, xy + 6) * scale,
+                               colors);
+        xy += 8;
+        colors += 4;
+        count -= 4;
+    }
+    while (count --> 0) {
+        *colors++ = SkPMFloat(filter_XY(s, xy) * scale).get();
+        xy += 2;
+    }
+}
+
+template <void (*filterProc)(const SkBitmapProcState&, const uint32_t*, int, SkPMColor*)>
+static void shaderproc(const SkBitmapProcState& s, int x, int y, SkPMColor* colors, int count) {
+    SkASSERT(kN32_SkColorType == s.fBitmap->colorType());
+    SkASSERT(kNone_SkFilterQuality != s.fFilterLevel);
+
+    uint32_t xy[256];
+    const int max = s.maxCountForBufferSize(sizeof(xy));
+    SkBitmapProcState::MatrixProc mproc = s.getMatrixProc();
+
+    while (count > 0) {
+        const int n = SkMin32(count, max);
+        mproc(s, xy, n, x, y);
+        filterProc(s, xy, n, colors);
+        x += n;
+        colors += n;
+        count -= n;
+    }
+}
+
+void S32_D32_filter_DX_4f_shaderproc(const SkBitmapProcState& s, int x, int y,
+                                     SkPMColor* colors, int count) {
+    SkASSERT((s.fInvType & ~(SkMatrix::kTranslate_Mask | SkMatrix::kScale_Mask)) == 0);
+    shaderproc<filter_DX>(s, x, y, colors, count);
+}
+
+void S32_D32_filter_DXDY_4f_shaderproc(const SkBitmapProcState& s, int x, int y,
+                                       SkPMColor* colors, int count) {
+    SkASSERT((s.fInvType & ~(SkMatrix::kTranslate_Mask | SkMatrix::kScale_Mask)) != 0);
+    shaderproc<filter_DXDY>(s, x, y, colors, count);
+}
@@ -1609,6 +1609,12 @@ void SkCanvas::drawRect(const SkRect& r, const SkPaint& paint) {
     this->onDrawRect(r, paint);
 }
 
+void SkCanvas::drawRects(const SkRect rects[], int count, const SkPaint& paint) {
+    if (count > 0) {
+        this->onDrawRects(rects, count, paint);
+    }
+}
+
 void SkCanvas::drawOval(const SkRect& r, const SkPaint& paint) {
     this->onDrawOval(r, paint);
 }
@@ -1650,6 +1656,13 @@ void SkCanvas::drawBitmapRectToRect(const SkBitmap& bitmap, const SkRect* src, c
     this->onDrawBitmapRect(bitmap, src, dst, paint, flags);
 }
 
+void SkCanvas::drawBitmapRects(const SkBitmap& bitmap, const SkRect src[], const SkRect dst[],
+                               int count, const SkPaint* paint) {
+    if (count > 0) {
+        this->onDrawBitmapRects(bitmap, src, dst, count, paint);
+    }
+}
+
 void SkCanvas::drawBitmapNine(const SkBitmap& bitmap, const SkIRect& center, const SkRect& dst,
                               const SkPaint* paint) {
     this->onDrawBitmapNine(bitmap, center, dst, paint);
@@ -1742,6 +1755,54 @@ void SkCanvas::onDrawRect(const SkRect& r, const SkPaint& paint) {
     LOOPER_END
 }
 
+// Loopers and image filters apply to each draw on its own, and draw filters are called per draw,
+// so batches that involve any of them are drawn one at a time.
+static bool can_batch(const SkPaint* paint, SkDrawFilter* drawFilter) {
+    return !drawFilter && (!paint || (!paint->getLooper() && !paint->getImageFilter()));
+}
+
+// Union of the sorted rects. SkRect::join() would skip empty ones, which may still draw (strokes).
+static SkRect sorted_union(const SkRect rects[], int count) {
+    SkRect bounds = rects[0];
+    bounds.sort();
+    for (int i = 1; i < count; ++i) {
+        SkRect r = rects[i];
+        r.sort();
+        bounds.fLeft   = SkTMin(bounds.fLeft,   r.fLeft);
+        bounds.fTop    = SkTMin(bounds.fTop,    r.fTop);
+        bounds.fRight  = SkTMax(bounds.fRight,  r.fRight);
+        bounds.fBottom = SkTMax(bounds.fBottom, r.fBottom);
+    }
+    return bounds;
+}
+
+void SkCanvas::onDrawRects(const SkRect rects[], int count, const SkPaint& paint) {
+    TRACE_EVENT0("disabled-by-default-skia", "SkCanvas::drawRects()");
+    if (!can_batch(&paint, this->getDrawFilter())) {
+        for (int i = 0; i < count; ++i) {
+            this->drawRect(rects[i], paint);
+        }
+        return;
+    }
+
+    SkRect storage;
+    const SkRect* bounds = NULL;
+    if (paint.canComputeFastBounds()) {
+        bounds = &paint.computeFastBounds(sorted_union(rects, count), &storage);
+        if (this->quickReject(*bounds)) {
+            return;
+        }
+    }
+
+    LOOPER_BEGIN(paint, SkDrawFilter::kRect_Type, bounds)
+
+    while (iter.next()) {
+        iter.fDevice->drawRects(iter, rects, count, looper.paint());
+    }
+
+    LOOPER_END
+}
+
 void SkCanvas::onDrawOval(const SkRect& oval, const SkPaint& paint) {
     TRACE_EVENT0("disabled-by-default-skia", "SkCanvas::drawOval()");
     SkRect storage;
@@ -1919,6 +1980,45 @@ void SkCanvas::onDrawBitmapRect(const SkBitmap& bitmap, const SkRect* src, const
     this->internalDrawBitmapRect(bitmap, src, dst, paint, flags);
 }
 
+void SkCanvas::onDrawBitmapRects(const SkBitmap& bitmap, const SkRect src[], const SkRect dst[],
+                                 int count, const SkPaint* paint) {
+    TRACE_EVENT0("disabled-by-default-skia", "SkCanvas::drawBitmapRects()");
+    SkDEBUGCODE(bitmap.validate();)
+    if (bitmap.drawsNothing()) {
+        return;
+    }
+    if (!can_batch(paint, this->getDrawFilter())) {
+        for (int i = 0; i < count; ++i) {
+            this->drawBitmapRectToRect(bitmap, &src[i], dst[i], paint);
+        }
+        return;
+    }
+
+    SkRect storage = sorted_union(dst, count);
+    const SkRect* bounds = &storage;
+    if (NULL == paint || paint->canComputeFastBounds()) {
+        if (paint) {
+            bounds = &paint->computeFastBounds(storage, &storage);
+        }
+        if (this->quickReject(*bounds)) {
+            return;
+        }
+    }
+
+    SkLazyPaint lazy;
+    if (NULL == paint) {
+        paint = lazy.init();
+    }
+
+    LOOPER_BEGIN(*paint, SkDrawFilter::kBitmap_Type, bounds)
+
+    while (iter.next()) {
+        iter.fDevice->drawBitmapRects(iter, bitmap, src, dst, count, looper.paint());
+    }
+
+    LOOPER_END
+}
+
 void SkCanvas::internalDrawBitmapNine(const SkBitmap& bitmap,
                                       const SkIRect& center, const SkRect& dst,
                                       const SkPaint* paint) {
@@ -106,6 +106,23 @@ void SkBaseDevice::drawDRRect(const SkDraw& draw, const SkRRect& outer,
     this->drawPath(draw, path, paint, preMatrix, pathIsMutable);
 }
 
+void SkBaseDevice::drawRects(const SkDraw& draw, const SkRect rects[], int count,
+                             const SkPaint& paint) {
+    for (int i = 0; i < count; ++i) {
+        this->drawRect(draw, rects[i], paint);
+    }
+}
+
+void SkBaseDevice::drawBitmapRects(const SkDraw& draw, const SkBitmap& bitmap, const SkRect src[],
+                                   const SkRect dst[], int count, const SkPaint& paint) {
+    for (int i = 0; i < count; ++i) {
+        if (!dst[i].isEmpty()) {
+            this->drawBitmapRect(draw, bitmap, &src[i], dst[i], paint,
+                                 SkCanvas::kNone_DrawBitmapRectFlag);
+        }
+    }
+}
+
 void SkBaseDevice::drawPatch(const SkDraw& draw, const SkPoint cubics[12], const SkColor colors[4],
                              const SkPoint texCoords[4], SkXfermode* xmode, const SkPaint& paint) {
     SkPatchUtils::VertexData data;
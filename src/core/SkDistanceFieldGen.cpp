@@ -7,6 +7,7 @@
 
 #include "SkDistanceFieldGen.h"
 #include "SkPoint.h"
+#include "SkTemplates.h"
 
 struct DFData {
     float   fAlpha;      // alpha value of source texel
@@ -312,60 +313,13 @@ static void B2(DFData* curr, int width) {
     }
 }
 
-// enable this to output edge data rather than the distance field
-#define DUMP_EDGE 0
-
-#if !DUMP_EDGE
-static unsigned char pack_distance_field_val(float dist, float distanceMagnitude) {
-    if (dist <= -distanceMagnitude) {
-        return 255;
-    } else if (dist > distanceMagnitude) {
-        return 0;
-    } else {
-        return (unsigned char)((distanceMagnitude-dist)*128.0f/distanceMagnitude);
-    }
-}
-#endif
-
-// assumes a padded 8-bit image and distance field
-// width and height are the original width and height of the image
-static bool generate_distance_field_from_image(unsigned char* distanceField,
-                                               const unsigned char* copyPtr,
-                                               int width, int height) {
-    SkASSERT(distanceField);
-    SkASSERT(copyPtr);
-
-    // we expand our temp data by one more on each side to simplify
-    // the scanning code -- will always be treated as infinitely far away
-    int pad = SK_DistanceFieldPad + 1;
-
-    // set params for distance field data
-    int dataWidth = width + 2*pad;
-    int dataHeight = height + 2*pad;
-
-    // create temp data
-    size_t dataSize = dataWidth*dataHeight*sizeof(DFData);
-    SkAutoSMalloc<1024> dfStorage(dataSize);
-    DFData* dataPtr = (DFData*) dfStorage.get();
-    sk_bzero(dataPtr, dataSize);
-
-    SkAutoSMalloc<1024> edgeStorage(dataWidth*dataHeight*sizeof(char));
-    unsigned char* edgePtr = (unsigned char*) edgeStorage.get();
-    sk_bzero(edgePtr, dataWidth*dataHeight*sizeof(char));
-
-    // copy glyph into distance field storage
-    init_glyph_data(dataPtr, edgePtr, copyPtr,
-                    dataWidth, dataHeight,
-                    width+2, height+2, SK_DistanceFieldPad);
-
-    // create initial distance data, particularly at edges
-    init_distances(dataPtr, edgePtr, dataWidth, dataHeight);
-
-    // now perform Euclidean distance transform to propagate distances
-
+// Runs the 8SSEDT: propagates the nearest edge points found by init_distances() through
+// the rest of data, with a sweep each way in x for each way in y.
+static void danielsson_8ssedt(DFData* dataPtr, const unsigned char* edgePtr,
+                              int dataWidth, int dataHeight) {
     // forwards in y
     DFData* currData = dataPtr+dataWidth+1; // skip outer buffer
-    unsigned char* currEdge = edgePtr+dataWidth+1;
+    const unsigned char* currEdge = edgePtr+dataWidth+1;
     for (int j = 1; j < dataHeight-1; ++j) {
         // forwards in x
         for (int i = 1; i < dataWidth-1; ++i) {
@@ -422,10 +376,227 @@ static bool generate_distance_field_from_image(unsigned char* distanceField,
         currData -= dataWidth-1;
         currEdge -= dataWidth-1;
     }
+}
+
+// Felzenszwalb and Huttenlocher's separable Euclidean distance transform (2012), which finds
+// the exact nearest edge texel for every texel in two passes. Each texel's distance vector then
+// points to that edge texel's subpixel edge point, as the 8SSEDT sweeps would have it.
+
+// Sentinel for "no edge texel in this column yet"; far enough that it never wins.
+static const int kNoEdge = 1 << 20;
+
+// First pass, down each column: finds the row of the nearest edge texel in the same column.
+// Every column is independent, so each step runs across a whole row at once, which the
+// compiler vectorizes.
+static void find_nearest_in_columns(int* nearestRow, const unsigned char* edges,
+                                    int width, int height) {
+    // Down: the nearest edge texel at or above each texel.
+    SkAutoSTMalloc<128, int> last(width);
+    for (int i = 0; i < width; ++i) {
+        last[i] = -kNoEdge;
+    }
+    for (int j = 0; j < height; ++j) {
+        const unsigned char* edgeRow = edges + j*width;
+        int* nearestInRow = nearestRow + j*width;
+        for (int i = 0; i < width; ++i) {
+            last[i] = edgeRow[i] ? j : last[i];
+            nearestInRow[i] = last[i];
+        }
+    }
+
+    // Up: keep whichever of that and the nearest edge texel below is closer.
+    int* next = last.get();
+    for (int i = 0; i < width; ++i) {
+        next[i] = kNoEdge;
+    }
+    for (int j = height - 1; j >= 0; --j) {
+        const unsigned char* edgeRow = edges + j*width;
+        int* nearestInRow = nearestRow + j*width;
+        for (int i = 0; i < width; ++i) {
+            next[i] = edgeRow[i] ? j : next[i];
+            nearestInRow[i] = (next[i] - j < j - nearestInRow[i]) ? next[i] : nearestInRow[i];
+        }
+    }
+}
+
+// A parabola (x - fColumn)^2 + (y - nearest(fColumn))^2 of the lower envelope. It's lowest from
+// where it crosses the parabola before it, at fCrossNum / fCrossDen (fCrossDen > 0): keeping that
+// a fraction saves dividing for every column.
+struct Parabola {
+    int fColumn;
+    int fHeight;    // its height at x = 0
+    int fCrossNum;
+    int fCrossDen;
+};
+
+// Second pass, along a row: for each texel, finds the column whose nearest edge texel (from the
+// first pass) is closest, as the lower envelope of the parabolas (x - i)^2 + (y - nearest(i))^2.
+// Rows are independent of each other. Returns false if there are no edge texels to find.
+static bool find_nearest_in_row(int* nearestColumn, const int* nearestRow, int y, int width,
+                                Parabola* envelope) {
+    // envelope[0..k] are the parabolas that make up the envelope, left to right.
+    int k = -1;
+    for (int i = 0; i < width; ++i) {
+        if (kNoEdge == SkTAbs(nearestRow[i])) {
+            continue;
+        }
+        const int height = (y - nearestRow[i])*(y - nearestRow[i]) + i*i;
+        int crossNum = 0, crossDen = 1;
+        while (k >= 0) {
+            const Parabola& last = envelope[k];
+            crossNum = height - last.fHeight;
+            crossDen = 2*(i - last.fColumn);
+            // Stop unless parabola i crosses under parabola k before parabola k is lowest.
+            if (0 == k ||
+                (int64_t)crossNum * last.fCrossDen > (int64_t)last.fCrossNum * crossDen) {
+                break;
+            }
+            --k;
+        }
+        ++k;
+        envelope[k].fColumn = i;
+        envelope[k].fHeight = height;
+        envelope[k].fCrossNum = crossNum;
+        envelope[k].fCrossDen = crossDen;
+    }
+
+    if (k < 0) {
+        return false;
+    }
+
+    const Parabola* curr = envelope;
+    const Parabola* last = envelope + k;
+    for (int i = 0; i < width; ++i) {
+        while (curr < last && (curr + 1)->fCrossNum < i * (curr + 1)->fCrossDen) {
+            ++curr;
+        }
+        nearestColumn[i] = curr->fColumn;
+    }
+    return true;
+}
+
+// Points curr, dx and dy away from an edge texel, at that texel's edge point if it's the
+// closest yet.
+static inline void nearest_edge_point(DFData* curr, const DFData& edge, int dx, int dy) {
+    const SkPoint distVec = SkPoint::Make(dx + edge.fDistVector.fX, dy + edge.fDistVector.fY);
+    const float distSq = distVec.lengthSqd();
+    if (distSq < curr->fDistSq) {
+        curr->fDistSq = distSq;
+        curr->fDistVector = distVec;
+    }
+}
+
+static void exact_distance_transform(DFData* data, const unsigned char* edges,
+                                     int width, int height) {
+    SkAutoSTMalloc<1024, int> nearestRowStorage(width*height);
+    int* nearestRow = nearestRowStorage.get();
+    find_nearest_in_columns(nearestRow, edges, width, height);
+
+    // Edge texels are never in the one-pixel outer buffer, so all their neighbors exist.
+    static const int kNeighborX[] = { -1,  0,  1, -1, 1, -1, 0, 1 };
+    static const int kNeighborY[] = { -1, -1, -1,  0, 0,  1, 1, 1 };
+    int neighborOffsets[SK_ARRAY_COUNT(kNeighborX)];
+    for (size_t n = 0; n < SK_ARRAY_COUNT(kNeighborX); ++n) {
+        neighborOffsets[n] = kNeighborY[n]*width + kNeighborX[n];
+    }
+
+    SkAutoSTMalloc<128, int> nearestColumn(width);
+    SkAutoSTMalloc<128, Parabola> envelope(width);
+    for (int j = 0; j < height; ++j) {
+        if (!find_nearest_in_row(nearestColumn.get(), nearestRow + j*width, j, width,
+                                 envelope.get())) {
+            // No edge texels at all: everything stays far away.
+            return;
+        }
+        DFData* currData = data + j*width;
+        const unsigned char* currEdge = edges + j*width;
+        for (int i = 0; i < width; ++i) {
+            // don't need to calculate distance for edge pixels
+            if (currEdge[i]) {
+                continue;
+            }
+            const int edgeX = nearestColumn[i];
+            const int edgeY = nearestRow[j*width + edgeX];
+            const int dx = edgeX - i;
+            const int dy = edgeY - j;
+            const int edge = edgeY*width + edgeX;
+            nearest_edge_point(&currData[i], data[edge], dx, dy);
+
+            // A neighboring edge texel may have its edge point closer still. That only
+            // matters if we're close enough not to be clamped to the magnitude.
+            const int d = SK_DistanceFieldMagnitude + 1;
+            if (dx*dx + dy*dy <= d*d) {
+                for (size_t n = 0; n < SK_ARRAY_COUNT(kNeighborX); ++n) {
+                    const int neighbor = edge + neighborOffsets[n];
+                    if (edges[neighbor]) {
+                        nearest_edge_point(&currData[i], data[neighbor],
+                                           dx + kNeighborX[n], dy + kNeighborY[n]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// enable this to output edge data rather than the distance field
+#define DUMP_EDGE 0
+
+#if !DUMP_EDGE
+static unsigned char pack_distance_field_val(float dist, float distanceMagnitude) {
+    if (dist <= -distanceMagnitude) {
+        return 255;
+    } else if (dist > distanceMagnitude) {
+        return 0;
+    } else {
+        return (unsigned char)((distanceMagnitude-dist)*128.0f/distanceMagnitude);
+    }
+}
+#endif
+
+// assumes a padded 8-bit image and distance field
+// width and height are the original width and height of the image
+static bool generate_distance_field_from_image(unsigned char* distanceField,
+                                               const unsigned char* copyPtr,
+                                               int width, int height, bool exact) {
+    SkASSERT(distanceField);
+    SkASSERT(copyPtr);
+
+    // we expand our temp data by one more on each side to simplify
+    // the scanning code -- will always be treated as infinitely far away
+    int pad = SK_DistanceFieldPad + 1;
+
+    // set params for distance field data
+    int dataWidth = width + 2*pad;
+    int dataHeight = height + 2*pad;
+
+    // create temp data
+    size_t dataSize = dataWidth*dataHeight*sizeof(DFData);
+    SkAutoSMalloc<1024> dfStorage(dataSize);
+    DFData* dataPtr = (DFData*) dfStorage.get();
+    sk_bzero(dataPtr, dataSize);
+
+    SkAutoSMalloc<1024> edgeStorage(dataWidth*dataHeight*sizeof(char));
+    unsigned char* edgePtr = (unsigned char*) edgeStorage.get();
+    sk_bzero(edgePtr, dataWidth*dataHeight*sizeof(char));
+
+    // copy glyph into distance field storage
+    init_glyph_data(dataPtr, edgePtr, copyPtr,
+                    dataWidth, dataHeight,
+                    width+2, height+2, SK_DistanceFieldPad);
+
+    // create initial distance data, particularly at edges
+    init_distances(dataPtr, edgePtr, dataWidth, dataHeight);
+
+    // now perform Euclidean distance transform to propagate distances
+    if (exact) {
+        exact_distance_transform(dataPtr, edgePtr, dataWidth, dataHeight);
+    } else {
+        danielsson_8ssedt(dataPtr, edgePtr, dataWidth, dataHeight);
+    }
 
     // copy results to final distance field data
-    currData = dataPtr + dataWidth+1;
-    currEdge = edgePtr + dataWidth+1;
+    DFData* currData = dataPtr + dataWidth+1;
+    unsigned char* currEdge = edgePtr + dataWidth+1;
     unsigned char *dfPtr = distanceField;
     for (int j = 1; j < dataHeight-1; ++j) {
         for (int i = 1; i < dataWidth-1; ++i) {
@@ -459,9 +630,10 @@ static bool generate_distance_field_from_image(unsigned char* distanceField,
 }
 
 // assumes an 8-bit image and distance field
-bool SkGenerateDistanceFieldFromA8Image(unsigned char* distanceField,
-                                        const unsigned char* image,
-                                        int width, int height, size_t rowBytes) {
+static bool generate_distance_field_from_a8_image(unsigned char* distanceField,
+                                                  const unsigned char* image,
+                                                  int width, int height, size_t rowBytes,
+                                                  bool exact) {
     SkASSERT(distanceField);
     SkASSERT(image);
 
@@ -483,7 +655,38 @@ bool SkGenerateDistanceFieldFromA8Image(unsigned char* distanceField,
     }
     sk_bzero(currDestPtr, (width+2)*sizeof(char));
 
-    return generate_distance_field_from_image(distanceField, copyPtr, width, height);
+    return generate_distance_field_from_image(distanceField, copyPtr, width, height, exact);
+}
+
+// The exact transform's passes cost about the same per texel whatever the image's size, while
+// the 8SSEDT sweeps slow down per texel as images grow. At -O3 on glyph-like masks they break
+// even between 64 and 80 texels square (e.g. 36us vs. 35us at 32px, 155us vs. 159us at 64px),
+// and the exact transform is 10-30% faster from 96px up (892us vs. 1208us at 160px). So small
+// distance field glyphs (32px) keep the sweeps, and large ones (162px) get the exact transform.
+static bool use_exact_transform(int width, int height) {
+    static const int kMinExactArea = 80 * 80;
+    return width * height > kMinExactArea;
+}
+
+bool SkGenerateDistanceFieldFromA8Image(unsigned char* distanceField,
+                                        const unsigned char* image,
+                                        int width, int height, size_t rowBytes) {
+    return generate_distance_field_from_a8_image(distanceField, image, width, height, rowBytes,
+                                                 use_exact_transform(width, height));
+}
+
+bool SkGenerateDistanceFieldFromA8ImageExact(unsigned char* distanceField,
+                                             const unsigned char* image,
+                                             int width, int height, size_t rowBytes) {
+    return generate_distance_field_from_a8_image(distanceField, image, width, height, rowBytes,
+                                                 true);
+}
+
+bool SkGenerateDistanceFieldFromA8Image8SSEDT(unsigned char* distanceField,
+                                              const unsigned char* image,
+                                              int width, int height, size_t rowBytes) {
+    return generate_distance_field_from_a8_image(distanceField, image, width, height, rowBytes,
+                                                 false);
 }
 
 // assumes a 1-bit image and 8-bit distance field
@@ -517,5 +720,6 @@ bool SkGenerateDistanceFieldFromBWImage(unsigned char* distanceField,
     }
     sk_bzero(currDestPtr, (width+2)*sizeof(char));
 
-    return generate_distance_field_from_image(distanceField, copyPtr, width, height);
+    return generate_distance_field_from_image(distanceField, copyPtr, width, height,
+                                              use_exact_transform(width, height));
 }
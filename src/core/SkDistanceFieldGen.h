@@ -26,6 +26,10 @@
 
 /** Given 8-bit mask data, generate the associated distance field
 
+ *  Images larger than about 80x80 use an exact Euclidean distance transform, which finds the
+ *  nearest edge texel of every texel. Smaller ones, where it's no faster, use the approximate
+ *  8SSEDT sweeps.
+
  *  @param distanceField     The distance field to be generated. Should already be allocated
  *                           by the client with the padding above.
  *  @param image             8-bit mask we're using to generate the distance field.
@@ -37,7 +41,18 @@ bool SkGenerateDistanceFieldFromA8Image(unsigned char* distanceField,
                                         const unsigned char* image,
                                         int w, int h, size_t rowBytes);
 
-/** Given 1-bit mask data, generate the associated distance field
+/** SkGenerateDistanceFieldFromA8Image, but always with the exact transform, or always with the
+    8SSEDT sweeps, whatever the image's size. For tests and benchmarks comparing the two.
+*/
+bool SkGenerateDistanceFieldFromA8ImageExact(unsigned char* distanceField,
+                                             const unsigned char* image,
+                                             int w, int h, size_t rowBytes);
+bool SkGenerateDistanceFieldFromA8Image8SSEDT(unsigned char* distanceField,
+                                              const unsigned char* image,
+                                              int w, int h, size_t rowBytes);
+
+/** Given 1-bit mask data, generate the associated distance field, choosing the transform by
+ *  size as SkGenerateDistanceFieldFromA8Image does
 
  *  @param distanceField     The distance field to be generated. Should already be allocated
  *                           by the client with the padding above.
@@ -895,6 +895,63 @@ void SkDraw::drawRect(const SkRect& prePaintRect, const SkPaint& paint,
     }
 }
 
+void SkDraw::drawRects(const SkRect rects[], int count, const SkPaint& paint) const {
+    SkDEBUGCODE(this->validate();)
+
+    // nothing to draw
+    if (fRC->isEmpty()) {
+        return;
+    }
+
+    // Only fills are worth batching: anything else draws a frame or a path per rect anyway.
+    SkPoint strokeSize;
+    if (kFill_RectType != ComputeRectType(paint, *fMatrix, &strokeSize)) {
+        for (int i = 0; i < count; ++i) {
+            this->drawRect(rects[i], paint);
+        }
+        return;
+    }
+
+    // Map the rects up front, dropping any we can reject, so we know the bounds of the rest.
+    SkAutoSTMalloc<32, SkRect> devRects(count);
+    SkRect bbox = SkRect::MakeEmpty();
+    int n = 0;
+    for (int i = 0; i < count; ++i) {
+        SkRect* devRect = &devRects[n];
+        fMatrix->mapPoints(rect_points(*devRect), rect_points(rects[i]), 2);
+        devRect->sort();
+        if (devRect->isEmpty() || fRC->quickReject(devRect->roundOut())) {
+            continue;
+        }
+        bbox.join(*devRect);
+        n++;
+    }
+    if (0 == n) {
+        return;
+    }
+
+    SkDeviceLooper looper(*fBitmap, *fRC, bbox.roundOut(), paint.isAntiAlias());
+    while (looper.next()) {
+        SkMatrix localMatrix;
+        looper.mapMatrix(&localMatrix, *fMatrix);
+
+        // Choosing the blitter (and setting up any shader) is the cost we share.
+        SkAutoBlitterChoose blitterStorage(looper.getBitmap(), localMatrix, paint);
+        const SkRasterClip& clip = looper.getRC();
+        SkBlitter*          blitter = blitterStorage.get();
+
+        for (int i = 0; i < n; ++i) {
+            SkRect localDevRect;
+            looper.mapRect(&localDevRect, devRects[i]);
+            if (paint.isAntiAlias()) {
+                SkScan::AntiFillRect(localDevRect, clip, blitter);
+            } else {
+                SkScan::FillRect(localDevRect, clip, blitter);
+            }
+        }
+    }
+}
+
 void SkDraw::drawDevMask(const SkMask& srcM, const SkPaint& paint) const {
     if (srcM.fBounds.isEmpty()) {
         return;
@@ -19,23 +19,89 @@
 
 namespace {
 
-SkGlyphCache_Globals* create_globals() {
+SkGlyphCache_Globals* create_globals(int) {
     return SkNEW_ARGS(SkGlyphCache_Globals, (SkGlyphCache_Globals::kYes_UseMutex));
 }
 
 }  // namespace
 
-SK_DECLARE_STATIC_LAZY_PTR(SkGlyphCache_Globals, globals, create_globals);
+// The shared cache is split into shards, each with its own mutex and LRU list, so threads
+// drawing with different fonts rarely wait on each other.  Each descriptor always maps to
+// the same shard.  The shards share one budget: see balance_shared_globals().
+static const int kShardCount = SK_DEFAULT_FONT_CACHE_SHARD_COUNT;
+SK_DECLARE_STATIC_LAZY_PTR_ARRAY(SkGlyphCache_Globals, gShards, kShardCount, create_globals);
 
-// Returns the shared globals
-static SkGlyphCache_Globals& getSharedGlobals() {
-    return *globals.get();
+// Returns the shard of the shared globals responsible for desc
+static SkGlyphCache_Globals& getSharedGlobals(const SkDescriptor& desc) {
+    return *gShards[desc.getChecksum() % kShardCount];
 }
 
-// Returns the TLS globals (if set), or the shared globals
-static SkGlyphCache_Globals& getGlobals() {
+// Returns the TLS globals (if set), or the shared globals for desc
+static SkGlyphCache_Globals& getGlobals(const SkDescriptor& desc) {
     SkGlyphCache_Globals* tls = SkGlyphCache_Globals::FindTLS();
-    return tls ? *tls : getSharedGlobals();
+    return tls ? *tls : getSharedGlobals(desc);
+}
+
+static void get_shards(SkGlyphCache_Globals* shards[kShardCount]) {
+    for (int i = 0; i < kShardCount; i++) {
+        shards[i] = gShards[i];
+    }
+}
+
+static size_t shared_memory_used() {
+    SkGlyphCache_Globals* shards[kShardCount];
+    get_shards(shards);
+    return SkGlyphCache_Globals::ShardsMemoryUsed(shards, kShardCount);
+}
+
+static int shared_count_used() {
+    SkGlyphCache_Globals* shards[kShardCount];
+    get_shards(shards);
+    return SkGlyphCache_Globals::ShardsCacheCountUsed(shards, kShardCount);
+}
+
+static void balance_shared_globals() {
+    SkGlyphCache_Globals* shards[kShardCount];
+    get_shards(shards);
+    SkGlyphCache_Globals::BalanceShards(shards, kShardCount);
+}
+
+size_t SkGlyphCache_Globals::ShardsMemoryUsed(SkGlyphCache_Globals* const shards[], int count) {
+    size_t used = 0;
+    for (int i = 0; i < count; i++) {
+        used += shards[i]->getTotalMemoryUsed();
+    }
+    return used;
+}
+
+int SkGlyphCache_Globals::ShardsCacheCountUsed(SkGlyphCache_Globals* const shards[], int count) {
+    int used = 0;
+    for (int i = 0; i < count; i++) {
+        used += shards[i]->getCacheCountUsed();
+    }
+    return used;
+}
+
+// Every shard's own limits are the limits for the whole shared cache, so no one shard can
+// blow the budget by itself.  Together, they can: when they do, shards using more than their
+// even share of the budget purge down to that share until we're back within budget.
+// We only lock one shard at a time here.
+void SkGlyphCache_Globals::BalanceShards(SkGlyphCache_Globals* const shards[], int count) {
+    const size_t sizeLimit  = shards[0]->getCacheSizeLimit();
+    const int    countLimit = shards[0]->getCacheCountLimit();
+    for (int i = 0; i < count; i++) {
+        if (ShardsMemoryUsed(shards, count) <= sizeLimit &&
+            ShardsCacheCountUsed(shards, count) <= countLimit) {
+            return;
+        }
+        shards[i]->purgeDownTo(sizeLimit / count, countLimit / count);
+    }
+}
+
+void SkGlyphCache_Globals::attachNewCacheForTesting(SkTypeface* typeface,
+                                                   const SkDescriptor* desc) {
+    SkScalerContext* ctx = typeface->createScalerContext(desc, false);
+    this->attachCacheToHead(SkNEW_ARGS(SkGlyphCache, (typeface, desc, ctx)));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -451,6 +517,21 @@ void SkGlyphCache_Globals::purgeAll() {
     this->internalPurge(fTotalMemoryUsed);
 }
 
+void SkGlyphCache_Globals::purgeDownTo(size_t bytes, int count) {
+    SkAutoMutexAcquire    ac(fMutex);
+    this->validate();
+
+    SkGlyphCache* cache = this->internalGetTail();
+    while (cache != NULL && (fTotalMemoryUsed > bytes || fCacheCount > count)) {
+        SkGlyphCache* prev = cache->fPrev;
+        this->internalDetachCache(cache);
+        SkDELETE(cache);
+        cache = prev;
+    }
+
+    this->validate();
+}
+
 /*  This guy calls the visitor from within the mutext lock, so the visitor
     cannot:
     - take too much time
@@ -466,7 +547,7 @@ SkGlyphCache* SkGlyphCache::VisitCache(SkTypeface* typeface,
     }
     SkASSERT(desc);
 
-    SkGlyphCache_Globals& globals = getGlobals();
+    SkGlyphCache_Globals& globals = getGlobals(*desc);
     SkAutoMutexAcquire    ac(globals.fMutex);
     SkGlyphCache*         cache;
     bool                  insideMutex = true;
@@ -494,7 +575,9 @@ SkGlyphCache* SkGlyphCache::VisitCache(SkTypeface* typeface,
         // so we can try the purge.
         SkScalerContext* ctx = typeface->createScalerContext(desc, true);
         if (!ctx) {
-            getSharedGlobals().purgeAll();
+            for (int i = 0; i < kShardCount; i++) {
+                gShards[i]->purgeAll();
+            }
             ctx = typeface->createScalerContext(desc, false);
             SkASSERT(ctx);
         }
@@ -510,6 +593,9 @@ FOUND_IT:
             globals.internalAttachCacheToHead(cache);
         } else {
             globals.attachCacheToHead(cache);
+            if (globals.fMutex) {
+                balance_shared_globals();
+            }
         }
         cache = NULL;
     }
@@ -520,25 +606,40 @@ void SkGlyphCache::AttachCache(SkGlyphCache* cache) {
     SkASSERT(cache);
     SkASSERT(cache->fNext == NULL);
 
-    getGlobals().attachCacheToHead(cache);
+    SkGlyphCache_Globals& globals = getGlobals(cache->getDescriptor());
+    globals.attachCacheToHead(cache);
+    if (globals.fMutex) {
+        balance_shared_globals();
+    }
 }
 
 void SkGlyphCache::Dump() {
-    SkGlyphCache_Globals& globals = getGlobals();
-    SkAutoMutexAcquire    ac(globals.fMutex);
+    if (SkGlyphCache_Globals* tls = SkGlyphCache_Globals::FindTLS()) {
+        tls->dump();
+        return;
+    }
+    for (int i = 0; i < kShardCount; i++) {
+        gShards[i]->dump();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SkGlyphCache_Globals::dump() {
+    SkAutoMutexAcquire    ac(fMutex);
     SkGlyphCache*         cache;
 
-    globals.validate();
+    this->validate();
 
     SkDebugf("SkGlyphCache strikes:%d memory:%d\n",
-             globals.getCacheCountUsed(), (int)globals.getTotalMemoryUsed());
+             this->getCacheCountUsed(), (int)this->getTotalMemoryUsed());
 
 #ifdef SK_GLYPHCACHE_TRACK_HASH_STATS
     int hitCount = 0;
     int missCount = 0;
 #endif
 
-    for (cache = globals.internalGetHead(); cache != NULL; cache = cache->fNext) {
+    for (cache = this->internalGetHead(); cache != NULL; cache = cache->fNext) {
 #ifdef SK_GLYPHCACHE_TRACK_HASH_STATS
         hitCount += cache->fHashHitCount;
         missCount += cache->fHashMissCount;
@@ -550,8 +651,6 @@ void SkGlyphCache::Dump() {
 #endif
 }
 
-///////////////////////////////////////////////////////////////////////////////
-
 void SkGlyphCache_Globals::attachCacheToHead(SkGlyphCache* cache) {
     SkAutoMutexAcquire    ac(fMutex);
 
@@ -634,14 +733,17 @@ void SkGlyphCache_Globals::internalAttachCacheToHead(SkGlyphCache* cache) {
     }
     fHead = cache;
 
-    fCacheCount += 1;
-    fTotalMemoryUsed += cache->fMemoryUsed;
+    // Other shards may be reading these without our mutex.
+    sk_atomic_store(&fCacheCount, fCacheCount + 1, sk_memory_order_relaxed);
+    sk_atomic_store(&fTotalMemoryUsed, fTotalMemoryUsed + cache->fMemoryUsed,
+                    sk_memory_order_relaxed);
 }
 
 void SkGlyphCache_Globals::internalDetachCache(SkGlyphCache* cache) {
     SkASSERT(fCacheCount > 0);
-    fCacheCount -= 1;
-    fTotalMemoryUsed -= cache->fMemoryUsed;
+    sk_atomic_store(&fCacheCount, fCacheCount - 1, sk_memory_order_relaxed);
+    sk_atomic_store(&fTotalMemoryUsed, fTotalMemoryUsed - cache->fMemoryUsed,
+                    sk_memory_order_relaxed);
 
     if (cache->fPrev) {
         cache->fPrev->fNext = cache->fNext;
@@ -694,31 +796,43 @@ void SkGlyphCache_Globals::validate() const {
 #include "SkTypefaceCache.h"
 
 size_t SkGraphics::GetFontCacheLimit() {
-    return getSharedGlobals().getCacheSizeLimit();
+    return gShards[0]->getCacheSizeLimit();
 }
 
 size_t SkGraphics::SetFontCacheLimit(size_t bytes) {
-    return getSharedGlobals().setCacheSizeLimit(bytes);
+    size_t prevLimit = 0;
+    for (int i = 0; i < kShardCount; i++) {
+        prevLimit = gShards[i]->setCacheSizeLimit(bytes);
+    }
+    balance_shared_globals();
+    return prevLimit;
 }
 
 size_t SkGraphics::GetFontCacheUsed() {
-    return getSharedGlobals().getTotalMemoryUsed();
+    return shared_memory_used();
 }
 
 int SkGraphics::GetFontCacheCountLimit() {
-    return getSharedGlobals().getCacheCountLimit();
+    return gShards[0]->getCacheCountLimit();
 }
 
 int SkGraphics::SetFontCacheCountLimit(int count) {
-    return getSharedGlobals().setCacheCountLimit(count);
+    int prevCount = 0;
+    for (int i = 0; i < kShardCount; i++) {
+        prevCount = gShards[i]->setCacheCountLimit(count);
+    }
+    balance_shared_globals();
+    return prevCount;
 }
 
 int SkGraphics::GetFontCacheCountUsed() {
-    return getSharedGlobals().getCacheCountUsed();
+    return shared_count_used();
 }
 
 void SkGraphics::PurgeFontCache() {
-    getSharedGlobals().purgeAll();
+    for (int i = 0; i < kShardCount; i++) {
+        gShards[i]->purgeAll();
+    }
     SkTypefaceCache::PurgeAll();
 }
 
@@ -8,6 +8,7 @@
 #ifndef SkGlyphCache_Globals_DEFINED
 #define SkGlyphCache_Globals_DEFINED
 
+#include "SkAtomics.h"
 #include "SkGlyphCache.h"
 #include "SkTLS.h"
 
@@ -19,6 +20,11 @@
     #define SK_DEFAULT_FONT_CACHE_LIMIT     (2 * 1024 * 1024)
 #endif
 
+// The shared cache is split into this many independently locked shards, picked by descriptor.
+#ifndef SK_DEFAULT_FONT_CACHE_SHARD_COUNT
+    #define SK_DEFAULT_FONT_CACHE_SHARD_COUNT   4
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 
 class SkMutex;
@@ -56,8 +62,14 @@ public:
     SkGlyphCache* internalGetHead() const { return fHead; }
     SkGlyphCache* internalGetTail() const;
 
-    size_t getTotalMemoryUsed() const { return fTotalMemoryUsed; }
-    int getCacheCountUsed() const { return fCacheCount; }
+    // These two may be read from any thread without holding fMutex,
+    // which is how the shards of the shared cache keep track of each other.
+    size_t getTotalMemoryUsed() const {
+        return sk_atomic_load(&fTotalMemoryUsed, sk_memory_order_relaxed);
+    }
+    int getCacheCountUsed() const {
+        return sk_atomic_load(&fCacheCount, sk_memory_order_relaxed);
+    }
 
 #ifdef SK_DEBUG
     void validate() const;
@@ -80,6 +92,12 @@ public:
 
     void purgeAll(); // does not change budget
 
+    // Purge least recently used caches until we use no more than bytes and count.
+    // Does not change budget.
+    void purgeDownTo(size_t bytes, int count);
+
+    void dump();    // SkDebugf all our caches
+
     // call when a glyphcache is available for caching (i.e. not in use)
     void attachCacheToHead(SkGlyphCache*);
 
@@ -87,6 +105,16 @@ public:
     void internalDetachCache(SkGlyphCache*);
     void internalAttachCacheToHead(SkGlyphCache*);
 
+    // The shared cache is split into shards, which share one budget: shards[0]'s limits.
+    // These work on any shards, so that tests can check the budget on shards of their own.
+    static size_t ShardsMemoryUsed(SkGlyphCache_Globals* const shards[], int count);
+    static int ShardsCacheCountUsed(SkGlyphCache_Globals* const shards[], int count);
+    // Purges shards until they're back within their budget.
+    static void BalanceShards(SkGlyphCache_Globals* const shards[], int count);
+
+    // Creates a cache for typeface and desc, and attaches it to these globals. Only for tests.
+    void attachNewCacheForTesting(SkTypeface*, const SkDescriptor*);
+
     // can return NULL
     static SkGlyphCache_Globals* FindTLS() {
         return (SkGlyphCache_Globals*)SkTLS::Find(CreateTLS);
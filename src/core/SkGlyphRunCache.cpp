@@ -0,0 +1,355 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkGlyphRunCache.h"
+
+#include "SkBlitter.h"
+#include "SkCachedData.h"
+#include "SkDevice.h"
+#include "SkDeviceProperties.h"
+#include "SkDraw.h"
+#include "SkDrawProcs.h"
+#include "SkGlyphCache.h"
+#include "SkRasterClip.h"
+#include "SkResourceCache.h"
+#include "SkTextBlob.h"
+
+uint64_t SkMakeResourceCacheSharedIDForTextBlob(uint32_t blobID) {
+    uint64_t sharedID = SkSetFourByteTag('b', 'l', 'o', 'b');
+    return (sharedID << 32) | blobID;
+}
+
+void SkNotifyTextBlobIsStale(uint32_t blobID) {
+    SkResourceCache::PostPurgeSharedID(SkMakeResourceCacheSharedIDForTextBlob(blobID));
+}
+
+namespace {
+
+// Past this, the fractional part of a device origin is lost, and its whole part may not fit
+// in an int.
+static const SkScalar kMaxOrigin = SkIntToScalar(1 << 24);
+
+static unsigned gGlyphRunKeyNamespaceLabel;
+
+struct GlyphRunKey : public SkResourceCache::Key {
+public:
+    GlyphRunKey(const SkTextBlob* blob, const SkMatrix& matrix, const SkPoint& fraction,
+                const SkPaint& paint, const SkDeviceProperties& props, bool lcdAllowed)
+        : fBlobID(blob->uniqueID())
+        , fScaleX(matrix.getScaleX())
+        , fSkewX(matrix.getSkewX())
+        , fSkewY(matrix.getSkewY())
+        , fScaleY(matrix.getScaleY())
+        , fFractionX(fraction.fX)
+        , fFractionY(fraction.fY)
+        , fColor(paint.getColor())
+        , fStrokeWidth(paint.getStrokeWidth())
+        , fStrokeMiter(paint.getStrokeMiter())
+        , fGamma(props.gamma())
+    {
+        // The glyphs' luminance comes from the color only if the paint is just a color.
+        bool justAColor = NULL == paint.getShader() && NULL == paint.getColorFilter();
+
+        fBits = paint.getTextAlign()
+              | paint.getStyle() << 2
+              | paint.getStrokeJoin() << 4
+              | justAColor << 6
+              | lcdAllowed << 7
+              | props.pixelGeometry() << 8;
+
+        this->init(&gGlyphRunKeyNamespaceLabel,
+                   SkMakeResourceCacheSharedIDForTextBlob(fBlobID),
+                   sizeof(fBlobID) + sizeof(fScaleX) + sizeof(fSkewX) + sizeof(fSkewY) +
+                   sizeof(fScaleY) + sizeof(fFractionX) + sizeof(fFractionY) + sizeof(fColor) +
+                   sizeof(fStrokeWidth) + sizeof(fStrokeMiter) + sizeof(fGamma) + sizeof(fBits));
+    }
+
+    uint32_t fBlobID;
+    SkScalar fScaleX;
+    SkScalar fSkewX;
+    SkScalar fSkewY;
+    SkScalar fScaleY;
+    SkScalar fFractionX;
+    SkScalar fFractionY;
+    SkColor  fColor;
+    SkScalar fStrokeWidth;
+    SkScalar fStrokeMiter;
+    float    fGamma;
+    uint32_t fBits;
+};
+
+struct CachedGlyph {
+    SkIRect  fBounds;   // Relative to the whole part of the blob's device origin.
+    uint32_t fImageOffset;
+    uint32_t fRowBytes;
+    uint32_t fFormat;
+};
+
+// A cached blob is a GlyphRuns, then fGlyphCount CachedGlyphs, then their images.
+struct GlyphRuns {
+    SkIRect  fBounds;   // Of all the glyphs.
+    int32_t  fGlyphCount;
+
+    const CachedGlyph* glyphs() const {
+        return reinterpret_cast<const CachedGlyph*>(this + 1);
+    }
+};
+
+struct GlyphRunRec : public SkResourceCache::Rec {
+    GlyphRunRec(const GlyphRunKey& key, SkCachedData* data)
+        : fKey(key)
+        , fData(data)
+    {
+        fData->attachToCacheAndRef();
+    }
+    ~GlyphRunRec() {
+        fData->detachFromCacheAndUnref();
+    }
+
+    GlyphRunKey   fKey;
+    SkCachedData* fData;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fData->size(); }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const GlyphRunRec& rec = static_cast<const GlyphRunRec&>(baseRec);
+        SkCachedData** result = (SkCachedData**)contextData;
+
+        SkCachedData* tmpData = rec.fData;
+        tmpData->ref();
+        if (NULL == tmpData->data()) {
+            tmpData->unref();
+            return false;
+        }
+        *result = tmpData;
+        return true;
+    }
+};
+
+// Stands in for SkDraw's own glyph procs, copying out each glyph's mask where it would have
+// been blitted instead of blitting it.
+class GlyphRecorder : public SkDrawProcs {
+public:
+    GlyphRecorder() : fFailed(false) {
+        fD1GProc = RecordGlyph;
+        fBounds.setEmpty();
+    }
+
+    bool failed() const { return fFailed; }
+
+    // Returns the recorded glyphs as the contents of a new SkCachedData, or NULL.
+    SkCachedData* detach() const {
+        size_t glyphBytes = fGlyphs.count() * sizeof(CachedGlyph);
+        SkCachedData* data = SkResourceCache::NewCachedData(sizeof(GlyphRuns) + glyphBytes +
+                                                            fImages.count());
+        if (NULL == data) {
+            return NULL;
+        }
+        char* storage = static_cast<char*>(data->writable_data());
+        GlyphRuns* runs = reinterpret_cast<GlyphRuns*>(storage);
+        runs->fBounds = fBounds;
+        runs->fGlyphCount = fGlyphs.count();
+        memcpy(storage + sizeof(GlyphRuns), fGlyphs.begin(), glyphBytes);
+        memcpy(storage + sizeof(GlyphRuns) + glyphBytes, fImages.begin(), fImages.count());
+        return data;
+    }
+
+private:
+    static void RecordGlyph(const SkDraw1Glyph& state, Sk48Dot16 fx, Sk48Dot16 fy,
+                            const SkGlyph& glyph) {
+        GlyphRecorder* recorder = static_cast<GlyphRecorder*>(state.fDraw->fProcs);
+        if (SkMask::k3D_Format == glyph.fMaskFormat) {
+            recorder->fFailed = true;
+            return;
+        }
+        const void* image = glyph.fImage;
+        if (NULL == image) {
+            image = state.fCache->findImage(glyph);
+            if (NULL == image) {
+                return; // can't rasterize glyph
+            }
+        }
+
+        int left = Sk48Dot16FloorToInt(fx) + glyph.fLeft;
+        int top = Sk48Dot16FloorToInt(fy) + glyph.fTop;
+
+        CachedGlyph* cached = recorder->fGlyphs.append();
+        cached->fBounds.set(left, top, left + glyph.fWidth, top + glyph.fHeight);
+        cached->fImageOffset = recorder->fImages.count();
+        cached->fRowBytes = glyph.rowBytes();
+        cached->fFormat = glyph.fMaskFormat;
+        recorder->fBounds.join(cached->fBounds);
+
+        // Pad each image, so that the next one is aligned for any format.
+        size_t size = glyph.computeImageSize();
+        memcpy(recorder->fImages.append(SkToInt(SkAlign4(size))), image, size);
+    }
+
+    SkTDArray<CachedGlyph> fGlyphs;
+    SkTDArray<uint8_t>     fImages;
+    SkIRect                fBounds;
+    bool                   fFailed;
+};
+
+} // namespace
+
+static bool can_cache(const SkPaint& paint) {
+    return NULL == paint.getPathEffect() &&
+           NULL == paint.getMaskFilter() &&
+           NULL == paint.getRasterizer();
+}
+
+// Draws blob's runs through a copy of draw, which is transformed by matrix and records the
+// glyphs rather than blitting them. Returns the recording, or NULL if it cannot be cached.
+SkCachedData* SkGlyphRunCache::Record(const SkDraw& draw, const SkMatrix& matrix,
+                                      const SkTextBlob* blob, SkScalar x, SkScalar y,
+                                      const SkPaint& paint) {
+    GlyphRecorder recorder;
+    SkDraw recordDraw(draw);
+    recordDraw.fMatrix = &matrix;
+    recordDraw.fProcs = &recorder;
+
+    SkPaint runPaint = paint;
+    SkTextBlob::RunIterator it(blob);
+    for (; !it.done(); it.next()) {
+        size_t textLen = it.glyphCount() * sizeof(uint16_t);
+        const SkPoint& offset = it.offset();
+        it.applyFontToPaint(&runPaint);
+        runPaint.setFlags(draw.fDevice->filterTextFlags(runPaint));
+
+        if (SkDraw::ShouldDrawTextAsPaths(runPaint, matrix)) {
+            return NULL;
+        }
+
+        const char* text = static_cast<const char*>(static_cast<const void*>(it.glyphs()));
+        switch (it.positioning()) {
+        case SkTextBlob::kDefault_Positioning:
+            recordDraw.drawText(text, textLen, x + offset.x(), y + offset.y(), runPaint);
+            break;
+        case SkTextBlob::kHorizontal_Positioning:
+            recordDraw.drawPosText(text, textLen, it.pos(), 1,
+                                   SkPoint::Make(x, y + offset.y()), runPaint);
+            break;
+        case SkTextBlob::kFull_Positioning:
+            recordDraw.drawPosText(text, textLen, it.pos(), 2, SkPoint::Make(x, y), runPaint);
+            break;
+        default:
+            SkFAIL("unhandled positioning mode");
+        }
+        if (recorder.failed()) {
+            return NULL;
+        }
+    }
+    return recorder.detach();
+}
+
+// Blits the recorded glyphs, offset by (dx, dy), as SkDraw's own glyph procs would.
+static void replay(const SkDraw& draw, const GlyphRuns& runs, int dx, int dy,
+                   const SkPaint& paint) {
+    const SkRasterClip& rc = *draw.fRC;
+    SkIRect bounds = runs.fBounds;
+    bounds.offset(dx, dy);
+    if (!SkIRect::Intersects(bounds, rc.getBounds())) {
+        return;
+    }
+
+    SkTBlitterAllocator allocator;
+    SkBlitter* blitter = SkBlitter::Choose(*draw.fBitmap, *draw.fMatrix, paint, &allocator);
+    SkAAClipBlitterWrapper wrapper;
+    const SkRegion* complexClip = NULL;
+    SkIRect clipBounds;
+    if (rc.isBW()) {
+        clipBounds = rc.bwRgn().getBounds();
+        if (!rc.bwRgn().isRect()) {
+            complexClip = &rc.bwRgn();
+        }
+    } else {
+        wrapper.init(rc, blitter);
+        blitter = wrapper.getBlitter();
+        clipBounds = rc.aaRgn().getBounds();
+    }
+
+    // Only used to blit ARGB32 masks as sprites.
+    SkDraw1Glyph d1g;
+    sk_bzero(&d1g, sizeof(d1g));
+    d1g.fDraw = &draw;
+    d1g.fBlitter = blitter;
+    d1g.fPaint = &paint;
+
+    const uint8_t* images = reinterpret_cast<const uint8_t*>(runs.glyphs() + runs.fGlyphCount);
+    for (int i = 0; i < runs.fGlyphCount; ++i) {
+        const CachedGlyph& glyph = runs.glyphs()[i];
+
+        SkMask mask;
+        mask.fBounds = glyph.fBounds;
+        mask.fBounds.offset(dx, dy);
+        mask.fImage = const_cast<uint8_t*>(images + glyph.fImageOffset);
+        mask.fRowBytes = glyph.fRowBytes;
+        mask.fFormat = static_cast<SkMask::Format>(glyph.fFormat);
+
+        if (complexClip) {
+            SkRegion::Cliperator clipper(*complexClip, mask.fBounds);
+            for (; !clipper.done(); clipper.next()) {
+                d1g.blitMask(mask, clipper.rect());
+            }
+        } else if (clipBounds.containsNoEmptyCheck(mask.fBounds)) {
+            d1g.blitMask(mask, mask.fBounds);
+        } else {
+            SkIRect storage;
+            if (storage.intersectNoEmptyCheck(mask.fBounds, clipBounds)) {
+                d1g.blitMask(mask, storage);
+            }
+        }
+    }
+}
+
+bool SkGlyphRunCache::Draw(const SkDraw& draw, const SkTextBlob* blob, SkScalar x, SkScalar y,
+                           const SkPaint& paint) {
+    if (draw.fProcs || NULL == draw.fDevice || !can_cache(paint) ||
+        draw.fMatrix->hasPerspective()) {
+        return false;
+    }
+    if (draw.fRC->isEmpty()) {
+        return true;
+    }
+
+    SkPoint origin;
+    draw.fMatrix->mapXY(x, y, &origin);
+    if (!(SkScalarAbs(origin.fX) < kMaxOrigin && SkScalarAbs(origin.fY) < kMaxOrigin)) {
+        return false;
+    }
+    SkScalar wholeX = SkScalarFloorToScalar(origin.fX),
+             wholeY = SkScalarFloorToScalar(origin.fY);
+
+    // Whether the device would turn off LCD text for a run of this paint. This depends on the
+    // paint's other attributes (e.g. its xfermode) as well as on the run's font.
+    SkPaint probe(paint);
+    probe.setFlags(probe.getFlags() | SkPaint::kAntiAlias_Flag | SkPaint::kLCDRenderText_Flag);
+    probe.setFakeBoldText(false);
+    bool lcdAllowed = SkToBool(draw.fDevice->filterTextFlags(probe) &
+                               SkPaint::kLCDRenderText_Flag);
+
+    GlyphRunKey key(blob, *draw.fMatrix, SkPoint::Make(origin.fX - wholeX, origin.fY - wholeY),
+                    paint, draw.fDevice->getLeakyProperties(), lcdAllowed);
+    SkCachedData* data = NULL;
+    if (!SkResourceCache::Find(key, GlyphRunRec::Visitor, &data)) {
+        SkMatrix matrix(*draw.fMatrix);
+        matrix.postTranslate(-wholeX, -wholeY);
+        data = Record(draw, matrix, blob, x, y, paint);
+        if (NULL == data) {
+            return false;
+        }
+        SkResourceCache::Add(SkNEW_ARGS(GlyphRunRec, (key, data)));
+        blob->notifyAddedToCache();
+    }
+
+    replay(draw, *static_cast<const GlyphRuns*>(data->data()),
+           SkScalarFloorToInt(wholeX), SkScalarFloorToInt(wholeY), paint);
+    data->unref();
+    return true;
+}
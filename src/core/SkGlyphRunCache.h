@@ -0,0 +1,49 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkGlyphRunCache_DEFINED
+#define SkGlyphRunCache_DEFINED
+
+#include "SkScalar.h"
+
+class SkCachedData;
+class SkDraw;
+class SkMatrix;
+class SkPaint;
+class SkTextBlob;
+
+uint64_t SkMakeResourceCacheSharedIDForTextBlob(uint32_t blobID);
+void SkNotifyTextBlobIsStale(uint32_t blobID);
+
+/**
+ *  Caches the glyph masks of an SkTextBlob, positioned as SkDraw would draw them, in the
+ *  global SkResourceCache.
+ *
+ *  Entries are keyed by the blob's unique ID, the matrix, the paint attributes that go into the
+ *  masks, and the device's properties. Only the fractional part of the blob's device origin is
+ *  in the key: the masks are stored relative to the whole part, so a blob scrolled by whole
+ *  pixels still finds its entry. Entries are purged when their blob is deleted.
+ */
+class SkGlyphRunCache {
+public:
+    /**
+     *  Draws blob the way SkBaseDevice::drawTextBlob() would with no draw filter, going
+     *  straight to blitMask() for each glyph if the blob's masks are cached, and recording
+     *  them first if not.
+     *
+     *  Returns false, having drawn nothing, if the blob cannot be cached this way (e.g. the
+     *  paint has a mask filter, or some run's glyphs are drawn as paths). The caller should
+     *  then draw the blob as usual.
+     */
+    static bool Draw(const SkDraw&, const SkTextBlob*, SkScalar x, SkScalar y, const SkPaint&);
+
+private:
+    static SkCachedData* Record(const SkDraw&, const SkMatrix&, const SkTextBlob*,
+                                SkScalar x, SkScalar y, const SkPaint&);
+};
+
+#endif
@@ -172,8 +172,9 @@ bool SkImageFilter::filterImage(Proxy* proxy, const SkBitmap& src,
     SkASSERT(offset);
     uint32_t srcGenID = fUsesSrcInput ? src.getGenerationID() : 0;
     Cache::Key key(fUniqueID, context.ctm(), context.clipBounds(), srcGenID);
+    const SkBitmap* usedSrc = fUsesSrcInput ? &src : NULL;
     if (context.cache()) {
-        if (context.cache()->get(key, result, offset)) {
+        if (context.cache()->find(key, this, usedSrc, context, result, offset)) {
             return true;
         }
     }
@@ -184,7 +185,7 @@ bool SkImageFilter::filterImage(Proxy* proxy, const SkBitmap& src,
     if ((proxy && proxy->filterImage(this, src, context, result, offset)) ||
         this->onFilterImage(proxy, src, context, result, offset)) {
         if (context.cache()) {
-            context.cache()->set(key, *result, *offset);
+            context.cache()->add(key, this, usedSrc, context, *result, *offset);
         }
         return true;
     }
@@ -39,6 +39,7 @@ void SkMultiPictureDraw::DrawData::init(SkCanvas* canvas, const SkPicture* pictu
     } else {
         fPaint = NULL;
     }
+    fTileSize.setEmpty();
 }
 
 void SkMultiPictureDraw::DrawData::Reset(SkTDArray<DrawData>& data) {
@@ -62,6 +63,7 @@ SkMultiPictureDraw::SkMultiPictureDraw(int reserve) {
 void SkMultiPictureDraw::reset() {
     DrawData::Reset(fGPUDrawData);
     DrawData::Reset(fThreadSafeDrawData);
+    DrawData::Reset(fTiledDrawData);
 }
 
 void SkMultiPictureDraw::add(SkCanvas* canvas,
@@ -77,6 +79,72 @@ void SkMultiPictureDraw::add(SkCanvas* canvas,
     array.append()->init(canvas, picture, matrix, paint);
 }
 
+void SkMultiPictureDraw::addTiled(SkCanvas* canvas,
+                                  const SkPicture* picture,
+                                  const SkISize& tileSize,
+                                  const SkMatrix* matrix) {
+    if (NULL == canvas || NULL == picture || tileSize.isEmpty()) {
+        SkDEBUGFAIL("parameters to SkMultiPictureDraw::addTiled should be non-NULL and non-empty");
+        return;
+    }
+
+    if (canvas->getGrContext()) {
+        this->add(canvas, picture, matrix);
+        return;
+    }
+
+    DrawData* data = fTiledDrawData.append();
+    data->init(canvas, picture, matrix, NULL);
+    data->fTileSize = tileSize;
+}
+
+void SkMultiPictureDraw::splitIntoTiles(const DrawData& data) {
+    SkCanvas* canvas = data.fCanvas;
+
+    SkIRect clip;
+    if (!canvas->getClipDeviceBounds(&clip)) {
+        return;  // Nothing to draw.
+    }
+
+    // We're about to write into the canvas' pixels behind its back, so give its surface
+    // (if any) a chance to copy-on-write first.
+    canvas->predrawNotify();
+
+    SkImageInfo info;
+    size_t rowBytes;
+    SkIPoint origin;
+    void* pixels = canvas->accessTopLayerPixels(&info, &rowBytes, &origin);
+    if (NULL == pixels || !origin.isZero() || !canvas->isClipRect()) {
+        // We can't share this canvas' pixels between threads.  Just draw it in one piece.
+        fThreadSafeDrawData.append()->init(canvas, data.fPicture, &data.fMatrix, NULL);
+        return;
+    }
+
+    // Every tile gets its own canvas over the same pixels.  The tiles don't overlap, so the
+    // threads never touch the same pixels.
+    SkBitmap bitmap;
+    if (!bitmap.installPixels(info, pixels, rowBytes)) {
+        fThreadSafeDrawData.append()->init(canvas, data.fPicture, &data.fMatrix, NULL);
+        return;
+    }
+
+    const SkMatrix& ctm = canvas->getTotalMatrix();
+    const int tileW = data.fTileSize.width(),
+              tileH = data.fTileSize.height();
+    for (int y = clip.fTop; y < clip.fBottom; y += tileH) {
+        for (int x = clip.fLeft; x < clip.fRight; x += tileW) {
+            SkIRect tile = SkIRect::MakeXYWH(x, y, tileW, tileH);
+            if (!tile.intersect(clip)) {
+                continue;
+            }
+            SkAutoTUnref<SkCanvas> tileCanvas(SkNEW_ARGS(SkCanvas, (bitmap, canvas->fProps)));
+            tileCanvas->clipRect(SkRect::Make(tile));
+            tileCanvas->setMatrix(ctm);
+            fThreadSafeDrawData.append()->init(tileCanvas, data.fPicture, &data.fMatrix, NULL);
+        }
+    }
+}
+
 class AutoMPDReset : SkNoncopyable {
     SkMultiPictureDraw* fMPD;
 public:
@@ -89,6 +157,10 @@ public:
 void SkMultiPictureDraw::draw(bool flush) {
     AutoMPDReset mpdreset(this);
 
+    for (int i = 0; i < fTiledDrawData.count(); ++i) {
+        this->splitIntoTiles(fTiledDrawData[i]);
+    }
+
 #ifdef FORCE_SINGLE_THREAD_DRAWING_FOR_TESTING
     for (int i = 0; i < fThreadSafeDrawData.count(); ++i) {
         DrawData* dd = &fThreadSafeDrawData.begin()[i];
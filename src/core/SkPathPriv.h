@@ -0,0 +1,27 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPathPriv_DEFINED
+#define SkPathPriv_DEFINED
+
+#include "SkPath.h"
+#include "SkPathRef.h"
+
+class SkPathPriv {
+public:
+    /**
+     *  Register a listener to be called the next time the generation ID of path's points and
+     *  verbs changes, i.e. when they are edited or deleted. Use this to invalidate caches keyed
+     *  by path.getGenerationID(). Takes ownership of listener.
+     */
+    static void AddGenIDChangeListener(const SkPath& path,
+                                       SkPathRef::GenIDChangeListener* listener) {
+        path.fPathRef->addGenIDChangeListener(listener);
+    }
+};
+
+#endif
@@ -7,6 +7,7 @@
 
 #include "SkBuffer.h"
 #include "SkLazyPtr.h"
+#include "SkOnce.h"
 #include "SkPath.h"
 #include "SkPathRef.h"
 
@@ -16,6 +17,9 @@ SkPathRef::Editor::Editor(SkAutoTUnref<SkPathRef>* pathRef,
                           int incReservePoints)
 {
     if ((*pathRef)->unique()) {
+        (*pathRef)->callGenIDChangeListeners();
+        (*pathRef)->materialize();
+        (*pathRef)->freeLazy();
         (*pathRef)->incReserve(incReserveVerbs, incReservePoints);
     } else {
         SkPathRef* copy = SkNEW(SkPathRef);
@@ -29,6 +33,42 @@ SkPathRef::Editor::Editor(SkAutoTUnref<SkPathRef>* pathRef,
 
 //////////////////////////////////////////////////////////////////////////////
 
+struct SkPathRef::Lazy {
+    Lazy(const SkPathRef& source, const SkMatrix& matrix)
+        : fSource(SkRef(&source)), fMatrix(matrix) {
+        sk_bzero(&fOnce, sizeof(fOnce));  // SkOnceFlag must be zero-initialized.
+    }
+
+    SkAutoTUnref<const SkPathRef> fSource;  // Never itself lazy.
+    SkMatrix                      fMatrix;
+    SkOnceFlag                    fOnce;
+};
+
+// Smaller paths are cheaper to map than to defer.
+static const int kMinLazyPointCount = 16;
+
+void SkPathRef::materializeSlow() const {
+    SkOnce(&fLazy->fOnce, Materialize, const_cast<SkPathRef*>(this));
+}
+
+void SkPathRef::Materialize(SkPathRef* ref) {
+    const SkPathRef& src = *ref->fLazy->fSource;
+    SkASSERT(NULL == ref->fPoints && NULL == src.fLazy);
+    SkASSERT(ref->fVerbCnt == src.fVerbCnt && ref->fPointCnt == src.fPointCnt);
+
+    size_t size = ref->fVerbCnt * sizeof(uint8_t) + ref->fPointCnt * sizeof(SkPoint);
+    ref->fPoints = reinterpret_cast<SkPoint*>(sk_malloc_throw(size));
+    ref->fVerbs = reinterpret_cast<uint8_t*>(ref->fPoints) + size;
+    ref->fFreeSpace = 0;
+    memcpy(ref->fVerbs - ref->fVerbCnt, src.verbsMemBegin(), src.fVerbCnt * sizeof(uint8_t));
+    ref->fLazy->fMatrix.mapPoints(ref->fPoints, src.points(), src.fPointCnt);
+}
+
+void SkPathRef::freeLazy() {
+    SkDELETE(fLazy);
+    fLazy = NULL;
+}
+
 // As a template argument, this must have external linkage.
 SkPathRef* sk_create_empty_pathref() {
     SkPathRef* empty = SkNEW(SkPathRef);
@@ -55,11 +95,53 @@ void SkPathRef::CreateTransformedCopy(SkAutoTUnref<SkPathRef>* dst,
         return;
     }
 
+    if ((*dst != &src || !src.unique()) && src.countPoints() >= kMinLazyPointCount) {
+        // Defer mapping the points. If src is itself a transformed view, view its source.
+        const SkPathRef* source = &src;
+        SkMatrix concat = matrix;
+        if (src.fLazy) {
+            source = src.fLazy->fSource;
+            concat.setConcat(matrix, src.fLazy->fMatrix);
+        }
+
+        SkPathRef* ref = SkNEW(SkPathRef);
+        ref->fVerbCnt = src.fVerbCnt;
+        ref->fPointCnt = src.fPointCnt;
+        ref->fConicWeights = src.fConicWeights;
+        ref->fSegmentMask = src.fSegmentMask;
+        ref->fIsOval = src.fIsOval && matrix.rectStaysRect();
+        ref->fLazy = SkNEW_ARGS(Lazy, (*source, concat));
+
+        // When rects stay rects, map the source's bounds (computing them if need be).
+        if (concat.rectStaysRect()) {
+            const SkRect& bounds = source->getBounds();
+            ref->fBoundsIsDirty = false;
+            if (source->fIsFinite) {
+                concat.mapRect(&ref->fBounds, bounds);
+                if (!(ref->fIsFinite = ref->fBounds.isFinite())) {
+                    ref->fBounds.setEmpty();
+                }
+            } else {
+                ref->fIsFinite = false;
+                ref->fBounds.setEmpty();
+            }
+        }
+        dst->reset(ref);
+        SkDEBUGCODE((*dst)->validate();)
+        return;
+    }
+
     if (!(*dst)->unique()) {
         dst->reset(SkNEW(SkPathRef));
     }
 
-    if (*dst != &src) {
+    if (*dst == &src) {
+        // Transforming in place, so there's nothing to defer.
+        (*dst)->callGenIDChangeListeners();
+        (*dst)->materialize();
+        (*dst)->freeLazy();
+    } else {
+        (*dst)->freeLazy();
         (*dst)->resetToSize(src.fVerbCnt, src.fPointCnt, src.fConicWeights.count());
         memcpy((*dst)->verbsMemWritable(), src.verbsMemBegin(), src.fVerbCnt * sizeof(uint8_t));
         (*dst)->fConicWeights = src.fConicWeights;
@@ -154,6 +236,7 @@ SkPathRef* SkPathRef::CreateFromBuffer(SkRBuffer* buffer) {
 void SkPathRef::Rewind(SkAutoTUnref<SkPathRef>* pathRef) {
     if ((*pathRef)->unique()) {
         SkDEBUGCODE((*pathRef)->validate();)
+        (*pathRef)->callGenIDChangeListeners();
         (*pathRef)->fBoundsIsDirty = true;  // this also invalidates fIsFinite
         (*pathRef)->fVerbCnt = 0;
         (*pathRef)->fPointCnt = 0;
@@ -162,6 +245,7 @@ void SkPathRef::Rewind(SkAutoTUnref<SkPathRef>* pathRef) {
         (*pathRef)->fConicWeights.rewind();
         (*pathRef)->fSegmentMask = 0;
         (*pathRef)->fIsOval = false;
+        (*pathRef)->freeLazy();
         SkDEBUGCODE((*pathRef)->validate();)
     } else {
         int oldVCnt = (*pathRef)->countVerbs();
@@ -245,7 +329,7 @@ void SkPathRef::writeToBuffer(SkWBuffer* buffer) const {
     buffer->write32(fPointCnt);
     buffer->write32(fConicWeights.count());
     buffer->write(verbsMemBegin(), fVerbCnt * sizeof(uint8_t));
-    buffer->write(fPoints, fPointCnt * sizeof(SkPoint));
+    buffer->write(this->points(), fPointCnt * sizeof(SkPoint));
     buffer->write(fConicWeights.begin(), fConicWeights.bytes());
     buffer->write(&bounds, sizeof(bounds));
 
@@ -267,7 +351,7 @@ void SkPathRef::copy(const SkPathRef& ref,
     this->resetToSize(ref.fVerbCnt, ref.fPointCnt, ref.fConicWeights.count(),
                         additionalReserveVerbs, additionalReservePoints);
     memcpy(this->verbsMemWritable(), ref.verbsMemBegin(), ref.fVerbCnt * sizeof(uint8_t));
-    memcpy(this->fPoints, ref.fPoints, ref.fPointCnt * sizeof(SkPoint));
+    memcpy(this->fPoints, ref.points(), ref.fPointCnt * sizeof(SkPoint));
     fConicWeights = ref.fConicWeights;
     // We could call genID() here to force a real ID (instead of 0). However, if we're making
     // a copy then presumably we intend to make a modification immediately afterwards.
@@ -436,9 +520,42 @@ uint32_t SkPathRef::genID() const {
     return fGenerationID;
 }
 
+void SkPathRef::addGenIDChangeListener(GenIDChangeListener* listener) {
+    if (NULL == listener || kEmptyGenID == this->genID()) {
+        // No point in tracking this if we're never going to call it.
+        SkDELETE(listener);
+        return;
+    }
+    SkAutoMutexAcquire lock(fGenIDChangeListenersMutex);
+    if (const void* kind = listener->kind()) {
+        for (int i = 0; i < fGenIDChangeListeners.count(); i++) {
+            const GenIDChangeListener* other = fGenIDChangeListeners[i];
+            if (other->kind() == kind && other->equals(*listener)) {
+                SkDELETE(listener);
+                return;
+            }
+        }
+    }
+    *fGenIDChangeListeners.append() = listener;
+}
+
+void SkPathRef::callGenIDChangeListeners() {
+    SkAutoMutexAcquire lock(fGenIDChangeListenersMutex);
+    for (int i = 0; i < fGenIDChangeListeners.count(); i++) {
+        fGenIDChangeListeners[i]->onChange();
+    }
+    // Listeners get at most one shot, so whether these triggered or not, blow them away.
+    fGenIDChangeListeners.deleteAll();
+}
+
 #ifdef SK_DEBUG
 void SkPathRef::validate() const {
     this->INHERITED::validate();
+    if (fLazy && !sk_atomic_load(fLazy->fOnce.mutableDone(), sk_memory_order_acquire)) {
+        // The points and verbs are yet to be allocated.
+        SkASSERT(NULL == fPoints && NULL == fVerbs && 0 == fFreeSpace);
+        return;
+    }
     SkASSERT(static_cast<ptrdiff_t>(fFreeSpace) >= 0);
     SkASSERT(reinterpret_cast<intptr_t>(fVerbs) - reinterpret_cast<intptr_t>(fPoints) >= 0);
     SkASSERT((NULL == fPoints) == (NULL == fVerbs));
@@ -63,7 +63,7 @@ static int32_t next_picture_generation_id() {
 namespace {
 
 // Some commands have a paint, some have an optional paint.  Either way, get back a pointer.
-static const SkPaint* AsPtr(const SkPaint& p) { return &p; }
+static const SkPaint* AsPtr(const SkRecords::Shared<SkPaint>& p) { return p.get(); }
 static const SkPaint* AsPtr(const SkRecords::Optional<SkPaint>& p) { return p; }
 
 /** SkRecords visitor to determine whether an instance may require an
@@ -169,12 +169,12 @@ struct SkPicture::PathCounter {
     }
 
     void operator()(const SkRecords::DrawPoints& op) {
-        this->checkPaint(&op.paint);
-        const SkPathEffect* effect = op.paint.getPathEffect();
+        this->checkPaint(op.paint.get());
+        const SkPathEffect* effect = op.paint->getPathEffect();
         if (effect) {
             SkPathEffect::DashInfo info;
             SkPathEffect::DashType dashType = effect->asADash(&info);
-            if (2 == op.count && SkPaint::kRound_Cap != op.paint.getStrokeCap() &&
+            if (2 == op.count && SkPaint::kRound_Cap != op.paint->getStrokeCap() &&
                 SkPathEffect::kDash_DashType == dashType && 2 == info.fCount) {
                 numFastPathDashEffects++;
             }
@@ -182,14 +182,14 @@ struct SkPicture::PathCounter {
     }
 
     void operator()(const SkRecords::DrawPath& op) {
-        this->checkPaint(&op.paint);
-        if (op.paint.isAntiAlias() && !op.path.isConvex()) {
+        this->checkPaint(op.paint.get());
+        if (op.paint->isAntiAlias() && !op.path.isConvex()) {
             numAAConcavePaths++;
 
-            SkPaint::Style paintStyle = op.paint.getStyle();
+            SkPaint::Style paintStyle = op.paint->getStyle();
             const SkRect& pathBounds = op.path.getBounds();
             if (SkPaint::kStroke_Style == paintStyle &&
-                0 == op.paint.getStrokeWidth()) {
+                0 == op.paint->getStrokeWidth()) {
                 numAAHairlineConcavePaths++;
             } else if (SkPaint::kFill_Style == paintStyle && pathBounds.width() < 64.f &&
                        pathBounds.height() < 64.f && !op.path.isVolatile()) {
@@ -398,11 +398,22 @@ SkPicture* SkPicture::Forwardport(const SkPictInfo& info, const SkPictureData* d
 }
 
 SkPicture* SkPicture::CreateFromStream(SkStream* stream, InstallPixelRefProc proc) {
+    return CreateFromStream(stream, proc, NULL);
+}
+
+SkPicture* SkPicture::CreateFromData(SkData* data, InstallPixelRefProc proc) {
+    SkMemoryStream stream(data);
+    return CreateFromStream(&stream, proc, data);
+}
+
+SkPicture* SkPicture::CreateFromStream(SkStream* stream, InstallPixelRefProc proc,
+                                       SkData* backing) {
     SkPictInfo info;
     if (!InternalOnly_StreamIsSKP(stream, &info) || !stream->readBool()) {
         return NULL;
     }
-    SkAutoTDelete<SkPictureData> data(SkPictureData::CreateFromStream(stream, info, proc));
+    SkAutoTDelete<SkPictureData> data(SkPictureData::CreateFromStream(stream, info, proc,
+                                                                      backing));
     return Forwardport(info, data);
 }
 
@@ -95,6 +95,15 @@ SkPictureData::~SkPictureData() {
     SkDELETE(fFactoryPlayback);
 }
 
+void SkPictureData::materializePath(int index) const {
+    LazyPath& lazy = fLazyPaths[index];
+    if (lazy.fData) {
+        SkDEBUGCODE(size_t read =) fPaths[index].readFromMemory(lazy.fData, lazy.fSize);
+        SkASSERT(read == lazy.fSize);
+        lazy.fData = NULL;
+    }
+}
+
 bool SkPictureData::containsBitmaps() const {
     if (fBitmaps.count() > 0) {
         return true;
@@ -139,6 +148,37 @@ static void write_tag_size(SkWStream* stream, uint32_t tag, size_t size) {
     stream->write32(SkToU32(size));
 }
 
+// Writes a pad count and that many zeros, so that what follows starts 4-byte aligned (relative
+// to the start of the stream), which lets a reader map it in place.
+static void write_pad(SkWStream* stream) {
+    const size_t pad = (4 - ((stream->bytesWritten() + 1) & 3)) & 3;
+    stream->write8(SkToU8(pad));
+    static const uint32_t kZero = 0;
+    stream->write(&kZero, pad);
+}
+
+static bool skip_pad(SkStream* stream) {
+    const size_t pad = stream->readU8();
+    return pad < 4 && stream->skip(pad) == pad;
+}
+
+// Returns size bytes at the stream's position as a subset of backing (which the stream reads
+// from), skipping past them. Returns NULL if they can't be shared that way.
+static SkData* share_from_stream(SkStream* stream, SkData* backing, size_t size) {
+    if (NULL == backing || !stream->hasPosition()) {
+        return NULL;
+    }
+    const size_t offset = stream->getPosition();
+    if (!SkIsAlign4((intptr_t)backing->bytes() + offset) ||
+        offset > backing->size() || size > backing->size() - offset) {
+        return NULL;
+    }
+    if (stream->skip(size) != size) {
+        return NULL;
+    }
+    return SkData::NewSubset(backing, offset, size);
+}
+
 void SkPictureData::WriteFactories(SkWStream* stream, const SkFactorySet& rec) {
     int count = rec.count();
 
@@ -207,6 +247,10 @@ void SkPictureData::flattenToBuffer(SkWriteBuffer& buffer) const {
         write_tag_size(buffer, SK_PICT_PATH_BUFFER_TAG, n);
         buffer.writeInt(n);
         for (int i = 0; i < n; i++) {
+            if (fLazyPaths.count() > 0) {
+                this->materializePath(i);
+            }
+            buffer.writeUInt(SkToU32(fPaths[i].writeToMemory(NULL)));
             buffer.writePath(fPaths[i]);
         }
     }
@@ -222,6 +266,7 @@ void SkPictureData::flattenToBuffer(SkWriteBuffer& buffer) const {
 void SkPictureData::serialize(SkWStream* stream,
                               SkPixelSerializer* pixelSerializer) const {
     write_tag_size(stream, SK_PICT_READER_TAG, fOpData->size());
+    write_pad(stream);
     stream->write(fOpData->bytes(), fOpData->size());
 
     if (fPictureCount > 0) {
@@ -251,6 +296,7 @@ void SkPictureData::serialize(SkWStream* stream,
         WriteTypefaces(stream, typefaceSet);
 
         write_tag_size(stream, SK_PICT_BUFFER_SIZE_TAG, buffer.bytesWritten());
+        write_pad(stream);
         buffer.writeToStream(stream);
     }
 
@@ -301,7 +347,8 @@ static uint32_t pictInfoFlagsToReadBufferFlags(uint32_t pictInfoFlags) {
 bool SkPictureData::parseStreamTag(SkStream* stream,
                                    uint32_t tag,
                                    uint32_t size,
-                                   SkPicture::InstallPixelRefProc proc) {
+                                   SkPicture::InstallPixelRefProc proc,
+                                   SkData* backing) {
     /*
      *  By the time we encounter BUFFER_SIZE_TAG, we need to have already seen
      *  its dependents: FACTORY_TAG and TYPEFACE_TAG. These two are not required
@@ -313,10 +360,19 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
      */
     SkDEBUGCODE(bool haveBuffer = false;)
 
+    // Newer SKPs pad the op data and the buffer so they can be used in place.
+    const bool padded = fInfo.fVersion >= SkReadBuffer::kMappableLayout_Version;
+
     switch (tag) {
         case SK_PICT_READER_TAG:
             SkASSERT(NULL == fOpData);
-            fOpData = SkData::NewFromStream(stream, size);
+            if (padded && !skip_pad(stream)) {
+                return false;
+            }
+            fOpData = share_from_stream(stream, backing, size);
+            if (NULL == fOpData) {
+                fOpData = SkData::NewFromStream(stream, size);
+            }
             if (!fOpData) {
                 return false;
             }
@@ -355,7 +411,7 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
             bool success = true;
             int i = 0;
             for ( ; i < fPictureCount; i++) {
-                fPictureRefs[i] = SkPicture::CreateFromStream(stream, proc);
+                fPictureRefs[i] = SkPicture::CreateFromStream(stream, proc, backing);
                 if (NULL == fPictureRefs[i]) {
                     success = false;
                     break;
@@ -373,15 +429,28 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
             }
         } break;
         case SK_PICT_BUFFER_SIZE_TAG: {
-            SkAutoMalloc storage(size);
-            if (stream->read(storage.get(), size) != size) {
+            if (padded && !skip_pad(stream)) {
                 return false;
             }
+            SkAutoTUnref<SkData> storage(share_from_stream(stream, backing, size));
+            const bool shared = SkToBool(storage.get());
+            if (!shared) {
+                storage.reset(SkData::NewFromStream(stream, size));
+                if (NULL == storage.get()) {
+                    return false;
+                }
+            }
 
             /* Should we use SkValidatingReadBuffer instead? */
-            SkReadBuffer buffer(storage.get(), size);
+            SkReadBuffer buffer(storage->data(), size);
             buffer.setFlags(pictInfoFlagsToReadBufferFlags(fInfo.fFlags));
             buffer.setVersion(fInfo.fVersion);
+            if (shared) {
+                // Only when mapped: sharing a private copy would pin all of it for a few pixels.
+                buffer.setBackingData(storage);
+            }
+            // Lazy paths point into the buffer.
+            fBufferData.reset(SkRef(storage.get()));
 
             fFactoryPlayback->setupBuffer(buffer);
             fTFPlayback.setupBuffer(buffer);
@@ -429,8 +498,30 @@ bool SkPictureData::parseBufferTag(SkReadBuffer& buffer,
             if (size > 0) {
                 const int count = buffer.readInt();
                 fPaths.reset(count);
+                if (buffer.isVersionLT(SkReadBuffer::kMappableLayout_Version)) {
+                    for (int i = 0; i < count; i++) {
+                        buffer.readPath(&fPaths[i]);
+                    }
+                    break;
+                }
+                // Each path is prefixed by its size, so it can be skipped now and read later.
+                const bool lazy = fBufferData.get() != NULL;
+                if (lazy) {
+                    fLazyPaths.setCount(count);
+                }
                 for (int i = 0; i < count; i++) {
-                    buffer.readPath(&fPaths[i]);
+                    const uint32_t pathSize = buffer.readUInt();
+                    const void* pathData = buffer.skip(SkAlign4(pathSize));
+                    if (!buffer.isValid()) {
+                        return false;
+                    }
+                    if (lazy) {
+                        fLazyPaths[i].fData = pathData;
+                        fLazyPaths[i].fSize = pathSize;
+                    } else if (!buffer.validate(fPaths[i].readFromMemory(pathData,
+                                                                         pathSize) == pathSize)) {
+                        return false;
+                    }
                 }
             } break;
         case SK_PICT_TEXTBLOB_BUFFER_TAG: {
@@ -504,10 +595,11 @@ bool SkPictureData::parseBufferTag(SkReadBuffer& buffer,
 
 SkPictureData* SkPictureData::CreateFromStream(SkStream* stream,
                                                const SkPictInfo& info,
-                                               SkPicture::InstallPixelRefProc proc) {
+                                               SkPicture::InstallPixelRefProc proc,
+                                               SkData* backing) {
     SkAutoTDelete<SkPictureData> data(SkNEW_ARGS(SkPictureData, (info)));
 
-    if (!data->parseStream(stream, proc)) {
+    if (!data->parseStream(stream, proc, backing)) {
         return NULL;
     }
     return data.detach();
@@ -525,7 +617,8 @@ SkPictureData* SkPictureData::CreateFromBuffer(SkReadBuffer& buffer,
 }
 
 bool SkPictureData::parseStream(SkStream* stream,
-                                SkPicture::InstallPixelRefProc proc) {
+                                SkPicture::InstallPixelRefProc proc,
+                                SkData* backing) {
     for (;;) {
         uint32_t tag = stream->readU32();
         if (SK_PICT_EOF_TAG == tag) {
@@ -533,7 +626,7 @@ bool SkPictureData::parseStream(SkStream* stream,
         }
 
         uint32_t size = stream->readU32();
-        if (!this->parseStreamTag(stream, tag, size, proc)) {
+        if (!this->parseStreamTag(stream, tag, size, proc, backing)) {
             return false; // we're invalid
         }
     }
@@ -58,10 +58,12 @@ struct SkPictInfo {
 class SkPictureData {
 public:
     SkPictureData(const SkPictureRecord& record, const SkPictInfo&, bool deepCopyOps);
-    // Does not affect ownership of SkStream.
+    // Does not affect ownership of SkStream. If backing is not NULL, stream must be an
+    // SkMemoryStream over it, and large blocks (ops, pixels, paths) will share it.
     static SkPictureData* CreateFromStream(SkStream*,
                                            const SkPictInfo&,
-                                           SkPicture::InstallPixelRefProc);
+                                           SkPicture::InstallPixelRefProc,
+                                           SkData* backing = NULL);
     static SkPictureData* CreateFromBuffer(SkReadBuffer&, const SkPictInfo&);
 
     virtual ~SkPictureData();
@@ -81,7 +83,7 @@ protected:
     explicit SkPictureData(const SkPictInfo& info);
 
     // Does not affect ownership of SkStream.
-    bool parseStream(SkStream*, SkPicture::InstallPixelRefProc);
+    bool parseStream(SkStream*, SkPicture::InstallPixelRefProc, SkData* backing);
     bool parseBuffer(SkReadBuffer& buffer);
 
 public:
@@ -92,6 +94,9 @@ public:
 
     const SkPath& getPath(SkReader32* reader) const {
         int index = reader->readInt() - 1;
+        if (fLazyPaths.count() > 0) {
+            this->materializePath(index);
+        }
         return fPaths[index];
     }
 
@@ -138,7 +143,8 @@ private:
 
     // these help us with reading/writing
     // Does not affect ownership of SkStream.
-    bool parseStreamTag(SkStream*, uint32_t tag, uint32_t size, SkPicture::InstallPixelRefProc);
+    bool parseStreamTag(SkStream*, uint32_t tag, uint32_t size, SkPicture::InstallPixelRefProc,
+                        SkData* backing);
     bool parseBufferTag(SkReadBuffer&, uint32_t tag, uint32_t size);
     void flattenToBuffer(SkWriteBuffer&) const;
 
@@ -148,7 +154,16 @@ private:
 
     SkTArray<SkBitmap> fBitmaps;
     SkTArray<SkPaint>  fPaints;
-    SkTArray<SkPath>   fPaths;
+    // Paths read from an SKP stream are only unflattened from fBufferData on first use.
+    struct LazyPath {
+        const void* fData;  // NULL once materialized into fPaths
+        uint32_t    fSize;
+    };
+    void materializePath(int index) const;
+
+    mutable SkTArray<SkPath>   fPaths;
+    mutable SkTDArray<LazyPath> fLazyPaths;
+    SkAutoTUnref<SkData>        fBufferData;
 
     SkData* fOpData;    // opcodes and parameters
 
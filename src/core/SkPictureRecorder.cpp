@@ -41,7 +41,7 @@ SkCanvas* SkPictureRecorder::getRecordingCanvas() {
 
 SkPicture* SkPictureRecorder::endRecordingAsPicture() {
     // TODO: delay as much of this work until just before first playback?
-    SkRecordOptimize(fRecord);
+    SkRecordOptimize(fRecord, SkToBool(fFlags & kNoopOccludedDraws_RecordFlag));
 
     SkAutoTUnref<SkLayerInfo> saveLayerData;
 
@@ -159,7 +159,7 @@ protected:
 
 SkDrawable* SkPictureRecorder::endRecordingAsDrawable() {
     // TODO: delay as much of this work until just before first playback?
-    SkRecordOptimize(fRecord);
+    SkRecordOptimize(fRecord, SkToBool(fFlags & kNoopOccludedDraws_RecordFlag));
 
     if (fBBH.get()) {
         SkRecordFillBounds(fCullRect, *fRecord, fBBH.get());
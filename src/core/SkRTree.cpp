@@ -6,8 +6,19 @@
  */
 
 #include "SkRTree.h"
+#include "SkTSort.h"
 
-SkRTree::SkRTree(SkScalar aspectRatio) : fCount(0), fAspectRatio(aspectRatio) {}
+SkRTree::SkRTree(SkScalar aspectRatio, SkRTreeFactory::BulkLoad bulkLoad)
+    : fCount(0)
+    , fAspectRatio(aspectRatio)
+    , fBulkLoad(bulkLoad)
+    , fLeavesInOrder(true) {}
+
+SkRTree::~SkRTree() {
+    for (int i = 0; i < fUpdateNodes.count(); ++i) {
+        SkDELETE(fUpdateNodes[i]);
+    }
+}
 
 SkRect SkRTree::getRootBound() const {
     if (fCount) {
@@ -35,6 +46,10 @@ void SkRTree::insert(const SkRect boundsArray[], int N) {
     }
 
     fCount = branches.count();
+    if (SkRTreeFactory::kHilbert_BulkLoad == fBulkLoad && fCount > 1) {
+        HilbertSort(&branches);
+        fLeavesInOrder = false;
+    }
     if (fCount) {
         if (1 == fCount) {
             fNodes.setReserve(1);
@@ -44,7 +59,7 @@ void SkRTree::insert(const SkRect boundsArray[], int N) {
             fRoot.fSubtree = n;
             fRoot.fBounds  = branches[0].fBounds;
         } else {
-            fNodes.setReserve(CountNodes(fCount, fAspectRatio));
+            fNodes.setReserve(CountNodes(fCount, fAspectRatio, fBulkLoad));
             fRoot = this->bulkLoad(&branches);
         }
     }
@@ -59,8 +74,95 @@ SkRTree::Node* SkRTree::allocateNodeAtLevel(uint16_t level) {
     return out;
 }
 
+SkRTree::Node* SkRTree::allocateUpdateNode(uint16_t level) {
+    Node* out;
+    if (fFreeNodes.count() > 0) {
+        fFreeNodes.pop(&out);
+    } else {
+        out = SkNEW(Node);
+        fUpdateNodes.push(out);
+    }
+    out->fNumChildren = 0;
+    out->fLevel = level;
+    return out;
+}
+
+void SkRTree::freeNode(Node* node) {
+    // This may be a node from fNodes, which stays where it is until we're destroyed.
+    fFreeNodes.push(node);
+}
+
+// Maps (x, y) on an n x n grid, n a power of 2, to its distance along the Hilbert curve.
+static uint32_t hilbert_index(uint32_t n, uint32_t x, uint32_t y) {
+    uint32_t d = 0;
+    for (uint32_t s = n / 2; s > 0; s /= 2) {
+        uint32_t rx = (x & s) > 0,
+                 ry = (y & s) > 0;
+        d += s * s * ((3 * rx) ^ ry);
+        // Rotate the quadrant so the curve within it runs the canonical way.
+        if (0 == ry) {
+            if (1 == rx) {
+                x = s - 1 - (x & (s - 1));
+                y = s - 1 - (y & (s - 1));
+            }
+            SkTSwap(x, y);
+        }
+    }
+    return d;
+}
+
+namespace {
+struct HilbertBranch {
+    uint32_t fIndex;
+    int fOrder;     // Keeps the sort stable, so equal keys stay in op order.
+
+    bool operator<(const HilbertBranch& other) const {
+        return fIndex < other.fIndex || (fIndex == other.fIndex && fOrder < other.fOrder);
+    }
+};
+}  // namespace
+
+void SkRTree::HilbertSort(SkTDArray<Branch>* branches) {
+    static const uint32_t kGridSize = 1 << 16;
+
+    SkRect centers = SkRect::MakeEmpty();
+    for (int i = 0; i < branches->count(); ++i) {
+        const SkRect& r = (*branches)[i].fBounds;
+        centers.growToInclude(r.centerX(), r.centerY());
+    }
+    // Degenerate dimensions all map to 0.
+    SkScalar sx = centers.width()  > 0 ? (kGridSize - 1) / centers.width()  : 0,
+             sy = centers.height() > 0 ? (kGridSize - 1) / centers.height() : 0;
+
+    SkAutoTMalloc<HilbertBranch> keys(branches->count());
+    for (int i = 0; i < branches->count(); ++i) {
+        const SkRect& r = (*branches)[i].fBounds;
+        uint32_t x = SkScalarFloorToInt((r.centerX() - centers.fLeft) * sx),
+                 y = SkScalarFloorToInt((r.centerY() - centers.fTop)  * sy);
+        keys[i].fIndex = hilbert_index(kGridSize, SkTMin(x, kGridSize - 1),
+                                                  SkTMin(y, kGridSize - 1));
+        keys[i].fOrder = i;
+    }
+    SkTQSort(keys.get(), keys.get() + branches->count() - 1);
+
+    SkTDArray<Branch> sorted;
+    sorted.setCount(branches->count());
+    for (int i = 0; i < branches->count(); ++i) {
+        sorted[i] = (*branches)[keys[i].fOrder];
+    }
+    branches->swap(sorted);
+}
+
+int SkRTree::CountStrips(int branches, SkScalar aspectRatio, SkRTreeFactory::BulkLoad bulkLoad) {
+    // Hilbert sorted branches are already grouped by position, so we take them in runs.
+    if (SkRTreeFactory::kHilbert_BulkLoad == bulkLoad) {
+        return 1;
+    }
+    return SkScalarCeilToInt(SkScalarSqrt(SkIntToScalar(branches) / aspectRatio));
+}
+
 // This function parallels bulkLoad, but just counts how many nodes bulkLoad would allocate.
-int SkRTree::CountNodes(int branches, SkScalar aspectRatio) {
+int SkRTree::CountNodes(int branches, SkScalar aspectRatio, SkRTreeFactory::BulkLoad bulkLoad) {
     if (branches == 1) {
         return 1;
     }
@@ -74,7 +176,7 @@ int SkRTree::CountNodes(int branches, SkScalar aspectRatio) {
             remainder = kMinChildren - remainder;
         }
     }
-    int numStrips = SkScalarCeilToInt(SkScalarSqrt(SkIntToScalar(numBranches) / aspectRatio));
+    int numStrips = CountStrips(numBranches, aspectRatio, bulkLoad);
     int numTiles  = SkScalarCeilToInt(SkIntToScalar(numBranches) / SkIntToScalar(numStrips));
     int currentBranch = 0;
     int nodes = 0;
@@ -97,7 +199,7 @@ int SkRTree::CountNodes(int branches, SkScalar aspectRatio) {
             }
         }
     }
-    return nodes + CountNodes(nodes, aspectRatio);
+    return nodes + CountNodes(nodes, aspectRatio, bulkLoad);
 }
 
 SkRTree::Branch SkRTree::bulkLoad(SkTDArray<Branch>* branches, int level) {
@@ -122,7 +224,7 @@ SkRTree::Branch SkRTree::bulkLoad(SkTDArray<Branch>* branches, int level) {
         }
     }
 
-    int numStrips = SkScalarCeilToInt(SkScalarSqrt(SkIntToScalar(numBranches) / fAspectRatio));
+    int numStrips = CountStrips(numBranches, fAspectRatio, fBulkLoad);
     int numTiles  = SkScalarCeilToInt(SkIntToScalar(numBranches) / SkIntToScalar(numStrips));
     int currentBranch = 0;
 
@@ -163,7 +265,12 @@ SkRTree::Branch SkRTree::bulkLoad(SkTDArray<Branch>* branches, int level) {
 
 void SkRTree::search(const SkRect& query, SkTDArray<unsigned>* results) const {
     if (fCount > 0 && SkRect::Intersects(fRoot.fBounds, query)) {
+        int start = results->count();
         this->search(fRoot.fSubtree, query, results);
+        // Our callers expect ops in the order they were inserted.
+        if (!fLeavesInOrder && results->count() - start > 1) {
+            SkTQSort(results->begin() + start, results->end() - 1);
+        }
     }
 }
 
@@ -179,10 +286,283 @@ void SkRTree::search(Node* node, const SkRect& query, SkTDArray<unsigned>* resul
     }
 }
 
+SkRect SkRTree::ComputeBounds(const Node* node) {
+    SkASSERT(node->fNumChildren > 0);
+    SkRect bounds = node->fChildren[0].fBounds;
+    for (int i = 1; i < node->fNumChildren; ++i) {
+        bounds.join(node->fChildren[i].fBounds);
+    }
+    return bounds;
+}
+
+static SkScalar area(const SkRect& r) { return r.width() * r.height(); }
+
+// How much r would have to grow to also hold other.
+static SkScalar enlargement(const SkRect& r, const SkRect& other) {
+    SkRect joined = r;
+    joined.join(other);
+    return area(joined) - area(r);
+}
+
+void SkRTree::insert(unsigned opIndex, const SkRect& bounds) {
+    if (bounds.isEmpty()) {
+        return;
+    }
+
+    Branch branch;
+    branch.fBounds = bounds;
+    branch.fOpIndex = opIndex;
+    fLeavesInOrder = false;
+
+    if (0 == fCount) {
+        Node* n = this->allocateUpdateNode(0);
+        n->fNumChildren = 1;
+        n->fChildren[0] = branch;
+        fRoot.fSubtree = n;
+        fRoot.fBounds  = bounds;
+    } else {
+        this->insertAtLevel(branch, 0);
+    }
+    fCount++;
+}
+
+void SkRTree::insertAtLevel(const Branch& branch, int level) {
+    SkASSERT(level <= fRoot.fSubtree->fLevel);
+
+    Branch split;
+    if (this->insert(fRoot.fSubtree, branch, level, &split)) {
+        Node* root = this->allocateUpdateNode(fRoot.fSubtree->fLevel + 1);
+        root->fNumChildren = 2;
+        root->fChildren[0].fSubtree = fRoot.fSubtree;
+        root->fChildren[0].fBounds  = ComputeBounds(fRoot.fSubtree);
+        root->fChildren[1] = split;
+        fRoot.fSubtree = root;
+    }
+    fRoot.fBounds = ComputeBounds(fRoot.fSubtree);
+}
+
+bool SkRTree::insert(Node* node, const Branch& branch, int level, Branch* split) {
+    SkASSERT(node->fLevel >= level);
+    if (node->fLevel == level) {
+        return this->addChild(node, branch, split);
+    }
+
+    // Descend into the child which grows least to hold branch, or if that's a tie, the smallest.
+    int best = 0;
+    SkScalar bestEnlargement = SK_ScalarMax,
+             bestArea        = SK_ScalarMax;
+    for (int i = 0; i < node->fNumChildren; ++i) {
+        const SkRect& r = node->fChildren[i].fBounds;
+        SkScalar e = enlargement(r, branch.fBounds),
+                 a = area(r);
+        if (e < bestEnlargement || (e == bestEnlargement && a < bestArea)) {
+            best = i;
+            bestEnlargement = e;
+            bestArea = a;
+        }
+    }
+
+    Branch* child = &node->fChildren[best];
+    Branch childSplit;
+    if (this->insert(child->fSubtree, branch, level, &childSplit)) {
+        child->fBounds = ComputeBounds(child->fSubtree);
+        return this->addChild(node, childSplit, split);
+    }
+    child->fBounds.join(branch.fBounds);
+    return false;
+}
+
+bool SkRTree::addChild(Node* node, const Branch& branch, Branch* split) {
+    if (node->fNumChildren < kMaxChildren) {
+        node->fChildren[node->fNumChildren++] = branch;
+        return false;
+    }
+
+    // Quadratic split: seed two groups with the pair of branches that would waste the most area
+    // together, then hand out the rest one at a time, most decided first.
+    static const int kCount = kMaxChildren + 1;
+    Branch entries[kCount];
+    memcpy(entries, node->fChildren, kMaxChildren * sizeof(Branch));
+    entries[kMaxChildren] = branch;
+
+    int seedA = 0, seedB = 1;
+    SkScalar worst = -SK_ScalarMax;
+    for (int i = 0; i < kCount; ++i) {
+        for (int j = i + 1; j < kCount; ++j) {
+            SkScalar waste = enlargement(entries[i].fBounds, entries[j].fBounds)
+                           - area(entries[j].fBounds);
+            if (waste > worst) {
+                worst = waste;
+                seedA = i;
+                seedB = j;
+            }
+        }
+    }
+
+    Node* sibling = this->allocateUpdateNode(node->fLevel);
+    bool assigned[kCount] = { false };
+    assigned[seedA] = assigned[seedB] = true;
+    node->fNumChildren = 1;
+    node->fChildren[0] = entries[seedA];
+    sibling->fNumChildren = 1;
+    sibling->fChildren[0] = entries[seedB];
+    SkRect boundsA = entries[seedA].fBounds,
+           boundsB = entries[seedB].fBounds;
+
+    for (int remaining = kCount - 2; remaining > 0; --remaining) {
+        // If one group needs all the rest to reach kMinChildren, it gets them.
+        Node* forced = NULL;
+        if (node->fNumChildren + remaining <= kMinChildren) {
+            forced = node;
+        } else if (sibling->fNumChildren + remaining <= kMinChildren) {
+            forced = sibling;
+        }
+
+        int next = -1;
+        SkScalar dA = 0, dB = 0, mostDecided = -1;
+        for (int i = 0; i < kCount; ++i) {
+            if (assigned[i]) {
+                continue;
+            }
+            SkScalar eA = enlargement(boundsA, entries[i].fBounds),
+                     eB = enlargement(boundsB, entries[i].fBounds);
+            if (SkScalarAbs(eA - eB) > mostDecided) {
+                mostDecided = SkScalarAbs(eA - eB);
+                next = i;
+                dA = eA;
+                dB = eB;
+            }
+        }
+        SkASSERT(next >= 0);
+        assigned[next] = true;
+
+        Node* target = forced;
+        if (!target) {
+            if (dA != dB) {
+                target = dA < dB ? node : sibling;
+            } else if (area(boundsA) != area(boundsB)) {
+                target = area(boundsA) < area(boundsB) ? node : sibling;
+            } else {
+                target = node->fNumChildren <= sibling->fNumChildren ? node : sibling;
+            }
+        }
+        target->fChildren[target->fNumChildren++] = entries[next];
+        (target == node ? boundsA : boundsB).join(entries[next].fBounds);
+    }
+
+    split->fSubtree = sibling;
+    split->fBounds  = boundsB;
+    return true;
+}
+
+bool SkRTree::remove(unsigned opIndex, const SkRect& bounds) {
+    if (0 == fCount || !fRoot.fBounds.contains(bounds)) {
+        return false;
+    }
+
+    SkTDArray<Orphan> orphans;
+    if (!this->remove(fRoot.fSubtree, opIndex, bounds, &orphans)) {
+        return false;
+    }
+    fLeavesInOrder = false;
+
+    if (0 == --fCount) {
+        SkASSERT(orphans.isEmpty());
+        this->freeNode(fRoot.fSubtree);
+        return true;
+    }
+
+    // Put the orphans back, highest level first.
+    for (int i = 0; i < orphans.count(); ++i) {
+        this->insertAtLevel(orphans[i].fBranch, orphans[i].fLevel);
+    }
+
+    // Collapse any chain of single children at the top.
+    while (fRoot.fSubtree->fLevel > 0 && 1 == fRoot.fSubtree->fNumChildren) {
+        Node* oldRoot = fRoot.fSubtree;
+        fRoot.fSubtree = oldRoot->fChildren[0].fSubtree;
+        this->freeNode(oldRoot);
+    }
+    fRoot.fBounds = ComputeBounds(fRoot.fSubtree);
+    return true;
+}
+
+void SkRTree::RemoveChild(Node* node, int index) {
+    memmove(&node->fChildren[index], &node->fChildren[index + 1],
+            (node->fNumChildren - index - 1) * sizeof(Branch));
+    node->fNumChildren--;
+}
+
+bool SkRTree::remove(Node* node, unsigned opIndex, const SkRect& bounds,
+                     SkTDArray<Orphan>* orphans) {
+    for (int i = 0; i < node->fNumChildren; ++i) {
+        Branch* branch = &node->fChildren[i];
+        if (!branch->fBounds.contains(bounds)) {
+            continue;
+        }
+
+        if (0 == node->fLevel) {
+            if (branch->fOpIndex == opIndex) {
+                RemoveChild(node, i);
+                return true;
+            }
+            continue;
+        }
+
+        Node* child = branch->fSubtree;
+        int childOrphans = orphans->count();
+        if (!this->remove(child, opIndex, bounds, orphans)) {
+            continue;
+        }
+
+        if (0 == child->fNumChildren) {
+            this->freeNode(child);
+            RemoveChild(node, i);
+        } else if (child->fNumChildren < kMinChildren && node->fNumChildren > 1) {
+            // Dissolve the underfull child.  (An only child stays, so every level the orphans
+            // need remains reachable.)  Its branches go ahead of any orphaned from deeper down.
+            Orphan* o = orphans->insert(childOrphans, child->fNumChildren);
+            for (int j = 0; j < child->fNumChildren; ++j) {
+                o[j].fBranch = child->fChildren[j];
+                o[j].fLevel  = child->fLevel;
+            }
+            this->freeNode(child);
+            RemoveChild(node, i);
+        } else {
+            branch->fBounds = ComputeBounds(child);
+        }
+        return true;
+    }
+    return false;
+}
+
+SkScalar SkRTree::getFill() const {
+    if (0 == fCount) {
+        return 0;
+    }
+    int nodes = 0, children = 0;
+    SkTDArray<const Node*> stack;
+    stack.push(fRoot.fSubtree);
+    while (!stack.isEmpty()) {
+        const Node* node;
+        stack.pop(&node);
+        nodes++;
+        children += node->fNumChildren;
+        if (node->fLevel > 0) {
+            for (int i = 0; i < node->fNumChildren; ++i) {
+                stack.push(node->fChildren[i].fSubtree);
+            }
+        }
+    }
+    return SkIntToScalar(children) / (nodes * kMaxChildren);
+}
+
 size_t SkRTree::bytesUsed() const {
     size_t byteCount = sizeof(SkRTree);
 
     byteCount += fNodes.reserved() * sizeof(Node);
+    byteCount += fUpdateNodes.count() * sizeof(Node);
+    byteCount += (fUpdateNodes.reserved() + fFreeNodes.reserved()) * sizeof(Node*);
 
     return byteCount;
 }
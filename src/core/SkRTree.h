@@ -9,6 +9,7 @@
 #ifndef SkRTree_DEFINED
 #define SkRTree_DEFINED
 
+#include "SkBBHFactory.h"
 #include "SkBBoxHierarchy.h"
 #include "SkRect.h"
 #include "SkTDArray.h"
@@ -17,15 +18,20 @@
  * An R-Tree implementation. In short, it is a balanced n-ary tree containing a hierarchy of
  * bounding rectangles.
  *
- * It only supports bulk-loading, i.e. creation from a batch of bounding rectangles.
- * This performs a bottom-up bulk load using the STR (sort-tile-recursive) algorithm.
+ * It is usually created by bulk-loading, i.e. from a batch of bounding rectangles. This performs
+ * a bottom-up bulk load using either the STR (sort-tile-recursive) algorithm, or the Hilbert pack
+ * variant, which groups rects by the position of their centers on the Hilbert curve.
  *
- * TODO: Experiment with other bulk-load algorithms (in particular the Hilbert pack variant,
- * which groups rects by position on the Hilbert curve, is probably worth a look). There also
- * exist top-down bulk load variants (VAMSplit, TopDownGreedy, etc).
+ * Rects may then be added and removed one at a time, so that a long-lived hierarchy can follow
+ * changes without being rebuilt. These updates use Guttman's original algorithms (least
+ * enlargement to choose a leaf, quadratic split, and reinsertion to condense after removal).
+ *
+ * TODO: There also exist top-down bulk load variants (VAMSplit, TopDownGreedy, etc).
  *
  * For more details see:
  *
+ *  Guttman, A. (1984). "R-trees: a dynamic index structure for spatial searching"
+ *  Kamel, I.; Faloutsos, C. (1993). "On packing R-trees"
  *  Beckmann, N.; Kriegel, H. P.; Schneider, R.; Seeger, B. (1990). "The R*-tree:
  *      an efficient and robust access method for points and rectangles"
  */
@@ -38,19 +44,34 @@ public:
      * can provide an optional aspect ratio parameter. This allows the bulk-load algorithm to
      * create better proportioned tiles of rectangles.
      */
-    explicit SkRTree(SkScalar aspectRatio = 1);
-    virtual ~SkRTree() {}
+    explicit SkRTree(SkScalar aspectRatio = 1,
+                     SkRTreeFactory::BulkLoad = SkRTreeFactory::kSTR_BulkLoad);
+    virtual ~SkRTree();
 
     void insert(const SkRect[], int N) override;
     void search(const SkRect& query, SkTDArray<unsigned>* results) const override;
     size_t bytesUsed() const override;
 
+    /**
+     * Add one more rect, to be found as opIndex. Empty rects are ignored, as they are by the
+     * bulk insert(), which must come first if it is used at all.
+     */
+    void insert(unsigned opIndex, const SkRect& bounds);
+
+    /**
+     * Remove the rect added as opIndex. bounds must be the rect it was added with. Returns false
+     * if there was no such rect.
+     */
+    bool remove(unsigned opIndex, const SkRect& bounds);
+
     // Methods and constants below here are only public for tests.
 
     // Return the depth of the tree structure.
     int getDepth() const { return fCount ? fRoot.fSubtree->fLevel + 1 : 0; }
     // Insertion count (not overall node count, which may be greater).
     int getCount() const { return fCount; }
+    // The average number of children per node, over kMaxChildren.
+    SkScalar getFill() const;
 
     // Get the root bound.
     SkRect getRootBound() const override;
@@ -76,21 +97,59 @@ private:
         Branch fChildren[kMaxChildren];
     };
 
+    // A branch removed from a node, to be inserted again into some node at this level.
+    struct Orphan {
+        Branch fBranch;
+        int fLevel;
+    };
+
     void search(Node* root, const SkRect& query, SkTDArray<unsigned>* results) const;
 
     // Consumes the input array.
     Branch bulkLoad(SkTDArray<Branch>* branches, int level = 0);
 
+    // Sorts the branches by the position of their centers along the Hilbert curve.
+    static void HilbertSort(SkTDArray<Branch>* branches);
+
+    // How many strips bulkLoad() divides this many branches into.
+    static int CountStrips(int branches, SkScalar aspectRatio, SkRTreeFactory::BulkLoad);
+
     // How many times will bulkLoad() call allocateNodeAtLevel()?
-    static int CountNodes(int branches, SkScalar aspectRatio);
+    static int CountNodes(int branches, SkScalar aspectRatio, SkRTreeFactory::BulkLoad);
 
     Node* allocateNodeAtLevel(uint16_t level);
 
+    // Incremental updates allocate and free nodes here, rather than in fNodes.
+    Node* allocateUpdateNode(uint16_t level);
+    void freeNode(Node*);
+
+    // Adds branch to a node at level, growing a new root if the old one splits.
+    void insertAtLevel(const Branch& branch, int level);
+    // Adds branch below node, in a node at level. Returns true if node had to split, in which
+    // case split is set to the new sibling node.
+    bool insert(Node* node, const Branch& branch, int level, Branch* split);
+    // Adds branch to node itself. Returns true if node had to split, as above.
+    bool addChild(Node* node, const Branch& branch, Branch* split);
+
+    // Removes opIndex below node, moving the branches of nodes left with too few children to
+    // orphans. Returns false if opIndex was not found.
+    bool remove(Node* node, unsigned opIndex, const SkRect& bounds, SkTDArray<Orphan>* orphans);
+
+    static SkRect ComputeBounds(const Node*);
+    static void RemoveChild(Node*, int index);
+
     // This is the count of data elements (rather than total nodes in the tree)
     int fCount;
     SkScalar fAspectRatio;
+    SkRTreeFactory::BulkLoad fBulkLoad;
     Branch fRoot;
     SkTDArray<Node> fNodes;
+    // Nodes allocated by incremental updates, and those of them freed for reuse.
+    SkTDArray<Node*> fUpdateNodes;
+    SkTDArray<Node*> fFreeNodes;
+    // STR bulk loading keeps the leaves in op order, so search() finds ops in order. Once we
+    // Hilbert sort or update, search() must sort what it finds instead.
+    bool fLeavesInOrder;
 
     typedef SkBBoxHierarchy INHERITED;
 };
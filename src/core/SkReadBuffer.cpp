@@ -25,6 +25,7 @@ SkReadBuffer::SkReadBuffer() {
     fFlags = default_flags();
     fVersion = 0;
     fMemoryPtr = NULL;
+    fBackingData = NULL;
 
     fBitmapStorage = NULL;
     fTFArray = NULL;
@@ -44,6 +45,7 @@ SkReadBuffer::SkReadBuffer(const void* data, size_t size) {
     fVersion = 0;
     fReader.setMemory(data, size);
     fMemoryPtr = NULL;
+    fBackingData = NULL;
 
     fBitmapStorage = NULL;
     fTFArray = NULL;
@@ -65,6 +67,7 @@ SkReadBuffer::SkReadBuffer(SkStream* stream) {
     fMemoryPtr = sk_malloc_throw(length);
     stream->read(fMemoryPtr, length);
     fReader.setMemory(fMemoryPtr, length);
+    fBackingData = NULL;
 
     fBitmapStorage = NULL;
     fTFArray = NULL;
@@ -81,6 +84,7 @@ SkReadBuffer::SkReadBuffer(SkStream* stream) {
 
 SkReadBuffer::~SkReadBuffer() {
     sk_free(fMemoryPtr);
+    SkSafeUnref(fBackingData);
     SkSafeUnref(fBitmapStorage);
 }
 
@@ -169,6 +173,27 @@ bool SkReadBuffer::readByteArray(void* value, size_t size) {
     return readArray(static_cast<unsigned char*>(value), size, sizeof(unsigned char));
 }
 
+SkData* SkReadBuffer::readSharedByteArray(size_t size) {
+    if (NULL == fBackingData || this->isValidating()) {
+        SkAutoDataUnref data(SkData::NewUninitialized(size));
+        if (!this->readByteArray(data->writable_data(), size)) {
+            return NULL;
+        }
+        return data.detach();
+    }
+
+    if (this->getArrayCount() != size) {
+        SkASSERT(false);
+        fReader.skip(fReader.available());
+        return NULL;
+    }
+    (void)fReader.skip(sizeof(uint32_t)); // Skip array count
+    const char* bytes = (const char*)fReader.skip(SkAlign4(size));
+    const size_t offset = bytes - (const char*)fBackingData->data();
+    SkASSERT(bytes >= (const char*)fBackingData->data() && offset + size <= fBackingData->size());
+    return SkData::NewSubset(fBackingData, offset, size);
+}
+
 bool SkReadBuffer::readColorArray(SkColor* colors, size_t size) {
     return readArray(colors, size, sizeof(SkColor));
 }
@@ -56,6 +56,7 @@ public:
         kPictureImageFilterResolution_Version = 38,
         kPictureImageFilterLevel_Version   = 39,
         kImageFilterNoUniqueID_Version     = 40,
+        kMappableLayout_Version            = 41,
     };
 
     /**
@@ -157,6 +158,13 @@ public:
         return SkData::NewFromMalloc(buffer, len);
     }
 
+    /**
+     *  Reads a byte array of exactly size bytes into an SkData. If the buffer has backing data
+     *  (see setBackingData()) the result is a subset of it rather than a copy.
+     *  Returns NULL if the array could not be read.
+     */
+    SkData* readSharedByteArray(size_t size);
+
     // helpers to get info about arrays and binary data
     virtual uint32_t getArrayCount();
 
@@ -172,6 +180,14 @@ public:
         SkRefCnt_SafeAssign(fBitmapStorage, bitmapStorage);
     }
 
+    /**
+     *  Tells the buffer that the memory it reads from lies within data, so arrays read with
+     *  readSharedByteArray() can ref it instead of being copied. Ignored when validating.
+     */
+    void setBackingData(SkData* data) {
+        SkRefCnt_SafeAssign(fBackingData, data);
+    }
+
     void setTypefaceArray(SkTypeface* array[], int count) {
         fTFArray = array;
         fTFCount = count;
@@ -222,6 +238,7 @@ private:
     int fVersion;
 
     void* fMemoryPtr;
+    SkData* fBackingData;
 
     SkBitmapHeapReader* fBitmapStorage;
     SkTypeface** fTFArray;
@@ -5,6 +5,23 @@ SkRecord::~SkRecord() {
     for (unsigned i = 0; i < this->count(); i++) {
         this->mutate<void>(i, destroyer);
     }
+    for (PaintCopy* copy = fPaints; copy; copy = copy->fNext) {
+        copy->fPaint.~SkPaint();
+    }
+}
+
+const SkPaint* SkRecord::copyPaint(const SkPaint& paint) {
+    PaintCopy* copy = this->alloc<PaintCopy>();
+    SkNEW_PLACEMENT_ARGS(&copy->fPaint, SkPaint, (paint));
+    copy->fNext = fPaints;
+    fPaints = copy;
+    return &copy->fPaint;
+}
+
+const SkMatrix* SkRecord::copyMatrix(const SkMatrix& matrix) {
+    // SkMatrix is trivially destructible, so there's no need to track these.
+    return SkNEW_PLACEMENT_ARGS(this->alloc<SkRecords::TypedMatrix>(),
+                                SkRecords::TypedMatrix, (matrix));
 }
 
 void SkRecord::grow() {
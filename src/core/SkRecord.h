@@ -30,7 +30,11 @@ class SkRecord : public SkNVRefCnt<SkRecord> {
         kFirstReserveCount = 64 / sizeof(void*),
     };
 public:
-    SkRecord() : fCount(0), fReserved(0), fAlloc(8/*start block sizes at 256 bytes*/) {}
+    SkRecord()
+        : fCount(0)
+        , fReserved(0)
+        , fAlloc(8/*start block sizes at 256 bytes*/)
+        , fPaints(NULL) {}
     ~SkRecord();
 
     // Returns the number of canvas commands in this SkRecord.
@@ -65,6 +69,12 @@ public:
         return (T*)fAlloc.alloc(sizeof(T) * count, SK_MALLOC_THROW);
     }
 
+    // Copy a paint or matrix into this SkRecord, to live as long as it does.  Commands may share
+    // these copies through SkRecords::Shared; SkRecorder hands each distinct one to every command
+    // using it.  Throws on failure.
+    const SkPaint* copyPaint(const SkPaint&);
+    const SkMatrix* copyMatrix(const SkMatrix&);
+
     // Add a new command of type T to the end of this SkRecord.
     // You are expected to placement new an object of type T onto this pointer.
     template <typename T>
@@ -176,6 +186,12 @@ private:
     // Called when we've run out of room to record new commands.
     void grow();
 
+    // A paint from copyPaint(), in fAlloc.  We keep them in a list to destroy them.
+    struct PaintCopy {
+        SkPaint    fPaint;
+        PaintCopy* fNext;
+    };
+
     // An untyped pointer to some bytes in fAlloc.  This is the interface for polymorphic dispatch:
     // visit() and mutate() work with the parallel fTypes array to do the work of a vtable.
     struct Record {
@@ -229,9 +245,10 @@ private:
     SkAutoTMalloc<Record> fRecords;
     SkAutoTMalloc<Type8> fTypes;
     SkVarAlloc fAlloc;
+    PaintCopy* fPaints;
     // Strangely the order of these fields matters.  If the unsigneds don't go first we're 56 bytes.
     // tomhudson and mtklein have no idea why.
 };
-SK_COMPILE_ASSERT(sizeof(SkRecord) <= 56, SkRecordSize);
+SK_COMPILE_ASSERT(sizeof(SkRecord) <= 64, SkRecordSize);
 
 #endif//SkRecord_DEFINED
@@ -98,6 +98,7 @@ DRAW(DrawBitmapRectToRect,
 DRAW(DrawBitmapRectToRectBleed,
         drawBitmapRectToRect(r.bitmap.shallowCopy(), r.src, r.dst, r.paint,
                              SkCanvas::kBleed_DrawBitmapRectFlag));
+DRAW(DrawBitmapRects, drawBitmapRects(r.bitmap.shallowCopy(), r.src, r.dst, r.count, r.paint));
 DRAW(DrawDRRect, drawDRRect(r.outer, r.inner, r.paint));
 DRAW(DrawImage, drawImage(r.image, r.left, r.top, r.paint));
 DRAW(DrawImageRect, drawImageRect(r.image, r.src, r.dst, r.paint));
@@ -105,16 +106,17 @@ DRAW(DrawOval, drawOval(r.oval, r.paint));
 DRAW(DrawPaint, drawPaint(r.paint));
 DRAW(DrawPath, drawPath(r.path, r.paint));
 DRAW(DrawPatch, drawPatch(r.cubics, r.colors, r.texCoords, r.xmode, r.paint));
-DRAW(DrawPicture, drawPicture(r.picture, &r.matrix, r.paint));
+DRAW(DrawPicture, drawPicture(r.picture, r.matrix.get(), r.paint));
 DRAW(DrawPoints, drawPoints(r.mode, r.count, r.pts, r.paint));
 DRAW(DrawPosText, drawPosText(r.text, r.byteLength, r.pos, r.paint));
 DRAW(DrawPosTextH, drawPosTextH(r.text, r.byteLength, r.xpos, r.y, r.paint));
 DRAW(DrawRRect, drawRRect(r.rrect, r.paint));
 DRAW(DrawRect, drawRect(r.rect, r.paint));
+DRAW(DrawRects, drawRects(r.rects, r.count, r.paint));
 DRAW(DrawSprite, drawSprite(r.bitmap.shallowCopy(), r.left, r.top, r.paint));
 DRAW(DrawText, drawText(r.text, r.byteLength, r.x, r.y, r.paint));
 DRAW(DrawTextBlob, drawTextBlob(r.blob, r.x, r.y, r.paint));
-DRAW(DrawTextOnPath, drawTextOnPath(r.text, r.byteLength, r.path, &r.matrix, r.paint));
+DRAW(DrawTextOnPath, drawTextOnPath(r.text, r.byteLength, r.path, r.matrix.get(), r.paint));
 DRAW(DrawVertices, drawVertices(r.vmode, r.vertexCount, r.vertices, r.texs, r.colors,
                                 r.xmode.get(), r.indices, r.indexCount, r.paint));
 #undef DRAW
@@ -231,8 +233,8 @@ private:
 
     // Only Restore and SetMatrix change the CTM.
     template <typename T> void updateCTM(const T&) {}
-    void updateCTM(const Restore& op)   { fCTM = &op.matrix; }
-    void updateCTM(const SetMatrix& op) { fCTM = &op.matrix; }
+    void updateCTM(const Restore& op)   { fCTM = op.matrix.get(); }
+    void updateCTM(const SetMatrix& op) { fCTM = op.matrix.get(); }
 
     // Most ops don't change the clip.
     template <typename T> void updateClipBounds(const T&) {}
@@ -402,13 +404,20 @@ private:
         return rect;
     }
 
-    Bounds bounds(const DrawRect& op) const { return this->adjustAndMap(op.rect, &op.paint); }
-    Bounds bounds(const DrawOval& op) const { return this->adjustAndMap(op.oval, &op.paint); }
+    Bounds bounds(const DrawRect& op) const { return this->adjustAndMap(op.rect, op.paint.get()); }
+    Bounds bounds(const DrawRects& op) const {
+        Bounds bounds = Bounds::MakeEmpty();
+        for (int i = 0; i < op.count; i++) {
+            bounds.join(this->adjustAndMap(op.rects[i], op.paint.get()));
+        }
+        return bounds;
+    }
+    Bounds bounds(const DrawOval& op) const { return this->adjustAndMap(op.oval, op.paint.get()); }
     Bounds bounds(const DrawRRect& op) const {
-        return this->adjustAndMap(op.rrect.rect(), &op.paint);
+        return this->adjustAndMap(op.rrect.rect(), op.paint.get());
     }
     Bounds bounds(const DrawDRRect& op) const {
-        return this->adjustAndMap(op.outer.rect(), &op.paint);
+        return this->adjustAndMap(op.outer.rect(), op.paint.get());
     }
     Bounds bounds(const DrawImage& op) const {
         const SkImage* image = op.image;
@@ -425,6 +434,13 @@ private:
     Bounds bounds(const DrawBitmapRectToRectBleed& op) const {
         return this->adjustAndMap(op.dst, op.paint);
     }
+    Bounds bounds(const DrawBitmapRects& op) const {
+        Bounds bounds = Bounds::MakeEmpty();
+        for (int i = 0; i < op.count; i++) {
+            bounds.join(this->adjustAndMap(op.dst[i], op.paint));
+        }
+        return bounds;
+    }
     Bounds bounds(const DrawBitmapNine& op) const {
         return this->adjustAndMap(op.dst, op.paint);
     }
@@ -436,37 +452,37 @@ private:
 
     Bounds bounds(const DrawPath& op) const {
         return op.path.isInverseFillType() ? fCurrentClipBounds
-                                           : this->adjustAndMap(op.path.getBounds(), &op.paint);
+                                           : this->adjustAndMap(op.path.getBounds(), op.paint.get());
     }
     Bounds bounds(const DrawPoints& op) const {
         SkRect dst;
         dst.set(op.pts, op.count);
 
         // Pad the bounding box a little to make sure hairline points' bounds aren't empty.
-        SkScalar stroke = SkMaxScalar(op.paint.getStrokeWidth(), 0.01f);
+        SkScalar stroke = SkMaxScalar(op.paint->getStrokeWidth(), 0.01f);
         dst.outset(stroke/2, stroke/2);
 
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint.get());
     }
     Bounds bounds(const DrawPatch& op) const {
         SkRect dst;
         dst.set(op.cubics, SkPatchUtils::kNumCtrlPts);
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint.get());
     }
     Bounds bounds(const DrawVertices& op) const {
         SkRect dst;
         dst.set(op.vertices, op.vertexCount);
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint.get());
     }
 
     Bounds bounds(const DrawPicture& op) const {
         SkRect dst = op.picture->cullRect();
-        op.matrix.mapRect(&dst);
+        op.matrix->mapRect(&dst);
         return this->adjustAndMap(dst, op.paint);
     }
 
     Bounds bounds(const DrawPosText& op) const {
-        const int N = op.paint.countText(op.text, op.byteLength);
+        const int N = op.paint->countText(op.text, op.byteLength);
         if (N == 0) {
             return Bounds::MakeEmpty();
         }
@@ -474,10 +490,10 @@ private:
         SkRect dst;
         dst.set(op.pos, N);
         AdjustTextForFontMetrics(&dst, op.paint);
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint.get());
     }
     Bounds bounds(const DrawPosTextH& op) const {
-        const int N = op.paint.countText(op.text, op.byteLength);
+        const int N = op.paint->countText(op.text, op.byteLength);
         if (N == 0) {
             return Bounds::MakeEmpty();
         }
@@ -489,7 +505,7 @@ private:
         }
         SkRect dst = { left, op.y, right, op.y };
         AdjustTextForFontMetrics(&dst, op.paint);
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint.get());
     }
     Bounds bounds(const DrawTextOnPath& op) const {
         SkRect dst = op.path.getBounds();
@@ -504,13 +520,13 @@ private:
         SkASSERT(pad.fRight > pad.fBottom);
         dst.outset(pad.fRight, pad.fRight);
 
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint.get());
     }
 
     Bounds bounds(const DrawTextBlob& op) const {
         SkRect dst = op.blob->bounds();
         dst.offset(op.x, op.y);
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint.get());
     }
 
     Bounds bounds(const DrawDrawable& op) const {
@@ -9,11 +9,13 @@
 
 #include "SkRecordPattern.h"
 #include "SkRecords.h"
+#include "SkShader.h"
 #include "SkTDArray.h"
+#include "SkXfermode.h"
 
 using namespace SkRecords;
 
-void SkRecordOptimize(SkRecord* record) {
+void SkRecordOptimize(SkRecord* record, bool noopOccludedDraws) {
     // This might be useful  as a first pass in the future if we want to weed
     // out junk for other optimization passes.  Right now, nothing needs it,
     // and the bounding box hierarchy will do the work of skipping no-op
@@ -22,6 +24,14 @@ void SkRecordOptimize(SkRecord* record) {
 
     SkRecordNoopSaveLayerDrawRestores(record);
     SkRecordMergeSvgOpacityAndFilterLayers(record);
+
+    // Folding layers away above puts more draws in the same layer, where they can occlude.
+    if (noopOccludedDraws) {
+        SkRecordNoopOccludedDraws(record);
+    }
+
+    // Batch last, so draws between which others were just nooped can merge.
+    SkRecordBatchDraws(record);
 }
 
 // Most of the optimizations in this file are pattern-based.  These are all defined as structs with:
@@ -115,6 +125,29 @@ static bool fold_opacity_layer_color_to_paint(const SkPaint& layerPaint,
     return true;
 }
 
+// Gives a draw a new paint.  Draws may share their paints with others, so we can't edit those.
+class DrawPaintSetter {
+    SK_CREATE_MEMBER_DETECTOR(paint);
+public:
+    DrawPaintSetter(SkRecord* record, const SkPaint& paint) : fRecord(record), fPaint(paint) {}
+
+    template <typename T>
+    SK_WHEN(HasMember_paint<T>, void) operator()(T* draw) { this->set(&draw->paint); }
+
+    template <typename T>
+    SK_WHEN(!HasMember_paint<T>, void) operator()(T*) { SkDEBUGFAIL("Not a draw."); }
+
+private:
+    void set(Shared<SkPaint>* paint) { *paint = fRecord->copyPaint(fPaint); }
+    void set(Optional<SkPaint>* paint) {
+        SkASSERT(*paint);
+        **paint = fPaint;
+    }
+
+    SkRecord* fRecord;
+    const SkPaint& fPaint;
+};
+
 // Turns logical no-op Save-[non-drawing command]*-Restore patterns into actual no-ops.
 struct SaveNoDrawsRestoreNooper {
     // Star matches greedily, so we also have to exclude Save and Restore.
@@ -156,16 +189,19 @@ struct SaveLayerDrawRestoreNooper {
             return KillSaveLayerAndRestore(record, begin);
         }
 
-        SkPaint* drawPaint = pattern->second<SkPaint>();
+        const SkPaint* drawPaint = pattern->second<const SkPaint>();
         if (drawPaint == NULL) {
             // We can just give the draw the SaveLayer's paint.
             // TODO(mtklein): figure out how to do this clearly
             return false;
         }
 
-        if (!fold_opacity_layer_color_to_paint(*layerPaint, false /*isSaveLayer*/, drawPaint)) {
+        SkPaint foldedPaint(*drawPaint);
+        if (!fold_opacity_layer_color_to_paint(*layerPaint, false /*isSaveLayer*/, &foldedPaint)) {
             return false;
         }
+        DrawPaintSetter setter(record, foldedPaint);
+        record->mutate<void>(begin+1, setter);
 
         return KillSaveLayerAndRestore(record, begin);
     }
@@ -230,3 +266,501 @@ void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord* record) {
     SvgOpacityAndFilterLayerMergePass pass;
     apply(&pass, record);
 }
+
+// Does drawing an opaque src with this paint replace what's underneath, no matter what it was?
+static bool paint_replaces_dst(const SkPaint* paint) {
+    if (NULL == paint) {
+        return true;
+    }
+    if (0xFF != paint->getAlpha() ||
+        paint->getColorFilter()   ||
+        paint->getMaskFilter()    ||
+        paint->getPathEffect()    ||
+        paint->getRasterizer()    ||
+        paint->getLooper()        ||
+        paint->getImageFilter()) {
+        return false;
+    }
+    SkXfermode::Mode mode;
+    return NULL == paint->getXfermode()
+        || (SkXfermode::AsMode(paint->getXfermode(), &mode) &&
+            (SkXfermode::kSrcOver_Mode == mode || SkXfermode::kSrc_Mode == mode));
+}
+
+// Is every pixel a fill with this paint covers opaque, whatever was underneath?
+static bool is_opaque_fill(const SkPaint& paint) {
+    return SkPaint::kFill_Style == paint.getStyle()
+        && (NULL == paint.getShader() || paint.getShader()->isOpaque())
+        && paint_replaces_dst(&paint);
+}
+
+// A rect inside rrect, clear of its corners: the larger of the two bands between them.
+static SkRect rrect_inner_rect(const SkRRect& rrect) {
+    const SkRect& r = rrect.rect();
+    SkVector ul = rrect.radii(SkRRect::kUpperLeft_Corner),
+             ur = rrect.radii(SkRRect::kUpperRight_Corner),
+             lr = rrect.radii(SkRRect::kLowerRight_Corner),
+             ll = rrect.radii(SkRRect::kLowerLeft_Corner);
+    SkRect wide = SkRect::MakeLTRB(r.fLeft,  r.fTop    + SkTMax(ul.fY, ur.fY),
+                                   r.fRight, r.fBottom - SkTMax(ll.fY, lr.fY)),
+           tall = SkRect::MakeLTRB(r.fLeft  + SkTMax(ul.fX, ll.fX), r.fTop,
+                                   r.fRight - SkTMax(ur.fX, lr.fX), r.fBottom);
+    return wide.width() * wide.height() > tall.width() * tall.height() ? wide : tall;
+}
+
+// Finds draws a later draw paints right over, whatever matrix the picture is played back with.
+//
+// A draw is occluded by a later draw of an opaque paint with a SrcOver or Src xfermode, which must
+// be a rect, rrect, opaque bitmap or image, or a paint filling the clip.  Draws in between don't
+// matter, as none can see past its own pixels.  We only compare draws under the same matrix and
+// clip in the same layer, though maybe across a Save/Restore that changed neither between them.
+// Then containment can be tested in local space, where it holds under any matrix.  Pixels are
+// another matter:
+//   - An aliased fill of a rect touches just the pixels an aliased fill of the same rect does.
+//   - Otherwise the two draws' edges may round, or anti-alias, to different pixels.  So the later
+//     draw must reach kMarginPixels, at the recording's scale, past everything the earlier draw
+//     might touch.  That holds under any translate or rotation, or when scaling up, but not when
+//     scaling down, which is why SkRecordOptimize() only runs this pass when asked.
+//   - Pixels on an anti-aliased clip's edge are blended with what's underneath, so nothing is
+//     occluded under one.
+class OccludedDrawNooper : SkNoncopyable {
+public:
+    explicit OccludedDrawNooper(SkRecord* record)
+        : fRecord(record)
+        , fCTM(&SkMatrix::I())
+        , fState(0)
+        , fNextState(1)
+        , fAAClip(false) {}
+
+    void setCurrentOp(unsigned currentOp) { fCurrentOp = currentOp; }
+
+    template <typename T> void operator()(const T& op) {
+        Cover cover;
+        if (!fAAClip && this->covers(op, &cover)) {
+            this->occlude(cover);
+        }
+        Candidate c;
+        if (this->bounds(op, &c)) {
+            c.fIndex = fCurrentOp;
+            c.fState = fState;
+            *fCandidates.append() = c;
+        }
+    }
+
+    // A Save changes nothing by itself, so draws on either side of it can still occlude.
+    void operator()(const SkRecords::Save&) { this->save(); }
+    void operator()(const SkRecords::SaveLayer&) {
+        this->save();
+        this->changeState();
+    }
+    void operator()(const SkRecords::Restore& op) {
+        fCTM = op.matrix.get();
+        if (fSaveStack.isEmpty()) {
+            this->changeState();
+            return;
+        }
+        SaveRec rec;
+        fSaveStack.pop(&rec);
+        fState = rec.fState;
+        fAAClip = rec.fAAClip;
+        // Draws under the states since the save can never be occluded again.
+        this->dropCandidates(rec.fFirstNewState);
+    }
+    void operator()(const SkRecords::SetMatrix& op) {
+        fCTM = op.matrix.get();
+        this->changeState();
+    }
+
+    void operator()(const SkRecords::ClipRect& op)   { this->updateClip(op.opAA.aa); }
+    void operator()(const SkRecords::ClipRRect& op)  { this->updateClip(op.opAA.aa); }
+    void operator()(const SkRecords::ClipPath& op)   { this->updateClip(op.opAA.aa); }
+    void operator()(const SkRecords::ClipRegion&)    { this->updateClip(false); }
+
+private:
+    // How far past an earlier draw, in pixels at the recording's scale, a later one must reach.
+    // Either may anti-alias its edges, touching pixels up to a diagonal away; round that up.
+    static const int kMarginPixels = 2;
+
+    struct Cover {
+        SkRect fRect;           // In local space, unless fFillsClip.
+        bool   fFillsClip;
+        bool   fAntiAlias;
+    };
+
+    struct Candidate {
+        unsigned fIndex;
+        unsigned fState;        // The matrix, clip and layer it was drawn under.
+        SkRect   fBounds;       // In local space, unless fFillsClip.
+        bool     fFillsClip;
+        bool     fAliasedRect;  // An aliased fill of exactly fBounds.
+        bool     fHairline;     // May touch pixels a little past fBounds.
+    };
+
+    // What a Restore returns to.
+    struct SaveRec {
+        unsigned fState;
+        unsigned fFirstNewState;  // Every state made since the save is at least this.
+        bool     fAAClip;
+    };
+
+    void save() {
+        SaveRec* rec = fSaveStack.append();
+        rec->fState = fState;
+        rec->fFirstNewState = fNextState;
+        rec->fAAClip = fAAClip;
+    }
+
+    // Draws under the new matrix, clip or layer can't occlude any draw so far.  Draws under the
+    // old state can only be occluded again once a Restore returns to it, so unless it's what the
+    // last Save saved, we're done with them.
+    void changeState() {
+        if (fSaveStack.isEmpty() || fSaveStack.top().fState != fState) {
+            this->dropCandidates(fState);
+        }
+        fState = fNextState++;
+    }
+
+    void dropCandidates(unsigned firstState) {
+        for (int i = fCandidates.count() - 1; i >= 0; i--) {
+            if (fCandidates[i].fState >= firstState) {
+                fCandidates.remove(i);
+            }
+        }
+    }
+
+    void updateClip(bool aa) {
+        fAAClip = fAAClip || aa;
+        this->changeState();
+    }
+
+    bool occludes(const Cover& cover, const Candidate& c) const {
+        if (cover.fFillsClip) {
+            return true;
+        }
+        if (c.fFillsClip || fCTM->hasPerspective()) {
+            return false;
+        }
+        if (c.fAliasedRect && !cover.fAntiAlias && c.fBounds == cover.fRect) {
+            return true;
+        }
+        const SkScalar scale = fCTM->getMinScale();
+        if (!(scale > 0)) {
+            return false;
+        }
+        const SkScalar margin = SkIntToScalar(kMarginPixels + (c.fHairline ? 1 : 0)) / scale;
+        SkRect bounds = c.fBounds;
+        bounds.outset(margin, margin);
+        return cover.fRect.contains(bounds);
+    }
+
+    // Kill earlier draws that cover paints right over.
+    void occlude(const Cover& cover) {
+        // This search makes the pass quadratic, so we only look back so far.  The repainted
+        // backgrounds we're after are almost always close to what covers them.
+        static const int kMaxCandidatesSearched = 128;
+        int stop = SkTMax(0, fCandidates.count() - kMaxCandidatesSearched);
+        for (int i = fCandidates.count() - 1; i >= stop; i--) {
+            if (fCandidates[i].fState == fState && this->occludes(cover, fCandidates[i])) {
+                fRecord->replace<SkRecords::NoOp>(fCandidates[i].fIndex);
+                fCandidates.remove(i);
+            }
+        }
+    }
+
+    static bool IsAntiAlias(const SkPaint* paint) {
+        return paint && paint->isAntiAlias();
+    }
+
+    bool covers(const SkRect& rect, const SkPaint* paint, Cover* cover) const {
+        if (!rect.isFinite() || rect.isEmpty()) {
+            return false;
+        }
+        cover->fRect = rect;
+        cover->fFillsClip = false;
+        cover->fAntiAlias = IsAntiAlias(paint);
+        return true;
+    }
+
+    bool bounds(const SkRect& rect, const SkPaint* paint, Candidate* c) const {
+        SkRect r = rect;
+        r.sort();
+        if (paint) {
+            // Path effects may draw anywhere, whatever computeFastBounds() says.
+            if (!paint->canComputeFastBounds() || paint->getPathEffect()) {
+                return false;
+            }
+            SkRect storage;
+            r = paint->computeFastBounds(r, &storage);
+        }
+        c->fBounds = r;
+        c->fFillsClip = false;
+        c->fAliasedRect = false;
+        c->fHairline = paint && SkPaint::kFill_Style != paint->getStyle()
+                             && 0 == paint->getStrokeWidth();
+        return r.isFinite();
+    }
+
+    template <typename T> bool covers(const T&, Cover*) const { return false; }
+    template <typename T> bool bounds(const T&, Candidate*) const { return false; }
+
+    bool covers(const SkRecords::DrawPaint& op, Cover* cover) const {
+        cover->fFillsClip = true;
+        return is_opaque_fill(op.paint);
+    }
+    bool covers(const SkRecords::DrawRect& op, Cover* cover) const {
+        return is_opaque_fill(op.paint) && this->covers(op.rect, op.paint.get(), cover);
+    }
+    bool covers(const SkRecords::DrawRRect& op, Cover* cover) const {
+        return is_opaque_fill(op.paint)
+            && this->covers(rrect_inner_rect(op.rrect), op.paint.get(), cover);
+    }
+    bool covers(const SkRecords::DrawBitmap& op, Cover* cover) const {
+        SkRect dst = SkRect::MakeXYWH(op.left, op.top,
+                                      SkIntToScalar(op.bitmap.width()),
+                                      SkIntToScalar(op.bitmap.height()));
+        return op.bitmap.isOpaque() && paint_replaces_dst(op.paint)
+            && this->covers(dst, op.paint, cover);
+    }
+    bool covers(const SkRecords::DrawBitmapRectToRect& op, Cover* cover) const {
+        return this->coversWithBitmap(op.bitmap, op.src, op.paint, op.dst, cover);
+    }
+    bool covers(const SkRecords::DrawBitmapRectToRectBleed& op, Cover* cover) const {
+        return this->coversWithBitmap(op.bitmap, op.src, op.paint, op.dst, cover);
+    }
+    bool covers(const SkRecords::DrawImage& op, Cover* cover) const {
+        SkRect dst = SkRect::MakeXYWH(op.left, op.top,
+                                      SkIntToScalar(op.image->width()),
+                                      SkIntToScalar(op.image->height()));
+        return op.image->isOpaque() && paint_replaces_dst(op.paint)
+            && this->covers(dst, op.paint, cover);
+    }
+    bool covers(const SkRecords::DrawImageRect& op, Cover* cover) const {
+        // A src reaching outside the image would shrink dst to match.
+        SkRect bounds = SkRect::MakeIWH(op.image->width(), op.image->height());
+        return op.image->isOpaque()
+            && (NULL == op.src || bounds.contains(*op.src))
+            && paint_replaces_dst(op.paint)
+            && this->covers(op.dst, op.paint, cover);
+    }
+
+    bool coversWithBitmap(const SkRecords::ImmutableBitmap& bitmap, const SkRect* src,
+                          const SkPaint* paint, const SkRect& dst, Cover* cover) const {
+        // A src reaching outside the bitmap would shrink dst to match.
+        SkRect bounds = SkRect::MakeIWH(bitmap.width(), bitmap.height());
+        return bitmap.isOpaque()
+            && (NULL == src || bounds.contains(*src))
+            && paint_replaces_dst(paint)
+            && this->covers(dst, paint, cover);
+    }
+
+    bool bounds(const SkRecords::DrawPaint&, Candidate* c) const {
+        c->fFillsClip = true;
+        return true;
+    }
+    bool bounds(const SkRecords::DrawRect& op, Candidate* c) const {
+        const SkPaint& paint = *op.paint.get();
+        if (!this->bounds(op.rect, &paint, c)) {
+            return false;
+        }
+        c->fAliasedRect = SkPaint::kFill_Style == paint.getStyle() && !paint.isAntiAlias()
+                       && NULL == paint.getMaskFilter() && NULL == paint.getLooper()
+                       && NULL == paint.getImageFilter();
+        return true;
+    }
+    bool bounds(const SkRecords::DrawOval& op, Candidate* c) const {
+        return this->bounds(op.oval, op.paint.get(), c);
+    }
+    bool bounds(const SkRecords::DrawRRect& op, Candidate* c) const {
+        return this->bounds(op.rrect.rect(), op.paint.get(), c);
+    }
+    bool bounds(const SkRecords::DrawDRRect& op, Candidate* c) const {
+        return this->bounds(op.outer.rect(), op.paint.get(), c);
+    }
+    bool bounds(const SkRecords::DrawPath& op, Candidate* c) const {
+        return !op.path.isInverseFillType()
+            && this->bounds(op.path.getBounds(), op.paint.get(), c);
+    }
+    bool bounds(const SkRecords::DrawBitmap& op, Candidate* c) const {
+        SkRect dst = SkRect::MakeXYWH(op.left, op.top,
+                                      SkIntToScalar(op.bitmap.width()),
+                                      SkIntToScalar(op.bitmap.height()));
+        return this->bounds(dst, op.paint, c);
+    }
+    bool bounds(const SkRecords::DrawBitmapRectToRect& op, Candidate* c) const {
+        return this->bounds(op.dst, op.paint, c);
+    }
+    bool bounds(const SkRecords::DrawBitmapRectToRectBleed& op, Candidate* c) const {
+        return this->bounds(op.dst, op.paint, c);
+    }
+    bool bounds(const SkRecords::DrawBitmapNine& op, Candidate* c) const {
+        return this->bounds(op.dst, op.paint, c);
+    }
+    bool bounds(const SkRecords::DrawImage& op, Candidate* c) const {
+        SkRect dst = SkRect::MakeXYWH(op.left, op.top,
+                                      SkIntToScalar(op.image->width()),
+                                      SkIntToScalar(op.image->height()));
+        return this->bounds(dst, op.paint, c);
+    }
+    bool bounds(const SkRecords::DrawImageRect& op, Candidate* c) const {
+        return this->bounds(op.dst, op.paint, c);
+    }
+
+    SkRecord* fRecord;
+    unsigned fCurrentOp;
+    const SkMatrix* fCTM;
+    unsigned fState;
+    unsigned fNextState;
+    bool fAAClip;
+    SkTDArray<SaveRec> fSaveStack;
+    SkTDArray<Candidate> fCandidates;
+};
+
+void SkRecordNoopOccludedDraws(SkRecord* record) {
+    OccludedDrawNooper pass(record);
+    for (unsigned i = 0; i < record->count(); i++) {
+        pass.setCurrentOp(i);
+        record->visit<void>(i, pass);
+    }
+}
+
+// Merges runs of DrawRect with one paint into DrawRects, and runs of DrawBitmapRectToRect from
+// one bitmap with equal paints into DrawBitmapRects, so devices can set up for each run once.
+// Only NoOps may come between the draws of a run: anything else might change the matrix or clip,
+// or draw in between.
+class DrawBatcher : SkNoncopyable {
+public:
+    explicit DrawBatcher(SkRecord* record) : fRecord(record) {}
+
+    // Returns the index just past the run starting at i, having batched it if it was one.
+    unsigned batchRun(unsigned i) {
+        Is<DrawRect> rect;
+        if (fRecord->mutate<bool>(i, rect)) {
+            return this->batchRects(i, rect.get());
+        }
+        Is<DrawBitmapRectToRect> bitmapRect;
+        if (fRecord->mutate<bool>(i, bitmapRect)) {
+            return this->batchBitmapRects(i, bitmapRect.get());
+        }
+        return i + 1;
+    }
+
+private:
+    // Loopers and image filters make canvases draw batches one at a time anyway.
+    static bool CanBatch(const SkPaint* paint) {
+        return !paint || (!paint->getLooper() && !paint->getImageFilter());
+    }
+
+    static bool SameBitmap(const SkBitmap& a, const SkBitmap& b) {
+        return a.pixelRef() == b.pixelRef() &&
+               a.pixelRefOrigin() == b.pixelRefOrigin() &&
+               a.width() == b.width() &&
+               a.height() == b.height();
+    }
+
+    static bool SamePaint(const SkPaint* a, const SkPaint* b) {
+        return a == b || (a && b && *a == *b);
+    }
+
+    // Collects the indices of the run started by first at i, returning the index just past it.
+    template <typename T, typename Matches>
+    unsigned collect(unsigned i, Matches matches) {
+        fRun.rewind();
+        *fRun.append() = i;
+        unsigned end = i + 1;
+        for (unsigned j = i + 1; j < fRecord->count(); j++) {
+            Is<NoOp> noop;
+            if (fRecord->mutate<bool>(j, noop)) {
+                continue;
+            }
+            Is<T> next;
+            if (!fRecord->mutate<bool>(j, next) || !matches(*next.get())) {
+                break;
+            }
+            *fRun.append() = j;
+            end = j + 1;
+        }
+        return end;
+    }
+
+    unsigned batchRects(unsigned i, DrawRect* first) {
+        const SkPaint* paint = first->paint.get();
+        if (!CanBatch(paint)) {
+            return i + 1;
+        }
+        // Interned paints are equal exactly when they're the same paint.
+        struct SamePaintAs {
+            bool operator()(const DrawRect& op) const { return op.paint.get() == fPaint; }
+            const SkPaint* fPaint;
+        } matches = { paint };
+        unsigned end = this->collect<DrawRect>(i, matches);
+
+        const int count = fRun.count();
+        if (count < 2) {
+            return end;
+        }
+        SkRect* rects = fRecord->alloc<SkRect>(count);
+        for (int k = 0; k < count; k++) {
+            Is<DrawRect> op;
+            SkAssertResult(fRecord->mutate<bool>(fRun[k], op));
+            rects[k] = op.get()->rect;
+        }
+        this->noopRun();
+        SkNEW_PLACEMENT_ARGS(fRecord->replace<DrawRects>(i), DrawRects, (paint, count, rects));
+        return end;
+    }
+
+    unsigned batchBitmapRects(unsigned i, DrawBitmapRectToRect* first) {
+        const SkPaint* paint = first->paint;
+        if (!CanBatch(paint)) {
+            return i + 1;
+        }
+        const SkBitmap bitmap = first->bitmap.shallowCopy();
+        struct SameBitmapAndPaintAs {
+            bool operator()(const DrawBitmapRectToRect& op) const {
+                return SamePaint(op.paint, fPaint) && SameBitmap(op.bitmap.shallowCopy(), fBitmap);
+            }
+            const SkPaint* fPaint;
+            const SkBitmap& fBitmap;
+        } matches = { paint, bitmap };
+        unsigned end = this->collect<DrawBitmapRectToRect>(i, matches);
+
+        const int count = fRun.count();
+        if (count < 2) {
+            return end;
+        }
+        SkRect* src = fRecord->alloc<SkRect>(count);
+        SkRect* dst = fRecord->alloc<SkRect>(count);
+        for (int k = 0; k < count; k++) {
+            Is<DrawBitmapRectToRect> op;
+            SkAssertResult(fRecord->mutate<bool>(fRun[k], op));
+            const SkRect* opSrc = op.get()->src;
+            src[k] = opSrc ? *opSrc : SkRect::MakeIWH(bitmap.width(), bitmap.height());
+            dst[k] = op.get()->dst;
+        }
+        // Replacing the first op destroys its paint, so the batch needs its own copy.
+        SkPaint* batchPaint = paint ? SkNEW_PLACEMENT_ARGS(fRecord->alloc<SkPaint>(), SkPaint,
+                                                           (*paint))
+                                    : NULL;
+        this->noopRun();
+        SkNEW_PLACEMENT_ARGS(fRecord->replace<DrawBitmapRects>(i), DrawBitmapRects,
+                             (batchPaint, bitmap, count, src, dst));
+        return end;
+    }
+
+    // NoOps all but the first op of the run, which the caller replaces with the batch.
+    void noopRun() {
+        for (int k = 1; k < fRun.count(); k++) {
+            fRecord->replace<NoOp>(fRun[k]);
+        }
+    }
+
+    SkRecord* fRecord;
+    SkTDArray<unsigned> fRun;
+};
+
+void SkRecordBatchDraws(SkRecord* record) {
+    DrawBatcher pass(record);
+    for (unsigned i = 0; i < record->count();) {
+        i = pass.batchRun(i);
+    }
+}
@@ -10,8 +10,9 @@
 
 #include "SkRecord.h"
 
-// Run all optimizations in recommended order.
-void SkRecordOptimize(SkRecord*);
+// Run all optimizations in recommended order.  Nooping occluded draws is only safe for some
+// playback (see SkRecordNoopOccludedDraws), so callers must ask for it.
+void SkRecordOptimize(SkRecord*, bool noopOccludedDraws = false);
 
 // Turns logical no-op Save-[non-drawing command]*-Restore patterns into actual no-ops.
 void SkRecordNoopSaveRestores(SkRecord*);
@@ -24,4 +25,13 @@ void SkRecordNoopSaveLayerDrawRestores(SkRecord*);
 // the alpha of the first SaveLayer to the second SaveLayer.
 void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord*);
 
+// Turns draws into no-ops when a later opaque draw under the same matrix and clip, in the same
+// layer, is sure to cover every pixel they could touch.  That holds when the record is played
+// back with no anti-aliased clip and a matrix that doesn't scale it down.
+void SkRecordNoopOccludedDraws(SkRecord*);
+
+// Merges runs of DrawRect sharing a paint, and of DrawBitmapRectToRect sharing a bitmap and paint,
+// into single DrawRects and DrawBitmapRects ops.
+void SkRecordBatchDraws(SkRecord*);
+
 #endif//SkRecordOpts_DEFINED
@@ -6,6 +6,7 @@
  */
 
 #include "SkRecorder.h"
+#include "SkChecksum.h"
 #include "SkPatchUtils.h"
 #include "SkPicture.h"
 
@@ -41,9 +42,35 @@ SkRecorder::SkRecorder(SkRecord* record, const SkRect& bounds)
 
 void SkRecorder::forgetRecord() {
     fDrawableList.reset(NULL);
+    fPaints.reset();
+    fMatrices.reset();
     fRecord = NULL;
 }
 
+uint32_t SkRecorder::MatrixTraits::Hash(const SkMatrix& matrix) {
+    SkScalar values[9];
+    matrix.get9(values);
+    return SkChecksum::Murmur3(values, sizeof(values));
+}
+
+const SkPaint* SkRecorder::intern(const SkPaint& paint) {
+    const SkPaint* shared = fPaints.find(paint);
+    if (NULL == shared) {
+        shared = fRecord->copyPaint(paint);
+        fPaints.add(const_cast<SkPaint*>(shared));
+    }
+    return shared;
+}
+
+const SkMatrix* SkRecorder::intern(const SkMatrix& matrix) {
+    const SkMatrix* shared = fMatrices.find(matrix);
+    if (NULL == shared) {
+        shared = fRecord->copyMatrix(matrix);
+        fMatrices.add(const_cast<SkMatrix*>(shared));
+    }
+    return shared;
+}
+
 // To make appending to fRecord a little less verbose.
 #define APPEND(T, ...) \
         SkNEW_PLACEMENT_ARGS(fRecord->append<SkRecords::T>(), SkRecords::T, (__VA_ARGS__))
@@ -57,9 +84,10 @@ void SkRecorder::forgetRecord() {
 // non-trivial copy constructors, we skip the first copy (and its destruction) by wrapping the value
 // with delay_copy(), forcing the argument to be passed by const&.
 //
-// This is used below for SkBitmap, SkPaint, SkPath, and SkRegion, which all have non-trivial copy
+// This is used below for SkBitmap, SkPath, and SkRegion, which all have non-trivial copy
 // constructors and destructors.  You'll know you've got a good candidate T if you see ~T() show up
-// unexpectedly on a profile of record time.  Otherwise don't bother.
+// unexpectedly on a profile of record time.  Otherwise don't bother.  (SkPaint and SkMatrix
+// aren't copied per command at all: see intern().)
 template <typename T>
 class Reference {
 public:
@@ -117,30 +145,34 @@ char* SkRecorder::copy(const char* src) {
 
 
 void SkRecorder::onDrawPaint(const SkPaint& paint) {
-    APPEND(DrawPaint, delay_copy(paint));
+    APPEND(DrawPaint, this->intern(paint));
 }
 
 void SkRecorder::onDrawPoints(PointMode mode,
                               size_t count,
                               const SkPoint pts[],
                               const SkPaint& paint) {
-    APPEND(DrawPoints, delay_copy(paint), mode, SkToUInt(count), this->copy(pts, count));
+    APPEND(DrawPoints, this->intern(paint), mode, SkToUInt(count), this->copy(pts, count));
 }
 
 void SkRecorder::onDrawRect(const SkRect& rect, const SkPaint& paint) {
-    APPEND(DrawRect, delay_copy(paint), rect);
+    APPEND(DrawRect, this->intern(paint), rect);
+}
+
+void SkRecorder::onDrawRects(const SkRect rects[], int count, const SkPaint& paint) {
+    APPEND(DrawRects, this->intern(paint), count, this->copy(rects, count));
 }
 
 void SkRecorder::onDrawOval(const SkRect& oval, const SkPaint& paint) {
-    APPEND(DrawOval, delay_copy(paint), oval);
+    APPEND(DrawOval, this->intern(paint), oval);
 }
 
 void SkRecorder::onDrawRRect(const SkRRect& rrect, const SkPaint& paint) {
-    APPEND(DrawRRect, delay_copy(paint), rrect);
+    APPEND(DrawRRect, this->intern(paint), rrect);
 }
 
 void SkRecorder::onDrawDRRect(const SkRRect& outer, const SkRRect& inner, const SkPaint& paint) {
-    APPEND(DrawDRRect, delay_copy(paint), outer, inner);
+    APPEND(DrawDRRect, this->intern(paint), outer, inner);
 }
 
 void SkRecorder::onDrawDrawable(SkDrawable* drawable) {
@@ -152,7 +184,7 @@ void SkRecorder::onDrawDrawable(SkDrawable* drawable) {
 }
 
 void SkRecorder::onDrawPath(const SkPath& path, const SkPaint& paint) {
-    APPEND(DrawPath, delay_copy(paint), delay_copy(path));
+    APPEND(DrawPath, this->intern(paint), delay_copy(path));
 }
 
 void SkRecorder::onDrawBitmap(const SkBitmap& bitmap,
@@ -177,6 +209,15 @@ void SkRecorder::onDrawBitmapRect(const SkBitmap& bitmap,
            this->copy(paint), delay_copy(bitmap), this->copy(src), dst);
 }
 
+void SkRecorder::onDrawBitmapRects(const SkBitmap& bitmap,
+                                   const SkRect src[],
+                                   const SkRect dst[],
+                                   int count,
+                                   const SkPaint* paint) {
+    APPEND(DrawBitmapRects, this->copy(paint), delay_copy(bitmap), count,
+           this->copy(src, count), this->copy(dst, count));
+}
+
 void SkRecorder::onDrawBitmapNine(const SkBitmap& bitmap,
                                   const SkIRect& center,
                                   const SkRect& dst,
@@ -202,14 +243,14 @@ void SkRecorder::onDrawSprite(const SkBitmap& bitmap, int left, int top, const S
 void SkRecorder::onDrawText(const void* text, size_t byteLength,
                             SkScalar x, SkScalar y, const SkPaint& paint) {
     APPEND(DrawText,
-           delay_copy(paint), this->copy((const char*)text, byteLength), byteLength, x, y);
+           this->intern(paint), this->copy((const char*)text, byteLength), byteLength, x, y);
 }
 
 void SkRecorder::onDrawPosText(const void* text, size_t byteLength,
                                const SkPoint pos[], const SkPaint& paint) {
     const unsigned points = paint.countText(text, byteLength);
     APPEND(DrawPosText,
-           delay_copy(paint),
+           this->intern(paint),
            this->copy((const char*)text, byteLength),
            byteLength,
            this->copy(pos, points));
@@ -219,7 +260,7 @@ void SkRecorder::onDrawPosTextH(const void* text, size_t byteLength,
                                 const SkScalar xpos[], SkScalar constY, const SkPaint& paint) {
     const unsigned points = paint.countText(text, byteLength);
     APPEND(DrawPosTextH,
-           delay_copy(paint),
+           this->intern(paint),
            this->copy((const char*)text, byteLength),
            SkToUInt(byteLength),
            constY,
@@ -229,20 +270,20 @@ void SkRecorder::onDrawPosTextH(const void* text, size_t byteLength,
 void SkRecorder::onDrawTextOnPath(const void* text, size_t byteLength, const SkPath& path,
                                   const SkMatrix* matrix, const SkPaint& paint) {
     APPEND(DrawTextOnPath,
-           delay_copy(paint),
+           this->intern(paint),
            this->copy((const char*)text, byteLength),
            byteLength,
            delay_copy(path),
-           matrix ? *matrix : SkMatrix::I());
+           this->intern(matrix ? *matrix : SkMatrix::I()));
 }
 
 void SkRecorder::onDrawTextBlob(const SkTextBlob* blob, SkScalar x, SkScalar y,
                                 const SkPaint& paint) {
-    APPEND(DrawTextBlob, delay_copy(paint), blob, x, y);
+    APPEND(DrawTextBlob, this->intern(paint), blob, x, y);
 }
 
 void SkRecorder::onDrawPicture(const SkPicture* pic, const SkMatrix* matrix, const SkPaint* paint) {
-    APPEND(DrawPicture, this->copy(paint), pic, matrix ? *matrix : SkMatrix::I());
+    APPEND(DrawPicture, this->copy(paint), pic, this->intern(matrix ? *matrix : SkMatrix::I()));
 }
 
 void SkRecorder::onDrawVertices(VertexMode vmode,
@@ -250,7 +291,7 @@ void SkRecorder::onDrawVertices(VertexMode vmode,
                                 const SkPoint texs[], const SkColor colors[],
                                 SkXfermode* xmode,
                                 const uint16_t indices[], int indexCount, const SkPaint& paint) {
-    APPEND(DrawVertices, delay_copy(paint),
+    APPEND(DrawVertices, this->intern(paint),
                          vmode,
                          vertexCount,
                          this->copy(vertices, vertexCount),
@@ -263,7 +304,7 @@ void SkRecorder::onDrawVertices(VertexMode vmode,
 
 void SkRecorder::onDrawPatch(const SkPoint cubics[12], const SkColor colors[4],
                              const SkPoint texCoords[4], SkXfermode* xmode, const SkPaint& paint) {
-    APPEND(DrawPatch, delay_copy(paint),
+    APPEND(DrawPatch, this->intern(paint),
            cubics ? this->copy(cubics, SkPatchUtils::kNumCtrlPts) : NULL,
            colors ? this->copy(colors, SkPatchUtils::kNumCorners) : NULL,
            texCoords ? this->copy(texCoords, SkPatchUtils::kNumCorners) : NULL,
@@ -282,7 +323,7 @@ SkCanvas::SaveLayerStrategy SkRecorder::willSaveLayer(const SkRect* bounds,
 }
 
 void SkRecorder::didRestore() {
-    APPEND(Restore, this->devBounds(), this->getTotalMatrix());
+    APPEND(Restore, this->devBounds(), this->intern(this->getTotalMatrix()));
 }
 
 void SkRecorder::didConcat(const SkMatrix& matrix) {
@@ -295,7 +336,7 @@ void SkRecorder::didSetMatrix(const SkMatrix& matrix) {
         this->getTotalMatrix().dump();
         SkASSERT(matrix == this->getTotalMatrix());
     })
-    APPEND(SetMatrix, matrix);
+    APPEND(SetMatrix, this->intern(matrix));
 }
 
 void SkRecorder::onClipRect(const SkRect& rect, SkRegion::Op op, ClipEdgeStyle edgeStyle) {
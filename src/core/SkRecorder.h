@@ -12,6 +12,7 @@
 #include "SkRecord.h"
 #include "SkRecords.h"
 #include "SkTDArray.h"
+#include "SkTDynamicHash.h"
 
 class SkBBHFactory;
 
@@ -85,12 +86,15 @@ public:
     void onDrawPaint(const SkPaint&) override;
     void onDrawPoints(PointMode, size_t count, const SkPoint pts[], const SkPaint&) override;
     void onDrawRect(const SkRect&, const SkPaint&) override;
+    void onDrawRects(const SkRect[], int count, const SkPaint&) override;
     void onDrawOval(const SkRect&, const SkPaint&) override;
     void onDrawRRect(const SkRRect&, const SkPaint&) override;
     void onDrawPath(const SkPath&, const SkPaint&) override;
     void onDrawBitmap(const SkBitmap&, SkScalar left, SkScalar top, const SkPaint*) override;
     void onDrawBitmapRect(const SkBitmap&, const SkRect* src, const SkRect& dst, const SkPaint*,
                           DrawBitmapRectFlags flags) override;
+    void onDrawBitmapRects(const SkBitmap&, const SkRect src[], const SkRect dst[], int count,
+                           const SkPaint*) override;
     void onDrawImage(const SkImage*, SkScalar left, SkScalar top, const SkPaint*) override;
     void onDrawImageRect(const SkImage*, const SkRect* src, const SkRect& dst,
                          const SkPaint*) override;
@@ -123,6 +127,10 @@ private:
     template <typename T>
     T* copy(const T[], size_t count);
 
+    // Returns fRecord's copy of paint or matrix, shared by all the commands using an equal one.
+    const SkPaint* intern(const SkPaint&);
+    const SkMatrix* intern(const SkMatrix&);
+
     SkIRect devBounds() const {
         SkIRect devBounds;
         this->getClipDeviceBounds(&devBounds);
@@ -131,6 +139,18 @@ private:
 
     SkRecord* fRecord;
 
+    struct PaintTraits {
+        static const SkPaint& GetKey(const SkPaint& paint) { return paint; }
+        static uint32_t Hash(const SkPaint& paint) { return paint.getHash(); }
+    };
+    struct MatrixTraits {
+        static const SkMatrix& GetKey(const SkMatrix& matrix) { return matrix; }
+        static uint32_t Hash(const SkMatrix&);
+    };
+    // The paints and matrices interned so far, all owned by fRecord.
+    SkTDynamicHash<SkPaint, SkPaint, PaintTraits> fPaints;
+    SkTDynamicHash<SkMatrix, SkMatrix, MatrixTraits> fMatrices;
+
     SkAutoTDelete<SkDrawableList> fDrawableList;
 };
 
@@ -42,6 +42,7 @@ namespace SkRecords {
     M(DrawBitmapNine)                                               \
     M(DrawBitmapRectToRect)                                         \
     M(DrawBitmapRectToRectBleed)                                    \
+    M(DrawBitmapRects)                                              \
     M(DrawDrawable)                                                 \
     M(DrawImage)                                                    \
     M(DrawImageRect)                                                \
@@ -58,6 +59,7 @@ namespace SkRecords {
     M(DrawTextOnPath)                                               \
     M(DrawRRect)                                                    \
     M(DrawRect)                                                     \
+    M(DrawRects)                                                    \
     M(DrawSprite)                                                   \
     M(DrawTextBlob)                                                 \
     M(DrawVertices)
@@ -177,6 +179,23 @@ private:
 
 #undef ACT_AS_PTR
 
+// A paint or matrix shared by all the commands in an SkRecord that use an equal one.  SkRecorder
+// interns these, so a picture drawing thousands of commands with a handful of distinct paints
+// stores each paint just once.  The SkRecord owns the pointee, which must not change: to change
+// one command's paint, point it at a new copy from SkRecord::copyPaint().
+template <typename T>
+class Shared {
+public:
+    Shared(const T* ptr) : fPtr(ptr) { SkASSERT(fPtr); }
+    // Default copy and assign.
+
+    operator const T&() const { return *fPtr; }
+    const T* operator->() const { return fPtr; }
+    const T* get() const { return fPtr; }
+private:
+    const T* fPtr;
+};
+
 // Like SkBitmap, but deep copies pixels if they're not immutable.
 // Using this, we guarantee the immutability of all bitmaps we record.
 class ImmutableBitmap : SkNoncopyable {
@@ -192,6 +211,7 @@ public:
 
     int width()  const { return fBitmap.width();  }
     int height() const { return fBitmap.height(); }
+    bool isOpaque() const { return fBitmap.isOpaque(); }
 
     // While the pixels are immutable, SkBitmap itself is not thread-safe, so return a copy.
     SkBitmap shallowCopy() const { return fBitmap; }
@@ -212,6 +232,7 @@ struct PreCachedPath : public SkPath {
 
 // Like SkPath::getBounds(), SkMatrix::getType() isn't thread safe unless we precache it.
 // This may not cover all SkMatrices used by the picture (e.g. some could be hiding in a shader).
+// SkRecord::copyMatrix() makes these for the matrices the commands share.
 struct TypedMatrix : public SkMatrix {
     explicit TypedMatrix(const SkMatrix& matrix) : SkMatrix(matrix) {
         (void)this->getType();
@@ -220,11 +241,11 @@ struct TypedMatrix : public SkMatrix {
 
 RECORD0(NoOp);
 
-RECORD2(Restore, SkIRect, devBounds, TypedMatrix, matrix);
+RECORD2(Restore, SkIRect, devBounds, Shared<SkMatrix>, matrix);
 RECORD0(Save);
 RECORD3(SaveLayer, Optional<SkRect>, bounds, Optional<SkPaint>, paint, SkCanvas::SaveFlags, flags);
 
-RECORD1(SetMatrix, TypedMatrix, matrix);
+RECORD1(SetMatrix, Shared<SkMatrix>, matrix);
 
 struct RegionOpAndAA {
     RegionOpAndAA(SkRegion::Op op, bool aa) : op(op), aa(aa) {}
@@ -259,7 +280,12 @@ RECORD4(DrawBitmapRectToRectBleed, Optional<SkPaint>, paint,
                                    ImmutableBitmap, bitmap,
                                    Optional<SkRect>, src,
                                    SkRect, dst);
-RECORD3(DrawDRRect, SkPaint, paint, SkRRect, outer, SkRRect, inner);
+RECORD5(DrawBitmapRects, Optional<SkPaint>, paint,
+                         ImmutableBitmap, bitmap,
+                         int, count,
+                         PODArray<SkRect>, src,
+                         PODArray<SkRect>, dst);
+RECORD3(DrawDRRect, Shared<SkPaint>, paint, SkRRect, outer, SkRRect, inner);
 RECORD2(DrawDrawable, SkRect, worstCaseBounds, int32_t, index);
 RECORD4(DrawImage, Optional<SkPaint>, paint,
                    RefBox<const SkImage>, image,
@@ -269,41 +295,45 @@ RECORD4(DrawImageRect, Optional<SkPaint>, paint,
                        RefBox<const SkImage>, image,
                        Optional<SkRect>, src,
                        SkRect, dst);
-RECORD2(DrawOval, SkPaint, paint, SkRect, oval);
-RECORD1(DrawPaint, SkPaint, paint);
-RECORD2(DrawPath, SkPaint, paint, PreCachedPath, path);
+RECORD2(DrawOval, Shared<SkPaint>, paint, SkRect, oval);
+RECORD1(DrawPaint, Shared<SkPaint>, paint);
+RECORD2(DrawPath, Shared<SkPaint>, paint, PreCachedPath, path);
 RECORD3(DrawPicture, Optional<SkPaint>, paint,
                      RefBox<const SkPicture>, picture,
-                     TypedMatrix, matrix);
-RECORD4(DrawPoints, SkPaint, paint, SkCanvas::PointMode, mode, unsigned, count, SkPoint*, pts);
-RECORD4(DrawPosText, SkPaint, paint,
+                     Shared<SkMatrix>, matrix);
+RECORD4(DrawPoints, Shared<SkPaint>, paint,
+                    SkCanvas::PointMode, mode,
+                    unsigned, count,
+                    SkPoint*, pts);
+RECORD4(DrawPosText, Shared<SkPaint>, paint,
                      PODArray<char>, text,
                      size_t, byteLength,
                      PODArray<SkPoint>, pos);
-RECORD5(DrawPosTextH, SkPaint, paint,
+RECORD5(DrawPosTextH, Shared<SkPaint>, paint,
                       PODArray<char>, text,
                       unsigned, byteLength,
                       SkScalar, y,
                       PODArray<SkScalar>, xpos);
-RECORD2(DrawRRect, SkPaint, paint, SkRRect, rrect);
-RECORD2(DrawRect, SkPaint, paint, SkRect, rect);
+RECORD2(DrawRRect, Shared<SkPaint>, paint, SkRRect, rrect);
+RECORD2(DrawRect, Shared<SkPaint>, paint, SkRect, rect);
+RECORD3(DrawRects, Shared<SkPaint>, paint, int, count, PODArray<SkRect>, rects);
 RECORD4(DrawSprite, Optional<SkPaint>, paint, ImmutableBitmap, bitmap, int, left, int, top);
-RECORD5(DrawText, SkPaint, paint,
+RECORD5(DrawText, Shared<SkPaint>, paint,
                   PODArray<char>, text,
                   size_t, byteLength,
                   SkScalar, x,
                   SkScalar, y);
-RECORD4(DrawTextBlob, SkPaint, paint,
+RECORD4(DrawTextBlob, Shared<SkPaint>, paint,
                       RefBox<const SkTextBlob>, blob,
                       SkScalar, x,
                       SkScalar, y);
-RECORD5(DrawTextOnPath, SkPaint, paint,
+RECORD5(DrawTextOnPath, Shared<SkPaint>, paint,
                         PODArray<char>, text,
                         size_t, byteLength,
                         PreCachedPath, path,
-                        TypedMatrix, matrix);
+                        Shared<SkMatrix>, matrix);
 
-RECORD5(DrawPatch, SkPaint, paint,
+RECORD5(DrawPatch, Shared<SkPaint>, paint,
                    PODArray<SkPoint>, cubics,
                    PODArray<SkColor>, colors,
                    PODArray<SkPoint>, texCoords,
@@ -313,7 +343,7 @@ RECORD5(DrawPatch, SkPaint, paint,
 struct DrawVertices {
     static const Type kType = DrawVertices_Type;
 
-    DrawVertices(const SkPaint& paint,
+    DrawVertices(const SkPaint* paint,
                  SkCanvas::VertexMode vmode,
                  int vertexCount,
                  SkPoint* vertices,
@@ -332,7 +362,7 @@ struct DrawVertices {
         , indices(indices)
         , indexCount(indexCount) {}
 
-    SkPaint paint;
+    Shared<SkPaint> paint;
     SkCanvas::VertexMode vmode;
     int vertexCount;
     PODArray<SkPoint> vertices;
@@ -25,6 +25,8 @@ class SkMipMap;
  *
  *  As a convenience, a global instance is also defined, which can be safely
  *  access across threads via the static methods (e.g. FindAndLock, etc.).
+ *  That global instance is sharded (see SkShardedResourceCache) so that threads
+ *  looking up different keys don't contend on a single mutex.
  */
 class SkResourceCache {
 public:
@@ -222,6 +224,11 @@ public:
         this->purgeAsNeeded(true);
     }
 
+    /**
+     *  Purge the least recently used entries until no more than byteLimit bytes are in use.
+     */
+    void purgeDownTo(size_t byteLimit);
+
     DiscardableFactory discardableFactory() const { return fDiscardableFactory; }
     SkBitmap::Allocator* allocator() const { return fAllocator; };
 
@@ -22,6 +22,11 @@ class SkPath;
 */
 typedef SkIRect SkXRect;
 
+/** When true, AntiFillPath() computes exact analytic pixel coverage instead of supersampling.
+    Defaults to false.  Not thread safe: set it once, before drawing.
+*/
+extern bool gSkUseAnalyticAA;
+
 class SkScan {
 public:
     static void FillPath(const SkPath&, const SkIRect&, SkBlitter*);
@@ -36,6 +41,11 @@ public:
     static void AntiFillXRect(const SkXRect&, const SkRasterClip&, SkBlitter*);
     static void FillPath(const SkPath&, const SkRasterClip&, SkBlitter*);
     static void AntiFillPath(const SkPath&, const SkRasterClip&, SkBlitter*);
+    /** Like AntiFillPath() above, but computes analytic coverage if analytic is true and
+        supersamples if it is false, whatever gSkUseAnalyticAA says.  Lets tests compare the two
+        without changing the global while other threads draw.
+    */
+    static void AntiFillPath(const SkPath&, const SkRasterClip&, SkBlitter*, bool analytic);
     static void FrameRect(const SkRect&, const SkPoint& strokeSize,
                           const SkRasterClip&, SkBlitter*);
     static void AntiFrameRect(const SkRect&, const SkPoint& strokeSize,
@@ -62,6 +72,7 @@ private:
     static void FillPath(const SkPath&, const SkRegion& clip, SkBlitter*);
     static void AntiFillPath(const SkPath&, const SkRegion& clip, SkBlitter*,
                              bool forceRLE = false);
+    static void AnalyticFillPath(const SkPath&, const SkRegion& clip, SkBlitter*);
     static void FillTriangle(const SkPoint pts[], const SkRegion*, SkBlitter*);
 
     static void AntiFrameRect(const SkRect&, const SkPoint& strokeSize,
@@ -0,0 +1,412 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkScanPriv.h"
+#include "SkBlitter.h"
+#include "SkGeometry.h"
+#include "SkLineClipper.h"
+#include "SkPath.h"
+#include "SkRegion.h"
+#include "SkTArray.h"
+#include "SkTSort.h"
+#include "SkTemplates.h"
+
+/** @file
+    Analytic coverage anti-aliasing.
+
+    Instead of supersampling, we compute the exact area of each pixel covered by the path.
+    Curves are flattened to lines, clipped with SkLineClipper, and then each line adds its
+    signed area contribution to a one row accumulation buffer, one pixel row at a time.
+    A running sum across the row turns those contributions into per-pixel coverage.
+
+    The coverage is exact for paths that don't overlap themselves.  Where a path does overlap
+    itself within a single pixel, the winding (or even-odd parity) is applied to the summed
+    area of that pixel rather than point by point, as in most font rasterizers.
+ */
+
+bool gSkUseAnalyticAA = false;
+
+// Curves are flattened so that no point on a curve is further than this from its lines.
+static const SkScalar kFlattenTolerance = SK_Scalar1 / 8;
+static const int kMaxFlattenLines = 128;
+
+// Small paths shouldn't need to touch the heap.
+static const int kStackWidth = 256;
+static const int kStackLines = 64;
+
+namespace {
+
+struct Line {
+    SkScalar fX0, fY0;  // top end point, fY0 < fY1
+    SkScalar fX1, fY1;
+    SkScalar fDXDY;
+    SkScalar fDir;      // +1 if the line originally went down, -1 if up
+
+    bool operator<(const Line& other) const { return fY0 < other.fY0; }
+};
+
+class LineBuilder {
+public:
+    // Lines are translated by dx, then clipped to clip.
+    LineBuilder(const SkRect& clip, SkScalar dx) : fClip(clip), fDX(dx) {}
+
+    void addLine(const SkPoint& p0, const SkPoint& p1) {
+        const SkPoint pts[2] = { { p0.fX + fDX, p0.fY }, { p1.fX + fDX, p1.fY } };
+        SkPoint lines[SkLineClipper::kMaxPoints];
+        // We can't cull lines to the right: the area left of them may still be in the clip.
+        int count = SkLineClipper::ClipLine(pts, fClip, lines, false);
+        for (int i = 0; i < count; ++i) {
+            this->addClippedLine(lines[i], lines[i + 1]);
+        }
+    }
+
+    void addQuad(const SkPoint pts[3]) {
+        SkVector dd = pts[0] - pts[1] - pts[1] + pts[2];
+        int n = count_lines(dd.length() * SK_ScalarHalf);
+
+        SkPoint prev = pts[0];
+        for (int i = 1; i < n; ++i) {
+            SkScalar t = SkIntToScalar(i) / n;
+            SkScalar mt = SK_Scalar1 - t;
+            SkPoint next = { mt*mt*pts[0].fX + 2*mt*t*pts[1].fX + t*t*pts[2].fX,
+                             mt*mt*pts[0].fY + 2*mt*t*pts[1].fY + t*t*pts[2].fY };
+            this->addLine(prev, next);
+            prev = next;
+        }
+        this->addLine(prev, pts[2]);
+    }
+
+    void addCubic(const SkPoint pts[4]) {
+        SkVector dd0 = pts[0] - pts[1] - pts[1] + pts[2];
+        SkVector dd1 = pts[1] - pts[2] - pts[2] + pts[3];
+        int n = count_lines(SkTMax(dd0.length(), dd1.length()) * 3 / 4);
+
+        SkPoint prev = pts[0];
+        for (int i = 1; i < n; ++i) {
+            SkScalar t = SkIntToScalar(i) / n;
+            SkScalar mt = SK_Scalar1 - t;
+            SkScalar a = mt*mt*mt, b = 3*mt*mt*t, c = 3*mt*t*t, d = t*t*t;
+            SkPoint next = { a*pts[0].fX + b*pts[1].fX + c*pts[2].fX + d*pts[3].fX,
+                             a*pts[0].fY + b*pts[1].fY + c*pts[2].fY + d*pts[3].fY };
+            this->addLine(prev, next);
+            prev = next;
+        }
+        this->addLine(prev, pts[3]);
+    }
+
+    SkTArray<Line, true>& lines() { return fLines; }
+
+private:
+    // A curve whose control polygon deviates by dev from a line is within dev/n^2 of its n
+    // line flattening, so pick the smallest n that gets us within tolerance.
+    static int count_lines(SkScalar dev) {
+        if (!(dev > kFlattenTolerance)) {   // also catches NaN
+            return 1;
+        }
+        int n = SkScalarCeilToInt(SkScalarSqrt(dev / kFlattenTolerance));
+        return SkTMin(n, kMaxFlattenLines);
+    }
+
+    void addClippedLine(const SkPoint& p0, const SkPoint& p1) {
+        if (p0.fY == p1.fY) {
+            return; // horizontal lines cover no area
+        }
+        Line* line = &fLines.push_back();
+        if (p0.fY < p1.fY) {
+            line->fX0 = p0.fX; line->fY0 = p0.fY;
+            line->fX1 = p1.fX; line->fY1 = p1.fY;
+            line->fDir = SK_Scalar1;
+        } else {
+            line->fX0 = p1.fX; line->fY0 = p1.fY;
+            line->fX1 = p0.fX; line->fY1 = p0.fY;
+            line->fDir = -SK_Scalar1;
+        }
+        line->fDXDY = (line->fX1 - line->fX0) / (line->fY1 - line->fY0);
+    }
+
+    SkRect          fClip;
+    SkScalar        fDX;
+    SkSTArray<kStackLines, Line, true> fLines;
+};
+
+// Walks the path, handing each line (or flattened curve) to the builder.
+static void build_lines(const SkPath& path, LineBuilder* builder) {
+    SkPath::Iter    iter(path, true);
+    SkPoint         pts[4];
+    SkPath::Verb    verb;
+
+    while ((verb = iter.next(pts, false)) != SkPath::kDone_Verb) {
+        switch (verb) {
+            case SkPath::kLine_Verb:
+                builder->addLine(pts[0], pts[1]);
+                break;
+            case SkPath::kQuad_Verb:
+                builder->addQuad(pts);
+                break;
+            case SkPath::kConic_Verb: {
+                SkAutoConicToQuads quadder;
+                const SkPoint* quadPts = quadder.computeQuads(pts, iter.conicWeight(),
+                                                              kFlattenTolerance);
+                for (int i = 0; i < quadder.countQuads(); ++i) {
+                    builder->addQuad(quadPts + 2 * i);
+                }
+                break;
+            }
+            case SkPath::kCubic_Verb:
+                builder->addCubic(pts);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+/**
+ *  Adds the area to the right of the line (x0, y0)..(x1, y1) within one pixel row to acc,
+ *  where y0 and y1 lie within that row, dy = y1 - y0 is already scaled by the line's direction,
+ *  and x0 and x1 lie within [0, width].  Each cell gets the area of its pixel to the right of
+ *  the line, and the cell after gets the rest of dy, so that summing the cells left to right
+ *  gives the coverage of each pixel.  acc must have at least width + 2 cells.
+ *
+ *  Returns the range of cells touched in [*minX, *maxX].
+ */
+static void accumulate_line(SkScalar* acc, SkScalar x0, SkScalar x1, SkScalar dy,
+                            int* minX, int* maxX) {
+    if (x0 > x1) {
+        SkTSwap(x0, x1);
+    }
+    const SkScalar x0floor = SkScalarFloorToScalar(x0);
+    const int      x0i     = SkScalarFloorToInt(x0);
+    const int      x1i     = SkScalarCeilToInt(x1);
+
+    if (x1i <= x0i + 1) {
+        // The line stays within a single pixel.
+        SkScalar xmf = SK_ScalarHalf * (x0 + x1) - x0floor;
+        acc[x0i]     += dy - dy * xmf;
+        acc[x0i + 1] += dy * xmf;
+    } else {
+        // The line crosses several pixels: a triangle in the first, trapezoids in the middle,
+        // and the rest of the area in the last.
+        const SkScalar s   = SkScalarInvert(x1 - x0);
+        const SkScalar x0f = x0 - x0floor;
+        const SkScalar a0  = SK_ScalarHalf * s * (1 - x0f) * (1 - x0f);
+        const SkScalar x1f = x1 - x1i + 1;
+        const SkScalar am  = SK_ScalarHalf * s * x1f * x1f;
+
+        acc[x0i] += dy * a0;
+        if (x1i == x0i + 2) {
+            acc[x0i + 1] += dy * (1 - a0 - am);
+        } else {
+            const SkScalar a1 = s * (SK_Scalar1 * 3 / 2 - x0f);
+            acc[x0i + 1] += dy * (a1 - a0);
+            for (int x = x0i + 2; x < x1i - 1; ++x) {
+                acc[x] += dy * s;
+            }
+            const SkScalar a2 = a1 + (x1i - x0i - 3) * s;
+            acc[x1i - 1] += dy * (1 - a2 - am);
+        }
+        acc[x1i] += dy * am;
+    }
+
+    *minX = SkMin32(*minX, x0i);
+    *maxX = SkMax32(*maxX, x1i);
+}
+
+static inline SkAlpha coverage_to_alpha(SkScalar sum, bool evenOdd, bool inverse) {
+    SkScalar c = SkScalarAbs(sum);
+    if (evenOdd) {
+        c -= 2 * SkScalarFloorToScalar(c * SK_ScalarHalf);
+        if (c > SK_Scalar1) {
+            c = 2 - c;
+        }
+    } else if (c > SK_Scalar1) {
+        c = SK_Scalar1;
+    }
+    if (inverse) {
+        c = SK_Scalar1 - c;
+    }
+    return SkToU8(SkScalarFloorToInt(c * 255 + SK_ScalarHalf));
+}
+
+/**
+ *  Sums acc[start..stop) into alpha, run length encodes it, and blits it to row y.
+ *  Clears the cells of acc it reads.
+ */
+static void blit_row(SkBlitter* blitter, int left, int y, SkScalar* acc, int start, int stop,
+                     bool evenOdd, bool inverse, SkAlpha* alpha, int16_t* runs) {
+    SkScalar sum = acc[start];
+    acc[start] = 0;
+    SkAlpha prev = coverage_to_alpha(sum, evenOdd, inverse);
+    int runStart = start;
+    for (int x = start + 1; x < stop; ++x) {
+        if (0 == acc[x]) {
+            continue;   // Coverage only changes where a line touched this row.
+        }
+        sum += acc[x];
+        acc[x] = 0;
+        SkAlpha a = coverage_to_alpha(sum, evenOdd, inverse);
+        if (a != prev) {
+            alpha[runStart - start] = prev;
+            runs[runStart - start] = SkToS16(x - runStart);
+            runStart = x;
+            prev = a;
+        }
+    }
+    alpha[runStart - start] = prev;
+    runs[runStart - start] = SkToS16(stop - runStart);
+    runs[stop - start] = 0;
+
+    blitter->blitAntiH(left + start, y, alpha, runs);
+}
+
+// Fills the lines into rows [bounds.fTop, bounds.fBottom), in bounds' coordinates.
+// Lines must already be clipped to bounds.
+static void fill_lines(SkTArray<Line, true>& lines, const SkIRect& bounds, SkPath::FillType fillType,
+                       SkBlitter* blitter) {
+    const bool evenOdd = SkToBool(fillType & 1);
+    const bool inverse = SkPath::IsInverseFillType(fillType);
+    const int  width   = bounds.width();
+
+    if (lines.count() > 1) {
+        SkTQSort(lines.begin(), lines.end() - 1);
+    }
+
+    SkAutoSTMalloc<kStackWidth + 2, SkScalar> acc(width + 2);
+    sk_bzero(acc.get(), (width + 2) * sizeof(SkScalar));
+    SkAutoSTMalloc<kStackWidth + 1, SkAlpha> alpha(width + 1);
+    SkAutoSTMalloc<kStackWidth + 1, int16_t> runs(width + 1);
+
+    SkSTArray<kStackLines, const Line*, true> active;
+    int next = 0;
+
+    for (int y = bounds.fTop; y < bounds.fBottom; ++y) {
+        const SkScalar rowTop = SkIntToScalar(y);
+        const SkScalar rowBot = SkIntToScalar(y + 1);
+
+        while (next < lines.count() && lines[next].fY0 < rowBot) {
+            active.push_back(&lines[next++]);
+        }
+
+        int minX = width + 1, maxX = -1;
+        for (int i = 0; i < active.count(); ) {
+            const Line& line = *active[i];
+            const SkScalar y0 = SkTMax(line.fY0, rowTop);
+            const SkScalar y1 = SkTMin(line.fY1, rowBot);
+            if (y1 > y0) {
+                // Pinning guards against rounding taking us a hair outside the clip.
+                SkScalar x0 = SkScalarPin(line.fX0 + (y0 - line.fY0) * line.fDXDY,
+                                          0, SkIntToScalar(width));
+                SkScalar x1 = SkScalarPin(line.fX0 + (y1 - line.fY0) * line.fDXDY,
+                                          0, SkIntToScalar(width));
+                accumulate_line(acc.get(), x0, x1, (y1 - y0) * line.fDir, &minX, &maxX);
+            }
+            if (line.fY1 <= rowBot) {
+                active.removeShuffle(i);
+            } else {
+                ++i;
+            }
+        }
+
+        if (inverse) {
+            blit_row(blitter, bounds.fLeft, y, acc.get(), 0, width, evenOdd, inverse,
+                     alpha.get(), runs.get());
+            // Cells at width and beyond are never read, but must start the next row clear.
+            acc[width] = acc[width + 1] = 0;
+        } else if (minX <= maxX) {
+            // Everything left of minX is empty, and the row sums back to zero after maxX.
+            int stop = SkMin32(maxX + 1, width);
+            if (minX < stop) {
+                blit_row(blitter, bounds.fLeft, y, acc.get(), minX, stop, evenOdd, inverse,
+                         alpha.get(), runs.get());
+            }
+            for (int x = stop; x <= maxX + 1; ++x) {
+                acc[x] = 0;
+            }
+        }
+    }
+}
+
+}  // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SkScan::AnalyticFillPath(const SkPath& path, const SkRegion& origClip,
+                              SkBlitter* blitter) {
+    if (origClip.isEmpty()) {
+        return;
+    }
+
+    const bool isInverse = path.isInverseFillType();
+    const SkRect& pathBounds = path.getBounds();
+
+    // Our runs are int16_t, so we restrict ourselves to the same limits as the supersampler.
+    static const int32_t kMaxCoord = 32767;
+    const SkRect limit = SkRect::MakeLTRB(-SkIntToScalar(kMaxCoord), -SkIntToScalar(kMaxCoord),
+                                          SkIntToScalar(kMaxCoord), SkIntToScalar(kMaxCoord));
+    if (!limit.contains(pathBounds)) {
+        SkScan::AntiFillPath(path, origClip, blitter);
+        return;
+    }
+
+    SkIRect ir;
+    pathBounds.roundOut(&ir);
+    if (ir.isEmpty()) {
+        if (isInverse) {
+            blitter->blitRegion(origClip);
+        }
+        return;
+    }
+
+    SkRegion tmpClipStorage;
+    const SkRegion* clipRgn = &origClip;
+    {
+        const SkIRect& bounds = origClip.getBounds();
+        if (bounds.fLeft < -kMaxCoord || bounds.fTop < -kMaxCoord ||
+            bounds.fRight > kMaxCoord || bounds.fBottom > kMaxCoord) {
+            SkIRect limitR = { -kMaxCoord, -kMaxCoord, kMaxCoord, kMaxCoord };
+            tmpClipStorage.op(origClip, limitR, SkRegion::kIntersect_Op);
+            clipRgn = &tmpClipStorage;
+        }
+    }
+    // for here down, use clipRgn, not origClip
+
+    // Inverse fills cover the full width of the clip on every row they touch.
+    SkIRect bounds = ir;
+    if (isInverse) {
+        bounds.fLeft  = clipRgn->getBounds().fLeft;
+        bounds.fRight = clipRgn->getBounds().fRight;
+    }
+    if (!bounds.intersect(clipRgn->getBounds())) {
+        if (isInverse) {
+            blitter->blitRegion(*clipRgn);
+        }
+        return;
+    }
+    if (bounds.width() > kMaxCoord) {
+        SkScan::AntiFillPath(path, *clipRgn, blitter);
+        return;
+    }
+
+    // bounds is inside the clip's bounds, so this only wraps the blitter for complex clips.
+    SkScanClipper clipper(blitter, clipRgn, bounds);
+    blitter = clipper.getBlitter();
+
+    if (isInverse) {
+        sk_blit_above(blitter, ir, *clipRgn);
+    }
+
+    // Work relative to bounds.fLeft, so the accumulation buffer starts at zero.
+    SkRect clip = SkRect::MakeLTRB(0, SkIntToScalar(bounds.fTop),
+                                   SkIntToScalar(bounds.width()), SkIntToScalar(bounds.fBottom));
+    LineBuilder builder(clip, -SkIntToScalar(bounds.fLeft));
+    build_lines(path, &builder);
+    fill_lines(builder.lines(), bounds, path.getFillType(), blitter);
+
+    if (isInverse) {
+        sk_blit_below(blitter, ir, *clipRgn);
+    }
+}
@@ -750,18 +750,31 @@ void SkScan::FillPath(const SkPath& path, const SkRasterClip& clip,
 
 void SkScan::AntiFillPath(const SkPath& path, const SkRasterClip& clip,
                           SkBlitter* blitter) {
+    AntiFillPath(path, clip, blitter, gSkUseAnalyticAA);
+}
+
+void SkScan::AntiFillPath(const SkPath& path, const SkRasterClip& clip,
+                          SkBlitter* blitter, bool analytic) {
     if (clip.isEmpty()) {
         return;
     }
 
     if (clip.isBW()) {
-        AntiFillPath(path, clip.bwRgn(), blitter);
+        if (analytic) {
+            AnalyticFillPath(path, clip.bwRgn(), blitter);
+        } else {
+            AntiFillPath(path, clip.bwRgn(), blitter);
+        }
     } else {
         SkRegion        tmp;
         SkAAClipBlitter aaBlitter;
 
         tmp.setRect(clip.getBounds());
         aaBlitter.init(blitter, &clip.aaRgn());
-        SkScan::AntiFillPath(path, tmp, &aaBlitter, true);
+        if (analytic) {
+            SkScan::AnalyticFillPath(path, tmp, &aaBlitter);
+        } else {
+            SkScan::AntiFillPath(path, tmp, &aaBlitter, true);
+        }
     }
 }
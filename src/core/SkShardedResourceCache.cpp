@@ -0,0 +1,168 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCachedData.h"
+#include "SkChecksum.h"
+#include "SkDiscardableMemory.h"
+#include "SkShardedResourceCache.h"
+
+// Runs op on shard's cache while holding its lock, adding any change in that cache's
+// bytes used to fTotalBytesUsed.
+#define SHARD_OP(shard, op)                                                        \
+    do {                                                                           \
+        SkAutoMutexAcquire am((shard)->fMutex);                                    \
+        const size_t before = (shard)->fCache->getTotalBytesUsed();                \
+        op;                                                                        \
+        const size_t after = (shard)->fCache->getTotalBytesUsed();                 \
+        if (before != after) {                                                     \
+            sk_atomic_fetch_add(&fTotalBytesUsed, (int64_t)after - (int64_t)before); \
+        }                                                                          \
+    } while (false)
+
+SkShardedResourceCache::SkShardedResourceCache(int shardCount, DiscardableFactory factory)
+    : fShards(shardCount)
+    , fShardCount(shardCount)
+    , fDiscardableFactory(factory)
+    , fTotalBytesUsed(0)
+    , fTotalByteLimit(0)
+    , fSingleAllocationByteLimit(0) {
+    SkASSERT(shardCount > 0);
+    for (int i = 0; i < fShardCount; i++) {
+        fShards[i].fCache.reset(SkNEW_ARGS(SkResourceCache, (factory)));
+    }
+}
+
+SkShardedResourceCache::SkShardedResourceCache(int shardCount, size_t byteLimit)
+    : fShards(shardCount)
+    , fShardCount(shardCount)
+    , fDiscardableFactory(NULL)
+    , fTotalBytesUsed(0)
+    , fTotalByteLimit(byteLimit)
+    , fSingleAllocationByteLimit(0) {
+    SkASSERT(shardCount > 0);
+    // Each shard may use the whole budget on its own.  balance() keeps the total in check.
+    for (int i = 0; i < fShardCount; i++) {
+        fShards[i].fCache.reset(SkNEW_ARGS(SkResourceCache, (byteLimit)));
+    }
+}
+
+SkShardedResourceCache::~SkShardedResourceCache() {}
+
+SkShardedResourceCache::Shard* SkShardedResourceCache::shardFor(const Key& key) {
+    // Each shard's SkTDynamicHash indexes by the low bits of the hash, so mix before
+    // picking a shard to keep every shard's keys spread over its whole table.
+    return &fShards[SkChecksum::Mix(key.hash()) % fShardCount];
+}
+
+bool SkShardedResourceCache::find(const Key& key, FindVisitor visitor, void* context) {
+    Shard* shard = this->shardFor(key);
+    bool found;
+    SHARD_OP(shard, found = shard->fCache->find(key, visitor, context));
+    return found;
+}
+
+void SkShardedResourceCache::add(Rec* rec) {
+    Shard* shard = this->shardFor(rec->getKey());
+    SHARD_OP(shard, shard->fCache->add(rec));
+    this->balance();
+}
+
+void SkShardedResourceCache::balance() {
+    if (fDiscardableFactory) {
+        return;  // No byte budget to balance.
+    }
+    const size_t limit = sk_atomic_load(&fTotalByteLimit);
+    if ((size_t)sk_atomic_load(&fTotalBytesUsed) <= limit) {
+        return;
+    }
+    // We only ever hold one shard's lock at a time, so there's no lock ordering to worry about.
+    const size_t share = limit / fShardCount;
+    for (int i = 0; i < fShardCount; i++) {
+        Shard* shard = &fShards[i];
+        SHARD_OP(shard, shard->fCache->purgeDownTo(share));
+        if ((size_t)sk_atomic_load(&fTotalBytesUsed) <= limit) {
+            break;
+        }
+    }
+}
+
+size_t SkShardedResourceCache::getTotalBytesUsed() const {
+    return fDiscardableFactory ? 0 : (size_t)sk_atomic_load(&fTotalBytesUsed);
+}
+
+size_t SkShardedResourceCache::getTotalByteLimit() const {
+    return sk_atomic_load(&fTotalByteLimit);
+}
+
+size_t SkShardedResourceCache::setTotalByteLimit(size_t newLimit) {
+    if (fDiscardableFactory) {
+        return 0;
+    }
+    const size_t prevLimit = sk_atomic_load(&fTotalByteLimit);
+    sk_atomic_store(&fTotalByteLimit, newLimit);
+    for (int i = 0; i < fShardCount; i++) {
+        Shard* shard = &fShards[i];
+        SHARD_OP(shard, shard->fCache->setTotalByteLimit(newLimit));
+    }
+    this->balance();
+    return prevLimit;
+}
+
+size_t SkShardedResourceCache::setSingleAllocationByteLimit(size_t newLimit) {
+    const size_t oldLimit = sk_atomic_load(&fSingleAllocationByteLimit);
+    sk_atomic_store(&fSingleAllocationByteLimit, newLimit);
+    return oldLimit;
+}
+
+size_t SkShardedResourceCache::getSingleAllocationByteLimit() const {
+    return sk_atomic_load(&fSingleAllocationByteLimit);
+}
+
+size_t SkShardedResourceCache::getEffectiveSingleAllocationByteLimit() const {
+    // Same policy as SkResourceCache: 0 means no explicit limit, and a fixed-budget
+    // cache pins the single allocation limit to its total budget.
+    size_t limit = this->getSingleAllocationByteLimit();
+    if (NULL == fDiscardableFactory) {
+        const size_t total = this->getTotalByteLimit();
+        limit = (0 == limit) ? total : SkTMin(limit, total);
+    }
+    return limit;
+}
+
+void SkShardedResourceCache::purgeAll() {
+    for (int i = 0; i < fShardCount; i++) {
+        Shard* shard = &fShards[i];
+        SHARD_OP(shard, shard->fCache->purgeAll());
+    }
+}
+
+SkBitmap::Allocator* SkShardedResourceCache::allocator() const {
+    // All shards have equivalent allocators, and they never change, so no need to lock.
+    return fShards[0].fCache->allocator();
+}
+
+SkCachedData* SkShardedResourceCache::newCachedData(size_t bytes) {
+    // This doesn't touch any shard's state, so there's nothing to lock.
+    if (fDiscardableFactory) {
+        SkDiscardableMemory* dm = fDiscardableFactory(bytes);
+        return dm ? SkNEW_ARGS(SkCachedData, (bytes, dm)) : NULL;
+    } else {
+        return SkNEW_ARGS(SkCachedData, (sk_malloc_throw(bytes), bytes));
+    }
+}
+
+void SkShardedResourceCache::dump() const {
+    SkDebugf("SkShardedResourceCache: shards=%d bytes=%zu limit=%zu\n",
+             fShardCount, this->getTotalBytesUsed(), this->getTotalByteLimit());
+    for (int i = 0; i < fShardCount; i++) {
+        Shard* shard = &fShards[i];
+        SkAutoMutexAcquire am(shard->fMutex);
+        shard->fCache->dump();
+    }
+}
+
+#undef SHARD_OP
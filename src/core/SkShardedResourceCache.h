@@ -0,0 +1,84 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkShardedResourceCache_DEFINED
+#define SkShardedResourceCache_DEFINED
+
+#include "SkResourceCache.h"
+#include "SkTemplates.h"
+#include "SkThread.h"
+
+/**
+ *  A thread-safe SkResourceCache, split into shards.  Each Key hashes to one shard, and each
+ *  shard has its own mutex, LRU list and hash table, so threads working with different keys
+ *  rarely contend with each other.
+ *
+ *  All shards share one byte budget.  A shard may grow past its even share of the budget as long
+ *  as the cache as a whole is under budget.  When the total goes over budget, the shards above
+ *  their share purge their least recently used entries until the total fits again.
+ *
+ *  When backed by discardable memory there is no byte budget, and each shard enforces the usual
+ *  entry count limit on its own.
+ *
+ *  With a single shard, this behaves just like one SkResourceCache guarded by one mutex.
+ */
+class SkShardedResourceCache : SkNoncopyable {
+public:
+    typedef SkResourceCache::Key                Key;
+    typedef SkResourceCache::Rec                Rec;
+    typedef SkResourceCache::FindVisitor        FindVisitor;
+    typedef SkResourceCache::DiscardableFactory DiscardableFactory;
+
+    SkShardedResourceCache(int shardCount, DiscardableFactory);
+    SkShardedResourceCache(int shardCount, size_t byteLimit);
+    ~SkShardedResourceCache();
+
+    // These all mean the same thing as their SkResourceCache counterparts,
+    // but are safe to call from any thread.
+    bool find(const Key&, FindVisitor, void* context);
+    void add(Rec*);
+
+    size_t getTotalBytesUsed() const;
+    size_t getTotalByteLimit() const;
+    size_t setTotalByteLimit(size_t newLimit);
+
+    size_t setSingleAllocationByteLimit(size_t maximumAllocationSize);
+    size_t getSingleAllocationByteLimit() const;
+    size_t getEffectiveSingleAllocationByteLimit() const;
+
+    void purgeAll();
+
+    DiscardableFactory discardableFactory() const { return fDiscardableFactory; }
+    SkBitmap::Allocator* allocator() const;
+
+    SkCachedData* newCachedData(size_t bytes);
+
+    void dump() const;
+
+    int shardCount() const { return fShardCount; }
+
+private:
+    struct Shard {
+        SkMutex                         fMutex;
+        SkAutoTDelete<SkResourceCache>  fCache;
+    };
+
+    Shard* shardFor(const Key&);
+
+    // Purge shards over their share of the budget until the total is back under budget.
+    void balance();
+
+    SkAutoTArray<Shard>       fShards;
+    const int                 fShardCount;
+    const DiscardableFactory  fDiscardableFactory;
+
+    int64_t fTotalBytesUsed;              // Sum of all shards' bytes used.  Atomic.
+    size_t  fTotalByteLimit;              // Atomic.
+    size_t  fSingleAllocationByteLimit;   // Atomic.
+};
+
+#endif
@@ -1,10 +1,12 @@
 #include "SkTaskGroup.h"
 
 #include "SkCondVar.h"
+#include "SkRandom.h"
 #include "SkRunnable.h"
 #include "SkTDArray.h"
 #include "SkThread.h"
 #include "SkThreadUtils.h"
+#include "SkTLS.h"
 
 #if defined(SK_BUILD_FOR_WIN32)
     static inline int num_cores() {
@@ -21,6 +23,77 @@
 
 namespace {
 
+struct Work {
+    void (*fn)(void*);  // A function to call,
+    void* arg;          // its argument,
+    int32_t* pending;   // then sk_atomic_dec(pending) afterwards.
+};
+
+// Each worker thread owns one of these.  The owner pushes and pops at the back (LIFO, so nested
+// subtasks run while their data is still hot in cache), while other threads steal from the front.
+// Every deque has its own lock, so threads only contend when they touch the same deque.
+class WorkDeque : SkNoncopyable {
+public:
+    WorkDeque() : fHead(0), fCount(0) {}
+
+    void push(const Work& work) {
+        SkAutoMutexAcquire lock(fLock);
+        this->reserve(fCount + 1);
+        fRing[this->index(fCount++)] = work;
+    }
+
+    void pushBatch(void (*fn)(void*), void* args, int N, size_t stride, int32_t* pending) {
+        SkAutoMutexAcquire lock(fLock);
+        this->reserve(fCount + N);
+        for (int i = 0; i < N; i++) {
+            Work work = { fn, (char*)args + i*stride, pending };
+            fRing[this->index(fCount++)] = work;
+        }
+    }
+
+    bool popBack(Work* work) {
+        SkAutoMutexAcquire lock(fLock);
+        if (0 == fCount) {
+            return false;
+        }
+        *work = fRing[this->index(--fCount)];
+        return true;
+    }
+
+    bool popFront(Work* work) {
+        SkAutoMutexAcquire lock(fLock);
+        if (0 == fCount) {
+            return false;
+        }
+        *work = fRing[fHead];
+        fHead = this->index(1);
+        fCount--;
+        return true;
+    }
+
+private:
+    // fRing is a circular buffer holding fCount Works starting at fRing[fHead].
+    int index(int i) const { return (fHead + i) % fRing.count(); }
+
+    void reserve(int count) {
+        if (count <= fRing.count()) {
+            return;
+        }
+        SkTDArray<Work> bigger;
+        bigger.setCount(SkTMax(count, 2 * fRing.count()));
+        for (int i = 0; i < fCount; i++) {
+            bigger[i] = fRing[this->index(i)];
+        }
+        fRing.swap(bigger);
+        fHead = 0;
+    }
+
+    SkMutex         fLock;
+    SkTDArray<Work> fRing;
+    int             fHead;
+    int             fCount;
+};
+
 class ThreadPool : SkNoncopyable {
 public:
     static void Add(SkRunnable* task, int32_t* pending) {
@@ -50,17 +123,17 @@ public:
             SkASSERT(*pending == 0);
             return;
         }
+        // If we're a worker (i.e. this is a nested wait() from inside a task), we'll drain our own
+        // deque first, which is where any subtasks we just add()ed went.
+        Worker* self = CurrentWorker();
+        SkRandom rand((uint32_t)(uintptr_t)pending);
         while (sk_acquire_load(pending) > 0) {  // Pairs with sk_atomic_dec here or in Loop.
             // Lend a hand until our SkTaskGroup of interest is done.
             Work work;
-            {
-                AutoLock lock(&gGlobal->fReady);
-                if (gGlobal->fWork.isEmpty()) {
-                    // Someone has picked up all the work (including ours).  How nice of them!
-                    // (They may still be working on it, so we can't assert *pending == 0 here.)
-                    continue;
-                }
-                gGlobal->fWork.pop(&work);
+            if (!gGlobal->findWork(self, self ? &self->fRand : &rand, &work)) {
+                // Someone has picked up all the work (including ours).  How nice of them!
+                // (They may still be working on it, so we can't assert *pending == 0 here.)
+                continue;
             }
             // This Work isn't necessarily part of our SkTaskGroup of interest, but that's fine.
             // We threads gotta stick together.  We're always making forward progress.
@@ -77,26 +150,43 @@ private:
         SkCondVar* fC;
     };
 
-    static void CallRunnable(void* arg) { static_cast<SkRunnable*>(arg)->run(); }
+    struct Worker {
+        Worker(ThreadPool* pool, int index) : fPool(pool), fIndex(index), fRand(index) {}
 
-    struct Work {
-        void (*fn)(void*);  // A function to call,
-        void* arg;          // its argument,
-        int32_t* pending;   // then sk_atomic_dec(pending) afterwards.
+        ThreadPool* fPool;
+        int         fIndex;
+        SkRandom    fRand;  // Used only by this worker's thread to pick victims.
+        WorkDeque   fDeque;
     };
 
-    explicit ThreadPool(int threads) : fDraining(false) {
+    static void CallRunnable(void* arg) { static_cast<SkRunnable*>(arg)->run(); }
+
+    // Each worker thread remembers its Worker in thread-local storage so add() and wait() can
+    // find the calling thread's own deque.  Other threads will find NULL.
+    static void* CreateWorkerSlot() { return SkNEW_ARGS(Worker*, (NULL)); }
+    static void DeleteWorkerSlot(void* slot) { SkDELETE((Worker**)slot); }
+
+    static Worker* CurrentWorker() {
+        Worker** slot = (Worker**)SkTLS::Find(CreateWorkerSlot);
+        return slot ? *slot : NULL;
+    }
+
+    explicit ThreadPool(int threads) : fQueued(0), fSleeping(0), fNextDeque(0), fDraining(false) {
         if (threads == -1) {
             threads = num_cores();
         }
+        // Create all the Workers before starting any threads; they may steal from each other.
+        for (int i = 0; i < threads; i++) {
+            fWorkers.push(SkNEW_ARGS(Worker, (this, i)));
+        }
         for (int i = 0; i < threads; i++) {
-            fThreads.push(SkNEW_ARGS(SkThread, (&ThreadPool::Loop, this)));
+            fThreads.push(SkNEW_ARGS(SkThread, (&ThreadPool::Loop, fWorkers[i])));
             fThreads.top()->start();
         }
     }
 
     ~ThreadPool() {
-        SkASSERT(fWork.isEmpty());  // All SkTaskGroups should be destroyed by now.
+        SkASSERT(sk_atomic_load(&fQueued) == 0);  // All SkTaskGroups should be destroyed by now.
         {
             AutoLock lock(&fReady);
             fDraining = true;
@@ -105,54 +195,116 @@ private:
         for (int i = 0; i < fThreads.count(); i++) {
             fThreads[i]->join();
         }
-        SkASSERT(fWork.isEmpty());  // Can't hurt to double check.
+        SkASSERT(sk_atomic_load(&fQueued) == 0);  // Can't hurt to double check.
         fThreads.deleteAll();
+        fWorkers.deleteAll();
+    }
+
+    // Pick the deque for new work: a worker adds to its own deque, anyone else spreads their work
+    // round-robin over all the workers' deques.
+    Worker* pickWorker(Worker* self) {
+        if (self) {
+            return self;
+        }
+        uint32_t next = (uint32_t)sk_atomic_inc(&fNextDeque);
+        return fWorkers[next % fWorkers.count()];
     }
 
     void add(void (*fn)(void*), void* arg, int32_t* pending) {
         Work work = { fn, arg, pending };
         sk_atomic_inc(pending);  // No barrier needed.
-        {
-            AutoLock lock(&fReady);
-            fWork.push(work);
-            fReady.signal();
-        }
+        this->pickWorker(CurrentWorker())->fDeque.push(work);
+        sk_atomic_inc(&fQueued);
+        this->wake(1);
     }
 
-    void batch(void (*fn)(void*), void* arg, int N, size_t stride, int32_t* pending) {
+    void batch(void (*fn)(void*), void* args, int N, size_t stride, int32_t* pending) {
+        if (N <= 0) {
+            return;
+        }
         sk_atomic_add(pending, N);  // No barrier needed.
-        {
+
+        // Deal the batch out in contiguous chunks, one per worker, starting with the
+        // calling worker if there is one.  That way nobody needs to steal to get started.
+        const int workers = fWorkers.count();
+        const int start   = this->pickWorker(CurrentWorker())->fIndex;
+        const int chunk   = (N + workers - 1) / workers;
+        for (int i = 0, done = 0; done < N; i++) {
+            const int n = SkTMin(chunk, N - done);
+            fWorkers[(start + i) % workers]->fDeque.pushBatch(fn, (char*)args + done*stride,
+                                                              n, stride, pending);
+            done += n;
+        }
+        sk_atomic_add(&fQueued, N);
+        this->wake(N);
+    }
+
+    // Wake up to n sleeping workers.  The sleepers check fQueued after announcing themselves in
+    // fSleeping, and we check fSleeping after bumping fQueued, so at least one of us will notice.
+    void wake(int n) {
+        if (sk_atomic_load(&fSleeping) > 0) {
             AutoLock lock(&fReady);
-            Work* batch = fWork.append(N);
-            for (int i = 0; i < N; i++) {
-                Work work = { fn, (char*)arg + i*stride, pending };
-                batch[i] = work;
+            if (n == 1) {
+                fReady.signal();
+            } else {
+                fReady.broadcast();
             }
-            fReady.broadcast();
         }
     }
 
+    // Look for work, first at the back of our own deque (if we have one), then at the front of
+    // the other deques, starting with a random victim.
+    bool findWork(Worker* self, SkRandom* rand, Work* work) {
+        if (sk_atomic_load(&fQueued, sk_memory_order_relaxed) <= 0) {
+            return false;  // Cheap early out, so idle threads don't hammer the deque locks.
+        }
+        if (self && self->fDeque.popBack(work)) {
+            sk_atomic_dec(&fQueued);
+            return true;
+        }
+        const int workers = fWorkers.count();
+        const int victim  = rand->nextULessThan(workers);
+        for (int i = 0; i < workers; i++) {
+            Worker* w = fWorkers[(victim + i) % workers];
+            if (w != self && w->fDeque.popFront(work)) {
+                sk_atomic_dec(&fQueued);
+                return true;
+            }
+        }
+        return false;
+    }
+
     static void Loop(void* arg) {
-        ThreadPool* pool = (ThreadPool*)arg;
+        Worker* self = (Worker*)arg;
+        ThreadPool* pool = self->fPool;
+        *(Worker**)SkTLS::Get(CreateWorkerSlot, DeleteWorkerSlot) = self;
+
         Work work;
         while (true) {
-            {
-                AutoLock lock(&pool->fReady);
-                while (pool->fWork.isEmpty()) {
-                    if (pool->fDraining) {
-                        return;
-                    }
-                    pool->fReady.wait();
+            if (pool->findWork(self, &self->fRand, &work)) {
+                work.fn(work.arg);
+                sk_atomic_dec(work.pending);  // Release pairs with sk_acquire_load() in Wait().
+                continue;
+            }
+
+            AutoLock lock(&pool->fReady);
+            sk_atomic_inc(&pool->fSleeping);
+            while (sk_atomic_load(&pool->fQueued) <= 0) {
+                if (pool->fDraining) {
+                    sk_atomic_dec(&pool->fSleeping);
+                    return;
                 }
-                pool->fWork.pop(&work);
+                pool->fReady.wait();
             }
-            work.fn(work.arg);
-            sk_atomic_dec(work.pending);  // Release pairs with sk_acquire_load() in Wait().
+            sk_atomic_dec(&pool->fSleeping);
         }
     }
 
-    SkTDArray<Work>      fWork;
+    SkTDArray<Worker*>   fWorkers;
     SkTDArray<SkThread*> fThreads;
+    int32_t              fQueued;     // Approximate count of Work sitting in any deque.  Atomic.
+    int32_t              fSleeping;   // Number of workers waiting on fReady.  Atomic.
+    int32_t              fNextDeque;  // Round-robin counter for non-worker add()s.  Atomic.
     SkCondVar            fReady;
     bool                 fDraining;
 
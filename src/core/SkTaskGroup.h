@@ -37,6 +37,8 @@ public:
 
     // Block until all Tasks previously add()ed to this SkTaskGroup have run.
     // You may safely reuse this SkTaskGroup after wait() returns.
+    // Tasks may themselves create SkTaskGroups, add() subtasks and wait() on them:
+    // wait() runs queued work while it waits instead of blocking its thread.
     void wait();
 
 private:
@@ -7,6 +7,7 @@
 
 #include "SkTextBlob.h"
 
+#include "SkGlyphRunCache.h"
 #include "SkReadBuffer.h"
 #include "SkTypeface.h"
 #include "SkWriteBuffer.h"
@@ -121,9 +122,14 @@ SkTextBlob::SkTextBlob(int runCount, const SkRect& bounds)
     : fRunCount(runCount)
     , fBounds(bounds)
     , fUniqueID(next_id()) {
+    fAddedToCache.store(false);
 }
 
 SkTextBlob::~SkTextBlob() {
+    if (fAddedToCache.load()) {
+        SkNotifyTextBlobIsStale(fUniqueID);
+    }
+
     const RunRecord* run = RunRecord::First(this);
     for (int i = 0; i < fRunCount; ++i) {
         const RunRecord* nextRun = RunRecord::Next(run);
@@ -2174,6 +2174,15 @@ void SkXPSDevice::drawText(const SkDraw& d,
                   paint));
 }
 
+void SkXPSDevice::drawTextBlob(const SkDraw& d,
+                               const SkTextBlob* blob,
+                               SkScalar x, SkScalar y,
+                               const SkPaint& paint,
+                               SkDrawFilter* drawFilter) {
+    // Skip SkBitmapDevice's glyph mask cache; text goes through drawText() and drawPosText().
+    this->SkBaseDevice::drawTextBlob(d, blob, x, y, paint, drawFilter);
+}
+
 void SkXPSDevice::drawPosText(const SkDraw& d,
                               const void* text, size_t byteLen,
                               const SkScalar pos[], int scalarsPerPos,
@@ -6,6 +6,7 @@
  */
 
 #include "SkDocument.h"
+#include "SkPDFBitmap.h"
 #include "SkPDFCanon.h"
 #include "SkPDFCatalog.h"
 #include "SkPDFDevice.h"
@@ -14,6 +15,7 @@
 #include "SkPDFStream.h"
 #include "SkPDFTypes.h"
 #include "SkStream.h"
+#include "SkTaskGroup.h"
 
 static void emit_pdf_header(SkWStream* stream) {
     stream->writeText("%PDF-1.4\n%");
@@ -41,15 +43,10 @@ static void emit_pdf_footer(SkWStream* stream,
     stream->writeText("\n%%EOF");
 }
 
-static void perform_font_subsetting(
-        const SkTDArray<const SkPDFDevice*>& pageDevices,
-        SkPDFCatalog* catalog) {
+static void perform_font_subsetting(const SkPDFGlyphSetMap& usage,
+                                    SkPDFCatalog* catalog) {
     SkASSERT(catalog);
 
-    SkPDFGlyphSetMap usage;
-    for (int i = 0; i < pageDevices.count(); ++i) {
-        usage.merge(pageDevices[i]->getFontGlyphUsage());
-    }
     SkPDFGlyphSetMap::F2BIter iterator(usage);
     const SkPDFGlyphSetMap::FontGlyphSetPair* entry = iterator.next();
     while (entry) {
@@ -62,7 +59,10 @@ static void perform_font_subsetting(
     }
 }
 
-static SkPDFDict* create_pdf_page(const SkPDFDevice* pageDevice) {
+// If catalog is not NULL, the page's content stream is added to it, so
+// that it can be written before the page itself.
+static SkPDFDict* create_pdf_page(const SkPDFDevice* pageDevice,
+                                  SkPDFCatalog* catalog) {
     SkAutoTUnref<SkPDFDict> page(SkNEW_ARGS(SkPDFDict, ("Page")));
     SkAutoTUnref<SkPDFResourceDict> deviceResourceDict(
             pageDevice->createResourceDict());
@@ -80,6 +80,9 @@ static SkPDFDict* create_pdf_page(const SkPDFDevice* pageDevice) {
     SkAutoTUnref<SkPDFStream> contentStream(
             SkNEW_ARGS(SkPDFStream, (content.get())));
     page->insert("Contents", new SkPDFObjRef(contentStream.get()))->unref();
+    if (catalog) {
+        catalog->addObject(contentStream.get());
+    }
     return page.detach();
 }
 
@@ -166,90 +169,8 @@ static void generate_page_tree(const SkTDArray<SkPDFDict*>& pages,
     }
 }
 
-static bool emit_pdf_document(const SkTDArray<const SkPDFDevice*>& pageDevices,
-                              SkWStream* stream) {
-    if (pageDevices.isEmpty()) {
-        return false;
-    }
-
-    SkTDArray<SkPDFDict*> pages;
-    SkAutoTUnref<SkPDFDict> dests(SkNEW(SkPDFDict));
-
-    for (int i = 0; i < pageDevices.count(); i++) {
-        SkASSERT(pageDevices[i]);
-        SkASSERT(i == 0 ||
-                 pageDevices[i - 1]->getCanon() == pageDevices[i]->getCanon());
-        SkAutoTUnref<SkPDFDict> page(create_pdf_page(pageDevices[i]));
-        pageDevices[i]->appendDestinations(dests, page.get());
-        pages.push(page.detach());
-    }
-    SkPDFCatalog catalog;
-
-    SkTDArray<SkPDFDict*> pageTree;
-    SkAutoTUnref<SkPDFDict> docCatalog(SkNEW_ARGS(SkPDFDict, ("Catalog")));
-
-    SkPDFDict* pageTreeRoot;
-    generate_page_tree(pages, &pageTree, &pageTreeRoot);
-
-    docCatalog->insert("Pages", new SkPDFObjRef(pageTreeRoot))->unref();
-
-    /* TODO(vandebo): output intent
-    SkAutoTUnref<SkPDFDict> outputIntent = new SkPDFDict("OutputIntent");
-    outputIntent->insert("S", new SkPDFName("GTS_PDFA1"))->unref();
-    outputIntent->insert("OutputConditionIdentifier",
-                         new SkPDFString("sRGB"))->unref();
-    SkAutoTUnref<SkPDFArray> intentArray = new SkPDFArray;
-    intentArray->append(outputIntent.get());
-    docCatalog->insert("OutputIntent", intentArray.get());
-    */
-
-    if (dests->size() > 0) {
-        docCatalog->insert("Dests", SkNEW_ARGS(SkPDFObjRef, (dests.get())))
-                ->unref();
-    }
-
-    // Build font subsetting info before proceeding.
-    perform_font_subsetting(pageDevices, &catalog);
-
-    if (catalog.addObject(docCatalog.get())) {
-        docCatalog->addResources(&catalog);
-    }
-    size_t baseOffset = SkToOffT(stream->bytesWritten());
-    emit_pdf_header(stream);
-    SkTDArray<int32_t> offsets;
-    for (int i = 0; i < catalog.objects().count(); ++i) {
-        SkPDFObject* object = catalog.objects()[i];
-        offsets.push(SkToS32(stream->bytesWritten() - baseOffset));
-        SkASSERT(object == catalog.getSubstituteObject(object));
-        SkASSERT(catalog.getObjectNumber(object) == i + 1);
-        stream->writeDecAsText(i + 1);
-        stream->writeText(" 0 obj\n");  // Generation number is always 0.
-        object->emitObject(stream, &catalog);
-        stream->writeText("\nendobj\n");
-    }
-    int32_t xRefFileOffset = SkToS32(stream->bytesWritten() - baseOffset);
-
-    int32_t objCount = SkToS32(offsets.count() + 1);
-
-    stream->writeText("xref\n0 ");
-    stream->writeDecAsText(objCount + 1);
-    stream->writeText("\n0000000000 65535 f \n");
-    for (int i = 0; i < offsets.count(); i++) {
-        SkASSERT(offsets[i] > 0);
-        stream->writeBigDecAsText(offsets[i], 10);
-        stream->writeText(" 00000 n \n");
-    }
-    emit_pdf_footer(stream, &catalog, docCatalog.get(), objCount,
-                    xRefFileOffset);
-
-    // The page tree has both child and parent pointers, so it creates a
-    // reference cycle.  We must clear that cycle to properly reclaim memory.
-    for (int i = 0; i < pageTree.count(); i++) {
-        pageTree[i]->clear();
-    }
-    pageTree.safeUnrefAll();
-    pages.unrefAll();
-    return true;
+static void compress_object(SkPDFObject** object) {
+    (*object)->compress();
 }
 
 #if 0
@@ -298,9 +219,14 @@ class SkDocument_PDF : public SkDocument {
 public:
     SkDocument_PDF(SkWStream* stream,
                    void (*doneProc)(SkWStream*, bool),
-                   SkScalar rasterDpi)
+                   SkScalar rasterDpi,
+                   bool streaming)
         : SkDocument(stream, doneProc)
-        , fRasterDpi(rasterDpi) {}
+        , fDests(SkNEW(SkPDFDict))
+        , fBaseOffset(0)
+        , fBitmapCount(0)
+        , fRasterDpi(rasterDpi)
+        , fStreaming(streaming) {}
 
     virtual ~SkDocument_PDF() {
         // subclasses must call close() in their destructors
@@ -314,10 +240,8 @@ protected:
 
         SkISize pageSize = SkISize::Make(
                 SkScalarRoundToInt(width), SkScalarRoundToInt(height));
-        SkAutoTUnref<SkPDFDevice> device(
-                SkPDFDevice::Create(pageSize, fRasterDpi, &fCanon));
-        fCanvas.reset(SkNEW_ARGS(SkCanvas, (device.get())));
-        fPageDevices.push(device.detach());
+        fDevice.reset(SkPDFDevice::Create(pageSize, fRasterDpi, &fCanon));
+        fCanvas.reset(SkNEW_ARGS(SkCanvas, (fDevice.get())));
         fCanvas->clipRect(trimBox);
         fCanvas->translate(trimBox.x(), trimBox.y());
         return fCanvas.get();
@@ -327,33 +251,170 @@ protected:
         SkASSERT(fCanvas.get());
         fCanvas->flush();
         fCanvas.reset(NULL);
+
+        SkAutoTUnref<SkPDFDict> page(
+                create_pdf_page(fDevice, fStreaming ? &fCatalog : NULL));
+        fDevice->appendDestinations(fDests, page.get());
+        fGlyphUsage.merge(fDevice->getFontGlyphUsage());
+        fDevice.reset(NULL);
+        fPages.push(page.detach());
+
+        if (fStreaming) {
+            // Write what the last page left compressing, then compress
+            // this page's content and new images while the next one draws.
+            this->writePending(this->getStream());
+            const SkTDArray<SkPDFBitmap*>& bitmaps = fCanon.bitmaps();
+            for (; fBitmapCount < bitmaps.count(); ++fBitmapCount) {
+                if (fCatalog.addObject(bitmaps[fBitmapCount])) {
+                    bitmaps[fBitmapCount]->addResources(&fCatalog);
+                }
+            }
+            this->compressPending();
+        }
     }
 
     bool onClose(SkWStream* stream) override {
         SkASSERT(!fCanvas.get());
+        if (fPages.isEmpty()) {
+            this->reset();
+            return false;
+        }
+        this->writePending(stream);
 
-        bool success = emit_pdf_document(fPageDevices, stream);
-        fPageDevices.unrefAll();
-        fCanon.reset();
-        return success;
+        SkTDArray<SkPDFDict*> pageTree;
+        SkAutoTUnref<SkPDFDict> docCatalog(SkNEW_ARGS(SkPDFDict, ("Catalog")));
+
+        SkPDFDict* pageTreeRoot;
+        generate_page_tree(fPages, &pageTree, &pageTreeRoot);
+
+        docCatalog->insert("Pages", new SkPDFObjRef(pageTreeRoot))->unref();
+
+        /* TODO(vandebo): output intent
+        SkAutoTUnref<SkPDFDict> outputIntent = new SkPDFDict("OutputIntent");
+        outputIntent->insert("S", new SkPDFName("GTS_PDFA1"))->unref();
+        outputIntent->insert("OutputConditionIdentifier",
+                             new SkPDFString("sRGB"))->unref();
+        SkAutoTUnref<SkPDFArray> intentArray = new SkPDFArray;
+        intentArray->append(outputIntent.get());
+        docCatalog->insert("OutputIntent", intentArray.get());
+        */
+
+        if (fDests->size() > 0) {
+            docCatalog->insert("Dests", SkNEW_ARGS(SkPDFObjRef, (fDests.get())))
+                    ->unref();
+        }
+
+        // Build font subsetting info before proceeding.
+        perform_font_subsetting(fGlyphUsage, &fCatalog);
+
+        if (fCatalog.addObject(docCatalog.get())) {
+            docCatalog->addResources(&fCatalog);
+        }
+        this->compressPending();
+        this->writePending(stream);
+
+        int32_t xRefFileOffset = SkToS32(stream->bytesWritten() - fBaseOffset);
+
+        int32_t objCount = SkToS32(fOffsets.count() + 1);
+
+        stream->writeText("xref\n0 ");
+        stream->writeDecAsText(objCount + 1);
+        stream->writeText("\n0000000000 65535 f \n");
+        for (int i = 0; i < fOffsets.count(); i++) {
+            SkASSERT(fOffsets[i] > 0);
+            stream->writeBigDecAsText(fOffsets[i], 10);
+            stream->writeText(" 00000 n \n");
+        }
+        emit_pdf_footer(stream, &fCatalog, docCatalog.get(), objCount,
+                        xRefFileOffset);
+
+        // The page tree has both child and parent pointers, so it creates a
+        // reference cycle.  We must clear that cycle to properly reclaim memory.
+        for (int i = 0; i < pageTree.count(); i++) {
+            pageTree[i]->clear();
+        }
+        pageTree.safeUnrefAll();
+        this->reset();
+        return true;
     }
 
     void onAbort() override {
-        fPageDevices.unrefAll();
-        fCanon.reset();
+        this->reset();
     }
 
 private:
+    // Starts compressing the objects added to the catalog since the last
+    // writePending(), on other threads if SkTaskGroups are enabled.
+    void compressPending() {
+        SkASSERT(fPending.isEmpty());
+        const SkTDArray<SkPDFObject*>& objects = fCatalog.objects();
+        fPending.append(objects.count() - fOffsets.count(),
+                        objects.begin() + fOffsets.count());
+        fCompressTasks.batch(compress_object, fPending.begin(), fPending.count());
+    }
+
+    // Waits for the pending objects to compress, then writes them, after the
+    // header if they are the first.  Written objects are dropped.
+    void writePending(SkWStream* stream) {
+        fCompressTasks.wait();
+        if (fPending.isEmpty()) {
+            return;
+        }
+        if (fOffsets.isEmpty()) {
+            fBaseOffset = SkToOffT(stream->bytesWritten());
+            emit_pdf_header(stream);
+        }
+        for (int i = 0; i < fPending.count(); ++i) {
+            SkPDFObject* object = fPending[i];
+            fOffsets.push(SkToS32(stream->bytesWritten() - fBaseOffset));
+            SkASSERT(object == fCatalog.getSubstituteObject(object));
+            SkASSERT(fCatalog.getObjectNumber(object) == fOffsets.count());
+            stream->writeDecAsText(fOffsets.count());
+            stream->writeText(" 0 obj\n");  // Generation number is always 0.
+            object->emitObject(stream, &fCatalog);
+            stream->writeText("\nendobj\n");
+            object->drop();
+        }
+        fPending.rewind();
+    }
+
+    void reset() {
+        fCompressTasks.wait();
+        fPending.rewind();
+        fPages.unrefAll();
+        fPages.rewind();
+        fGlyphUsage.reset();
+        fCanon.reset();
+        fBitmapCount = 0;
+    }
+
     SkPDFCanon fCanon;
-    SkTDArray<const SkPDFDevice*> fPageDevices;
+    SkAutoTUnref<SkPDFDevice> fDevice;
     SkAutoTUnref<SkCanvas> fCanvas;
+
+    // Each finished page, its destinations, and the glyphs it uses.
+    SkTDArray<SkPDFDict*> fPages;
+    SkAutoTUnref<SkPDFDict> fDests;
+    SkPDFGlyphSetMap fGlyphUsage;
+
+    // fPending are the objects numbered after the fOffsets.count() already
+    // written, compressing on fCompressTasks.  When streaming, fBitmapCount
+    // of the canon's bitmaps have been added to the catalog.
+    SkPDFCatalog fCatalog;
+    SkTDArray<SkPDFObject*> fPending;
+    SkTaskGroup fCompressTasks;
+    SkTDArray<int32_t> fOffsets;
+    size_t fBaseOffset;
+    int fBitmapCount;
+
     SkScalar fRasterDpi;
+    bool fStreaming;
 };
 }  // namespace
 ///////////////////////////////////////////////////////////////////////////////
 
 SkDocument* SkDocument::CreatePDF(SkWStream* stream, SkScalar dpi) {
-    return stream ? SkNEW_ARGS(SkDocument_PDF, (stream, NULL, dpi)) : NULL;
+    return stream ? SkNEW_ARGS(SkDocument_PDF, (stream, NULL, dpi, false)) : NULL;
 }
 
 SkDocument* SkDocument::CreatePDF(const char path[], SkScalar dpi) {
@@ -363,5 +424,9 @@ SkDocument* SkDocument::CreatePDF(const char path[], SkScalar dpi) {
         return NULL;
     }
     auto delete_wstream = [](SkWStream* stream, bool) { SkDELETE(stream); };
-    return SkNEW_ARGS(SkDocument_PDF, (stream, delete_wstream, dpi));
+    return SkNEW_ARGS(SkDocument_PDF, (stream, delete_wstream, dpi, false));
+}
+
+SkDocument* SkDocument::CreateStreamingPDF(SkWStream* stream, SkScalar dpi) {
+    return stream ? SkNEW_ARGS(SkDocument_PDF, (stream, NULL, dpi, true)) : NULL;
 }
@@ -8,10 +8,13 @@
 
 
 #include "SkBlurMask.h"
+#include "Sk4x.h"
 #include "SkMath.h"
 #include "SkTemplates.h"
+#include "SkTLS.h"
 #include "SkEndian.h"
 
+SkBlurMaskSk4Policy gSkBlurMaskSk4Policy = kWhenFaster_SkBlurMaskSk4Policy;
 
 // This constant approximates the scaling done in the software path's
 // "high quality" mode, in SkBlurMask::Blur() (1 / sqrt(3)).
@@ -30,8 +33,264 @@ SkScalar SkBlurMask::ConvertSigmaToRadius(SkScalar sigma) {
     return sigma > 0.5f ? (sigma - 0.5f) / kBLUR_SIGMA_SCALE : 0.0f;
 }
 
+namespace {
+
+// Per-thread scratch memory for BoxBlur(), so back-to-back blurs reuse one temporary
+// mask (and the Sk4i lane buffer) instead of going to malloc for each.
+class BlurScratch {
+public:
+    BlurScratch() : fMaskSize(0), fLaneCount(0) {}
+
+    static BlurScratch* Get() {
+        return static_cast<BlurScratch*>(SkTLS::Get(Create, Delete));
+    }
+
+    uint8_t*  mask(size_t size)   { return Grow(&fMask,  &fMaskSize,  size);  }
+    uint32_t* lanes(size_t count) { return Grow(&fLanes, &fLaneCount, count); }
+
+    // Frees buffers too big to be worth holding on to between blurs.
+    void trim() {
+        if (fMaskSize > kMaxRetainedBytes) {
+            fMask.reset(0);
+            fMaskSize = 0;
+        }
+        if (fLaneCount * sizeof(uint32_t) > kMaxRetainedBytes) {
+            fLanes.reset(0);
+            fLaneCount = 0;
+        }
+    }
+
+private:
+    static const size_t kMaxRetainedBytes = 1 << 20;
+
+    template <typename T>
+    static T* Grow(SkAutoTMalloc<T>* storage, size_t* count, size_t needed) {
+        if (needed > *count) {
+            storage->reset(needed);
+            *count = needed;
+        }
+        return storage->get();
+    }
+
+    static void* Create() { return SkNEW(BlurScratch); }
+    static void Delete(void* scratch) { SkDELETE(static_cast<BlurScratch*>(scratch)); }
+
+    SkAutoTMalloc<uint8_t>  fMask;
+    size_t                  fMaskSize;
+    SkAutoTMalloc<uint32_t> fLanes;
+    size_t                  fLaneCount;
+};
+
+}  // namespace
+
 #define UNROLL_SEPARABLE_LOOPS
 
+/**
+ * Sk4i versions of boxBlur() and boxBlurInterp() below.  These blur four rows
+ * at once, one row per lane, and are bit-identical to the scalar code.
+ *
+ * Each group of four rows is first interleaved into lanes, with zero padding on
+ * both ends.  That turns the border and center phases of the scalar loops into
+ * one uniform sliding window, reads each source byte only once, and lets a
+ * transposing pass write four adjacent bytes per column instead of scattering
+ * single bytes across the whole destination.
+ *
+ * The scalar code computes (sum * scale + half) >> 24 in uint32_t.  That
+ * arithmetic is modulo 2^32, so we may just as well sum up src * scale, which
+ * is scaled as it's interleaved.  This keeps multiplies (which SSE2 lacks for
+ * 32-bit lanes) out of the inner loop.  Sk4i's lanes are signed, but its add()
+ * and subtract() wrap around modulo 2^32 too, on every backend, so the sums'
+ * bits come out the same as the scalar code's.
+ *
+ * These handle rows in groups of four and return how many rows they blurred;
+ * the scalar code finishes off any remaining rows.
+ */
+
+// Four 32-bit lanes don't beat the unrolled scalar loops on their own; where
+// this pays off is transposing passes with a large or cache-unfriendly column
+// stride, where the scalar code's single byte writes keep evicting each other.
+static bool use_sk4(SkBlurMaskSk4Policy policy, bool transpose, int new_width, int height) {
+    switch (policy) {
+        case kNever_SkBlurMaskSk4Policy:  return false;
+        case kAlways_SkBlurMaskSk4Policy: return true;
+        default: break;
+    }
+    // These thresholds were measured on x86; there's nothing deep about them.
+    int64_t size = sk_64_mul(new_width, height);
+    return transpose && size > (1 << 16) && (0 == (height & 255) || size > (1 << 20));
+}
+
+// Interleaves four rows of width bytes into lanes[], scaling each by scale, with leftPad
+// zeros before and rightPad zeros after, so lanes[4*i + k] is byte (i - leftPad) of row k.
+static void interleave4(const uint8_t* src, int src_y_stride, int width,
+                        int leftPad, int rightPad, uint32_t scale, uint32_t* lanes) {
+    sk_bzero(lanes, 4 * leftPad * sizeof(uint32_t));
+    lanes += 4 * leftPad;
+    const uint8_t* r0 = src;
+    const uint8_t* r1 = r0 + src_y_stride;
+    const uint8_t* r2 = r1 + src_y_stride;
+    const uint8_t* r3 = r2 + src_y_stride;
+    for (int x = 0; x < width; ++x) {
+        lanes[0] = r0[x] * scale;
+        lanes[1] = r1[x] * scale;
+        lanes[2] = r2[x] * scale;
+        lanes[3] = r3[x] * scale;
+        lanes += 4;
+    }
+    sk_bzero(lanes, 4 * rightPad * sizeof(uint32_t));
+}
+
+static inline Sk4i load4(const uint32_t* lanes) {
+    return Sk4i::Load(reinterpret_cast<const int32_t*>(lanes));
+}
+
+// Stores four bytes to p, with b0 first, whatever the CPU's byte order.
+static inline void store_bytes(uint8_t* p, uint32_t b0, uint32_t b1, uint32_t b2, uint32_t b3) {
+    uint32_t packed = SkEndian_SwapLE32(b0 | (b1 << 8) | (b2 << 16) | (b3 << 24));
+    memcpy(p, &packed, sizeof(packed));
+}
+
+/**
+ * Runs count steps of a blur, writing the top byte of each lane of each step.
+ * Lane k of step x goes to dst[x * dst_x_stride + k * dst_y_stride].
+ * Blur provides Sk4i next(), the next step's unshifted sums.
+ */
+template <typename Blur>
+static void write_steps(Blur* blur, int count, uint8_t* dst, int dst_x_stride, int dst_y_stride) {
+    uint32_t bytes[4];
+    if (1 == dst_y_stride) {
+        // Transposing: each step's lanes are adjacent.
+        for (int x = 0; x < count; ++x) {
+            blur->next().shiftRight(24).store(reinterpret_cast<int32_t*>(bytes));
+            store_bytes(dst, bytes[0], bytes[1], bytes[2], bytes[3]);
+            dst += dst_x_stride;
+        }
+        return;
+    }
+    // Not transposing: lanes are rows, so gather four steps of each row into a word.
+    SkASSERT(1 == dst_x_stride);
+    int x = 0;
+    for (; x + 4 <= count; x += 4) {
+        Sk4i step0 = blur->next().shiftRight(24);
+        Sk4i step1 = blur->next().shiftRight(24).shiftLeft(8);
+        Sk4i step2 = blur->next().shiftRight(24).shiftLeft(16);
+        Sk4i step3 = blur->next().shiftRight(24).shiftLeft(24);
+        (step0 | step1 | step2 | step3).store(reinterpret_cast<int32_t*>(bytes));
+        for (int k = 0; k < 4; ++k) {
+            uint32_t packed = SkEndian_SwapLE32(bytes[k]);
+            memcpy(dst + k * dst_y_stride, &packed, sizeof(packed));
+        }
+        dst += 4;
+    }
+    for (; x < count; ++x) {
+        blur->next().shiftRight(24).store(reinterpret_cast<int32_t*>(bytes));
+        for (int k = 0; k < 4; ++k) {
+            dst[k * dst_y_stride] = SkToU8(bytes[k]);
+        }
+        dst += 1;
+    }
+}
+
+// One sliding window over interleaved lanes, as in boxBlur().
+class Sk4BoxBlur {
+public:
+    Sk4BoxBlur(const uint32_t* lanes, int diameter)
+        : fLeft(lanes), fRight(lanes + 4 * diameter), fSum(1 << 23) {}  // 1<<23 is half
+
+    Sk4i next() {
+        fSum += load4(fRight);
+        Sk4i result = fSum;
+        fSum -= load4(fLeft);
+        fRight += 4;
+        fLeft += 4;
+        return result;
+    }
+
+private:
+    const uint32_t* fLeft;
+    const uint32_t* fRight;
+    Sk4i            fSum;
+};
+
+// The inner sum is the outer sum without its two ends, so as in boxBlurInterp(),
+//   outer_sum * outer_scale + inner_sum * inner_scale
+// = outer_sum * (outer_scale + inner_scale) - (left + right) * inner_scale.
+class Sk4BoxBlurInterp {
+public:
+    Sk4BoxBlurInterp(const uint32_t* outer, const uint32_t* inner, int diameter)
+        : fOuter(outer, diameter), fInnerLeft(inner), fInnerRight(inner + 4 * diameter) {}
+
+    Sk4i next() {
+        Sk4i result = fOuter.next() - load4(fInnerLeft) - load4(fInnerRight);
+        fInnerRight += 4;
+        fInnerLeft += 4;
+        return result;
+    }
+
+private:
+    Sk4BoxBlur      fOuter;
+    const uint32_t* fInnerLeft;
+    const uint32_t* fInnerRight;
+};
+
+static int boxBlur_Sk4(const uint8_t* src, int src_y_stride, uint8_t* dst,
+                       int leftRadius, int rightRadius, int width, int height,
+                       bool transpose)
+{
+    int diameter = leftRadius + rightRadius;
+    int kernelSize = diameter + 1;
+    uint32_t scale = (1 << 24) / kernelSize;
+    int new_width = width + SkMax32(leftRadius, rightRadius) * 2;
+    int dst_x_stride = transpose ? height : 1;
+    int dst_y_stride = transpose ? 1 : new_width;
+    // The scalar code writes rightRadius - leftRadius zeros before the blur, and
+    // leftRadius - rightRadius after it.  Zero input blurs to zero, so we just pad more.
+    int leftPad = diameter + SkMax32(rightRadius - leftRadius, 0);
+    int rightPad = new_width + diameter - width - leftPad;
+    uint32_t* lanes = BlurScratch::Get()->lanes(4 * (width + leftPad + rightPad));
+    int y = 0;
+    for (; y + 4 <= height; y += 4) {
+        interleave4(src + y * src_y_stride, src_y_stride, width, leftPad, rightPad, scale, lanes);
+        Sk4BoxBlur blur(lanes, diameter);
+        write_steps(&blur, new_width, dst + y * dst_y_stride, dst_x_stride, dst_y_stride);
+    }
+    return y;
+}
+
+static int boxBlurInterp_Sk4(const uint8_t* src, int src_y_stride, uint8_t* dst,
+                             int radius, int width, int height,
+                             bool transpose, uint8_t outer_weight)
+{
+    int diameter = radius * 2;
+    int kernelSize = diameter + 1;
+    int inner_weight = 255 - outer_weight;
+    outer_weight += outer_weight >> 7;
+    inner_weight += inner_weight >> 7;
+    uint32_t outer_scale = (outer_weight << 16) / kernelSize;
+    uint32_t inner_scale = (inner_weight << 16) / (kernelSize - 2);
+    int new_width = width + diameter;
+    int dst_x_stride = transpose ? height : 1;
+    int dst_y_stride = transpose ? 1 : new_width;
+    int laneCount = 4 * (width + 2 * diameter);
+    uint32_t* outer = BlurScratch::Get()->lanes(2 * laneCount);
+    uint32_t* inner = outer + laneCount;
+    int y = 0;
+    for (; y + 4 <= height; y += 4) {
+        const uint8_t* rows = src + y * src_y_stride;
+        interleave4(rows, src_y_stride, width, diameter, diameter,
+                    outer_scale + inner_scale, outer);
+        interleave4(rows, src_y_stride, width, diameter, diameter, inner_scale, inner);
+        // When width < diameter, the scalar code's middle phase reuses the inner sum
+        // from its last step, which left out the last pixel, rather than recomputing it.
+        for (int x = width; x < diameter; ++x) {
+            memcpy(inner + 4 * x, inner + 4 * (diameter + width - 1), 4 * sizeof(uint32_t));
+        }
+        Sk4BoxBlurInterp blur(outer, inner, diameter);
+        write_steps(&blur, new_width, dst + y * dst_y_stride, dst_x_stride, dst_y_stride);
+    }
+    return y;
+}
+
 /**
  * This function performs a box blur in X, of the given radius.  If the
  * "transpose" parameter is true, it will transpose the pixels on write,
@@ -78,7 +337,7 @@ SkScalar SkBlurMask::ConvertSigmaToRadius(SkScalar sigma) {
  */
 static int boxBlur(const uint8_t* src, int src_y_stride, uint8_t* dst,
                    int leftRadius, int rightRadius, int width, int height,
-                   bool transpose)
+                   bool transpose, SkBlurMaskSk4Policy policy)
 {
     int diameter = leftRadius + rightRadius;
     int kernelSize = diameter + 1;
@@ -88,7 +347,12 @@ static int boxBlur(const uint8_t* src, int src_y_stride, uint8_t* dst,
     int dst_x_stride = transpose ? height : 1;
     int dst_y_stride = transpose ? 1 : new_width;
     uint32_t half = 1 << 23;
-    for (int y = 0; y < height; ++y) {
+    int y = 0;
+    if (use_sk4(policy, transpose, new_width, height)) {
+        y = boxBlur_Sk4(src, src_y_stride, dst, leftRadius, rightRadius, width, height,
+                        transpose);
+    }
+    for (; y < height; ++y) {
         uint32_t sum = 0;
         uint8_t* dptr = dst + y * dst_y_stride;
         const uint8_t* right = src + y * src_y_stride;
@@ -280,8 +544,14 @@ static int boxBlur(const uint8_t* src, int src_y_stride, uint8_t* dst,
 
 static int boxBlurInterp(const uint8_t* src, int src_y_stride, uint8_t* dst,
                          int radius, int width, int height,
-                         bool transpose, uint8_t outer_weight)
+                         bool transpose, uint8_t outer_weight, SkBlurMaskSk4Policy policy)
 {
+    int y = 0;
+    if (use_sk4(policy, transpose, width + radius * 2, height)) {
+        // Before outer_weight is adjusted below; boxBlurInterp_Sk4() does that itself.
+        y = boxBlurInterp_Sk4(src, src_y_stride, dst, radius, width, height, transpose,
+                              outer_weight);
+    }
     int diameter = radius * 2;
     int kernelSize = diameter + 1;
     int border = SkMin32(width, diameter);
@@ -294,7 +564,7 @@ static int boxBlurInterp(const uint8_t* src, int src_y_stride, uint8_t* dst,
     int new_width = width + diameter;
     int dst_x_stride = transpose ? height : 1;
     int dst_y_stride = transpose ? 1 : new_width;
-    for (int y = 0; y < height; ++y) {
+    for (; y < height; ++y) {
         uint32_t outer_sum = 0, inner_sum = 0;
         uint8_t* dptr = dst + y * dst_y_stride;
         const uint8_t* right = src + y * src_y_stride;
@@ -482,6 +752,12 @@ void SkMask_FreeImage(uint8_t* image) {
 bool SkBlurMask::BoxBlur(SkMask* dst, const SkMask& src,
                          SkScalar sigma, SkBlurStyle style, SkBlurQuality quality,
                          SkIPoint* margin, bool force_quality) {
+    return BoxBlur(dst, src, sigma, style, quality, gSkBlurMaskSk4Policy, margin, force_quality);
+}
+
+bool SkBlurMask::BoxBlur(SkMask* dst, const SkMask& src,
+                         SkScalar sigma, SkBlurStyle style, SkBlurQuality quality,
+                         SkBlurMaskSk4Policy policy, SkIPoint* margin, bool force_quality) {
 
     if (src.fFormat != SkMask::kA8_Format) {
         return false;
@@ -545,8 +821,8 @@ bool SkBlurMask::BoxBlur(SkMask* dst, const SkMask& src,
         SkAutoTCallVProc<uint8_t, SkMask_FreeImage> autoCall(dp);
 
         // build the blurry destination
-        SkAutoTMalloc<uint8_t>  tmpBuffer(dstSize);
-        uint8_t*                tp = tmpBuffer.get();
+        BlurScratch*            scratch = BlurScratch::Get();
+        uint8_t*                tp = scratch->mask(dstSize);
         int w = sw, h = sh;
 
         if (outerWeight == 255) {
@@ -554,33 +830,35 @@ bool SkBlurMask::BoxBlur(SkMask* dst, const SkMask& src,
             get_adjusted_radii(passRadius, &loRadius, &hiRadius);
             if (kHigh_SkBlurQuality == quality) {
                 // Do three X blurs, with a transpose on the final one.
-                w = boxBlur(sp, src.fRowBytes, tp, loRadius, hiRadius, w, h, false);
-                w = boxBlur(tp, w,             dp, hiRadius, loRadius, w, h, false);
-                w = boxBlur(dp, w,             tp, hiRadius, hiRadius, w, h, true);
+                w = boxBlur(sp, src.fRowBytes, tp, loRadius, hiRadius, w, h, false, policy);
+                w = boxBlur(tp, w,             dp, hiRadius, loRadius, w, h, false, policy);
+                w = boxBlur(dp, w,             tp, hiRadius, hiRadius, w, h, true, policy);
                 // Do three Y blurs, with a transpose on the final one.
-                h = boxBlur(tp, h,             dp, loRadius, hiRadius, h, w, false);
-                h = boxBlur(dp, h,             tp, hiRadius, loRadius, h, w, false);
-                h = boxBlur(tp, h,             dp, hiRadius, hiRadius, h, w, true);
+                h = boxBlur(tp, h,             dp, loRadius, hiRadius, h, w, false, policy);
+                h = boxBlur(dp, h,             tp, hiRadius, loRadius, h, w, false, policy);
+                h = boxBlur(tp, h,             dp, hiRadius, hiRadius, h, w, true, policy);
             } else {
-                w = boxBlur(sp, src.fRowBytes, tp, rx, rx, w, h, true);
-                h = boxBlur(tp, h,             dp, ry, ry, h, w, true);
+                w = boxBlur(sp, src.fRowBytes, tp, rx, rx, w, h, true, policy);
+                h = boxBlur(tp, h,             dp, ry, ry, h, w, true, policy);
             }
         } else {
             if (kHigh_SkBlurQuality == quality) {
                 // Do three X blurs, with a transpose on the final one.
-                w = boxBlurInterp(sp, src.fRowBytes, tp, rx, w, h, false, outerWeight);
-                w = boxBlurInterp(tp, w,             dp, rx, w, h, false, outerWeight);
-                w = boxBlurInterp(dp, w,             tp, rx, w, h, true, outerWeight);
+                w = boxBlurInterp(sp, src.fRowBytes, tp, rx, w, h, false, outerWeight, policy);
+                w = boxBlurInterp(tp, w,             dp, rx, w, h, false, outerWeight, policy);
+                w = boxBlurInterp(dp, w,             tp, rx, w, h, true, outerWeight, policy);
                 // Do three Y blurs, with a transpose on the final one.
-                h = boxBlurInterp(tp, h,             dp, ry, h, w, false, outerWeight);
-                h = boxBlurInterp(dp, h,             tp, ry, h, w, false, outerWeight);
-                h = boxBlurInterp(tp, h,             dp, ry, h, w, true, outerWeight);
+                h = boxBlurInterp(tp, h,             dp, ry, h, w, false, outerWeight, policy);
+                h = boxBlurInterp(dp, h,             tp, ry, h, w, false, outerWeight, policy);
+                h = boxBlurInterp(tp, h,             dp, ry, h, w, true, outerWeight, policy);
             } else {
-                w = boxBlurInterp(sp, src.fRowBytes, tp, rx, w, h, true, outerWeight);
-                h = boxBlurInterp(tp, h,             dp, ry, h, w, true, outerWeight);
+                w = boxBlurInterp(sp, src.fRowBytes, tp, rx, w, h, true, outerWeight, policy);
+                h = boxBlurInterp(tp, h,             dp, ry, h, w, true, outerWeight, policy);
             }
         }
 
+        scratch->trim();
+
         dst->fImage = dp;
         // if need be, alloc the "real" dst (same size as src) and copy/merge
         // the blur into it (applying the src)
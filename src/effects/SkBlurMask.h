@@ -13,6 +13,15 @@
 #include "SkMask.h"
 #include "SkRRect.h"
 
+// When BoxBlur() blurs four rows at a time with Sk4i instead of one at a time.
+// The output is identical either way; this is here so tests and benches can compare.
+enum SkBlurMaskSk4Policy {
+    kNever_SkBlurMaskSk4Policy,
+    kWhenFaster_SkBlurMaskSk4Policy,    // The default.
+    kAlways_SkBlurMaskSk4Policy,
+};
+extern SkBlurMaskSk4Policy gSkBlurMaskSk4Policy;
+
 class SkBlurMask {
 public:
     static bool BlurRect(SkScalar sigma, SkMask *dst, const SkRect &src, SkBlurStyle,
@@ -33,6 +42,12 @@ public:
     static bool BoxBlur(SkMask* dst, const SkMask& src,
                         SkScalar sigma, SkBlurStyle style, SkBlurQuality quality,
                         SkIPoint* margin = NULL, bool force_quality=false);
+    // As above, but uses Sk4i as policy says rather than as gSkBlurMaskSk4Policy says, so tests
+    // can compare the two without changing the global while other threads blur.
+    static bool BoxBlur(SkMask* dst, const SkMask& src,
+                        SkScalar sigma, SkBlurStyle style, SkBlurQuality quality,
+                        SkBlurMaskSk4Policy policy,
+                        SkIPoint* margin = NULL, bool force_quality=false);
 
     // the "ground truth" blur does a gaussian convolution; it's slow
     // but useful for comparison purposes.
@@ -31,7 +31,7 @@ void GrPathRenderer::AddPathRenderers(GrContext* ctx, GrPathRendererChain* chain
     chain->addPathRenderer(SkNEW(GrAndroidPathRenderer))->unref();
 #endif
 #if GR_TESSELLATING_PATH_RENDERING
-    chain->addPathRenderer(new GrTessellatingPathRenderer)->unref();
+    chain->addPathRenderer(SkNEW_ARGS(GrTessellatingPathRenderer, (ctx)))->unref();
 #endif
     if (GrPathRenderer* pr = GrStencilAndCoverPathRenderer::Create(ctx)) {
         chain->addPathRenderer(pr)->unref();
@@ -359,6 +359,8 @@ public:
             fTextureCreates = 0;
             fTextureUploads = 0;
             fStencilBufferCreates = 0;
+            fTessellationCacheHits = 0;
+            fTessellationCacheMisses = 0;
         }
 
         int renderTargetBinds() const { return fRenderTargetBinds; }
@@ -370,6 +372,10 @@ public:
         int textureUploads() const { return fTextureUploads; }
         void incTextureUploads() { fTextureUploads++; }
         void incStencilBufferCreates() { fStencilBufferCreates++; }
+        int tessellationCacheHits() const { return fTessellationCacheHits; }
+        void incTessellationCacheHits() { fTessellationCacheHits++; }
+        int tessellationCacheMisses() const { return fTessellationCacheMisses; }
+        void incTessellationCacheMisses() { fTessellationCacheMisses++; }
         void dump(SkString*);
 
     private:
@@ -378,6 +384,8 @@ public:
         int fTextureCreates;
         int fTextureUploads;
         int fStencilBufferCreates;
+        int fTessellationCacheHits;
+        int fTessellationCacheMisses;
 #else
         void dump(SkString*) {};
         void incRenderTargetBinds() {}
@@ -385,6 +393,8 @@ public:
         void incTextureCreates() {}
         void incTextureUploads() {}
         void incStencilBufferCreates() {}
+        void incTessellationCacheHits() {}
+        void incTessellationCacheMisses() {}
 #endif
     };
 
@@ -133,7 +133,7 @@ public:
 
         fOpIndexStack.push(drawPictureOffset);
 
-        SkAutoCanvasMatrixPaint acmp(fCanvas, &dp.matrix, dp.paint, dp.picture->cullRect());
+        SkAutoCanvasMatrixPaint acmp(fCanvas, dp.matrix.get(), dp.paint, dp.picture->cullRect());
 
         // Draw sub-pictures with the same replacement list but a different picture
         ReplaceDraw draw(fCanvas, fLayerCache, 
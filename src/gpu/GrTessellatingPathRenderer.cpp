@@ -9,10 +9,16 @@
 
 #include "GrBatch.h"
 #include "GrBatchTarget.h"
+#include "GrContext.h"
 #include "GrDefaultGeoProcFactory.h"
+#include "GrGpu.h"
 #include "GrPathUtils.h"
+#include "GrResourceKey.h"
+#include "GrVertexBuffer.h"
 #include "SkChunkAlloc.h"
 #include "SkGeometry.h"
+#include "SkMessageBus.h"
+#include "SkPathPriv.h"
 
 #include <stdio.h>
 
@@ -78,6 +84,12 @@
  * The choice is arbitrary, but most test cases are wider than they are tall, so the
  * default is to sweep in X. In the future, we may want to make this a runtime parameter
  * and base it on the aspect ratio of the clip bounds.
+ *
+ * The triangles are in path space, so unless the path is volatile, they are cached in a vertex
+ * buffer in the GrResourceCache. The key is the path's generation ID, its fill type and the view
+ * matrix's scale, rounded up to a quarter octave (the path is tessellated at that scale), plus
+ * the clip bounds for inverse fills. A listener on the path's SkPathRef invalidates the entry
+ * when the path is edited or deleted.
  */
 #define LOGGING_ENABLED 0
 #define WIREFRAME 0
@@ -1414,9 +1426,153 @@ void* polys_to_triangles(Poly* polys, SkPath::FillType fillType, void* data) {
     return d;
 }
 
+// Where tessellate() puts its triangles.
+class VertexAllocator {
+public:
+    virtual ~VertexAllocator() {}
+    // Returns space for (at most) vertexCount vertices, or NULL.
+    virtual SkPoint* lock(int vertexCount) = 0;
+    // Called with the number of vertices actually written to the space lock() returned.
+    virtual void unlock(int actualCount) = 0;
 };
 
-GrTessellatingPathRenderer::GrTessellatingPathRenderer() {
+// This is the driver for all six stages. Returns the number of vertices written.
+int tessellate(const SkPath& path, SkScalar tol, const SkRect& clipBounds,
+               VertexAllocator* allocator) {
+    int contourCnt;
+    int maxPts = GrPathUtils::worstCasePointCount(path, &contourCnt, tol);
+    if (maxPts <= 0) {
+        return 0;
+    }
+    if (maxPts > ((int)SK_MaxU16 + 1)) {
+        SkDebugf("Path not rendered, too many verts (%d)\n", maxPts);
+        return 0;
+    }
+    SkPath::FillType fillType = path.getFillType();
+    if (SkPath::IsInverseFillType(fillType)) {
+        contourCnt++;
+    }
+
+    LOG("got %d pts, %d contours\n", maxPts, contourCnt);
+    SkAutoTDeleteArray<Vertex*> contours(SkNEW_ARRAY(Vertex *, contourCnt));
+
+    // For the initial size of the chunk allocator, estimate based on the point count:
+    // one vertex per point for the initial passes, plus two for the vertices in the
+    // resulting Polys, since the same point may end up in two Polys.  Assume minimal
+    // connectivity of one Edge per Vertex (will grow for intersections).
+    SkChunkAlloc alloc(maxPts * (3 * sizeof(Vertex) + sizeof(Edge)));
+    path_to_contours(path, tol, clipBounds, contours.get(), alloc);
+    Poly* polys;
+    polys = contours_to_polys(contours.get(), contourCnt, alloc);
+    int count = 0;
+    for (Poly* poly = polys; poly; poly = poly->fNext) {
+        if (apply_fill_type(fillType, poly->fWinding) && poly->fCount >= 3) {
+            count += (poly->fCount - 2) * (WIREFRAME ? 6 : 3);
+        }
+    }
+    if (0 == count) {
+        return 0;
+    }
+
+    SkPoint* vertices = allocator->lock(count);
+    if (!vertices) {
+        SkDebugf("Could not allocate vertices\n");
+        return 0;
+    }
+
+    LOG("emitting %d verts\n", count);
+    SkPoint* end = static_cast<SkPoint*>(polys_to_triangles(polys, fillType, vertices));
+    int actualCount = static_cast<int>(end - vertices);
+    LOG("actual count: %d\n", actualCount);
+    SkASSERT(actualCount <= count);
+    allocator->unlock(actualCount);
+    return actualCount;
+}
+
+// Tessellates into a batch's share of the vertex pool.
+class PoolAllocator : public VertexAllocator {
+public:
+    PoolAllocator(GrBatchTarget* batchTarget, size_t stride)
+        : fBatchTarget(batchTarget), fStride(stride), fCount(0), fVertexBuffer(NULL)
+        , fFirstVertex(0) {}
+
+    SkPoint* lock(int vertexCount) override {
+        fCount = vertexCount;
+        return static_cast<SkPoint*>(fBatchTarget->vertexPool()->makeSpace(fStride, vertexCount,
+                                                                          &fVertexBuffer,
+                                                                          &fFirstVertex));
+    }
+    void unlock(int actualCount) override {
+        fBatchTarget->putBackVertices((size_t)(fCount - actualCount), fStride);
+    }
+
+    const GrVertexBuffer* vertexBuffer() const { return fVertexBuffer; }
+    int firstVertex() const { return fFirstVertex; }
+
+private:
+    GrBatchTarget*        fBatchTarget;
+    size_t                fStride;
+    int                   fCount;
+    const GrVertexBuffer* fVertexBuffer;
+    int                   fFirstVertex;
+};
+
+// Tessellates into a vertex buffer of its own, sized to fit, to be cached.
+class BufferAllocator : public VertexAllocator {
+public:
+    explicit BufferAllocator(GrGpu* gpu) : fGpu(gpu) {}
+
+    SkPoint* lock(int vertexCount) override {
+        fVertices.reset(vertexCount);
+        return fVertices.get();
+    }
+    void unlock(int actualCount) override {
+        if (0 == actualCount) {
+            return;
+        }
+        size_t size = actualCount * sizeof(SkPoint);
+        fVertexBuffer.reset(fGpu->createVertexBuffer(size, false));
+        if (fVertexBuffer && !fVertexBuffer->updateData(fVertices.get(), size)) {
+            fVertexBuffer.reset(NULL);
+        }
+    }
+
+    GrVertexBuffer* vertexBuffer() { return fVertexBuffer; }
+
+private:
+    GrGpu*                        fGpu;
+    SkAutoTMalloc<SkPoint>        fVertices;
+    SkAutoTUnref<GrVertexBuffer>  fVertexBuffer;
+};
+
+// When the path's generation ID changes, invalidate its cached vertex buffer.
+class PathInvalidator : public SkPathRef::GenIDChangeListener {
+public:
+    explicit PathInvalidator(const GrUniqueKey& key) : fMsg(key) {}
+private:
+    GrUniqueKeyInvalidatedMessage fMsg;
+
+    void onChange() override {
+        SkMessageBus<GrUniqueKeyInvalidatedMessage>::Post(fMsg);
+    }
+
+    // A purged vertex buffer is re-cached under the same key; keep one invalidator for it.
+    const void* kind() const override {
+        static const char kKind = 0;
+        return &kKind;
+    }
+    bool equals(const GenIDChangeListener& other) const override {
+        return static_cast<const PathInvalidator&>(other).fMsg.key() == fMsg.key();
+    }
+};
+
+// The view scale is rounded up to a multiple of 1/kScaleStepsPerOctave octaves, so that all the
+// scales in a step share one tessellation, at least as fine as each of them needs.
+static const int kScaleStepsPerOctave = 4;
+
+};
+
+GrTessellatingPathRenderer::GrTessellatingPathRenderer(GrContext* context) : fContext(context) {
 }
 
 GrPathRenderer::StencilSupport GrTessellatingPathRenderer::onGetStencilSupport(
@@ -1441,11 +1597,16 @@ bool GrTessellatingPathRenderer::canDrawPath(const GrDrawTarget* target,
 class TessellatingPathBatch : public GrBatch {
 public:
 
+    // If vertexBuffer is non-NULL, it holds the path's triangles, and the batch draws those.
+    // Otherwise it tessellates the path itself, with the given tolerance.
     static GrBatch* Create(const GrColor& color,
                            const SkPath& path,
                            const SkMatrix& viewMatrix,
-                           SkRect clipBounds) {
-        return SkNEW_ARGS(TessellatingPathBatch, (color, path, viewMatrix, clipBounds));
+                           SkRect clipBounds,
+                           SkScalar tolerance,
+                           const GrVertexBuffer* vertexBuffer) {
+        return SkNEW_ARGS(TessellatingPathBatch, (color, path, viewMatrix, clipBounds, tolerance,
+                                                  vertexBuffer));
     }
 
     const char* name() const override { return "TessellatingPathBatch"; }
@@ -1469,64 +1630,27 @@ public:
     }
 
     void generateGeometry(GrBatchTarget* batchTarget, const GrPipeline* pipeline) override {
-        SkScalar tol = GrPathUtils::scaleToleranceToSrc(SK_Scalar1, fViewMatrix, fPath.getBounds());
-        int contourCnt;
-        int maxPts = GrPathUtils::worstCasePointCount(fPath, &contourCnt, tol);
-        if (maxPts <= 0) {
-            return;
-        }
-        if (maxPts > ((int)SK_MaxU16 + 1)) {
-            SkDebugf("Path not rendered, too many verts (%d)\n", maxPts);
-            return;
-        }
-        SkPath::FillType fillType = fPath.getFillType();
-        if (SkPath::IsInverseFillType(fillType)) {
-            contourCnt++;
-        }
-
-        LOG("got %d pts, %d contours\n", maxPts, contourCnt);
         uint32_t flags = GrDefaultGeoProcFactory::kPosition_GPType;
         SkAutoTUnref<const GrGeometryProcessor> gp(
             GrDefaultGeoProcFactory::Create(flags, fColor, fViewMatrix, SkMatrix::I()));
-        batchTarget->initDraw(gp, pipeline);
-        gp->initBatchTracker(batchTarget->currentBatchTracker(), fPipelineInfo);
-
-        SkAutoTDeleteArray<Vertex*> contours(SkNEW_ARRAY(Vertex *, contourCnt));
-
-        // For the initial size of the chunk allocator, estimate based on the point count:
-        // one vertex per point for the initial passes, plus two for the vertices in the
-        // resulting Polys, since the same point may end up in two Polys.  Assume minimal
-        // connectivity of one Edge per Vertex (will grow for intersections).
-        SkChunkAlloc alloc(maxPts * (3 * sizeof(Vertex) + sizeof(Edge)));
-        path_to_contours(fPath, tol, fClipBounds, contours.get(), alloc);
-        Poly* polys;
-        polys = contours_to_polys(contours.get(), contourCnt, alloc);
-        int count = 0;
-        for (Poly* poly = polys; poly; poly = poly->fNext) {
-            if (apply_fill_type(fillType, poly->fWinding) && poly->fCount >= 3) {
-                count += (poly->fCount - 2) * (WIREFRAME ? 6 : 3);
-            }
-        }
-
         size_t stride = gp->getVertexStride();
-        const GrVertexBuffer* vertexBuffer;
-        int firstVertex;
-        void* vertices = batchTarget->vertexPool()->makeSpace(stride,
-                                                              count,
-                                                              &vertexBuffer,
-                                                              &firstVertex);
-
-        if (!vertices) {
-            SkDebugf("Could not allocate vertices\n");
+        SkASSERT(sizeof(SkPoint) == stride);
+
+        const GrVertexBuffer* vertexBuffer = fVertexBuffer;
+        int firstVertex = 0;
+        int actualCount = fVertexCount;
+        if (!vertexBuffer) {
+            PoolAllocator allocator(batchTarget, stride);
+            actualCount = tessellate(fPath, fTolerance, fClipBounds, &allocator);
+            vertexBuffer = allocator.vertexBuffer();
+            firstVertex = allocator.firstVertex();
+        }
+        if (0 == actualCount) {
             return;
         }
 
-        LOG("emitting %d verts\n", count);
-        void* end = polys_to_triangles(polys, fillType, vertices);
-        int actualCount = static_cast<int>(
-            (static_cast<char*>(end) - static_cast<char*>(vertices)) / stride);
-        LOG("actual count: %d\n", actualCount);
-        SkASSERT(actualCount <= count);
+        batchTarget->initDraw(gp, pipeline);
+        gp->initBatchTracker(batchTarget->currentBatchTracker(), fPipelineInfo);
 
         GrPrimitiveType primitiveType = WIREFRAME ? kLines_GrPrimitiveType
                                                   : kTriangles_GrPrimitiveType;
@@ -1538,9 +1662,6 @@ public:
         drawInfo.setStartIndex(0);
         drawInfo.setIndexCount(0);
         batchTarget->draw(drawInfo);
-
-        batchTarget->putBackVertices((size_t)(count - actualCount), stride);
-        return;
     }
 
     bool onCombineIfPossible(GrBatch*) override {
@@ -1551,19 +1672,27 @@ private:
     TessellatingPathBatch(const GrColor& color,
                           const SkPath& path,
                           const SkMatrix& viewMatrix,
-                          const SkRect& clipBounds)
+                          const SkRect& clipBounds,
+                          SkScalar tolerance,
+                          const GrVertexBuffer* vertexBuffer)
       : fColor(color)
       , fPath(path)
       , fViewMatrix(viewMatrix)
-      , fClipBounds(clipBounds) {
+      , fClipBounds(clipBounds)
+      , fTolerance(tolerance)
+      , fVertexBuffer(SkSafeRef(vertexBuffer))
+      , fVertexCount(vertexBuffer ? SkToInt(vertexBuffer->gpuMemorySize() / sizeof(SkPoint)) : 0) {
         this->initClassID<TessellatingPathBatch>();
     }
 
-    GrColor        fColor;
-    SkPath         fPath;
-    SkMatrix       fViewMatrix;
-    SkRect         fClipBounds; // in source space
-    GrPipelineInfo fPipelineInfo;
+    GrColor                             fColor;
+    SkPath                              fPath;
+    SkMatrix                            fViewMatrix;
+    SkRect                              fClipBounds; // in source space
+    SkScalar                            fTolerance;  // in source space
+    SkAutoTUnref<const GrVertexBuffer>  fVertexBuffer;
+    int                                 fVertexCount;
+    GrPipelineInfo                      fPipelineInfo;
 };
 
 bool GrTessellatingPathRenderer::onDrawPath(GrDrawTarget* target,
@@ -1587,7 +1716,52 @@ bool GrTessellatingPathRenderer::onDrawPath(GrDrawTarget* target,
         return false;
     }
     vmi.mapRect(&clipBounds);
-    SkAutoTUnref<GrBatch> batch(TessellatingPathBatch::Create(color, path, viewM, clipBounds));
+
+    // Perspective makes getMaxScale() negative, and volatile paths are not worth caching.
+    SkScalar scale = viewM.getMaxScale();
+    GrContext* context = fContext;
+    if (path.isVolatile() || scale <= 0 || NULL == context) {
+        SkScalar tol = GrPathUtils::scaleToleranceToSrc(SK_Scalar1, viewM, path.getBounds());
+        SkAutoTUnref<GrBatch> batch(TessellatingPathBatch::Create(color, path, viewM, clipBounds,
+                                                                  tol, NULL));
+        target->drawBatch(pipelineBuilder, batch);
+        return true;
+    }
+
+    int scaleStep = SkScalarCeilToInt(kScaleStepsPerOctave * SkScalarLog2(scale));
+    SkScalar tol = SkScalarInvert(SkScalarPow(2, SkIntToScalar(scaleStep) / kScaleStepsPerOctave));
+
+    static const GrUniqueKey::Domain kDomain = GrUniqueKey::GenerateDomain();
+    GrUniqueKey key;
+    bool inverse = path.isInverseFillType();
+    GrUniqueKey::Builder builder(&key, kDomain, inverse ? 7 : 3);
+    builder[0] = path.getGenerationID();
+    builder[1] = path.getFillType();
+    builder[2] = scaleStep;
+    if (inverse) {
+        // The clip bounds are part of an inverse fill's triangles.
+        memcpy(&builder[3], &clipBounds, sizeof(clipBounds));
+    }
+    builder.finish();
+
+    GrGpu* gpu = context->getGpu();
+    SkAutoTUnref<GrVertexBuffer> vertexBuffer(
+        static_cast<GrVertexBuffer*>(context->findAndRefCachedResource(key)));
+    if (vertexBuffer) {
+        gpu->stats()->incTessellationCacheHits();
+    } else {
+        gpu->stats()->incTessellationCacheMisses();
+        BufferAllocator allocator(gpu);
+        if (0 == tessellate(path, tol, clipBounds, &allocator) || !allocator.vertexBuffer()) {
+            return true;
+        }
+        vertexBuffer.reset(SkRef(allocator.vertexBuffer()));
+        context->addResourceToCache(key, vertexBuffer);
+        SkPathPriv::AddGenIDChangeListener(path, SkNEW_ARGS(PathInvalidator, (key)));
+    }
+
+    SkAutoTUnref<GrBatch> batch(TessellatingPathBatch::Create(color, path, viewM, clipBounds,
+                                                              tol, vertexBuffer));
     target->drawBatch(pipelineBuilder, batch);
 
     return true;
@@ -16,7 +16,9 @@
  */
 class SK_API GrTessellatingPathRenderer : public GrPathRenderer {
 public:
-    GrTessellatingPathRenderer();
+    // If context is not NULL, the triangles of non-volatile paths are cached in its resource
+    // cache, which must outlive this.
+    explicit GrTessellatingPathRenderer(GrContext* context = NULL);
 
     bool canDrawPath(const GrDrawTarget*,
                      const GrPipelineBuilder*,
@@ -39,6 +41,9 @@ protected:
                     const SkStrokeRec&,
                     bool antiAlias) override;
 
+private:
+    GrContext* fContext;
+
     typedef GrPathRenderer INHERITED;
 };
 
@@ -72,6 +72,8 @@ void GrGpu::Stats::dump(SkString* out) {
     out->appendf("Textures Created: %d\n", fTextureCreates);
     out->appendf("Texture Uploads: %d\n", fTextureUploads);
     out->appendf("Stencil Buffer Creates: %d\n", fStencilBufferCreates);
+    out->appendf("Tessellation Cache Hits: %d\n", fTessellationCacheHits);
+    out->appendf("Tessellation Cache Misses: %d\n", fTessellationCacheMisses);
 }
 #endif
 
@@ -478,6 +478,30 @@ void SkGpuDevice::drawRect(const SkDraw& draw, const SkRect& rect,
     fContext->drawRect(fRenderTarget, fClip, grPaint, *draw.fMatrix, rect, &strokeInfo);
 }
 
+void SkGpuDevice::drawRects(const SkDraw& draw, const SkRect rects[], int count,
+                            const SkPaint& paint) {
+    // Only plain fills skip straight to GrContext::drawRect(). Anything else goes through
+    // drawRect(), which knows when to draw a path instead.
+    if (paint.getStyle() != SkPaint::kFill_Style || paint.getMaskFilter() ||
+        paint.getPathEffect() || (paint.isAntiAlias() && !draw.fMatrix->rectStaysRect())) {
+        INHERITED::drawRects(draw, rects, count, paint);
+        return;
+    }
+
+    GR_CREATE_TRACE_MARKER_CONTEXT("SkGpuDevice::drawRects", fContext);
+
+    CHECK_FOR_ANNOTATION(paint);
+    CHECK_SHOULD_DRAW(draw);
+
+    // Converting the paint is the cost we share. The rect batches then combine on their own.
+    GrPaint grPaint;
+    SkPaint2GrPaintShader(this->context(), fRenderTarget, paint, *draw.fMatrix, true, &grPaint);
+
+    for (int i = 0; i < count; ++i) {
+        fContext->drawRect(fRenderTarget, fClip, grPaint, *draw.fMatrix, rects[i]);
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void SkGpuDevice::drawRRect(const SkDraw& draw, const SkRRect& rect,
@@ -1555,6 +1579,60 @@ void SkGpuDevice::drawSprite(const SkDraw& draw, const SkBitmap& bitmap,
                                                    SK_Scalar1 * h / texture->height()));
 }
 
+void SkGpuDevice::drawBitmapRects(const SkDraw& draw, const SkBitmap& bitmap,
+                                  const SkRect src[], const SkRect dst[], int count,
+                                  const SkPaint& paint) {
+    // The shared path handles unfiltered, unmasked, directly drawn subsets which need neither
+    // tiling nor a texture domain, i.e. sprite sheets. Anything else is drawn one at a time.
+    int maxTextureSize = fContext->getMaxTextureSize();
+    bool shared = kNone_SkFilterQuality == paint.getFilterQuality() &&
+                  !paint.getMaskFilter() &&
+                  (fRenderTarget->isMultisampled() || !paint.isAntiAlias()) &&
+                  bitmap.width() <= maxTextureSize &&
+                  bitmap.height() <= maxTextureSize;
+    const SkRect bitmapBounds = SkRect::MakeIWH(bitmap.width(), bitmap.height());
+    for (int i = 0; shared && i < count; ++i) {
+        shared = bitmapBounds.contains(src[i]);
+    }
+    if (!shared) {
+        INHERITED::drawBitmapRects(draw, bitmap, src, dst, count, paint);
+        return;
+    }
+
+    GR_CREATE_TRACE_MARKER_CONTEXT("SkGpuDevice::drawBitmapRects", fContext);
+
+    CHECK_SHOULD_DRAW(draw);
+
+    GrTextureParams params(SkShader::kClamp_TileMode, GrTextureParams::kNone_FilterMode);
+    GrTexture* texture;
+    AutoBitmapTexture abt(fContext, bitmap, &params, &texture);
+    if (NULL == texture) {
+        return;
+    }
+
+    GrPaint grPaint;
+    grPaint.addColorTextureProcessor(texture, SkMatrix::I(), params);
+    bool alphaOnly = !(kAlpha_8_SkColorType == bitmap.colorType());
+    GrColor paintColor = (alphaOnly) ? SkColor2GrColorJustAlpha(paint.getColor()) :
+                                       SkColor2GrColor(paint.getColor());
+    SkPaint2GrPaintNoShader(this->context(), fRenderTarget, paint, paintColor, false, &grPaint);
+
+    SkScalar wInv = SkScalarInvert(SkIntToScalar(texture->width()));
+    SkScalar hInv = SkScalarInvert(SkIntToScalar(texture->height()));
+    for (int i = 0; i < count; ++i) {
+        if (dst[i].isEmpty() || src[i].isEmpty()) {
+            continue;
+        }
+        SkRect texRect;
+        texRect.setLTRB(SkScalarMul(src[i].fLeft,   wInv),
+                        SkScalarMul(src[i].fTop,    hInv),
+                        SkScalarMul(src[i].fRight,  wInv),
+                        SkScalarMul(src[i].fBottom, hInv));
+        fContext->drawNonAARectToRect(fRenderTarget, fClip, grPaint, *draw.fMatrix, dst[i],
+                                      texRect);
+    }
+}
+
 void SkGpuDevice::drawBitmapRect(const SkDraw& origDraw, const SkBitmap& bitmap,
                                  const SkRect* src, const SkRect& dst,
                                  const SkPaint& paint,
@@ -77,6 +77,7 @@ public:
                             const SkPoint[], const SkPaint& paint) override;
     virtual void drawRect(const SkDraw&, const SkRect& r,
                           const SkPaint& paint) override;
+    void drawRects(const SkDraw&, const SkRect rects[], int count, const SkPaint&) override;
     virtual void drawRRect(const SkDraw&, const SkRRect& r,
                            const SkPaint& paint) override;
     virtual void drawDRRect(const SkDraw& draw, const SkRRect& outer,
@@ -92,6 +93,8 @@ public:
                                 const SkRect* srcOrNull, const SkRect& dst,
                                 const SkPaint& paint,
                                 SkCanvas::DrawBitmapRectFlags flags) override;
+    void drawBitmapRects(const SkDraw&, const SkBitmap&, const SkRect src[], const SkRect dst[],
+                         int count, const SkPaint&) override;
     virtual void drawSprite(const SkDraw&, const SkBitmap& bitmap,
                             int x, int y, const SkPaint& paint) override;
     virtual void drawText(const SkDraw&, const void* text, size_t len,
@@ -153,6 +153,11 @@ M(Sk4i) greaterThanEqual(const Sk4i& o) const { return vreinterpretq_s32_u32(vcg
 M(Sk4i) add     (const Sk4i& o) const { return vaddq_s32(fVec, o.fVec); }
 M(Sk4i) subtract(const Sk4i& o) const { return vsubq_s32(fVec, o.fVec); }
 M(Sk4i) multiply(const Sk4i& o) const { return vmulq_s32(fVec, o.fVec); }
+M(Sk4i)  shiftLeft(int bits) const { return vshlq_s32(fVec, vdupq_n_s32(bits)); }
+M(Sk4i) shiftRight(int bits) const {
+    // NEON shifts right by shifting left by a negative amount.
+    return vreinterpretq_s32_u32(vshlq_u32(vreinterpretq_u32_s32(fVec), vdupq_n_s32(-bits)));
+}
 // NEON does not have integer reciprocal, sqrt, or division.
 M(Sk4i) Min(const Sk4i& a, const Sk4i& b) { return vminq_s32(a.fVec, b.fVec); }
 M(Sk4i) Max(const Sk4i& a, const Sk4i& b) { return vmaxq_s32(a.fVec, b.fVec); }
@@ -64,6 +64,30 @@ M(Sk4x<T>) multiply(const Sk4x<T>& other) const { return Sk4x(BINOP(*)); }
 M(Sk4x<T>)   divide(const Sk4x<T>& other) const { return Sk4x(BINOP(/)); }
 #undef BINOP
 
+// Signed overflow is undefined, so Sk4i wraps around in uint32_t, as SSE and NEON do.
+#define UNSIGNED_BINOP(op) (int32_t)((uint32_t)fVec[0] op (uint32_t)other.fVec[0]), \
+                           (int32_t)((uint32_t)fVec[1] op (uint32_t)other.fVec[1]), \
+                           (int32_t)((uint32_t)fVec[2] op (uint32_t)other.fVec[2]), \
+                           (int32_t)((uint32_t)fVec[3] op (uint32_t)other.fVec[3])
+template<> inline Sk4i      Sk4i::add(const Sk4i& other) const { return Sk4i(UNSIGNED_BINOP(+)); }
+template<> inline Sk4i Sk4i::subtract(const Sk4i& other) const { return Sk4i(UNSIGNED_BINOP(-)); }
+template<> inline Sk4i Sk4i::multiply(const Sk4i& other) const { return Sk4i(UNSIGNED_BINOP(*)); }
+#undef UNSIGNED_BINOP
+
+template<> inline Sk4i Sk4i::shiftLeft(int bits) const {
+    return Sk4i((int32_t)((uint32_t)fVec[0] << bits),
+                (int32_t)((uint32_t)fVec[1] << bits),
+                (int32_t)((uint32_t)fVec[2] << bits),
+                (int32_t)((uint32_t)fVec[3] << bits));
+}
+
+template<> inline Sk4i Sk4i::shiftRight(int bits) const {
+    return Sk4i((int32_t)((uint32_t)fVec[0] >> bits),
+                (int32_t)((uint32_t)fVec[1] >> bits),
+                (int32_t)((uint32_t)fVec[2] >> bits),
+                (int32_t)((uint32_t)fVec[3] >> bits));
+}
+
 template<> inline Sk4f Sk4f::rsqrt() const {
     return Sk4f(sk_float_rsqrt(fVec[0]),
                 sk_float_rsqrt(fVec[1]),
@@ -143,6 +143,9 @@ M(Sk4i) greaterThanEqual(const Sk4i& o) const { return this->   lessThan(o).bitN
 M(Sk4i) add     (const Sk4i& o) const { return _mm_add_epi32(fVec, o.fVec); }
 M(Sk4i) subtract(const Sk4i& o) const { return _mm_sub_epi32(fVec, o.fVec); }
 
+M(Sk4i)  shiftLeft(int bits) const { return _mm_sll_epi32(fVec, _mm_cvtsi32_si128(bits)); }
+M(Sk4i) shiftRight(int bits) const { return _mm_srl_epi32(fVec, _mm_cvtsi32_si128(bits)); }
+
 // SSE doesn't have integer division.  Let's see how far we can get without Sk4i::divide().
 
 // Sk4i's multiply(), Min(), and Max() all improve significantly with SSE4.1.
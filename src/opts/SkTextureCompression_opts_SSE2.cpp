@@ -0,0 +1,218 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkTextureCompression_opts_SSE2.h"
+#include "SkTextureCompressor.h"
+
+#include <emmintrin.h>
+
+// Each of these compresses the four 4x4 blocks in a 16x4 strip of alpha values, one row per
+// register. They match the portable code bit for bit: see SkTextureCompressor_LATC.cpp and
+// SkTextureCompressor_R11EAC.cpp for the scalar versions they follow.
+
+// Divides each byte by three, as SkTextureCompressor::MultibyteDiv3 does.
+static inline __m128i multibyte_div3(const __m128i& x) {
+    const __m128i a  = _mm_and_si128(_mm_srli_epi32(x, 2), _mm_set1_epi8(0x3F));
+    const __m128i ar = _mm_slli_epi32(_mm_and_si128(x, _mm_set1_epi8(0x03)), 4);
+
+    const __m128i b  = _mm_and_si128(_mm_srli_epi32(x, 4), _mm_set1_epi8(0x0F));
+    const __m128i br = _mm_slli_epi32(_mm_and_si128(x, _mm_set1_epi8(0x0F)), 2);
+
+    const __m128i c  = _mm_and_si128(_mm_srli_epi32(x, 6), _mm_set1_epi8(0x03));
+    const __m128i cr = _mm_and_si128(x, _mm_set1_epi8(0x3F));
+
+    const __m128i r = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(ar, br), cr), 6);
+    return _mm_add_epi32(_mm_add_epi32(_mm_add_epi32(a, b), c),
+                         _mm_and_si128(r, _mm_set1_epi8(0x03)));
+}
+
+// Quantizes each byte to a three bit index, as SkTextureCompressor::ConvertToThreeBitIndex does.
+static inline __m128i convert_to_three_bit_index(const __m128i& alpha) {
+    __m128i x = _mm_and_si128(_mm_srli_epi32(alpha, 1), _mm_set1_epi8(0x7F));
+    x = _mm_add_epi32(x, _mm_set1_epi8(0x09));
+    x = _mm_and_si128(_mm_srli_epi32(x, 1), _mm_set1_epi8(0x7F));
+    return multibyte_div3(multibyte_div3(x));
+}
+
+// Returns the low 32 bits of each 64-bit lane.
+static inline __m128i low_32(const __m128i& x) {
+    return _mm_and_si128(x, _mm_set_epi32(0, ~0, 0, ~0));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// LATC
+
+// Maps the indices 0 1 2 3 4 5 6 7 to 1 7 6 5 4 3 2 0 for the palette 255, 0, 219, ..., 36.
+static inline __m128i latc_indices(const __m128i& alpha) {
+    // 0 1 2 3 4 5 6 7 --> 7 6 5 4 3 2 1 0
+    __m128i x = _mm_sub_epi8(_mm_set1_epi8(7), convert_to_three_bit_index(alpha));
+    // 7 6 5 4 3 2 1 0 --> 8 7 6 5 4 3 2 0
+    x = _mm_add_epi8(x, _mm_andnot_si128(_mm_cmpeq_epi8(x, _mm_setzero_si128()),
+                                         _mm_set1_epi8(1)));
+    // 8 7 6 5 4 3 2 0 --> 1 7 6 5 4 3 2 0
+    return _mm_xor_si128(x, _mm_and_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(8)),
+                                          _mm_set1_epi8(9)));
+}
+
+// Packs a row of sixteen indices into four 12-bit values, one per block, in each 32-bit lane.
+static inline __m128i latc_row(const __m128i& alpha) {
+    const __m128i idx = latc_indices(alpha);
+    // Each 16-bit lane: first index in bits 0-2, second in bits 3-5.
+    const __m128i pairs = _mm_or_si128(_mm_and_si128(idx, _mm_set1_epi16(0x07)),
+                                       _mm_and_si128(_mm_srli_epi16(idx, 5),
+                                                     _mm_set1_epi16(0x38)));
+    return _mm_madd_epi16(pairs, _mm_set1_epi32((64 << 16) | 1));
+}
+
+// Given rows 0 and 1 of a block in the low 32 bits of a 64-bit lane and rows 2 and 3 in the high
+// 32 bits, 24 bits each, packs them into 48 bits with row 0 in the low bits.
+static inline __m128i pack_rows(const __m128i& x) {
+    return _mm_or_si128(low_32(x), _mm_slli_epi64(_mm_srli_epi64(x, 32), 24));
+}
+
+static void compress_latc_blocks(uint8_t* dst, const uint8_t* src, size_t rowBytes) {
+    const __m128i row0 = latc_row(_mm_loadu_si128((const __m128i*)(src)));
+    const __m128i row1 = latc_row(_mm_loadu_si128((const __m128i*)(src + rowBytes)));
+    const __m128i row2 = latc_row(_mm_loadu_si128((const __m128i*)(src + 2*rowBytes)));
+    const __m128i row3 = latc_row(_mm_loadu_si128((const __m128i*)(src + 3*rowBytes)));
+
+    // Rows 0 and 1, and rows 2 and 3, fit together in 24 bits.
+    const __m128i top    = _mm_or_si128(row0, _mm_slli_epi32(row1, 12));
+    const __m128i bottom = _mm_or_si128(row2, _mm_slli_epi32(row3, 12));
+
+    // lum0 = 255 and lum1 = 0 in the low 16 bits, then the indices, in little endian.
+    const __m128i kHeader = _mm_set_epi32(0, 0xFF, 0, 0xFF);
+    const __m128i blocks01 = _mm_unpacklo_epi32(top, bottom);
+    const __m128i blocks23 = _mm_unpackhi_epi32(top, bottom);
+    _mm_storeu_si128((__m128i*)(dst),
+                     _mm_or_si128(_mm_slli_epi64(pack_rows(blocks01), 16), kHeader));
+    _mm_storeu_si128((__m128i*)(dst + 16),
+                     _mm_or_si128(_mm_slli_epi64(pack_rows(blocks23), 16), kHeader));
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// R11 EAC
+
+// Maps the indices 0 1 2 3 4 5 6 7 to 3 2 1 0 4 5 6 7.
+static inline __m128i r11eac_indices(const __m128i& alpha) {
+    const __m128i x = convert_to_three_bit_index(alpha);
+    const __m128i high = _mm_cmpgt_epi8(x, _mm_set1_epi8(3));
+    return _mm_or_si128(_mm_and_si128(high, x),
+                        _mm_andnot_si128(high, _mm_sub_epi8(_mm_set1_epi8(3), x)));
+}
+
+// Given each column's indices for rows 0 and 1 (top) and rows 2 and 3 (bottom) as 6-bit bytes,
+// returns two blocks' 48 bits of indices, in column major order, in each 64-bit lane.
+static inline __m128i r11eac_columns(const __m128i& top, const __m128i& bottom, bool hi) {
+    const __m128i x = hi ? _mm_unpackhi_epi8(bottom, top) : _mm_unpacklo_epi8(bottom, top);
+    // Each 16-bit lane: one column's four indices, row 0 in the top bits.
+    const __m128i column = _mm_or_si128(_mm_and_si128(x, _mm_set1_epi16(0x3F)),
+                                        _mm_and_si128(_mm_srli_epi16(x, 2),
+                                                      _mm_set1_epi16(0xFC0)));
+    // Each 32-bit lane: two columns, the left one in the top bits.
+    const __m128i pairs = _mm_madd_epi16(column, _mm_set1_epi32((1 << 16) | (1 << 12)));
+    // Each 64-bit lane: one block's four columns, the left one in the top bits.
+    return _mm_or_si128(_mm_slli_epi64(low_32(pairs), 24), _mm_srli_epi64(pairs, 32));
+}
+
+static inline __m128i swap_endian_64(__m128i x) {
+    x = _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+    x = _mm_shufflelo_epi16(x, _MM_SHUFFLE(0, 1, 2, 3));
+    return _mm_shufflehi_epi16(x, _MM_SHUFFLE(0, 1, 2, 3));
+}
+
+static void compress_r11eac_blocks(uint8_t* dst, const uint8_t* src, size_t rowBytes) {
+    const __m128i alphaRow0 = _mm_loadu_si128((const __m128i*)(src));
+    const __m128i alphaRow1 = _mm_loadu_si128((const __m128i*)(src + rowBytes));
+    const __m128i alphaRow2 = _mm_loadu_si128((const __m128i*)(src + 2*rowBytes));
+    const __m128i alphaRow3 = _mm_loadu_si128((const __m128i*)(src + 3*rowBytes));
+
+    const __m128i top = _mm_or_si128(_mm_slli_epi16(r11eac_indices(alphaRow0), 3),
+                                     r11eac_indices(alphaRow1));
+    const __m128i bottom = _mm_or_si128(_mm_slli_epi16(r11eac_indices(alphaRow2), 3),
+                                        r11eac_indices(alphaRow3));
+
+    // The block header, then the indices, in big endian.
+    const __m128i kHeader = _mm_set_epi32((int)0x84900000, 0, (int)0x84900000, 0);
+    _mm_storeu_si128((__m128i*)(dst),
+                     swap_endian_64(_mm_or_si128(r11eac_columns(top, bottom, false), kHeader)));
+    _mm_storeu_si128((__m128i*)(dst + 16),
+                     swap_endian_64(_mm_or_si128(r11eac_columns(top, bottom, true), kHeader)));
+
+    // Solid transparent and opaque blocks have their own encodings.
+    const __m128i same = _mm_and_si128(_mm_and_si128(_mm_cmpeq_epi8(alphaRow0, alphaRow1),
+                                                     _mm_cmpeq_epi8(alphaRow2, alphaRow3)),
+                                       _mm_cmpeq_epi8(alphaRow0, alphaRow2));
+    const int sameMask = _mm_movemask_epi8(same);
+    if (0 == sameMask) {
+        return;
+    }
+    const int transparentMask = sameMask &
+        _mm_movemask_epi8(_mm_cmpeq_epi8(alphaRow0, _mm_setzero_si128()));
+    const int opaqueMask = sameMask &
+        _mm_movemask_epi8(_mm_cmpeq_epi8(alphaRow0, _mm_set1_epi8((char)0xFF)));
+
+    uint64_t* blocks = reinterpret_cast<uint64_t*>(dst);
+    for (int i = 0; i < 4; ++i) {
+        const int blockMask = 0xF << (4*i);
+        if (blockMask == (transparentMask & blockMask)) {
+            blocks[i] = 0x0020000000002000ULL;
+        } else if (blockMask == (opaqueMask & blockMask)) {
+            blocks[i] = 0xFFFFFFFFFFFFFFFFULL;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+typedef void (*CompressBlocksProc)(uint8_t* dst, const uint8_t* src, size_t rowBytes);
+
+template <CompressBlocksProc compressBlocks, SkTextureCompressor::Format format>
+static bool compress_a8(uint8_t* dst, const uint8_t* src,
+                        int width, int height, size_t rowBytes) {
+    if (width <= 0 || height <= 0 || (width % 4) != 0 || (height % 4) != 0) {
+        return SkTextureCompressor::CompressBufferToFormat(
+            dst, src,
+            kAlpha_8_SkColorType,
+            width, height, rowBytes,
+            format, false);
+    }
+
+    // The last few blocks of each row, if width isn't a multiple of 16, go to the portable code.
+    const int simdWidth = width & ~15;
+    const int remainder = width - simdWidth;
+    for (int y = 0; y < height; y += 4) {
+        for (int x = 0; x < simdWidth; x += 16) {
+            compressBlocks(dst, src + x, rowBytes);
+            dst += 32;
+        }
+        if (remainder > 0) {
+            if (!SkTextureCompressor::CompressBufferToFormat(dst, src + simdWidth,
+                                                             kAlpha_8_SkColorType,
+                                                             remainder, 4, rowBytes,
+                                                             format, false)) {
+                return false;
+            }
+            dst += 2 * remainder;
+        }
+        src += 4 * rowBytes;
+    }
+    return true;
+}
+
+bool CompressA8toLATC_SSE2(uint8_t* dst, const uint8_t* src,
+                           int width, int height, size_t rowBytes) {
+    return compress_a8<compress_latc_blocks, SkTextureCompressor::kLATC_Format>(
+        dst, src, width, height, rowBytes);
+}
+
+bool CompressA8toR11EAC_SSE2(uint8_t* dst, const uint8_t* src,
+                             int width, int height, size_t rowBytes) {
+    return compress_a8<compress_r11eac_blocks, SkTextureCompressor::kR11_EAC_Format>(
+        dst, src, width, height, rowBytes);
+}
@@ -0,0 +1,20 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkTextureCompression_opts_SSE2_DEFINED
+#define SkTextureCompression_opts_SSE2_DEFINED
+
+#include "SkTypes.h"
+
+// These compress four 4x4 blocks at a time, handing any blocks left over at the end of each row
+// to the portable code. Their output is the same as the portable code's.
+bool CompressA8toLATC_SSE2(uint8_t* dst, const uint8_t* src,
+                           int width, int height, size_t rowBytes);
+bool CompressA8toR11EAC_SSE2(uint8_t* dst, const uint8_t* src,
+                             int width, int height, size_t rowBytes);
+
+#endif  // SkTextureCompression_opts_SSE2_DEFINED
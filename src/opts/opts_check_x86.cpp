@@ -19,6 +19,8 @@
 #include "SkMorphology_opts.h"
 #include "SkMorphology_opts_SSE2.h"
 #include "SkRTConf.h"
+#include "SkTextureCompression_opts.h"
+#include "SkTextureCompression_opts_SSE2.h"
 #include "SkUtils.h"
 #include "SkUtils_opts_SSE2.h"
 #include "SkXfermode.h"
@@ -357,6 +359,28 @@ SkMorphologyImageFilter::Proc SkMorphologyGetPlatformProc(SkMorphologyProcType t
 
 ////////////////////////////////////////////////////////////////////////////////
 
+SkTextureCompressor::CompressionProc
+SkTextureCompressorGetPlatformProc(SkColorType colorType, SkTextureCompressor::Format fmt) {
+    if (!supports_simd(SK_CPU_SSE_LEVEL_SSE2) || kAlpha_8_SkColorType != colorType) {
+        return NULL;
+    }
+    switch (fmt) {
+        case SkTextureCompressor::kLATC_Format:
+            return CompressA8toLATC_SSE2;
+        case SkTextureCompressor::kR11_EAC_Format:
+            return CompressA8toR11EAC_SSE2;
+        default:
+            return NULL;
+    }
+}
+
+bool SkTextureCompressorGetPlatformDims(SkTextureCompressor::Format fmt, int* dimX, int* dimY) {
+    // The SSE2 procs take any width the portable ones do.
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 bool SkBoxBlurGetPlatformProcs(SkBoxBlurProc* boxBlurX,
                                SkBoxBlurProc* boxBlurY,
                                SkBoxBlurProc* boxBlurXY,
@@ -6,6 +6,7 @@
  */
 #include "SkAddIntersections.h"
 #include "SkPathOpsBounds.h"
+#include "SkTaskGroup.h"
 
 #if DEBUG_ADD_INTERSECTING_TS
 
@@ -174,16 +175,245 @@ static void debugShowCubicIntersection(int , const SkIntersectionHelper& ,
 }
 #endif
 
-bool AddIntersectTs(SkOpContour* test, SkOpContour* next) {
+// Finds where the segments wt and wn intersect, returning the number of points found. This only
+// reads the segments' points, so it may run on any thread.
+static int intersect(const SkIntersectionHelper& wt, const SkIntersectionHelper& wn,
+                     SkIntersections* ts, bool* swapPtr) {
+    int pts = 0;
+    bool swap = false;
+    switch (wt.segmentType()) {
+        case SkIntersectionHelper::kHorizontalLine_Segment:
+            swap = true;
+            switch (wn.segmentType()) {
+                case SkIntersectionHelper::kHorizontalLine_Segment:
+                case SkIntersectionHelper::kVerticalLine_Segment:
+                case SkIntersectionHelper::kLine_Segment: {
+                    pts = ts->lineHorizontal(wn.pts(), wt.left(),
+                            wt.right(), wt.y(), wt.xFlipped());
+                    debugShowLineIntersection(pts, wn, wt, *ts);
+                    break;
+                }
+                case SkIntersectionHelper::kQuad_Segment: {
+                    pts = ts->quadHorizontal(wn.pts(), wt.left(),
+                            wt.right(), wt.y(), wt.xFlipped());
+                    debugShowQuadLineIntersection(pts, wn, wt, *ts);
+                    break;
+                }
+                case SkIntersectionHelper::kCubic_Segment: {
+                    pts = ts->cubicHorizontal(wn.pts(), wt.left(),
+                            wt.right(), wt.y(), wt.xFlipped());
+                    debugShowCubicLineIntersection(pts, wn, wt, *ts);
+                    break;
+                }
+                default:
+                    SkASSERT(0);
+            }
+            break;
+        case SkIntersectionHelper::kVerticalLine_Segment:
+            swap = true;
+            switch (wn.segmentType()) {
+                case SkIntersectionHelper::kHorizontalLine_Segment:
+                case SkIntersectionHelper::kVerticalLine_Segment:
+                case SkIntersectionHelper::kLine_Segment: {
+                    pts = ts->lineVertical(wn.pts(), wt.top(),
+                            wt.bottom(), wt.x(), wt.yFlipped());
+                    debugShowLineIntersection(pts, wn, wt, *ts);
+                    break;
+                }
+                case SkIntersectionHelper::kQuad_Segment: {
+                    pts = ts->quadVertical(wn.pts(), wt.top(),
+                            wt.bottom(), wt.x(), wt.yFlipped());
+                    debugShowQuadLineIntersection(pts, wn, wt, *ts);
+                    break;
+                }
+                case SkIntersectionHelper::kCubic_Segment: {
+                    pts = ts->cubicVertical(wn.pts(), wt.top(),
+                            wt.bottom(), wt.x(), wt.yFlipped());
+                    debugShowCubicLineIntersection(pts, wn, wt, *ts);
+                    break;
+                }
+                default:
+                    SkASSERT(0);
+            }
+            break;
+        case SkIntersectionHelper::kLine_Segment:
+            switch (wn.segmentType()) {
+                case SkIntersectionHelper::kHorizontalLine_Segment:
+                    pts = ts->lineHorizontal(wt.pts(), wn.left(),
+                            wn.right(), wn.y(), wn.xFlipped());
+                    debugShowLineIntersection(pts, wt, wn, *ts);
+                    break;
+                case SkIntersectionHelper::kVerticalLine_Segment:
+                    pts = ts->lineVertical(wt.pts(), wn.top(),
+                            wn.bottom(), wn.x(), wn.yFlipped());
+                    debugShowLineIntersection(pts, wt, wn, *ts);
+                    break;
+                case SkIntersectionHelper::kLine_Segment: {
+                    pts = ts->lineLine(wt.pts(), wn.pts());
+                    debugShowLineIntersection(pts, wt, wn, *ts);
+                    break;
+                }
+                case SkIntersectionHelper::kQuad_Segment: {
+                    swap = true;
+                    pts = ts->quadLine(wn.pts(), wt.pts());
+                    debugShowQuadLineIntersection(pts, wn, wt, *ts);
+                    break;
+                }
+                case SkIntersectionHelper::kCubic_Segment: {
+                    swap = true;
+                    pts = ts->cubicLine(wn.pts(), wt.pts());
+                    debugShowCubicLineIntersection(pts, wn, wt, *ts);
+                    break;
+                }
+                default:
+                    SkASSERT(0);
+            }
+            break;
+        case SkIntersectionHelper::kQuad_Segment:
+            switch (wn.segmentType()) {
+                case SkIntersectionHelper::kHorizontalLine_Segment:
+                    pts = ts->quadHorizontal(wt.pts(), wn.left(),
+                            wn.right(), wn.y(), wn.xFlipped());
+                    debugShowQuadLineIntersection(pts, wt, wn, *ts);
+                    break;
+                case SkIntersectionHelper::kVerticalLine_Segment:
+                    pts = ts->quadVertical(wt.pts(), wn.top(),
+                            wn.bottom(), wn.x(), wn.yFlipped());
+                    debugShowQuadLineIntersection(pts, wt, wn, *ts);
+                    break;
+                case SkIntersectionHelper::kLine_Segment: {
+                    pts = ts->quadLine(wt.pts(), wn.pts());
+                    debugShowQuadLineIntersection(pts, wt, wn, *ts);
+                    break;
+                }
+                case SkIntersectionHelper::kQuad_Segment: {
+                    pts = ts->quadQuad(wt.pts(), wn.pts());
+                    ts->alignQuadPts(wt.pts(), wn.pts());
+                    debugShowQuadIntersection(pts, wt, wn, *ts);
+                    break;
+                }
+                case SkIntersectionHelper::kCubic_Segment: {
+                    swap = true;
+                    pts = ts->cubicQuad(wn.pts(), wt.pts());
+                    debugShowCubicQuadIntersection(pts, wn, wt, *ts);
+                    break;
+                }
+                default:
+                    SkASSERT(0);
+            }
+            break;
+        case SkIntersectionHelper::kCubic_Segment:
+            switch (wn.segmentType()) {
+                case SkIntersectionHelper::kHorizontalLine_Segment:
+                    pts = ts->cubicHorizontal(wt.pts(), wn.left(),
+                            wn.right(), wn.y(), wn.xFlipped());
+                    debugShowCubicLineIntersection(pts, wt, wn, *ts);
+                    break;
+                case SkIntersectionHelper::kVerticalLine_Segment:
+                    pts = ts->cubicVertical(wt.pts(), wn.top(),
+                            wn.bottom(), wn.x(), wn.yFlipped());
+                    debugShowCubicLineIntersection(pts, wt, wn, *ts);
+                    break;
+                case SkIntersectionHelper::kLine_Segment: {
+                    pts = ts->cubicLine(wt.pts(), wn.pts());
+                    debugShowCubicLineIntersection(pts, wt, wn, *ts);
+                    break;
+                }
+                case SkIntersectionHelper::kQuad_Segment: {
+                    pts = ts->cubicQuad(wt.pts(), wn.pts());
+                    debugShowCubicQuadIntersection(pts, wt, wn, *ts);
+                    break;
+                }
+                case SkIntersectionHelper::kCubic_Segment: {
+                    pts = ts->cubicCubic(wt.pts(), wn.pts());
+                    debugShowCubicIntersection(pts, wt, wn, *ts);
+                    break;
+                }
+                default:
+                    SkASSERT(0);
+            }
+            break;
+        default:
+            SkASSERT(0);
+    }
+    *swapPtr = swap;
+    return pts;
+}
+
+// Adds the pts intersections of wt and wn found by intersect() to their segments.
+static void add_ts(SkOpContour* test, SkOpContour* next, SkIntersectionHelper& wt,
+                   SkIntersectionHelper& wn, SkIntersections& ts, int pts, bool swap,
+                   bool* foundCommonContour) {
+    if (!*foundCommonContour && pts > 0) {
+        test->addCross(next);
+        next->addCross(test);
+        *foundCommonContour = true;
+    }
+    // in addition to recording T values, record matching segment
+    if (pts == 2) {
+        if (wn.segmentType() <= SkIntersectionHelper::kLine_Segment
+                && wt.segmentType() <= SkIntersectionHelper::kLine_Segment) {
+            if (wt.addCoincident(wn, ts, swap)) {
+                return;
+            }
+            pts = ts.cleanUpCoincidence();  // prefer (t == 0 or t == 1)
+        } else if (wn.segmentType() >= SkIntersectionHelper::kQuad_Segment
+                && wt.segmentType() >= SkIntersectionHelper::kQuad_Segment
+                && ts.isCoincident(0)) {
+            SkASSERT(ts.coincidentUsed() == 2);
+            if (wt.addCoincident(wn, ts, swap)) {
+                return;
+            }
+            pts = ts.cleanUpCoincidence();  // prefer (t == 0 or t == 1)
+        }
+    }
+    if (pts >= 2) {
+        for (int pt = 0; pt < pts - 1; ++pt) {
+            const SkDPoint& point = ts.pt(pt);
+            const SkDPoint& next = ts.pt(pt + 1);
+            if (wt.isPartial(ts[swap][pt], ts[swap][pt + 1], point, next)
+                    && wn.isPartial(ts[!swap][pt], ts[!swap][pt + 1], point, next)) {
+                if (!wt.addPartialCoincident(wn, ts, pt, swap)) {
+                    // remove extra point if two map to same float values
+                    pts = ts.cleanUpCoincidence();  // prefer (t == 0 or t == 1)
+                }
+            }
+        }
+    }
+    for (int pt = 0; pt < pts; ++pt) {
+        SkASSERT(ts[0][pt] >= 0 && ts[0][pt] <= 1);
+        SkASSERT(ts[1][pt] >= 0 && ts[1][pt] <= 1);
+        SkPoint point = ts.pt(pt).asSkPoint();
+        wt.alignTPt(wn, swap, pt, &ts, &point);
+        int testTAt = wt.addT(wn, point, ts[swap][pt]);
+        int nextTAt = wn.addT(wt, point, ts[!swap][pt]);
+        wt.addOtherT(testTAt, ts[!swap][pt], nextTAt);
+        wn.addOtherT(nextTAt, ts[swap][pt], testTAt);
+    }
+}
+
+// Returns whether test and next may intersect. If not, sets later to whether contours after next
+// may still intersect test, i.e. whether next starts above test's bottom.
+static bool may_intersect(const SkOpContour* test, const SkOpContour* next, bool* later) {
+    *later = true;
     if (test != next) {
         if (AlmostLessUlps(test->bounds().fBottom, next->bounds().fTop)) {
+            *later = false;
             return false;
         }
         // OPTIMIZATION: outset contour bounds a smidgen instead?
         if (!SkPathOpsBounds::Intersects(test->bounds(), next->bounds())) {
-            return true;
+            return false;
         }
     }
+    return true;
+}
+
+bool AddIntersectTs(SkOpContour* test, SkOpContour* next) {
+    bool later;
+    if (!may_intersect(test, next, &later)) {
+        return later;
+    }
     SkIntersectionHelper wt;
     wt.init(test);
     bool foundCommonContour = test == next;
@@ -197,213 +427,127 @@ bool AddIntersectTs(SkOpContour* test, SkOpContour* next) {
             if (!SkPathOpsBounds::Intersects(wt.bounds(), wn.bounds())) {
                 continue;
             }
-            int pts = 0;
             SkIntersections ts;
-            bool swap = false;
-            switch (wt.segmentType()) {
-                case SkIntersectionHelper::kHorizontalLine_Segment:
-                    swap = true;
-                    switch (wn.segmentType()) {
-                        case SkIntersectionHelper::kHorizontalLine_Segment:
-                        case SkIntersectionHelper::kVerticalLine_Segment:
-                        case SkIntersectionHelper::kLine_Segment: {
-                            pts = ts.lineHorizontal(wn.pts(), wt.left(),
-                                    wt.right(), wt.y(), wt.xFlipped());
-                            debugShowLineIntersection(pts, wn, wt, ts);
-                            break;
-                        }
-                        case SkIntersectionHelper::kQuad_Segment: {
-                            pts = ts.quadHorizontal(wn.pts(), wt.left(),
-                                    wt.right(), wt.y(), wt.xFlipped());
-                            debugShowQuadLineIntersection(pts, wn, wt, ts);
-                            break;
-                        }
-                        case SkIntersectionHelper::kCubic_Segment: {
-                            pts = ts.cubicHorizontal(wn.pts(), wt.left(),
-                                    wt.right(), wt.y(), wt.xFlipped());
-                            debugShowCubicLineIntersection(pts, wn, wt, ts);
-                            break;
-                        }
-                        default:
-                            SkASSERT(0);
-                    }
-                    break;
-                case SkIntersectionHelper::kVerticalLine_Segment:
-                    swap = true;
-                    switch (wn.segmentType()) {
-                        case SkIntersectionHelper::kHorizontalLine_Segment:
-                        case SkIntersectionHelper::kVerticalLine_Segment:
-                        case SkIntersectionHelper::kLine_Segment: {
-                            pts = ts.lineVertical(wn.pts(), wt.top(),
-                                    wt.bottom(), wt.x(), wt.yFlipped());
-                            debugShowLineIntersection(pts, wn, wt, ts);
-                            break;
-                        }
-                        case SkIntersectionHelper::kQuad_Segment: {
-                            pts = ts.quadVertical(wn.pts(), wt.top(),
-                                    wt.bottom(), wt.x(), wt.yFlipped());
-                            debugShowQuadLineIntersection(pts, wn, wt, ts);
-                            break;
-                        }
-                        case SkIntersectionHelper::kCubic_Segment: {
-                            pts = ts.cubicVertical(wn.pts(), wt.top(),
-                                    wt.bottom(), wt.x(), wt.yFlipped());
-                            debugShowCubicLineIntersection(pts, wn, wt, ts);
-                            break;
-                        }
-                        default:
-                            SkASSERT(0);
-                    }
-                    break;
-                case SkIntersectionHelper::kLine_Segment:
-                    switch (wn.segmentType()) {
-                        case SkIntersectionHelper::kHorizontalLine_Segment:
-                            pts = ts.lineHorizontal(wt.pts(), wn.left(),
-                                    wn.right(), wn.y(), wn.xFlipped());
-                            debugShowLineIntersection(pts, wt, wn, ts);
-                            break;
-                        case SkIntersectionHelper::kVerticalLine_Segment:
-                            pts = ts.lineVertical(wt.pts(), wn.top(),
-                                    wn.bottom(), wn.x(), wn.yFlipped());
-                            debugShowLineIntersection(pts, wt, wn, ts);
-                            break;
-                        case SkIntersectionHelper::kLine_Segment: {
-                            pts = ts.lineLine(wt.pts(), wn.pts());
-                            debugShowLineIntersection(pts, wt, wn, ts);
-                            break;
-                        }
-                        case SkIntersectionHelper::kQuad_Segment: {
-                            swap = true;
-                            pts = ts.quadLine(wn.pts(), wt.pts());
-                            debugShowQuadLineIntersection(pts, wn, wt, ts);
-                            break;
-                        }
-                        case SkIntersectionHelper::kCubic_Segment: {
-                            swap = true;
-                            pts = ts.cubicLine(wn.pts(), wt.pts());
-                            debugShowCubicLineIntersection(pts, wn, wt,  ts);
-                            break;
-                        }
-                        default:
-                            SkASSERT(0);
-                    }
-                    break;
-                case SkIntersectionHelper::kQuad_Segment:
-                    switch (wn.segmentType()) {
-                        case SkIntersectionHelper::kHorizontalLine_Segment:
-                            pts = ts.quadHorizontal(wt.pts(), wn.left(),
-                                    wn.right(), wn.y(), wn.xFlipped());
-                            debugShowQuadLineIntersection(pts, wt, wn, ts);
-                            break;
-                        case SkIntersectionHelper::kVerticalLine_Segment:
-                            pts = ts.quadVertical(wt.pts(), wn.top(),
-                                    wn.bottom(), wn.x(), wn.yFlipped());
-                            debugShowQuadLineIntersection(pts, wt, wn, ts);
-                            break;
-                        case SkIntersectionHelper::kLine_Segment: {
-                            pts = ts.quadLine(wt.pts(), wn.pts());
-                            debugShowQuadLineIntersection(pts, wt, wn, ts);
-                            break;
-                        }
-                        case SkIntersectionHelper::kQuad_Segment: {
-                            pts = ts.quadQuad(wt.pts(), wn.pts());
-                            ts.alignQuadPts(wt.pts(), wn.pts());
-                            debugShowQuadIntersection(pts, wt, wn, ts);
-                            break;
-                        }
-                        case SkIntersectionHelper::kCubic_Segment: {
-                            swap = true;
-                            pts = ts.cubicQuad(wn.pts(), wt.pts());
-                            debugShowCubicQuadIntersection(pts, wn, wt, ts);
-                            break;
-                        }
-                        default:
-                            SkASSERT(0);
-                    }
-                    break;
-                case SkIntersectionHelper::kCubic_Segment:
-                    switch (wn.segmentType()) {
-                        case SkIntersectionHelper::kHorizontalLine_Segment:
-                            pts = ts.cubicHorizontal(wt.pts(), wn.left(),
-                                    wn.right(), wn.y(), wn.xFlipped());
-                            debugShowCubicLineIntersection(pts, wt, wn, ts);
-                            break;
-                        case SkIntersectionHelper::kVerticalLine_Segment:
-                            pts = ts.cubicVertical(wt.pts(), wn.top(),
-                                    wn.bottom(), wn.x(), wn.yFlipped());
-                            debugShowCubicLineIntersection(pts, wt, wn, ts);
-                            break;
-                        case SkIntersectionHelper::kLine_Segment: {
-                            pts = ts.cubicLine(wt.pts(), wn.pts());
-                            debugShowCubicLineIntersection(pts, wt, wn, ts);
-                            break;
-                        }
-                        case SkIntersectionHelper::kQuad_Segment: {
-                            pts = ts.cubicQuad(wt.pts(), wn.pts());
-                            debugShowCubicQuadIntersection(pts, wt, wn, ts);
-                            break;
-                        }
-                        case SkIntersectionHelper::kCubic_Segment: {
-                            pts = ts.cubicCubic(wt.pts(), wn.pts());
-                            debugShowCubicIntersection(pts, wt, wn, ts);
-                            break;
-                        }
-                        default:
-                            SkASSERT(0);
-                    }
-                    break;
-                default:
-                    SkASSERT(0);
+            bool swap;
+            int pts = intersect(wt, wn, &ts, &swap);
+            add_ts(test, next, wt, wn, ts, pts, swap, &foundCommonContour);
+        } while (wn.advance());
+    } while (wt.advance());
+    return true;
+}
+
+namespace {
+
+// The intersections of one pair of segments, found but not yet added.
+struct FoundTs {
+    int fTestIndex;
+    int fNextIndex;
+    int fPts;
+    bool fSwap;
+    SkIntersections fTs;
+};
+
+// A pair of contours whose bounds intersect, and the intersections found between their segments.
+struct ContourPair {
+    SkOpContour* fTest;
+    SkOpContour* fNext;
+    SkTArray<FoundTs, true> fFound;
+};
+
+}  // namespace
+
+static void find_ts(ContourPair* pair) {
+    SkIntersectionHelper wt;
+    wt.init(pair->fTest);
+    do {
+        SkIntersectionHelper wn;
+        wn.init(pair->fNext);
+        if (pair->fTest == pair->fNext && !wn.startAfter(wt)) {
+            continue;
+        }
+        do {
+            if (!SkPathOpsBounds::Intersects(wt.bounds(), wn.bounds())) {
+                continue;
             }
-            if (!foundCommonContour && pts > 0) {
-                test->addCross(next);
-                next->addCross(test);
-                foundCommonContour = true;
+            FoundTs found;
+            found.fPts = intersect(wt, wn, &found.fTs, &found.fSwap);
+            if (found.fPts > 0) {
+                found.fTestIndex = wt.index();
+                found.fNextIndex = wn.index();
+                pair->fFound.push_back(found);
             }
-            // in addition to recording T values, record matching segment
-            if (pts == 2) {
-                if (wn.segmentType() <= SkIntersectionHelper::kLine_Segment
-                        && wt.segmentType() <= SkIntersectionHelper::kLine_Segment) {
-                    if (wt.addCoincident(wn, ts, swap)) {
-                        continue;
-                    }
-                    pts = ts.cleanUpCoincidence();  // prefer (t == 0 or t == 1)
-                } else if (wn.segmentType() >= SkIntersectionHelper::kQuad_Segment
-                        && wt.segmentType() >= SkIntersectionHelper::kQuad_Segment
-                        && ts.isCoincident(0)) {
-                    SkASSERT(ts.coincidentUsed() == 2);
-                    if (wt.addCoincident(wn, ts, swap)) {
-                        continue;
-                    }
-                    pts = ts.cleanUpCoincidence();  // prefer (t == 0 or t == 1)
-                }
+        } while (wn.advance());
+    } while (wt.advance());
+}
+
+static void add_found_ts(ContourPair* pair) {
+    bool foundCommonContour = pair->fTest == pair->fNext;
+    for (int index = 0; index < pair->fFound.count(); ++index) {
+        FoundTs& found = pair->fFound[index];
+        SkIntersectionHelper wt, wn;
+        wt.init(pair->fTest, found.fTestIndex);
+        wn.init(pair->fNext, found.fNextIndex);
+        add_ts(pair->fTest, pair->fNext, wt, wn, found.fTs, found.fPts, found.fSwap,
+               &foundCommonContour);
+    }
+}
+
+// Below this many contours, finding intersections on other threads costs more than it saves.
+static const int kMinThreadedContours = 64;
+
+void AddAllIntersectTs(SkTArray<SkOpContour*, true>& contourList, bool allowThreads) {
+    const int count = contourList.count();
+    if (!allowThreads || count < kMinThreadedContours) {
+        for (int index = 0; index < count; ++index) {
+            SkOpContour* current = contourList[index];
+            if (current->containsCubics()) {
+                AddSelfIntersectTs(current);
             }
-            if (pts >= 2) {
-                for (int pt = 0; pt < pts - 1; ++pt) {
-                    const SkDPoint& point = ts.pt(pt);
-                    const SkDPoint& next = ts.pt(pt + 1);
-                    if (wt.isPartial(ts[swap][pt], ts[swap][pt + 1], point, next)
-                            && wn.isPartial(ts[!swap][pt], ts[!swap][pt + 1], point, next)) {
-                        if (!wt.addPartialCoincident(wn, ts, pt, swap)) {
-                            // remove extra point if two map to same float values
-                            pts = ts.cleanUpCoincidence();  // prefer (t == 0 or t == 1)
-                        }
-                    }
+            for (int next = index; next < count; ++next) {
+                if (!AddIntersectTs(current, contourList[next])) {
+                    break;
                 }
             }
-            for (int pt = 0; pt < pts; ++pt) {
-                SkASSERT(ts[0][pt] >= 0 && ts[0][pt] <= 1);
-                SkASSERT(ts[1][pt] >= 0 && ts[1][pt] <= 1);
-                SkPoint point = ts.pt(pt).asSkPoint();
-                wt.alignTPt(wn, swap, pt, &ts, &point);
-                int testTAt = wt.addT(wn, point, ts[swap][pt]);
-                int nextTAt = wn.addT(wt, point, ts[!swap][pt]);
-                wt.addOtherT(testTAt, ts[!swap][pt], nextTAt);
-                wn.addOtherT(nextTAt, ts[swap][pt], testTAt);
+        }
+        return;
+    }
+
+    // The list is sorted by top, so sweeping down it finds every pair of contours whose bounds
+    // intersect, in the order the loop above visits them.
+    SkTArray<ContourPair> pairs;
+    SkTDArray<int> firstPair;  // Index into pairs of the first pair for each contour.
+    firstPair.setCount(count + 1);
+    for (int index = 0; index < count; ++index) {
+        firstPair[index] = pairs.count();
+        SkOpContour* current = contourList[index];
+        for (int next = index; next < count; ++next) {
+            bool later;
+            if (may_intersect(current, contourList[next], &later)) {
+                ContourPair& pair = pairs.push_back();
+                pair.fTest = current;
+                pair.fNext = contourList[next];
+            } else if (!later) {
+                break;
             }
-        } while (wn.advance());
-    } while (wt.advance());
-    return true;
+        }
+    }
+    firstPair[count] = pairs.count();
+
+    // Intersecting the segments is most of the work, and only reads them.
+    SkTaskGroup tg;
+    tg.batch(find_ts, pairs.begin(), pairs.count());
+    tg.wait();
+
+    // Adding the Ts changes the segments, so do it here, in the same order as the loop above.
+    for (int index = 0; index < count; ++index) {
+        SkOpContour* current = contourList[index];
+        if (current->containsCubics()) {
+            AddSelfIntersectTs(current);
+        }
+        for (int pair = firstPair[index]; pair < firstPair[index + 1]; ++pair) {
+            add_found_ts(&pairs[pair]);
+        }
+    }
 }
 
 void AddSelfIntersectTs(SkOpContour* test) {
@@ -12,6 +12,11 @@
 #include "SkTArray.h"
 
 bool AddIntersectTs(SkOpContour* test, SkOpContour* next);
+// Adds the Ts where each pair of contours intersects, and where cubics intersect themselves.
+// contourList must be sorted by top, as MakeContourList() leaves it. Long lists find the
+// intersections on SkTaskGroup threads unless allowThreads is false. Either way the Ts are added
+// in the same order, so the contours end up the same.
+void AddAllIntersectTs(SkTArray<SkOpContour*, true>& contourList, bool allowThreads = true);
 void AddSelfIntersectTs(SkOpContour* test);
 bool CoincidenceCheck(SkTArray<SkOpContour*, true>* contourList, int total);
 
@@ -67,12 +67,16 @@ public:
         return fContour->segments()[fIndex].bounds();
     }
 
-    void init(SkOpContour* contour) {
+    void init(SkOpContour* contour, int index = 0) {
         fContour = contour;
-        fIndex = 0;
+        fIndex = index;
         fLast = contour->segments().count();
     }
 
+    int index() const {
+        return fIndex;
+    }
+
     bool isAdjacent(const SkIntersectionHelper& next) {
         return fContour == next.fContour && fIndex + 1 == next.fIndex;
     }
@@ -8,6 +8,104 @@
 #include "SkMatrix.h"
 #include "SkPath.h"
 #include "SkPathOps.h"
+#include "SkTaskGroup.h"
+
+namespace {
+
+struct Operand {
+    SkPath fPath;
+    bool   fSimplified;  // fPath is the output of a path op, so Simplify() would not change it.
+};
+
+// One task of a reduction level: fOne = fOne op fTwo.
+struct Combine {
+    Operand*       fOne;
+    const Operand* fTwo;
+    SkPathOp       fOp;
+    bool           fSucceeded;
+};
+
+}  // namespace
+
+static bool simplified(const Operand& operand, SkPath* result) {
+    if (operand.fSimplified) {
+        *result = operand.fPath;
+        return true;
+    }
+    return Simplify(operand.fPath, result);
+}
+
+// Operands whose bounds do not intersect need no full op: their union is both of them,
+// simplified, and their intersection is empty.
+static bool combine(const Operand& one, const Operand& two, SkPathOp op, Operand* result) {
+    SkASSERT(kUnion_PathOp == op || kIntersect_PathOp == op);
+    if (!one.fPath.isInverseFillType() && !two.fPath.isInverseFillType()
+            && !SkRect::Intersects(one.fPath.getBounds(), two.fPath.getBounds())) {
+        SkPath sum;
+        if (kUnion_PathOp == op) {
+            SkPath second;
+            if (!simplified(one, &sum) || !simplified(two, &second)) {
+                return false;
+            }
+            sum.addPath(second);
+        }
+        sum.setFillType(SkPath::kEvenOdd_FillType);
+        result->fPath.swap(sum);
+        result->fSimplified = true;
+        return true;
+    }
+    if (!Op(one.fPath, two.fPath, op, &result->fPath)) {
+        return false;
+    }
+    result->fSimplified = true;
+    return true;
+}
+
+static void combine_pair(Combine* pair) {
+    pair->fSucceeded = combine(*pair->fOne, *pair->fTwo, pair->fOp, pair->fOne);
+}
+
+// Combines operands[0..count) with op, which must be associative and commutative, pairwise
+// as a balanced tree, leaving the result in operands[0]. Each level's pairs are independent,
+// so they may be combined on SkTaskGroup threads.
+static bool reduce(Operand operands[], int count, SkPathOp op, bool threaded) {
+    SkTArray<Combine, true> pairs(count / 2);
+    while (count > 1) {
+        pairs.reset();
+        for (int index = 0; index + 1 < count; index += 2) {
+            Combine& pair = pairs.push_back();
+            pair.fOne = &operands[index];
+            pair.fTwo = &operands[index + 1];
+            pair.fOp = op;
+            pair.fSucceeded = false;
+        }
+        if (threaded && pairs.count() > 1) {
+            SkTaskGroup tg;
+            tg.batch(combine_pair, pairs.begin(), pairs.count());
+            tg.wait();
+        } else {
+            for (int index = 0; index < pairs.count(); ++index) {
+                combine_pair(&pairs[index]);
+            }
+        }
+        for (int index = 0; index < pairs.count(); ++index) {
+            if (!pairs[index].fSucceeded) {
+                return false;
+            }
+        }
+        // Gather the level's results (and any odd operand out) at the front.
+        int next = 0;
+        for (int index = 0; index < count; index += 2) {
+            if (index != next) {
+                operands[next].fPath.swap(operands[index].fPath);
+                operands[next].fSimplified = operands[index].fSimplified;
+            }
+            ++next;
+        }
+        count = next;
+    }
+    return true;
+}
 
 void SkOpBuilder::add(const SkPath& path, SkPathOp op) {
     if (0 == fOps.count() && op != kUnion_PathOp) {
@@ -64,11 +162,44 @@ bool SkOpBuilder::resolve(SkPath* result) {
     }
     if (!allUnion) {
         *result = fPathRefs[0];
-        for (int index = 1; index < count; ++index) {
-            if (!Op(*result, fPathRefs[index], fOps[index], result)) {
+        for (int index = 1; index < count; ) {
+            SkPathOp op = fOps[index];
+            int end = index + 1;
+            if (kSequential_Reduction != fReduction
+                    && (kUnion_PathOp == op || kIntersect_PathOp == op)) {
+                while (end < count && op == fOps[end]) {
+                    ++end;
+                }
+            }
+            if (end - index == 1) {
+                if (!Op(*result, fPathRefs[index], op, result)) {
+                    reset();
+                    return false;
+                }
+                index = end;
+                continue;
+            }
+            // Combine the run on its own, along with the result so far when the run starts it,
+            // since (((a op b) op c) op d) == (a op b) op (c op d) when op is union or intersect.
+            int start = 1 == index ? 0 : index;
+            SkAutoTArray<Operand> operands(end - start + (start ? 1 : 0));
+            for (int i = start; i < end; ++i) {
+                operands[i - start].fPath = fPathRefs[i];
+                operands[i - start].fSimplified = false;
+            }
+            bool succeeded = reduce(operands.get(), end - start, op,
+                                    kParallel_Reduction == fReduction);
+            if (succeeded && start) {
+                operands[end - start].fPath.swap(*result);
+                operands[end - start].fSimplified = true;
+                succeeded = combine(operands[end - start], operands[0], op, &operands[0]);
+            }
+            if (!succeeded) {
                 reset();
                 return false;
             }
+            result->swap(operands[0].fPath);
+            index = end;
         }
         reset();
         return true;
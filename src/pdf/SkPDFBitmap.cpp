@@ -5,11 +5,13 @@
  * found in the LICENSE file.
  */
 
+#include "SkChecksum.h"
 #include "SkColorPriv.h"
 #include "SkFlate.h"
 #include "SkPDFBitmap.h"
 #include "SkPDFCanon.h"
 #include "SkPDFCatalog.h"
+#include "SkPixelRef.h"
 #include "SkStream.h"
 #include "SkUnPreMultiply.h"
 
@@ -238,6 +240,24 @@ static void bitmap_alpha_to_a8(const SkBitmap& bitmap, SkWStream* out) {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// Deflates the bitmap's pixels, as written by toPixels, into memory: the
+// stream dictionary needs their compressed length before they are written.
+static SkStreamAsset* deflate_bitmap(const SkBitmap& bitmap,
+                                     void (*toPixels)(const SkBitmap&,
+                                                      SkWStream*)) {
+    SkAutoLockPixels autoLockPixels(bitmap);
+    SkASSERT(bitmap.colorType() != kIndex_8_SkColorType ||
+             bitmap.getColorTable());
+
+    SkDynamicMemoryWStream buffer;
+    SkDeflateWStream deflateWStream(&buffer);
+    toPixels(bitmap, &deflateWStream);
+    deflateWStream.finalize();  // call before detachAsStream().
+    return buffer.detachAsStream();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 namespace {
 // This SkPDFObject only outputs the alpha layer of the given bitmap.
 class PDFAlphaBitmap : public SkPDFObject {
@@ -245,23 +265,24 @@ public:
     PDFAlphaBitmap(const SkBitmap& bm) : fBitmap(bm) {}
     ~PDFAlphaBitmap() {}
     void emitObject(SkWStream*, SkPDFCatalog*) override;
+    void compress() override;
+    void drop() override { fBitmap.reset(); }
 
 private:
-    const SkBitmap fBitmap;
+    SkBitmap fBitmap;
+    SkAutoTDelete<SkStreamAsset> fDeflated;
     void emitDict(SkWStream*, SkPDFCatalog*, size_t) const;
 };
 
-void PDFAlphaBitmap::emitObject(SkWStream* stream, SkPDFCatalog* catalog) {
-    SkAutoLockPixels autoLockPixels(fBitmap);
-    SkASSERT(fBitmap.colorType() != kIndex_8_SkColorType ||
-             fBitmap.getColorTable());
+void PDFAlphaBitmap::compress() {
+    if (!fDeflated.get()) {
+        fDeflated.reset(deflate_bitmap(fBitmap, bitmap_alpha_to_a8));
+    }
+}
 
-    // Write to a temporary buffer to get the compressed length.
-    SkDynamicMemoryWStream buffer;
-    SkDeflateWStream deflateWStream(&buffer);
-    bitmap_alpha_to_a8(fBitmap, &deflateWStream);
-    deflateWStream.finalize();  // call before detachAsStream().
-    SkAutoTDelete<SkStreamAsset> asset(buffer.detachAsStream());
+void PDFAlphaBitmap::emitObject(SkWStream* stream, SkPDFCatalog* catalog) {
+    this->compress();
+    SkAutoTDelete<SkStreamAsset> asset(fDeflated.detach());
 
     this->emitDict(stream, catalog, asset->getLength());
     pdf_stream_begin(stream);
@@ -294,17 +315,20 @@ void SkPDFBitmap::addResources(SkPDFCatalog* catalog) const {
     }
 }
 
-void SkPDFBitmap::emitObject(SkWStream* stream, SkPDFCatalog* catalog) {
-    SkAutoLockPixels autoLockPixels(fBitmap);
-    SkASSERT(fBitmap.colorType() != kIndex_8_SkColorType ||
-             fBitmap.getColorTable());
+void SkPDFBitmap::compress() {
+    if (!fDeflated.get()) {
+        fDeflated.reset(deflate_bitmap(fBitmap, bitmap_to_pdf_pixels));
+    }
+}
 
-    // Write to a temporary buffer to get the compressed length.
-    SkDynamicMemoryWStream buffer;
-    SkDeflateWStream deflateWStream(&buffer);
-    bitmap_to_pdf_pixels(fBitmap, &deflateWStream);
-    deflateWStream.finalize();  // call before detachAsStream().
-    SkAutoTDelete<SkStreamAsset> asset(buffer.detachAsStream());
+void SkPDFBitmap::drop() {
+    fBitmap.reset();
+    fEncoded.reset(NULL);
+}
+
+void SkPDFBitmap::emitObject(SkWStream* stream, SkPDFCatalog* catalog) {
+    this->compress();
+    SkAutoTDelete<SkStreamAsset> asset(fDeflated.detach());
 
     this->emitDict(stream, catalog, asset->getLength());
     pdf_stream_begin(stream);
@@ -368,13 +392,192 @@ void SkPDFBitmap::emitDict(SkWStream* stream,
 }
 
 SkPDFBitmap::SkPDFBitmap(const SkBitmap& bm,
-                         SkPDFObject* smask)
-    : fBitmap(bm), fSMask(smask) {}
+                         SkPDFObject* smask,
+                         SkData* encoded,
+                         uint32_t checksum)
+    : fBitmap(bm)
+    , fEncoded(SkSafeRef(encoded))
+    , fSMask(smask)
+    , fChecksum(checksum)
+    , fGenerationID(bm.getGenerationID())
+    , fPixelRefOrigin(bm.pixelRefOrigin())
+    , fDimensions(bm.dimensions()) {}
 
 SkPDFBitmap::~SkPDFBitmap() {}
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// Hashes what bitmap_to_pdf_pixels() and bitmap_alpha_to_a8() read.
+static uint32_t pixel_checksum(const SkBitmap& bm) {
+    const uint32_t header[] = {
+        SkToU32(bm.width()), SkToU32(bm.height()), SkToU32(bm.colorType()),
+    };
+    uint32_t hash = SkChecksum::Murmur3(header, sizeof(header));
+    SkAutoLockPixels autoLockPixels(bm);
+    if (!bm.getPixels()) {
+        return hash;
+    }
+    if (const SkColorTable* table = bm.getColorTable()) {
+        hash = SkChecksum::Murmur3(table->readColors(),
+                                   table->count() * sizeof(SkPMColor), hash);
+    }
+    const size_t rowBytes = bm.width() * bm.bytesPerPixel();
+    for (int y = 0; y < bm.height(); ++y) {
+        hash = SkChecksum::Murmur3(bm.getAddr(0, y), rowBytes, hash);
+    }
+    return hash;
+}
+
+static bool same_pixels(const SkBitmap& a, const SkBitmap& b) {
+    if (a.colorType() != b.colorType() || a.dimensions() != b.dimensions()) {
+        return false;
+    }
+    SkAutoLockPixels autoLockA(a), autoLockB(b);
+    if (!a.getPixels() || !b.getPixels()) {
+        return !a.getPixels() && !b.getPixels();
+    }
+    const SkColorTable* tableA = a.getColorTable();
+    const SkColorTable* tableB = b.getColorTable();
+    if (tableA || tableB) {
+        if (!tableA || !tableB || tableA->count() != tableB->count() ||
+            memcmp(tableA->readColors(), tableB->readColors(),
+                   tableA->count() * sizeof(SkPMColor))) {
+            return false;
+        }
+    }
+    const size_t rowBytes = a.width() * a.bytesPerPixel();
+    for (int y = 0; y < a.height(); ++y) {
+        if (memcmp(a.getAddr(0, y), b.getAddr(0, y), rowBytes)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SkPDFBitmap::equals(const SkBitmap& other,
+                         SkData* encoded,
+                         uint32_t checksum) const {
+    if (fBitmap.isNull()) {
+        return false;  // Dropped, with nothing left to compare.
+    }
+    if (checksum != fChecksum || SkToBool(encoded) != SkToBool(fEncoded)) {
+        return false;
+    }
+    if (encoded) {
+        return encoded->equals(fEncoded);
+    }
+    // compress() may be locking fBitmap on another thread, so lock a
+    // bitmap of our own on the same pixels.
+    SkBitmap bm;
+    bm.setInfo(fBitmap.info(), fBitmap.rowBytes());
+    bm.setPixelRef(fBitmap.pixelRef(), fBitmap.pixelRefOrigin());
+    return same_pixels(bm, other);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Returns true if data is a JFIF JPEG with one (gray) or three (YCbCr)
+// components, which PDF's DCTDecode filter can decode as it is, and finds
+// its size.  Other JPEGs, e.g. Adobe's CMYK ones, need re-encoding.
+static bool parse_jfif(const SkData* data, SkISize* size, bool* gray) {
+    const uint8_t* bytes = data->bytes();
+    const size_t length = data->size();
+    if (length < 4 || bytes[0] != 0xFF || bytes[1] != 0xD8) {  // SOI
+        return false;
+    }
+    bool jfif = false;
+    size_t i = 2;
+    while (i + 4 <= length) {
+        if (bytes[i] != 0xFF) {
+            return false;
+        }
+        const uint8_t marker = bytes[i + 1];
+        if (0xFF == marker) {  // Fill byte.
+            ++i;
+            continue;
+        }
+        // Every marker before the first scan has a segment, whose length
+        // counts its own two bytes.
+        const size_t segmentLength = (bytes[i + 2] << 8) | bytes[i + 3];
+        const uint8_t* segment = bytes + i + 4;
+        if (segmentLength < 2 || i + 2 + segmentLength > length) {
+            return false;
+        }
+        if (0xE0 == marker && segmentLength >= 7 &&  // APP0
+            0 == memcmp(segment, "JFIF", 5)) {
+            jfif = true;
+        } else if (marker >= 0xC0 && marker <= 0xC2) {  // SOF0 - SOF2
+            if (!jfif || segmentLength < 8 || segment[0] != 8) {
+                return false;
+            }
+            const int height = (segment[1] << 8) | segment[2];
+            const int width  = (segment[3] << 8) | segment[4];
+            const int components = segment[5];
+            if (0 == width || 0 == height ||
+                (components != 1 && components != 3)) {
+                return false;
+            }
+            size->set(width, height);
+            *gray = 1 == components;
+            return true;
+        } else if ((marker >= 0xC3 && marker <= 0xCF &&
+                    marker != 0xC4 && marker != 0xCC) ||  // DHT, DAC
+                   (marker >= 0xD0 && marker <= 0xDA)) {
+            // Other frames, or anything from a scan before the frame.
+            return false;
+        }
+        i += 2 + segmentLength;
+    }
+    return false;
+}
+
+// Returns bm's encoded data if it is a JFIF JPEG of all of bm.
+static SkData* ref_jfif_data(const SkBitmap& bm, bool* gray) {
+    SkPixelRef* pixelRef = bm.pixelRef();
+    if (!pixelRef || !bm.pixelRefOrigin().isZero() ||
+        bm.dimensions() != pixelRef->info().dimensions()) {
+        return NULL;
+    }
+    SkAutoTUnref<SkData> data(pixelRef->refEncodedData());
+    SkISize size;
+    if (!data || !parse_jfif(data, &size, gray) || size != bm.dimensions()) {
+        return NULL;
+    }
+    return data.detach();
+}
+
+namespace {
+// This SkPDFBitmap writes a JFIF JPEG as it is, for DCTDecode to decode.
+class PDFJpegBitmap : public SkPDFBitmap {
+public:
+    PDFJpegBitmap(const SkBitmap& bm, SkData* jpeg, uint32_t checksum,
+                  bool gray)
+        : SkPDFBitmap(bm, NULL, jpeg, checksum), fGray(gray) {}
+    void emitObject(SkWStream*, SkPDFCatalog*) override;
+    void compress() override {}
+
+private:
+    const bool fGray;
+};
+
+void PDFJpegBitmap::emitObject(SkWStream* stream, SkPDFCatalog* catalog) {
+    SkPDFDict pdfDict("XObject");
+    pdfDict.insertName("Subtype", "Image");
+    pdfDict.insertInt("Width", fBitmap.width());
+    pdfDict.insertInt("Height", fBitmap.height());
+    pdfDict.insertName("ColorSpace", fGray ? "DeviceGray" : "DeviceRGB");
+    pdfDict.insertInt("BitsPerComponent", 8);
+    pdfDict.insertName("Filter", "DCTDecode");
+    pdfDict.insertInt("Length", fEncoded->size());
+    pdfDict.emitObject(stream, catalog);
+    pdf_stream_begin(stream);
+    stream->write(fEncoded->data(), fEncoded->size());
+    pdf_stream_end(stream);
+}
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
 static const SkBitmap& immutable_bitmap(const SkBitmap& bm, SkBitmap* copy) {
     if (bm.isImmutable()) {
         return bm;
@@ -398,11 +601,25 @@ SkPDFBitmap* SkPDFBitmap::Create(SkPDFCanon* canon, const SkBitmap& bitmap) {
     if (SkPDFBitmap* canonBitmap = canon->findBitmap(bm)) {
         return SkRef(canonBitmap);
     }
-    SkPDFObject* smask = NULL;
-    if (!bm.isOpaque() && !SkBitmap::ComputeIsOpaque(bm)) {
-        smask = SkNEW_ARGS(PDFAlphaBitmap, (bm));
+    // Images decoded separately from the same data, or with the same
+    // pixels, are written once.
+    bool gray;
+    SkAutoTUnref<SkData> jpeg(ref_jfif_data(bm, &gray));
+    uint32_t checksum = jpeg ? SkChecksum::Murmur3(jpeg->data(), jpeg->size())
+                             : pixel_checksum(bm);
+    if (SkPDFBitmap* canonBitmap = canon->findBitmap(bm, jpeg, checksum)) {
+        return SkRef(canonBitmap);
+    }
+    SkPDFBitmap* pdfBitmap;
+    if (jpeg) {
+        pdfBitmap = SkNEW_ARGS(PDFJpegBitmap, (bm, jpeg, checksum, gray));
+    } else {
+        SkPDFObject* smask = NULL;
+        if (!bm.isOpaque() && !SkBitmap::ComputeIsOpaque(bm)) {
+            smask = SkNEW_ARGS(PDFAlphaBitmap, (bm));
+        }
+        pdfBitmap = SkNEW_ARGS(SkPDFBitmap, (bm, smask, NULL, checksum));
     }
-    SkPDFBitmap* pdfBitmap = SkNEW_ARGS(SkPDFBitmap, (bm, smask));
     canon->addBitmap(pdfBitmap);
     return pdfBitmap;
 }
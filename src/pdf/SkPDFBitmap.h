@@ -9,18 +9,25 @@
 
 #include "SkPDFTypes.h"
 #include "SkBitmap.h"
+#include "SkData.h"
+#include "SkTemplates.h"
 
 class SkPDFCanon;
+class SkStreamAsset;
 
 /**
  * SkPDFBitmap wraps a SkBitmap and serializes it as an image Xobject.
  * It is designed to use a minimal amout of memory, aside from refing
- * the bitmap's pixels, and its emitObject() does not cache any data.
+ * the bitmap's pixels.  Only compress() caches any data: the deflated
+ * pixels, which the next emitObject() writes and frees.  drop() lets go
+ * of the bitmap (or its encoded data) once it has been written.
  *
  * If !bitmap.isImmutable(), then a copy of the bitmap must be made;
  * there is no way around this.
  *
- * The SkPDFBitmap::Create function will check the canon for duplicates.
+ * The SkPDFBitmap::Create function will check the canon for duplicates:
+ * the same bitmap, or another with the same pixels or encoded data.  A
+ * bitmap decoded from a JFIF JPEG is written as that JPEG, undecoded.
  */
 class SkPDFBitmap : public SkPDFObject {
 public:
@@ -29,16 +36,34 @@ public:
     ~SkPDFBitmap();
     void emitObject(SkWStream*, SkPDFCatalog*) override;
     void addResources(SkPDFCatalog*) const override;
+    void compress() override;
+    void drop() override;
     bool equals(const SkBitmap& other) const {
-        return fBitmap.getGenerationID() == other.getGenerationID() &&
-               fBitmap.pixelRefOrigin() == other.pixelRefOrigin() &&
-               fBitmap.dimensions() == other.dimensions();
+        return fGenerationID == other.getGenerationID() &&
+               fPixelRefOrigin == other.pixelRefOrigin() &&
+               fDimensions == other.dimensions();
     }
+    // Returns true if other has the same encoded data as this (if encoded
+    // is not NULL), or the same pixels.  checksum is other's, from Create().
+    // Always false once dropped.
+    bool equals(const SkBitmap& other,
+                SkData* encoded,
+                uint32_t checksum) const;
+
+protected:
+    // Both are released by drop().
+    SkBitmap fBitmap;
+    SkAutoTUnref<SkData> fEncoded;
+    SkPDFBitmap(const SkBitmap&, SkPDFObject*, SkData*, uint32_t);
 
 private:
-    const SkBitmap fBitmap;
     const SkAutoTUnref<SkPDFObject> fSMask;
-    SkPDFBitmap(const SkBitmap&, SkPDFObject*);
+    const uint32_t fChecksum;
+    // fBitmap's identity, which outlives it for equals().
+    const uint32_t fGenerationID;
+    const SkIPoint fPixelRefOrigin;
+    const SkISize fDimensions;
+    SkAutoTDelete<SkStreamAsset> fDeflated;
     void emitDict(SkWStream*, SkPDFCatalog*, size_t) const;
 };
 
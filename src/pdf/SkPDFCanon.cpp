@@ -121,6 +121,17 @@ SkPDFBitmap* SkPDFCanon::findBitmap(const SkBitmap& bm) const {
     return find_item(fBitmapRecords, bm);
 }
 
+SkPDFBitmap* SkPDFCanon::findBitmap(const SkBitmap& bm,
+                                    SkData* encoded,
+                                    uint32_t checksum) const {
+    for (int i = 0; i < fBitmapRecords.count(); ++i) {
+        if (fBitmapRecords[i]->equals(bm, encoded, checksum)) {
+            return fBitmapRecords[i];
+        }
+    }
+    return NULL;
+}
+
 void SkPDFCanon::addBitmap(SkPDFBitmap* pdfBitmap) {
     fBitmapRecords.push(SkRef(pdfBitmap));
 }
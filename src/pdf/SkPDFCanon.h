@@ -11,6 +11,7 @@
 #include "SkTDArray.h"
 
 class SkBitmap;
+class SkData;
 class SkPDFFont;
 class SkPDFGraphicState;
 class SkPDFBitmap;
@@ -60,7 +61,14 @@ public:
     void addGraphicState(SkPDFGraphicState*);
 
     SkPDFBitmap* findBitmap(const SkBitmap&) const;
+    // Returns a bitmap with the same contents, if there is one; see
+    // SkPDFBitmap::equals().
+    SkPDFBitmap* findBitmap(const SkBitmap&,
+                            SkData* encoded,
+                            uint32_t checksum) const;
     void addBitmap(SkPDFBitmap*);
+    // Every bitmap added since the last reset(), in the order they were added.
+    const SkTDArray<SkPDFBitmap*>& bitmaps() const { return fBitmapRecords; }
 
 private:
     struct FontRec {
@@ -52,6 +52,30 @@ void SkPDFStream::emitObject(SkWStream* stream, SkPDFCatalog* catalog) {
     stream->writeText("\nendstream");
 }
 
+void SkPDFStream::compress() {
+#ifndef SK_NO_FLATE
+    if (fState != kUnused_State) {
+        return;
+    }
+    fState = kNoCompression_State;
+    SkDynamicMemoryWStream compressedData;
+
+    SkAssertResult(SkFlate::Deflate(fDataStream.get(), &compressedData));
+    SkAssertResult(fDataStream->rewind());
+    if (compressedData.getOffset() < this->dataSize()) {
+        SkAutoTDelete<SkStream> compressed(compressedData.detachAsStream());
+        this->setData(compressed.get());
+        insertName("Filter", "FlateDecode");
+    }
+    fState = kCompressed_State;
+    insertInt("Length", this->dataSize());
+#endif  // SK_NO_FLATE
+}
+
+void SkPDFStream::drop() {
+    this->setData((SkStream*)NULL);
+}
+
 SkPDFStream::SkPDFStream() : fState(kUnused_State) {}
 
 void SkPDFStream::setData(SkData* data) {
@@ -87,20 +111,7 @@ bool SkPDFStream::populate(SkPDFCatalog* catalog) {
 #else  // !SK_NO_FLATE
 
     if (fState == kUnused_State) {
-        fState = kNoCompression_State;
-        SkDynamicMemoryWStream compressedData;
-
-        SkAssertResult(
-                SkFlate::Deflate(fDataStream.get(), &compressedData));
-        SkAssertResult(fDataStream->rewind());
-        if (compressedData.getOffset() < this->dataSize()) {
-            SkAutoTDelete<SkStream> compressed(
-                    compressedData.detachAsStream());
-            this->setData(compressed.get());
-            insertName("Filter", "FlateDecode");
-        }
-        fState = kCompressed_State;
-        insertInt("Length", this->dataSize());
+        this->compress();
     }
     else if (fState == kNoCompression_State) {
         if (!fSubstitute.get()) {
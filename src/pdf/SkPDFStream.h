@@ -41,6 +41,8 @@ public:
 
     // The SkPDFObject interface.
     virtual void emitObject(SkWStream* stream, SkPDFCatalog* catalog) override;
+    void compress() override;
+    void drop() override;
 
 protected:
     enum State {
@@ -46,6 +46,19 @@ public:
      */
     virtual void addResources(SkPDFCatalog* catalog) const {}
 
+    /**
+     *  Does the expensive, self-contained part of emitObject() (e.g.
+     *  deflating stream data) ahead of time.  This may be called from
+     *  any thread, but not while anything else uses this object.
+     */
+    virtual void compress() {}
+
+    /**
+     *  Frees the data only emitObject() needs, once the object has been
+     *  written.  emitObject() must not be called again afterwards.
+     */
+    virtual void drop() {}
+
 private:
     typedef SkRefCnt INHERITED;
 };
@@ -75,6 +75,7 @@ enum DrawOps {
     kDef_Flattenable_DrawOp,
     kDef_Bitmap_DrawOp,
     kDef_Factory_DrawOp,
+    kDef_SharedBitmap_DrawOp,
 
     // these are signals to playback, not drawing verbs
     kReportFlags_DrawOp,
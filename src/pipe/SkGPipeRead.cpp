@@ -147,14 +147,33 @@ public:
      */
     void addBitmap(int index) {
         SkASSERT(shouldFlattenBitmaps(fFlags));
-        SkBitmap* bm;
-        if(fBitmaps.count() == index) {
-            bm = SkNEW(SkBitmap);
-            *fBitmaps.append() = bm;
-        } else {
-            bm = fBitmaps[index];
+        fReader->readBitmap(this->bitmapForSlot(index));
+    }
+
+    /**
+     * Add or replace a bitmap, like addBitmap(), whose pixels the writer's controller shared
+     * with us. If we can't find them, the bitmap is left empty.
+     */
+    void addSharedBitmap(int index) {
+        SkASSERT(shouldFlattenBitmaps(fFlags));
+        SkImageInfo info;
+        info.unflatten(*fReader);
+        size_t rowBytes = fReader->readUInt();
+        uint32_t id = fReader->readUInt();
+
+        SkBitmap* bm = this->bitmapForSlot(index);
+        void* pixels = NULL;
+        if (fSharedPixelsProc && info.validRowBytes(rowBytes)) {
+            pixels = fSharedPixelsProc(id, info.getSafeSize(rowBytes), fSharedPixelsContext);
         }
-        fReader->readBitmap(bm);
+        if (NULL == pixels || !bm->installPixels(info, pixels, rowBytes)) {
+            bm->reset();
+        }
+    }
+
+    void setSharedPixelsProc(SkGPipeReader::SharedPixelsProc proc, void* context) {
+        fSharedPixelsProc = proc;
+        fSharedPixelsContext = context;
     }
 
     /**
@@ -199,6 +218,13 @@ public:
     }
 
 private:
+    SkBitmap* bitmapForSlot(int index) {
+        if (fBitmaps.count() == index) {
+            *fBitmaps.append() = SkNEW(SkBitmap);
+        }
+        return fBitmaps[index];
+    }
+
     void updateReader() {
         if (NULL == fReader) {
             return;
@@ -228,6 +254,9 @@ private:
     // Only used when sharing bitmaps with the writer.
     SkBitmapHeap*             fSharedHeap;
     unsigned                  fFlags;
+    // Only used when the writer's controller shares pixels with us.
+    SkGPipeReader::SharedPixelsProc fSharedPixelsProc;
+    void*                           fSharedPixelsContext;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -760,6 +789,12 @@ static void def_Factory_rp(SkCanvas*, SkReader32* reader, uint32_t,
     state->defFactory(reader->readString());
 }
 
+static void def_SharedBitmap_rp(SkCanvas*, SkReader32*, uint32_t op32,
+                                SkGPipeState* state) {
+    unsigned index = DrawOp_unpackData(op32);
+    state->addSharedBitmap(index);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 static void skip_rp(SkCanvas*, SkReader32* reader, uint32_t op32, SkGPipeState*) {
@@ -825,6 +860,7 @@ static const ReadProc gReadTable[] = {
     def_PaintFlat_rp,
     def_Bitmap_rp,
     def_Factory_rp,
+    def_SharedBitmap_rp,
 
     reportFlags_rp,
     shareBitmapHeap_rp,
@@ -837,7 +873,9 @@ SkGPipeState::SkGPipeState()
     : fReader(0)
     , fSilent(false)
     , fSharedHeap(NULL)
-    , fFlags(0) {
+    , fFlags(0)
+    , fSharedPixelsProc(NULL)
+    , fSharedPixelsContext(NULL) {
 
 }
 
@@ -856,6 +894,8 @@ SkGPipeReader::SkGPipeReader() {
     fCanvas = NULL;
     fState = NULL;
     fProc = NULL;
+    fSharedPixelsProc = NULL;
+    fSharedPixelsContext = NULL;
 }
 
 SkGPipeReader::SkGPipeReader(SkCanvas* target) {
@@ -863,6 +903,8 @@ SkGPipeReader::SkGPipeReader(SkCanvas* target) {
     this->setCanvas(target);
     fState = NULL;
     fProc = NULL;
+    fSharedPixelsProc = NULL;
+    fSharedPixelsContext = NULL;
 }
 
 void SkGPipeReader::setCanvas(SkCanvas *target) {
@@ -885,6 +927,7 @@ SkGPipeReader::Status SkGPipeReader::playback(const void* data, size_t length,
     }
 
     fState->setSilent(playbackFlags & kSilent_PlaybackFlag);
+    fState->setSharedPixelsProc(fSharedPixelsProc, fSharedPixelsContext);
 
     SkASSERT(SK_ARRAY_COUNT(gReadTable) == (kDone_DrawOp + 1));
 
@@ -914,7 +957,8 @@ SkGPipeReader::Status SkGPipeReader::playback(const void* data, size_t length,
             (table[op] != paintOp_rp &&
              table[op] != def_Typeface_rp &&
              table[op] != def_PaintFlat_rp &&
-             table[op] != def_Bitmap_rp
+             table[op] != def_Bitmap_rp &&
+             table[op] != def_SharedBitmap_rp
              )) {
                 status = kReadAtom_Status;
                 break;
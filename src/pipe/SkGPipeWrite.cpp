@@ -266,12 +266,15 @@ protected:
     void onDrawPaint(const SkPaint&) override;
     void onDrawPoints(PointMode, size_t count, const SkPoint pts[], const SkPaint&) override;
     void onDrawRect(const SkRect&, const SkPaint&) override;
+    void onDrawRects(const SkRect[], int count, const SkPaint&) override;
     void onDrawOval(const SkRect&, const SkPaint&) override;
     void onDrawRRect(const SkRRect&, const SkPaint&) override;
     void onDrawPath(const SkPath&, const SkPaint&) override;
     void onDrawBitmap(const SkBitmap&, SkScalar left, SkScalar top, const SkPaint*) override;
     void onDrawBitmapRect(const SkBitmap&, const SkRect* src, const SkRect& dst, const SkPaint*,
                           DrawBitmapRectFlags flags) override;
+    void onDrawBitmapRects(const SkBitmap&, const SkRect src[], const SkRect dst[],
+                           int count, const SkPaint*) override;
 #if 0
     // rely on decomposition into bitmap (for now)
     void onDrawImage(const SkImage*, SkScalar left, SkScalar top, const SkPaint*) override;
@@ -379,6 +382,22 @@ void SkGPipeCanvas::flattenFactoryNames() {
 
 bool SkGPipeCanvas::shuttleBitmap(const SkBitmap& bm, int32_t slot) {
     SkASSERT(shouldFlattenBitmaps(fFlags));
+    uint32_t id;
+    if (fController->shareBitmap(bm, &id)) {
+        // The reader can see the pixels already, so just tell it where they are.
+        SkWriteBuffer buffer;
+        bm.info().flatten(buffer);
+        buffer.writeUInt(SkToU32(bm.rowBytes()));
+        buffer.writeUInt(id);
+        size_t size = buffer.bytesWritten();
+        if (this->needOpBytes(size)) {
+            this->writeOp(kDef_SharedBitmap_DrawOp, 0, slot);
+            buffer.writeToMemory(fWriter.reserve(size));
+            return true;
+        }
+        return false;
+    }
+
     SkWriteBuffer buffer;
     buffer.setNamedFactoryRecorder(fFactorySet);
     buffer.writeBitmap(bm);
@@ -708,6 +727,12 @@ void SkGPipeCanvas::onDrawRect(const SkRect& rect, const SkPaint& paint) {
     }
 }
 
+void SkGPipeCanvas::onDrawRects(const SkRect rects[], int count, const SkPaint& paint) {
+    for (int i = 0; i < count; ++i) {
+        this->onDrawRect(rects[i], paint);
+    }
+}
+
 void SkGPipeCanvas::onDrawRRect(const SkRRect& rrect, const SkPaint& paint) {
     NOTIFY_SETUP(this);
     this->writePaint(paint);
@@ -799,6 +824,13 @@ void SkGPipeCanvas::onDrawBitmapRect(const SkBitmap& bm, const SkRect* src, cons
     }
 }
 
+void SkGPipeCanvas::onDrawBitmapRects(const SkBitmap& bitmap, const SkRect src[],
+                                      const SkRect dst[], int count, const SkPaint* paint) {
+    for (int i = 0; i < count; ++i) {
+        this->onDrawBitmapRect(bitmap, &src[i], dst[i], paint, kNone_DrawBitmapRectFlag);
+    }
+}
+
 void SkGPipeCanvas::onDrawBitmapNine(const SkBitmap& bm, const SkIRect& center,
                                      const SkRect& dst, const SkPaint* paint) {
     NOTIFY_SETUP(this);
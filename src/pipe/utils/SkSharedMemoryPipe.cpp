@@ -0,0 +1,264 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkSharedMemoryPipe.h"
+
+#include "SkAtomics.h"
+#include "SkBitmap.h"
+#include "SkGPipePriv.h"
+#include "SkMath.h"
+
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// The start of the shared memory segment. The ring buffer follows it, then the pixel pool.
+struct SkSharedMemoryPipeHeader {
+    uint32_t fRingBytes;    // a power of 2
+    uint32_t fPixelBytes;
+
+    // Bytes ever written to and read from the ring. Both wrap around at 2^32 together, which the
+    // ring's size divides, and fWritten - fRead bytes are waiting to be read. Each side only
+    // changes its own count, so they're kept on separate cache lines.
+    uint32_t fWritten;
+    char     fPadding0[64 - 3*sizeof(uint32_t)];
+    uint32_t fRead;
+    char     fPadding1[64 - sizeof(uint32_t)];
+};
+
+static const size_t kMinRingBytes = 64 * 1024;  // The writer asks for blocks of at least 16K.
+static const size_t kMaxRingBytes = 1 << 30;
+
+static char* ring(SkSharedMemoryPipeHeader* header) {
+    return reinterpret_cast<char*>(header + 1);
+}
+
+static char* pixel_pool(SkSharedMemoryPipeHeader* header) {
+    return ring(header) + header->fRingBytes;
+}
+
+// Fills the end of the ring, when it's too short for the next block, with ops telling the reader
+// to skip over it.
+static void write_skips(void* dst, size_t bytes) {
+    uint32_t* op = static_cast<uint32_t*>(dst);
+    while (bytes > 0) {
+        const size_t skip = SkTMin<size_t>(bytes - sizeof(uint32_t), DRAWOPS_DATA_MASK & ~3);
+        *op = DrawOp_packOpFlagData(kSkip_DrawOp, 0, SkToU32(skip));
+        op += 1 + skip / sizeof(uint32_t);
+        bytes -= sizeof(uint32_t) + skip;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SkSharedMemoryPipeController* SkSharedMemoryPipeController::Create(const char name[],
+                                                                   size_t ringBytes,
+                                                                   size_t pixelBytes) {
+    if (ringBytes > kMaxRingBytes || pixelBytes > SK_MaxU32) {
+        return NULL;
+    }
+    ringBytes = SkNextPow2(SkToInt(SkTMax(ringBytes, kMinRingBytes)));
+    const size_t size = sizeof(SkSharedMemoryPipeHeader) + ringBytes + pixelBytes;
+
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        return NULL;
+    }
+    void* addr = MAP_FAILED;
+    if (0 == ftruncate(fd, size)) {
+        addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (MAP_FAILED == addr) {
+        shm_unlink(name);
+        return NULL;
+    }
+
+    // ftruncate() zeroed the segment, so nothing has been written or read yet.
+    SkSharedMemoryPipeHeader* header = static_cast<SkSharedMemoryPipeHeader*>(addr);
+    header->fRingBytes = SkToU32(ringBytes);
+    header->fPixelBytes = SkToU32(pixelBytes);
+    return SkNEW_ARGS(SkSharedMemoryPipeController, (name, header, size));
+}
+
+SkSharedMemoryPipeController::SkSharedMemoryPipeController(const char name[],
+                                                           SkSharedMemoryPipeHeader* header,
+                                                           size_t size)
+    : fName(name)
+    , fHeader(header)
+    , fSize(size)
+    , fPixelBytesUsed(0) {}
+
+SkSharedMemoryPipeController::~SkSharedMemoryPipeController() {
+    munmap(fHeader, fSize);
+    shm_unlink(fName.c_str());
+}
+
+bool SkSharedMemoryPipeController::allocSharedPixels(SkBitmap* bitmap, const SkImageInfo& info) {
+    const size_t rowBytes = info.minRowBytes();
+    const size_t bytes = info.getSafeSize(rowBytes);
+    if (0 == bytes || bytes > fHeader->fPixelBytes - fPixelBytesUsed) {
+        return false;
+    }
+    if (!bitmap->installPixels(info, pixel_pool(fHeader) + fPixelBytesUsed, rowBytes)) {
+        return false;
+    }
+    fPixelBytesUsed = SkTMin<size_t>(SkAlign8(fPixelBytesUsed + bytes), fHeader->fPixelBytes);
+    return true;
+}
+
+uint32_t SkSharedMemoryPipeController::waitForRoom(uint32_t bytes) {
+    const uint32_t written = sk_atomic_load(&fHeader->fWritten, sk_memory_order_relaxed);
+    for (;;) {
+        // Acquire, so the reader is done with what it's freed before we write over it.
+        const uint32_t read = sk_atomic_load(&fHeader->fRead, sk_memory_order_acquire);
+        const uint32_t room = fHeader->fRingBytes - (written - read);
+        if (room >= bytes) {
+            return room;
+        }
+        sched_yield();
+    }
+}
+
+void SkSharedMemoryPipeController::waitForReader() {
+    this->waitForRoom(fHeader->fRingBytes);
+}
+
+void* SkSharedMemoryPipeController::requestBlock(size_t minRequest, size_t* actual) {
+    const uint32_t ringBytes = fHeader->fRingBytes;
+    if (minRequest > ringBytes) {
+        return NULL;
+    }
+
+    // The writer has told us about everything it wrote to the last block, so the new one
+    // starts where that left off.
+    uint32_t written = sk_atomic_load(&fHeader->fWritten, sk_memory_order_relaxed);
+    uint32_t offset = written & (ringBytes - 1);
+    if (ringBytes - offset < minRequest) {
+        // Blocks have to be contiguous: skip to the start of the ring.
+        const uint32_t tail = ringBytes - offset;
+        this->waitForRoom(tail);
+        write_skips(ring(fHeader) + offset, tail);
+        written += tail;
+        sk_atomic_store(&fHeader->fWritten, written, sk_memory_order_release);
+        offset = 0;
+    }
+
+    const uint32_t room = this->waitForRoom(SkToU32(minRequest));
+    *actual = SkTMin(room, ringBytes - offset);
+    return ring(fHeader) + offset;
+}
+
+void SkSharedMemoryPipeController::notifyWritten(size_t bytes) {
+    const uint32_t written = sk_atomic_load(&fHeader->fWritten, sk_memory_order_relaxed);
+    // Release, so the reader sees the commands before it sees there are more to read.
+    sk_atomic_store(&fHeader->fWritten, written + SkToU32(bytes), sk_memory_order_release);
+}
+
+bool SkSharedMemoryPipeController::shareBitmap(const SkBitmap& bitmap, uint32_t* id) {
+    SkAutoLockPixels alp(bitmap);
+    const char* pixels = static_cast<const char*>(bitmap.getPixels());
+    const char* pool = pixel_pool(fHeader);
+    if (NULL == pixels || pixels < pool ||
+        pixels + bitmap.getSafeSize() > pool + fPixelBytesUsed) {
+        return false;
+    }
+    *id = SkToU32(pixels - pool);
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SkSharedMemoryPipeReader* SkSharedMemoryPipeReader::Open(const char name[], SkCanvas* target) {
+    int fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0) {
+        return NULL;
+    }
+    void* addr = MAP_FAILED;
+    size_t size = 0;
+    struct stat status;
+    if (0 == fstat(fd, &status) && status.st_size >= (off_t)sizeof(SkSharedMemoryPipeHeader)) {
+        size = static_cast<size_t>(status.st_size);
+        addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (MAP_FAILED == addr) {
+        return NULL;
+    }
+
+    SkSharedMemoryPipeHeader* header = static_cast<SkSharedMemoryPipeHeader*>(addr);
+    if (!SkIsPow2(header->fRingBytes) ||
+        sizeof(SkSharedMemoryPipeHeader) + header->fRingBytes + header->fPixelBytes != size) {
+        munmap(addr, size);
+        return NULL;
+    }
+    return SkNEW_ARGS(SkSharedMemoryPipeReader, (header, size, target));
+}
+
+SkSharedMemoryPipeReader::SkSharedMemoryPipeReader(SkSharedMemoryPipeHeader* header, size_t size,
+                                                   SkCanvas* target)
+    : fHeader(header)
+    , fSize(size)
+    , fReader(target)
+    , fDone(false) {
+    fReader.setSharedPixelsProc(FindSharedPixels, this);
+}
+
+SkSharedMemoryPipeReader::~SkSharedMemoryPipeReader() {
+    munmap(fHeader, fSize);
+}
+
+void* SkSharedMemoryPipeReader::FindSharedPixels(uint32_t id, size_t bytes, void* context) {
+    SkSharedMemoryPipeHeader* header = static_cast<SkSharedMemoryPipeReader*>(context)->fHeader;
+    if (id > header->fPixelBytes || bytes > header->fPixelBytes - id) {
+        return NULL;
+    }
+    return pixel_pool(header) + id;
+}
+
+SkGPipeReader::Status SkSharedMemoryPipeReader::playbackAvailable() {
+    if (fDone) {
+        return SkGPipeReader::kDone_Status;
+    }
+    const uint32_t ringBytes = fHeader->fRingBytes;
+    uint32_t read = sk_atomic_load(&fHeader->fRead, sk_memory_order_relaxed);
+    for (;;) {
+        // Acquire, so we see the commands the writer says are there.
+        const uint32_t written = sk_atomic_load(&fHeader->fWritten, sk_memory_order_acquire);
+        if (written == read) {
+            return SkGPipeReader::kEOF_Status;
+        }
+
+        // The writer never splits a command across the end of the ring.
+        const uint32_t offset = read & (ringBytes - 1);
+        size_t bytesRead = 0;
+        SkGPipeReader::Status status = fReader.playback(ring(fHeader) + offset,
+                                                        SkTMin(written - read, ringBytes - offset),
+                                                        0, &bytesRead);
+        read += SkToU32(bytesRead);
+        sk_atomic_store(&fHeader->fRead, read, sk_memory_order_release);
+
+        if (SkGPipeReader::kDone_Status == status) {
+            fDone = true;
+        }
+        if (SkGPipeReader::kEOF_Status != status) {
+            return status;
+        }
+    }
+}
+
+SkGPipeReader::Status SkSharedMemoryPipeReader::playbackUntilDone() {
+    for (;;) {
+        SkGPipeReader::Status status = this->playbackAvailable();
+        if (SkGPipeReader::kEOF_Status != status) {
+            return status;
+        }
+        sched_yield();
+    }
+}
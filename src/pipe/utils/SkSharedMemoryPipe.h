@@ -0,0 +1,118 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkSharedMemoryPipe_DEFINED
+#define SkSharedMemoryPipe_DEFINED
+
+#include "SkGPipe.h"
+#include "SkImageInfo.h"
+#include "SkString.h"
+
+class SkBitmap;
+class SkCanvas;
+struct SkSharedMemoryPipeHeader;
+
+/**
+ *  Pipes draws from one process to another on the same host through a POSIX shared memory
+ *  segment. The segment holds a ring buffer, which the SkGPipeWriter writes its commands
+ *  straight into and the SkSharedMemoryPipeReader plays them back from, and a pool of pixel
+ *  buffers. Drawing a bitmap whose pixels are in the pool only sends the reader their ID, and
+ *  the reader draws from the same pixels: they are never copied.
+ *
+ *  There is one writer, recording with SkGPipeWriter::kCrossProcess_Flag (and not
+ *  kSharedAddressSpace_Flag) into this controller, and one reader. When the ring buffer is full
+ *  the writer waits for the reader, yielding the CPU, so the reader has to keep reading.
+ */
+class SkSharedMemoryPipeController : public SkGPipeController {
+public:
+    /**
+     *  Creates and maps a new shared memory segment called name (e.g. "/skia-pipe"), with
+     *  ringBytes (rounded up to a power of 2, and at least 64K) for commands and pixelBytes for
+     *  shared pixels. Returns NULL if it can't. The name is unlinked when the controller is
+     *  deleted; readers that have already opened it keep it mapped.
+     */
+    static SkSharedMemoryPipeController* Create(const char name[], size_t ringBytes,
+                                                size_t pixelBytes);
+
+    virtual ~SkSharedMemoryPipeController();
+
+    /**
+     *  Allocates the pixels of bitmap from the shared pixel buffers. Returns false if there isn't
+     *  room for them. The pixels can be changed (followed by notifyPixelsChanged()) once the
+     *  reader has drawn them; see waitForReader().
+     *
+     *  The pool is a bump allocator that is never reclaimed: pixels stay allocated until the
+     *  controller is deleted, even once their bitmaps are gone. A long-lived writer should
+     *  allocate its shared bitmaps up front and reuse them; once the pool runs out, new bitmaps
+     *  have to use their own pixels, which the writer flattens through the ring instead.
+     */
+    bool allocSharedPixels(SkBitmap* bitmap, const SkImageInfo& info);
+
+    /**
+     *  Waits, yielding the CPU, until the reader has played back everything notifyWritten() has
+     *  been told about, i.e. the ring is empty. Flush the SkGPipeWriter first (e.g. with
+     *  flushRecording()) so everything recorded has been written. After this the reader is done
+     *  with every shared pixel it was sent, so they can be changed.
+     */
+    void waitForReader();
+
+    void* requestBlock(size_t minRequest, size_t* actual) override;
+    void notifyWritten(size_t bytes) override;
+    bool shareBitmap(const SkBitmap&, uint32_t* id) override;
+
+private:
+    SkSharedMemoryPipeController(const char name[], SkSharedMemoryPipeHeader*, size_t size);
+
+    // Waits for the reader until there are at least bytes free in the ring, and returns how
+    // many there are.
+    uint32_t waitForRoom(uint32_t bytes);
+
+    SkString                  fName;
+    SkSharedMemoryPipeHeader* fHeader;
+    size_t                    fSize;
+    size_t                    fPixelBytesUsed;
+};
+
+/**
+ *  Plays back the draws an SkSharedMemoryPipeController's writer sends, in the same process or
+ *  another one.
+ */
+class SkSharedMemoryPipeReader {
+public:
+    /**
+     *  Maps the shared memory segment called name, which an SkSharedMemoryPipeController has
+     *  created, to play back its draws into target. Returns NULL if it can't.
+     */
+    static SkSharedMemoryPipeReader* Open(const char name[], SkCanvas* target);
+
+    ~SkSharedMemoryPipeReader();
+
+    /**
+     *  Plays back every command written so far, without waiting for more. Returns
+     *  SkGPipeReader::kDone_Status once the writer has finished, kEOF_Status if there may be
+     *  more to come, or kError_Status.
+     */
+    SkGPipeReader::Status playbackAvailable();
+
+    /**
+     *  Plays back commands, waiting for more by yielding the CPU, until the writer has finished
+     *  or there is an error.
+     */
+    SkGPipeReader::Status playbackUntilDone();
+
+private:
+    SkSharedMemoryPipeReader(SkSharedMemoryPipeHeader*, size_t size, SkCanvas* target);
+
+    static void* FindSharedPixels(uint32_t id, size_t bytes, void* context);
+
+    SkSharedMemoryPipeHeader* fHeader;
+    size_t                    fSize;
+    SkGPipeReader             fReader;
+    bool                      fDone;
+};
+
+#endif
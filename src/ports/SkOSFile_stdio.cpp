@@ -153,3 +153,11 @@ bool sk_mkdir(const char* path) {
         return false;
     }
 }
+
+bool sk_remove(const char* path) {
+    return 0 == ::remove(path);
+}
+
+bool sk_rename(const char* oldPath, const char* newPath) {
+    return 0 == ::rename(oldPath, newPath);
+}
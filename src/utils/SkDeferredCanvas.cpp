@@ -782,6 +782,12 @@ void SkDeferredCanvas::onDrawRect(const SkRect& rect, const SkPaint& paint) {
     this->recordedDrawCommand();
 }
 
+void SkDeferredCanvas::onDrawRects(const SkRect rects[], int count, const SkPaint& paint) {
+    AutoImmediateDrawIfNeeded autoDraw(*this, &paint);
+    this->drawingCanvas()->drawRects(rects, count, paint);
+    this->recordedDrawCommand();
+}
+
 void SkDeferredCanvas::onDrawRRect(const SkRRect& rrect, const SkPaint& paint) {
     if (rrect.isRect()) {
         this->SkDeferredCanvas::drawRect(rrect.getBounds(), paint);
@@ -836,6 +842,13 @@ void SkDeferredCanvas::onDrawBitmapRect(const SkBitmap& bitmap, const SkRect* sr
     this->recordedDrawCommand();
 }
 
+void SkDeferredCanvas::onDrawBitmapRects(const SkBitmap& bitmap, const SkRect src[],
+                                         const SkRect dst[], int count, const SkPaint* paint) {
+    AutoImmediateDrawIfNeeded autoDraw(*this, &bitmap, paint);
+    this->drawingCanvas()->drawBitmapRects(bitmap, src, dst, count, paint);
+    this->recordedDrawCommand();
+}
+
 void SkDeferredCanvas::onDrawBitmapNine(const SkBitmap& bitmap,
                                         const SkIRect& center, const SkRect& dst,
                                         const SkPaint* paint) {
@@ -316,6 +316,12 @@ void SkDumpCanvas::onDrawRect(const SkRect& rect, const SkPaint& paint) {
     this->dump(kDrawRect_Verb, &paint, "drawRect(%s)", str.c_str());
 }
 
+void SkDumpCanvas::onDrawRects(const SkRect rects[], int count, const SkPaint& paint) {
+    for (int i = 0; i < count; ++i) {
+        this->onDrawRect(rects[i], paint);
+    }
+}
+
 void SkDumpCanvas::onDrawRRect(const SkRRect& rrect, const SkPaint& paint) {
     SkString str;
     toString(rrect, &str);
@@ -363,6 +369,13 @@ void SkDumpCanvas::onDrawBitmapRect(const SkBitmap& bitmap, const SkRect* src, c
                bs.c_str(), rs.c_str());
 }
 
+void SkDumpCanvas::onDrawBitmapRects(const SkBitmap& bitmap, const SkRect src[],
+                                     const SkRect dst[], int count, const SkPaint* paint) {
+    for (int i = 0; i < count; ++i) {
+        this->onDrawBitmapRect(bitmap, &src[i], dst[i], paint, kNone_DrawBitmapRectFlag);
+    }
+}
+
 void SkDumpCanvas::onDrawBitmapNine(const SkBitmap& bitmap, const SkIRect& center,
                                     const SkRect& dst, const SkPaint* paint) {
     SkString str, centerStr, dstStr;
@@ -186,6 +186,12 @@ void SkLuaCanvas::onDrawRect(const SkRect& rect, const SkPaint& paint) {
     lua.pushPaint(paint, "paint");
 }
 
+void SkLuaCanvas::onDrawRects(const SkRect rects[], int count, const SkPaint& paint) {
+    for (int i = 0; i < count; ++i) {
+        this->onDrawRect(rects[i], paint);
+    }
+}
+
 void SkLuaCanvas::onDrawRRect(const SkRRect& rrect, const SkPaint& paint) {
     AUTO_LUA("drawRRect");
     lua.pushRRect(rrect, "rrect");
@@ -222,6 +228,13 @@ void SkLuaCanvas::onDrawBitmapRect(const SkBitmap& bitmap, const SkRect* src, co
     }
 }
 
+void SkLuaCanvas::onDrawBitmapRects(const SkBitmap& bitmap, const SkRect src[],
+                                    const SkRect dst[], int count, const SkPaint* paint) {
+    for (int i = 0; i < count; ++i) {
+        this->onDrawBitmapRect(bitmap, &src[i], dst[i], paint, kNone_DrawBitmapRectFlag);
+    }
+}
+
 void SkLuaCanvas::onDrawBitmapNine(const SkBitmap& bitmap, const SkIRect& center, const SkRect& dst,
                                    const SkPaint* paint) {
     AUTO_LUA("drawBitmapNine");
@@ -156,6 +156,13 @@ void SkNWayCanvas::onDrawRect(const SkRect& rect, const SkPaint& paint) {
     }
 }
 
+void SkNWayCanvas::onDrawRects(const SkRect rects[], int count, const SkPaint& paint) {
+    Iter iter(fList);
+    while (iter.next()) {
+        iter->drawRects(rects, count, paint);
+    }
+}
+
 void SkNWayCanvas::onDrawOval(const SkRect& rect, const SkPaint& paint) {
     Iter iter(fList);
     while (iter.next()) {
@@ -201,6 +208,14 @@ void SkNWayCanvas::onDrawBitmapRect(const SkBitmap& bitmap, const SkRect* src, c
     }
 }
 
+void SkNWayCanvas::onDrawBitmapRects(const SkBitmap& bitmap, const SkRect src[],
+                                     const SkRect dst[], int count, const SkPaint* paint) {
+    Iter iter(fList);
+    while (iter.next()) {
+        iter->drawBitmapRects(bitmap, src, dst, count, paint);
+    }
+}
+
 void SkNWayCanvas::onDrawBitmapNine(const SkBitmap& bitmap, const SkIRect& center,
                                     const SkRect& dst, const SkPaint* paint) {
     Iter iter(fList);
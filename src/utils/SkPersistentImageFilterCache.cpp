@@ -0,0 +1,574 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkPersistentImageFilterCache.h"
+
+#include "SkAtomics.h"
+#include "SkBitmap.h"
+#include "SkData.h"
+#include "SkFlattenableSerialization.h"
+#include "SkMD5.h"
+#include "SkMutex.h"
+#include "SkOSFile.h"
+#include "SkString.h"
+#include "SkTDArray.h"
+#include "SkTDynamicHash.h"
+#include "SkTHash.h"
+#include "SkTInternalLList.h"
+#include "SkTSort.h"
+#include "SkTime.h"
+
+#include <time.h>
+
+namespace {
+
+static const uint32_t kMagic = SkSetFourByteTag('s', 'k', 'i', 'f');
+// Bump this whenever the file format, or the way keys are computed, changes.
+static const uint32_t kVersion = 1;
+static const char kSuffix[] = "skif";
+
+// Memoized digests of filters and sources are dropped when there are more than this.
+static const int kMaxMemoizedDigests = 1024;
+
+uint32_t system_seconds() {
+    return (uint32_t) time(NULL);
+}
+
+struct DiskKey {
+    uint8_t fData[16];
+
+    bool operator==(const DiskKey& other) const {
+        return 0 == memcmp(fData, other.fData, sizeof(fData));
+    }
+
+    static DiskKey Make(SkMD5* md5) {
+        SkMD5::Digest digest;
+        md5->finish(digest);
+        DiskKey key;
+        SK_COMPILE_ASSERT(sizeof(key.fData) == sizeof(digest.data), disk_key_is_an_md5);
+        memcpy(key.fData, digest.data, sizeof(key.fData));
+        return key;
+    }
+
+    SkString fileName() const {
+        SkString name;
+        for (size_t i = 0; i < sizeof(fData); i++) {
+            name.appendf("%02x", fData[i]);
+        }
+        name.appendf(".%s", kSuffix);
+        return name;
+    }
+
+    // The inverse of fileName().
+    bool parseFileName(const char* name) {
+        static const char kHex[] = "0123456789abcdef";
+        if (strlen(name) != 2 * sizeof(fData) + 1 + strlen(kSuffix)) {
+            return false;
+        }
+        for (size_t i = 0; i < 2 * sizeof(fData); i++) {
+            const char* digit = strchr(kHex, name[i]);
+            if (NULL == digit || '\0' == *digit) {
+                return false;
+            }
+            const uint8_t nibble = SkToU8(digit - kHex);
+            fData[i / 2] = (i & 1) ? (fData[i / 2] | nibble) : (nibble << 4);
+        }
+        return true;
+    }
+};
+
+struct FileHeader {
+    uint32_t    fMagic;
+    uint32_t    fVersion;
+    uint32_t    fCreated;   // Seconds since the epoch.
+    int32_t     fOffsetX;
+    int32_t     fOffsetY;
+    int32_t     fWidth;
+    int32_t     fHeight;
+    int32_t     fColorType;
+    int32_t     fAlphaType;
+};
+
+static bool valid_header(const FileHeader& header, size_t fileSize) {
+    if (kMagic != header.fMagic || kVersion != header.fVersion ||
+            header.fWidth <= 0 || header.fHeight <= 0 ||
+            header.fColorType <= kUnknown_SkColorType ||
+            header.fColorType > kLastEnum_SkColorType ||
+            kIndex_8_SkColorType == header.fColorType ||
+            header.fAlphaType <= kUnknown_SkAlphaType ||
+            header.fAlphaType > kLastEnum_SkAlphaType) {
+        return false;
+    }
+    const uint64_t pixelBytes = (uint64_t) header.fWidth * header.fHeight *
+                                SkColorTypeBytesPerPixel((SkColorType) header.fColorType);
+    return sizeof(FileHeader) + pixelBytes == fileSize;
+}
+
+// We can only write out results whose pixels we can read, without a color table.
+static bool can_write(const SkBitmap& result) {
+    return !result.drawsNothing() && NULL == result.getTexture() &&
+           kIndex_8_SkColorType != result.colorType() &&
+           kUnknown_SkAlphaType != result.alphaType() && result.pixelRef();
+}
+
+struct DiskEntry {
+    DiskKey     fKey;
+    size_t      fSize;      // Of the file.
+    uint32_t    fCreated;
+
+    static const DiskKey& GetKey(const DiskEntry& entry) { return entry.fKey; }
+    static uint32_t Hash(const DiskKey& key) {
+        // The key is already an MD5.
+        uint32_t hash;
+        memcpy(&hash, key.fData, sizeof(hash));
+        return hash;
+    }
+
+    SK_DECLARE_INTERNAL_LLIST_INTERFACE(DiskEntry);
+};
+
+struct OlderThan {
+    bool operator()(const DiskEntry* a, const DiskEntry* b) const {
+        return a->fCreated < b->fCreated;
+    }
+};
+
+}  // namespace
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+class SkPersistentImageFilterCache::DiskLevel {
+public:
+    DiskLevel(const char dir[], const Options& options)
+        : fDir(dir)
+        , fOptions(options)
+        , fBytes(0)
+        , fTempCount(0)
+        , fHits(0)
+        , fMisses(0)
+        , fWrites(0)
+        , fEvictions(0) {}
+
+    ~DiskLevel() {
+        while (DiskEntry* entry = fLRU.head()) {
+            fLRU.remove(entry);
+            SkDELETE(entry);
+        }
+    }
+
+    // Index what earlier processes left in the directory.
+    void indexDirectory() {
+        SkAutoMutexAcquire lock(fMutex);
+
+        SkTDArray<DiskEntry*> entries;
+        SkOSFile::Iter iter(fDir.c_str(), kSuffix);
+        SkString name;
+        while (iter.next(&name)) {
+            DiskKey key;
+            FileHeader header;
+            size_t size;
+            if (!key.parseFileName(name.c_str())) {
+                continue;
+            }
+            if (!this->readFile(key, &header, &size, NULL) || fIndex.find(key)) {
+                // Not one of ours, or corrupt.
+                sk_remove(this->pathFor(key).c_str());
+                continue;
+            }
+            DiskEntry* entry = SkNEW(DiskEntry);
+            entry->fKey = key;
+            entry->fSize = size;
+            entry->fCreated = header.fCreated;
+            fIndex.add(entry);
+            *entries.append() = entry;
+        }
+
+        // Treat the oldest as least recently used.
+        if (entries.count() > 1) {
+            SkTQSort(entries.begin(), entries.end() - 1, OlderThan());
+        }
+        for (int i = 0; i < entries.count(); i++) {
+            fLRU.addToHead(entries[i]);
+            fBytes += entries[i]->fSize;
+        }
+
+        this->purgeExpiredLocked();
+        this->purgeToBudgetLocked();
+    }
+
+    bool computeKey(const SkImageFilter* filter, const SkBitmap* src,
+                    const SkImageFilter::Context& context, DiskKey* key) {
+        DiskKey filterKey, srcKey;
+        if (!this->filterKey(filter, &filterKey) || (src && !this->srcKey(*src, &srcKey))) {
+            return false;
+        }
+
+        SkMD5 md5;
+        md5.update((const uint8_t*) &kVersion, sizeof(kVersion));
+        md5.update((const uint8_t*) filterKey.fData, sizeof(filterKey.fData));
+        const uint8_t hasSrc = src ? 1 : 0;
+        md5.update((const uint8_t*) &hasSrc, sizeof(hasSrc));
+        if (src) {
+            md5.update((const uint8_t*) srcKey.fData, sizeof(srcKey.fData));
+        }
+        SkScalar matrix[9];
+        context.ctm().get9(matrix);
+        md5.update((const uint8_t*) matrix, sizeof(matrix));
+        const SkIRect& clip = context.clipBounds();
+        md5.update((const uint8_t*) &clip, sizeof(clip));
+        *key = DiskKey::Make(&md5);
+        return true;
+    }
+
+    bool read(const DiskKey& key, SkBitmap* result, SkIPoint* offset) {
+        {
+            SkAutoMutexAcquire lock(fMutex);
+            DiskEntry* entry = fIndex.find(key);
+            if (entry && this->isExpired(*entry, this->now())) {
+                this->evictLocked(entry);
+                fMisses++;
+                return false;
+            }
+            // If we have no entry, another process may still have written one.
+        }
+
+        FileHeader header;
+        size_t size;
+        SkBitmap bitmap;
+        const bool success = this->readFile(key, &header, &size, &bitmap);
+
+        SkAutoMutexAcquire lock(fMutex);
+        DiskEntry* entry = fIndex.find(key);
+        if (!success) {
+            if (entry) {
+                // Deleted or corrupted behind our back.
+                this->evictLocked(entry);
+            }
+            fMisses++;
+            return false;
+        }
+        if (NULL == entry) {
+            if (this->isExpired(header.fCreated, this->now())) {
+                sk_remove(this->pathFor(key).c_str());
+                fMisses++;
+                return false;
+            }
+            entry = this->addLocked(key, size, header.fCreated);
+        } else if (entry != fLRU.head()) {
+            fLRU.remove(entry);
+            fLRU.addToHead(entry);
+        }
+        fHits++;
+
+        *result = bitmap;
+        offset->set(header.fOffsetX, header.fOffsetY);
+        return true;
+    }
+
+    void write(const DiskKey& key, const SkBitmap& result, const SkIPoint& offset) {
+        if (!can_write(result)) {
+            return;
+        }
+        const size_t size = sizeof(FileHeader) + result.getSize();
+        if (size > fOptions.fMaxDiskBytes) {
+            return;
+        }
+        int32_t tempCount;
+        {
+            SkAutoMutexAcquire lock(fMutex);
+            if (fIndex.find(key)) {
+                return;
+            }
+            tempCount = fTempCount++;
+        }
+
+        FileHeader header;
+        header.fMagic = kMagic;
+        header.fVersion = kVersion;
+        header.fCreated = this->now();
+        header.fOffsetX = offset.x();
+        header.fOffsetY = offset.y();
+        header.fWidth = result.width();
+        header.fHeight = result.height();
+        header.fColorType = result.colorType();
+        header.fAlphaType = result.alphaType();
+
+        // Write to a file no other writer will use, then move it into place.
+        const SkString path = this->pathFor(key);
+        SkString tempPath(path);
+        tempPath.appendf(".%p.%u.%d.tmp", this, SkTime::GetMSecs(), tempCount);
+        SkFILE* file = sk_fopen(tempPath.c_str(), kWrite_SkFILE_Flag);
+        if (NULL == file) {
+            return;
+        }
+        bool success = sizeof(header) == sk_fwrite(&header, sizeof(header), file);
+        {
+            SkAutoLockPixels alp(result);
+            const size_t rowBytes = result.width() * result.bytesPerPixel();
+            for (int y = 0; success && y < result.height(); y++) {
+                success = result.getAddr(0, y) &&
+                          rowBytes == sk_fwrite(result.getAddr(0, y), rowBytes, file);
+            }
+        }
+        sk_fclose(file);
+        if (!success || !sk_rename(tempPath.c_str(), path.c_str())) {
+            // Perhaps another process got there first, on a platform where that matters.
+            sk_remove(tempPath.c_str());
+            return;
+        }
+
+        SkAutoMutexAcquire lock(fMutex);
+        if (NULL == fIndex.find(key)) {
+            this->addLocked(key, size, header.fCreated);
+            fWrites++;
+            this->purgeToBudgetLocked();
+        }
+    }
+
+    void purgeExpired() {
+        SkAutoMutexAcquire lock(fMutex);
+        this->purgeExpiredLocked();
+    }
+
+    void getStats(Stats* stats) const {
+        SkAutoMutexAcquire lock(fMutex);
+        stats->fDiskHits = fHits;
+        stats->fMisses = fMisses;
+        stats->fDiskWrites = fWrites;
+        stats->fDiskEvictions = fEvictions;
+        stats->fDiskEntries = fIndex.count();
+        stats->fDiskBytes = fBytes;
+    }
+
+private:
+    SkString pathFor(const DiskKey& key) const {
+        return SkOSPath::Join(fDir.c_str(), key.fileName().c_str());
+    }
+
+    // Reads and checks the header, then the pixels if bitmap is not NULL.
+    bool readFile(const DiskKey& key, FileHeader* header, size_t* size, SkBitmap* bitmap) const {
+        SkFILE* file = sk_fopen(this->pathFor(key).c_str(), kRead_SkFILE_Flag);
+        if (NULL == file) {
+            return false;
+        }
+        *size = sk_fgetsize(file);
+        bool success = sizeof(FileHeader) == sk_fread(header, sizeof(FileHeader), file) &&
+                       valid_header(*header, *size);
+        if (success && bitmap) {
+            const SkImageInfo info = SkImageInfo::Make(header->fWidth, header->fHeight,
+                                                       (SkColorType) header->fColorType,
+                                                       (SkAlphaType) header->fAlphaType);
+            // Our rows are packed, just like a freshly allocated bitmap's.
+            success = bitmap->tryAllocPixels(info, info.minRowBytes()) &&
+                      bitmap->getSize() == sk_fread(bitmap->getPixels(), bitmap->getSize(), file);
+            if (success) {
+                bitmap->setImmutable();
+            }
+        }
+        sk_fclose(file);
+        return success;
+    }
+
+    bool filterKey(const SkImageFilter* filter, DiskKey* key) {
+        {
+            SkAutoMutexAcquire lock(fMutex);
+            if (const DiskKey* found = fFilterKeys.find(filter->uniqueID())) {
+                *key = *found;
+                return true;
+            }
+        }
+
+        // Filters are immutable, so their serialization describes their results completely.
+        SkAutoTUnref<SkData> data(
+                SkValidatingSerializeFlattenable(const_cast<SkImageFilter*>(filter)));
+        if (!data) {
+            return false;
+        }
+        SkMD5 md5;
+        md5.update((const uint8_t*) data->data(), data->size());
+        *key = DiskKey::Make(&md5);
+
+        SkAutoMutexAcquire lock(fMutex);
+        if (fFilterKeys.count() >= kMaxMemoizedDigests) {
+            fFilterKeys.reset();
+        }
+        fFilterKeys.set(filter->uniqueID(), *key);
+        return true;
+    }
+
+    bool srcKey(const SkBitmap& src, DiskKey* key) {
+        const uint32_t genID = src.getGenerationID();
+        if (0 == genID || kIndex_8_SkColorType == src.colorType()) {
+            return false;
+        }
+        {
+            SkAutoMutexAcquire lock(fMutex);
+            if (const DiskKey* found = fSrcKeys.find(genID)) {
+                *key = *found;
+                return true;
+            }
+        }
+
+        SkAutoLockPixels alp(src);
+        if (NULL == src.getPixels()) {
+            // e.g. a texture.
+            return false;
+        }
+        SkMD5 md5;
+        const int32_t description[] = { src.width(), src.height(), src.colorType(),
+                                        src.alphaType() };
+        md5.update((const uint8_t*) description, sizeof(description));
+        const size_t rowBytes = src.width() * src.bytesPerPixel();
+        for (int y = 0; y < src.height(); y++) {
+            md5.update((const uint8_t*) src.getAddr(0, y), rowBytes);
+        }
+        *key = DiskKey::Make(&md5);
+
+        SkAutoMutexAcquire lock(fMutex);
+        if (fSrcKeys.count() >= kMaxMemoizedDigests) {
+            fSrcKeys.reset();
+        }
+        fSrcKeys.set(genID, *key);
+        return true;
+    }
+
+    uint32_t now() const {
+        return fOptions.fClock ? fOptions.fClock(fOptions.fClockContext) : system_seconds();
+    }
+
+    bool isExpired(uint32_t created, uint32_t now) const {
+        return fOptions.fMaxAgeSeconds > 0 && now - created > fOptions.fMaxAgeSeconds;
+    }
+    bool isExpired(const DiskEntry& entry, uint32_t now) const {
+        return this->isExpired(entry.fCreated, now);
+    }
+
+    DiskEntry* addLocked(const DiskKey& key, size_t size, uint32_t created) {
+        DiskEntry* entry = SkNEW(DiskEntry);
+        entry->fKey = key;
+        entry->fSize = size;
+        entry->fCreated = created;
+        fIndex.add(entry);
+        fLRU.addToHead(entry);
+        fBytes += size;
+        return entry;
+    }
+
+    void evictLocked(DiskEntry* entry) {
+        sk_remove(this->pathFor(entry->fKey).c_str());
+        fBytes -= entry->fSize;
+        fLRU.remove(entry);
+        fIndex.remove(entry->fKey);
+        SkDELETE(entry);
+        fEvictions++;
+    }
+
+    void purgeExpiredLocked() {
+        const uint32_t now = this->now();
+        DiskEntry* entry = fLRU.head();
+        while (entry) {
+            DiskEntry* next = entry->fNext;
+            if (this->isExpired(*entry, now)) {
+                this->evictLocked(entry);
+            }
+            entry = next;
+        }
+    }
+
+    void purgeToBudgetLocked() {
+        while (fBytes > fOptions.fMaxDiskBytes) {
+            DiskEntry* tail = fLRU.tail();
+            SkASSERT(tail);
+            this->evictLocked(tail);
+        }
+    }
+
+    const SkString                              fDir;
+    const Options                               fOptions;
+
+    mutable SkMutex                             fMutex;
+    // Everything below is guarded by fMutex.
+    SkTDynamicHash<DiskEntry, DiskKey>          fIndex;
+    SkTInternalLList<DiskEntry>                 fLRU;
+    size_t                                      fBytes;
+    int32_t                                     fTempCount;
+    SkTHashMap<uint32_t, DiskKey>               fFilterKeys;    // By filter unique ID.
+    SkTHashMap<uint32_t, DiskKey>               fSrcKeys;       // By source generation ID.
+    int32_t                                     fHits;
+    int32_t                                     fMisses;
+    int32_t                                     fWrites;
+    int32_t                                     fEvictions;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+SkPersistentImageFilterCache* SkPersistentImageFilterCache::Create(const char dir[],
+                                                                   SkImageFilter::Cache* memory,
+                                                                   const Options& options) {
+    if (NULL == memory || !sk_mkdir(dir)) {
+        return NULL;
+    }
+    DiskLevel* disk = SkNEW_ARGS(DiskLevel, (dir, options));
+    disk->indexDirectory();
+    return SkNEW_ARGS(SkPersistentImageFilterCache, (memory, disk));
+}
+
+SkPersistentImageFilterCache::SkPersistentImageFilterCache(SkImageFilter::Cache* memory,
+                                                           DiskLevel* disk)
+    : fMemory(SkRef(memory))
+    , fDisk(disk)
+    , fMemoryHits(0) {}
+
+SkPersistentImageFilterCache::~SkPersistentImageFilterCache() {}
+
+void SkPersistentImageFilterCache::getStats(Stats* stats) const {
+    fDisk->getStats(stats);
+    stats->fMemoryHits = sk_atomic_load(&fMemoryHits);
+}
+
+void SkPersistentImageFilterCache::purgeExpired() {
+    fDisk->purgeExpired();
+}
+
+bool SkPersistentImageFilterCache::get(const Key& key, SkBitmap* result,
+                                       SkIPoint* offset) const {
+    return fMemory->get(key, result, offset);
+}
+
+void SkPersistentImageFilterCache::set(const Key& key, const SkBitmap& result,
+                                       const SkIPoint& offset) {
+    fMemory->set(key, result, offset);
+}
+
+bool SkPersistentImageFilterCache::find(const Key& key, const SkImageFilter* filter,
+                                        const SkBitmap* src,
+                                        const SkImageFilter::Context& context,
+                                        SkBitmap* result, SkIPoint* offset) const {
+    if (fMemory->find(key, filter, src, context, result, offset)) {
+        sk_atomic_inc(&fMemoryHits);
+        return true;
+    }
+    DiskKey diskKey;
+    if (!fDisk->computeKey(filter, src, context, &diskKey) ||
+            !fDisk->read(diskKey, result, offset)) {
+        return false;
+    }
+    // Promote it, so we need not read it again.
+    fMemory->add(key, filter, src, context, *result, *offset);
+    return true;
+}
+
+void SkPersistentImageFilterCache::add(const Key& key, const SkImageFilter* filter,
+                                       const SkBitmap* src,
+                                       const SkImageFilter::Context& context,
+                                       const SkBitmap& result, const SkIPoint& offset) {
+    fMemory->add(key, filter, src, context, result, offset);
+    DiskKey diskKey;
+    if (fDisk->computeKey(filter, src, context, &diskKey)) {
+        fDisk->write(diskKey, result, offset);
+    }
+}
@@ -11,6 +11,8 @@
 #include "SkPictureUtils.h"
 #include "SkRecord.h"
 #include "SkShader.h"
+#include "SkTHash.h"
+#include "SkTLogic.h"
 
 struct MeasureRecords {
     template <typename T> size_t operator()(const T& op) { return 0; }
@@ -33,3 +35,58 @@ size_t SkPictureUtils::ApproximateBytesUsed(const SkPicture* pict) {
 
     return byteCount;
 }
+
+// Counts the uses of each shared paint and matrix.  Every use past the first is a copy saved.
+class MeasureSharing {
+    SK_CREATE_MEMBER_DETECTOR(paint);
+    SK_CREATE_MEMBER_DETECTOR(matrix);
+public:
+    MeasureSharing() : fBytes(0) {}
+
+    template <typename T>
+    void operator()(const T& op) {
+        this->checkPaint(op);
+        this->checkMatrix(op);
+    }
+
+    void operator()(const SkRecords::DrawPicture& op) {
+        fBytes += SkPictureUtils::ApproximateBytesShared(op.picture);
+        this->checkMatrix(op);
+    }
+
+    size_t bytes() const { return fBytes; }
+
+private:
+    template <typename T>
+    SK_WHEN(HasMember_paint<T>, void) checkPaint(const T& op) { this->count(op.paint); }
+    template <typename T>
+    SK_WHEN(!HasMember_paint<T>, void) checkPaint(const T&) {}
+
+    template <typename T>
+    SK_WHEN(HasMember_matrix<T>, void) checkMatrix(const T& op) { this->count(op.matrix); }
+    template <typename T>
+    SK_WHEN(!HasMember_matrix<T>, void) checkMatrix(const T&) {}
+
+    template <typename T>
+    void count(const SkRecords::Shared<T>& shared) {
+        if (fSeen.contains(shared.get())) {
+            fBytes += sizeof(T);
+        } else {
+            fSeen.add(shared.get());
+        }
+    }
+    // Unshared paints save nothing.
+    template <typename T>
+    void count(const T&) {}
+
+    SkTHashSet<const void*> fSeen;
+    size_t fBytes;
+};
+
+size_t SkPictureUtils::ApproximateBytesShared(const SkPicture* pict) {
+    MeasureSharing visitor;
+    for (unsigned curOp = 0; curOp < pict->fRecord->count(); curOp++) {
+        pict->fRecord->visit<void>(curOp, visitor);
+    }
+    return visitor.bytes();
+}
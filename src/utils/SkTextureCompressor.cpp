@@ -14,6 +14,8 @@
 #include "SkBitmapProcShader.h"
 #include "SkData.h"
 #include "SkEndian.h"
+#include "SkTaskGroup.h"
+#include "SkTemplates.h"
 
 #include "SkTextureCompression_opts.h"
 
@@ -33,6 +35,74 @@ static bool compress_etc1_565(uint8_t* dst, const uint8_t* src,
 
 ////////////////////////////////////////////////////////////////////////////////
 
+namespace {
+// A horizontal band of an image, a whole number of blocks tall, compressed by one task.
+struct CompressionBand {
+    SkTextureCompressor::CompressionProc fProc;
+    uint8_t*       fDst;
+    const uint8_t* fSrc;
+    int            fWidth;
+    int            fHeight;
+    size_t         fRowBytes;
+    bool           fSuccess;
+};
+}  // namespace
+
+static void compress_band(CompressionBand* band) {
+    band->fSuccess = band->fProc(band->fDst, band->fSrc,
+                                 band->fWidth, band->fHeight, band->fRowBytes);
+}
+
+// Bands smaller than this aren't worth a task of their own.
+static const int kMinPixelsPerBand = 64 * 1024;
+
+// Every format lays its blocks out in rows, so a band of block rows compresses into a contiguous
+// run of dst. This splits the image into such bands and compresses them on SkTaskGroup threads.
+static bool compress_in_bands(SkTextureCompressor::CompressionProc proc,
+                              uint8_t* dst, const uint8_t* src, int width, int height,
+                              size_t rowBytes, SkTextureCompressor::Format format) {
+    // Bands must be whole blocks tall for proc, and for the format itself, which the
+    // compressed data size checks.
+    int dimX, dimY;
+    SkTextureCompressor::GetBlockDimensions(format, &dimX, &dimY);
+    if (width <= 0 || height <= 0 ||
+        SkTextureCompressor::GetCompressedDataSize(format, width, height) < 0) {
+        return proc(dst, src, width, height, rowBytes);
+    }
+
+    const int bandHeight = SkTMax(1, kMinPixelsPerBand / (width * dimY)) * dimY;
+    const int bandSize = SkTextureCompressor::GetCompressedDataSize(format, width, bandHeight);
+    if (height <= bandHeight || bandSize < 0) {
+        return proc(dst, src, width, height, rowBytes);
+    }
+
+    const int bandCount = (height + bandHeight - 1) / bandHeight;
+    SkAutoSTMalloc<16, CompressionBand> bands(bandCount);
+    for (int i = 0; i < bandCount; ++i) {
+        CompressionBand& band = bands[i];
+        band.fProc = proc;
+        band.fDst = dst + i * bandSize;
+        band.fSrc = src + i * bandHeight * rowBytes;
+        band.fWidth = width;
+        band.fHeight = SkTMin(bandHeight, height - i * bandHeight);
+        band.fRowBytes = rowBytes;
+        band.fSuccess = false;
+    }
+
+    SkTaskGroup tg;
+    tg.batch(compress_band, bands.get(), bandCount);
+    tg.wait();
+
+    for (int i = 0; i < bandCount; ++i) {
+        if (!bands[i].fSuccess) {
+            return false;
+        }
+    }
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 namespace SkTextureCompressor {
 
 void GetBlockDimensions(Format format, int* dimX, int* dimY, bool matchSpec) {
@@ -167,7 +237,7 @@ bool CompressBufferToFormat(uint8_t* dst, const uint8_t* src, SkColorType srcCol
     }
 
     if (proc) {
-        return proc(dst, src, width, height, rowBytes);
+        return compress_in_bands(proc, dst, src, width, height, rowBytes, format);
     }
 
     return false;
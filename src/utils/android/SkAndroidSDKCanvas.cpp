@@ -124,6 +124,10 @@ void SkAndroidSDKCanvas::onDrawRect(const SkRect& r, const SkPaint& paint) {
     FILTER(paint);
     fProxyTarget->drawRect(r, filteredPaint);
 }
+void SkAndroidSDKCanvas::onDrawRects(const SkRect rects[], int count, const SkPaint& paint) {
+    FILTER(paint);
+    fProxyTarget->drawRects(rects, count, filteredPaint);
+}
 void SkAndroidSDKCanvas::onDrawRRect(const SkRRect& r, const SkPaint& paint) {
     FILTER(paint);
     fProxyTarget->drawRRect(r, filteredPaint);
@@ -147,6 +151,14 @@ void SkAndroidSDKCanvas::onDrawBitmapRect(const SkBitmap& bitmap,
     FILTER_PTR(paint);
     fProxyTarget->drawBitmapRectToRect(bitmap, src, dst, filteredPaint, flags);
 }
+void SkAndroidSDKCanvas::onDrawBitmapRects(const SkBitmap& bitmap,
+                                           const SkRect src[],
+                                           const SkRect dst[],
+                                           int count,
+                                           const SkPaint* paint) {
+    FILTER_PTR(paint);
+    fProxyTarget->drawBitmapRects(bitmap, src, dst, count, filteredPaint);
+}
 void SkAndroidSDKCanvas::onDrawBitmapNine(const SkBitmap& bitmap,
                                                    const SkIRect& center,
                                                    const SkRect& dst,
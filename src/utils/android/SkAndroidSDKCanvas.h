@@ -38,12 +38,15 @@ protected:
                       const SkPaint& paint) override;
     void onDrawOval(const SkRect& r, const SkPaint& paint) override;
     void onDrawRect(const SkRect& r, const SkPaint& paint) override;
+    void onDrawRects(const SkRect[], int count, const SkPaint&) override;
     void onDrawRRect(const SkRRect& r, const SkPaint& paint) override;
     void onDrawPath(const SkPath& path, const SkPaint& paint) override;
     void onDrawBitmap(const SkBitmap& bitmap, SkScalar left, SkScalar top,
                       const SkPaint* paint) override;
     void onDrawBitmapRect(const SkBitmap& bitmap, const SkRect* src, const SkRect& dst,
                           const SkPaint* paint, DrawBitmapRectFlags flags) override;
+    void onDrawBitmapRects(const SkBitmap&, const SkRect src[], const SkRect dst[],
+                           int count, const SkPaint*) override;
     void onDrawBitmapNine(const SkBitmap& bitmap, const SkIRect& center,
                           const SkRect& dst, const SkPaint* paint) override;
     void onDrawSprite(const SkBitmap& bitmap, int left, int top,
@@ -419,6 +419,13 @@ void SkDebugCanvas::onDrawBitmapRect(const SkBitmap& bitmap, const SkRect* src,
     this->addDrawCommand(new SkDrawBitmapRectCommand(bitmap, src, dst, paint, flags));
 }
 
+void SkDebugCanvas::onDrawBitmapRects(const SkBitmap& bitmap, const SkRect src[],
+                                      const SkRect dst[], int count, const SkPaint* paint) {
+    for (int i = 0; i < count; ++i) {
+        this->onDrawBitmapRect(bitmap, &src[i], dst[i], paint, kNone_DrawBitmapRectFlag);
+    }
+}
+
 void SkDebugCanvas::onDrawBitmapNine(const SkBitmap& bitmap, const SkIRect& center,
                                      const SkRect& dst, const SkPaint* paint) {
     this->addDrawCommand(new SkDrawBitmapNineCommand(bitmap, center, dst, paint));
@@ -485,6 +492,12 @@ void SkDebugCanvas::onDrawRect(const SkRect& rect, const SkPaint& paint) {
     addDrawCommand(new SkDrawRectCommand(rect, paint));
 }
 
+void SkDebugCanvas::onDrawRects(const SkRect rects[], int count, const SkPaint& paint) {
+    for (int i = 0; i < count; ++i) {
+        this->onDrawRect(rects[i], paint);
+    }
+}
+
 void SkDebugCanvas::onDrawRRect(const SkRRect& rrect, const SkPaint& paint) {
     this->addDrawCommand(new SkDrawRRectCommand(rrect, paint));
 }
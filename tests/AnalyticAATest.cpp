@@ -0,0 +1,183 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkBlitter.h"
+#include "SkCanvas.h"
+#include "SkPath.h"
+#include "SkRasterClip.h"
+#include "SkRegion.h"
+#include "SkScan.h"
+#include "SkTArray.h"
+#include "Test.h"
+
+static const int kSize = 64;
+
+// Fills path into a fresh A8 bitmap with analytic AA or supersampling, optionally clipped.
+static void draw(SkBitmap* bm, const SkPath& path, bool analytic, const SkRegion* clip = NULL) {
+    bm->allocPixels(SkImageInfo::MakeA8(kSize, kSize));
+    bm->eraseColor(SK_ColorTRANSPARENT);
+
+    SkRasterClip rc(SkIRect::MakeWH(kSize, kSize));
+    if (clip) {
+        rc.op(*clip, SkRegion::kIntersect_Op);
+    }
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    SkTBlitterAllocator allocator;
+    SkBlitter* blitter = SkBlitter::Choose(*bm, SkMatrix::I(), paint, &allocator);
+    SkScan::AntiFillPath(path, rc, blitter, analytic);
+}
+
+// Returns the coverage of pixel (x, y) of bm, found by point sampling a 16x16 grid in it.
+static int reference_coverage(const SkBitmap& bm, int x, int y) {
+    int hits = 0;
+    for (int j = 0; j < 16; ++j) {
+        for (int i = 0; i < 16; ++i) {
+            hits += *bm.getAddr8(16 * x + i, 16 * y + j) ? 1 : 0;
+        }
+    }
+    return (hits * 255 + 128) >> 8;
+}
+
+// Checks analytic AA against coverage sampled from a 16x scaled, aliased drawing of path.
+static void check_reference(skiatest::Reporter* reporter, const SkPath& path) {
+    SkBitmap analytic, reference;
+    draw(&analytic, path, true);
+
+    reference.allocPixels(SkImageInfo::MakeA8(16 * kSize, 16 * kSize));
+    reference.eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas canvas(reference);
+    canvas.scale(16, 16);
+    canvas.drawPath(path, SkPaint());
+
+    int maxDiff = 0;
+    for (int y = 0; y < kSize; ++y) {
+        for (int x = 0; x < kSize; ++x) {
+            int diff = *analytic.getAddr8(x, y) - reference_coverage(reference, x, y);
+            maxDiff = SkTMax(maxDiff, SkAbs32(diff));
+        }
+    }
+    // Leaves room for curve flattening and the reference's own sampling error.
+    REPORTER_ASSERT(reporter, maxDiff <= 24);
+}
+
+// Checks that analytic AA is within tolerance of supersampling everywhere, and that they
+// agree on the total area covered.
+static void check_parity(skiatest::Reporter* reporter, const SkPath& path,
+                         const SkRegion* clip = NULL) {
+    SkBitmap analytic, supersampled;
+    draw(&analytic, path, true, clip);
+    draw(&supersampled, path, false, clip);
+
+    int maxDiff = 0;
+    int analyticSum = 0, supersampledSum = 0;
+    for (int y = 0; y < kSize; ++y) {
+        for (int x = 0; x < kSize; ++x) {
+            int a = *analytic.getAddr8(x, y);
+            int s = *supersampled.getAddr8(x, y);
+            maxDiff = SkTMax(maxDiff, SkAbs32(a - s));
+            analyticSum += a;
+            supersampledSum += s;
+        }
+    }
+    // 4x4 supersampling can be off by up to a quarter pixel along shallow edges.
+    REPORTER_ASSERT(reporter, maxDiff <= 64);
+    // Over the whole path, those errors mostly cancel out.
+    REPORTER_ASSERT(reporter, SkAbs32(analyticSum - supersampledSum) <= supersampledSum / 50 + 255);
+}
+
+static void make_paths(SkTArray<SkPath>* paths) {
+    paths->push_back().addCircle(30.3f, 31.7f, 20.1f);
+    paths->push_back().addOval(SkRect::MakeLTRB(-10.5f, 5.25f, 40.75f, 70.1f));
+
+    SkPath& curves = paths->push_back();
+    curves.moveTo(5, 60);
+    curves.cubicTo(5, -30, 60, 90, 60, 3);
+    curves.quadTo(30, 30, 5, 60);
+
+    SkPath& donut = paths->push_back();
+    donut.addCircle(32, 32, 25.5f);
+    donut.addCircle(32.5f, 30, 12.25f);
+    donut.setFillType(SkPath::kEvenOdd_FillType);
+
+    SkPath& inverse = paths->push_back();
+    inverse.addRoundRect(SkRect::MakeLTRB(8.5f, 9.25f, 50, 40.75f), 6.5f, 6.5f);
+    inverse.setFillType(SkPath::kInverseWinding_FillType);
+}
+
+DEF_TEST(AnalyticAA_ExactCoverage, reporter) {
+    // A right triangle: the hypotenuse cuts the pixels along it exactly in half.
+    SkPath path;
+    path.moveTo(0, 0);
+    path.lineTo(4, 0);
+    path.lineTo(0, 4);
+    path.close();
+
+    SkBitmap bm;
+    draw(&bm, path, true);
+    REPORTER_ASSERT(reporter, *bm.getAddr8(0, 0) == 0xFF);
+    REPORTER_ASSERT(reporter, *bm.getAddr8(2, 0) == 0xFF);
+    REPORTER_ASSERT(reporter, *bm.getAddr8(3, 0) == 0x80);
+    REPORTER_ASSERT(reporter, *bm.getAddr8(2, 1) == 0x80);
+    REPORTER_ASSERT(reporter, *bm.getAddr8(0, 3) == 0x80);
+    REPORTER_ASSERT(reporter, *bm.getAddr8(3, 1) == 0x00);
+    REPORTER_ASSERT(reporter, *bm.getAddr8(4, 0) == 0x00);
+
+    // A quarter pixel square.
+    path.reset();
+    path.moveTo(10, 10);
+    path.lineTo(10.5f, 10);
+    path.lineTo(10.5f, 10.5f);
+    path.lineTo(10, 10.5f);
+    path.close();
+    draw(&bm, path, true);
+    REPORTER_ASSERT(reporter, *bm.getAddr8(10, 10) == 0x40);
+    REPORTER_ASSERT(reporter, *bm.getAddr8(11, 10) == 0x00);
+    REPORTER_ASSERT(reporter, *bm.getAddr8(10, 11) == 0x00);
+}
+
+DEF_TEST(AnalyticAA_Reference, reporter) {
+    SkTArray<SkPath> paths;
+    make_paths(&paths);
+    for (int i = 0; i < paths.count(); ++i) {
+        check_reference(reporter, paths[i]);
+    }
+}
+
+DEF_TEST(AnalyticAA_Parity, reporter) {
+    SkTArray<SkPath> paths;
+    make_paths(&paths);
+
+    // Self intersecting.  Where edges cross within a pixel, coverage is only approximate.
+    SkPath& star = paths.push_back();
+    star.moveTo(32, 2);
+    star.lineTo(50.5f, 60);
+    star.lineTo(2, 22.3f);
+    star.lineTo(62, 22.3f);
+    star.lineTo(13.5f, 60);
+    star.close();
+
+    for (int i = 0; i < paths.count(); ++i) {
+        check_parity(reporter, paths[i]);
+    }
+}
+
+DEF_TEST(AnalyticAA_Clipped, reporter) {
+    SkPath path;
+    path.addCircle(32, 32, 28.6f);
+
+    SkRegion rect(SkIRect::MakeLTRB(10, 10, 50, 40));
+    check_parity(reporter, path, &rect);
+
+    SkRegion complex(SkIRect::MakeLTRB(0, 0, 20, 64));
+    complex.op(SkIRect::MakeLTRB(30, 20, 64, 30), SkRegion::kUnion_Op);
+    check_parity(reporter, path, &complex);
+
+    path.toggleInverseFillType();
+    check_parity(reporter, path, &complex);
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkBitmapProcState.h"
+#include "SkRandom.h"
+#include "SkShader.h"
+#include "Test.h"
+
+static const int kSize = 48;
+
+// Fills dst with src, bilerped by the state's matrix and sample procs as SkBitmapProcShader would
+// without gSkUse4fBilerp, or by the SkPMFloat shader procs it would use with it.  We call the procs
+// ourselves rather than set gSkUse4fBilerp, which other threads may be drawing with.
+static void draw(skiatest::Reporter* reporter, SkBitmap* dst, const SkBitmap& src,
+                 SkShader::TileMode tile, const SkMatrix& matrix, U8CPU alpha, bool use4f) {
+    dst->allocN32Pixels(kSize, kSize);
+    dst->eraseColor(SK_ColorTRANSPARENT);
+
+    SkMatrix inv;
+    SkAssertResult(matrix.invert(&inv));
+    SkPaint paint;
+    paint.setFilterQuality(kLow_SkFilterQuality);
+    paint.setAlpha(alpha);
+    SkBitmapProcState state;
+    if (!state.setupForTesting(src, tile, tile, inv, paint)) {
+        ERRORF(reporter, "Can't set up to draw src.");
+        return;
+    }
+    REPORTER_ASSERT(reporter, kLow_SkFilterQuality == state.fFilterLevel);
+
+    static const unsigned kScaleTranslate = SkMatrix::kTranslate_Mask | SkMatrix::kScale_Mask;
+    const SkBitmapProcState::ShaderProc32 proc4f =
+            0 == (state.fInvType & ~kScaleTranslate) ? S32_D32_filter_DX_4f_shaderproc
+                                                     : S32_D32_filter_DXDY_4f_shaderproc;
+    uint32_t xy[kSize * 2 + 1];
+    const int max = state.maxCountForBufferSize(sizeof(xy));
+    for (int y = 0; y < kSize; ++y) {
+        SkPMColor* row = dst->getAddr32(0, y);
+        if (use4f) {
+            proc4f(state, 0, y, row, kSize);
+            continue;
+        }
+        for (int x = 0; x < kSize; x += max) {
+            const int n = SkTMin(max, kSize - x);
+            state.getMatrixProc()(state, xy, n, x, y);
+            state.getSampleProc32()(state, xy, n, row + x);
+        }
+    }
+}
+
+static int max_component_diff(SkPMColor a, SkPMColor b) {
+    int diff = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        diff = SkTMax(diff, SkAbs32((int)((a >> shift) & 0xFF) - (int)((b >> shift) & 0xFF)));
+    }
+    return diff;
+}
+
+// The SkPMFloat procs round where the sample procs truncate, so they may differ by one (two with
+// partial alpha, which the sample procs apply after truncating once already).
+DEF_TEST(BitmapProcState4f, reporter) {
+    SkRandom rand;
+    SkBitmap opaque, premul;
+    opaque.allocN32Pixels(11, 7, true);
+    premul.allocN32Pixels(11, 7);
+    for (int y = 0; y < 7; ++y) {
+        for (int x = 0; x < 11; ++x) {
+            *opaque.getAddr32(x, y) = rand.nextU() | 0xFF000000;
+            *premul.getAddr32(x, y) = SkPreMultiplyColor(rand.nextU());
+        }
+    }
+
+    SkMatrix matrices[4];
+    matrices[0].setScale(3.3f, 2.7f);                   // Scaling up.
+    matrices[1].setScale(0.6f, 0.45f);                  // Scaling down.
+    matrices[1].postTranslate(-5.5f, 3.25f);
+    matrices[2].setRotate(30, 5, 3);                    // Affine.
+    matrices[2].postScale(2.5f, 2.5f);
+    matrices[3].setScale(-1.7f, 2.1f, 20, 20);          // Flipped.
+
+    const SkShader::TileMode tiles[] = {
+        SkShader::kClamp_TileMode, SkShader::kRepeat_TileMode, SkShader::kMirror_TileMode,
+    };
+    const U8CPU alphas[] = { 0xFF, 0x80 };
+    const SkBitmap* srcs[] = { &opaque, &premul };
+
+    for (size_t s = 0; s < SK_ARRAY_COUNT(srcs); ++s) {
+    for (size_t t = 0; t < SK_ARRAY_COUNT(tiles); ++t) {
+    for (size_t m = 0; m < SK_ARRAY_COUNT(matrices); ++m) {
+    for (size_t a = 0; a < SK_ARRAY_COUNT(alphas); ++a) {
+        SkBitmap expected, actual;
+        draw(reporter, &expected, *srcs[s], tiles[t], matrices[m], alphas[a], false);
+        draw(reporter, &actual,   *srcs[s], tiles[t], matrices[m], alphas[a], true);
+
+        const int tolerance = 0xFF == alphas[a] ? 1 : 2;
+        int worst = 0;
+        bool opaqueStayedOpaque = true;
+        for (int y = 0; y < kSize; ++y) {
+            for (int x = 0; x < kSize; ++x) {
+                SkPMColor e = *expected.getAddr32(x, y),
+                          c = *actual.getAddr32(x, y);
+                worst = SkTMax(worst, max_component_diff(e, c));
+                if (srcs[s] == &opaque && 0xFF == alphas[a] && 0xFF != SkGetPackedA32(c)) {
+                    opaqueStayedOpaque = false;
+                }
+            }
+        }
+        REPORTER_ASSERT_MESSAGE(reporter, worst <= tolerance,
+                                SkStringPrintf("src %d tile %d matrix %d alpha 0x%X: off by %d",
+                                               (int)s, (int)t, (int)m, alphas[a], worst));
+        REPORTER_ASSERT(reporter, opaqueStayedOpaque);
+    }
+    }
+    }
+    }
+}
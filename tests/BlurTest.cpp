@@ -13,6 +13,7 @@
 #include "SkCanvas.h"
 #include "SkMath.h"
 #include "SkPaint.h"
+#include "SkRandom.h"
 #include "Test.h"
 
 #if SK_SUPPORT_GPU
@@ -571,3 +572,50 @@ DEF_GPUTEST(Blur, reporter, factory) {
     test_sigma_range(reporter, factory);
     test_asABlur(reporter);
 }
+
+// The Sk4i box blur must match the scalar one exactly, including for heights that
+// aren't a multiple of four and for the interpolated (fractional radius) kernels.
+DEF_TEST(BlurMask_Sk4MatchesScalar, reporter) {
+    SkRandom rand;
+    const SkScalar sigmas[] = { 0.8f, 1.7f, 2.5f, 3.0f, 4.33f, 9.0f, 20.2f };
+    const SkIRect bounds[] = {
+        SkIRect::MakeWH(1, 1),
+        SkIRect::MakeXYWH(3, -2, 7, 5),
+        SkIRect::MakeWH(32, 33),
+        SkIRect::MakeXYWH(-5, 10, 61, 18),
+    };
+
+    for (size_t b = 0; b < SK_ARRAY_COUNT(bounds); ++b) {
+        SkMask src;
+        src.fBounds = bounds[b];
+        src.fRowBytes = src.fBounds.width();
+        src.fFormat = SkMask::kA8_Format;
+        src.fImage = SkMask::AllocImage(src.computeImageSize());
+        SkAutoMaskFreeImage srcImage(src.fImage);
+        for (size_t i = 0; i < src.computeImageSize(); ++i) {
+            src.fImage[i] = rand.nextBool() ? rand.nextU() & 0xFF : 0;
+        }
+
+        for (size_t s = 0; s < SK_ARRAY_COUNT(sigmas); ++s) {
+            for (int q = 0; q < kLastEnum_SkBlurQuality; ++q) {
+                for (int style = 0; style <= kLastEnum_SkBlurStyle; ++style) {
+                    SkMask masks[2];
+                    for (int simd = 0; simd < 2; ++simd) {
+                        const SkBlurMaskSk4Policy policy = simd ? kAlways_SkBlurMaskSk4Policy
+                                                                : kNever_SkBlurMaskSk4Policy;
+                        REPORTER_ASSERT(reporter, SkBlurMask::BoxBlur(&masks[simd], src,
+                                                                      sigmas[s],
+                                                                      (SkBlurStyle)style,
+                                                                      (SkBlurQuality)q,
+                                                                      policy));
+                    }
+                    SkAutoMaskFreeImage scalarImage(masks[0].fImage),
+                                        simdImage(masks[1].fImage);
+                    REPORTER_ASSERT(reporter, masks[0].fBounds == masks[1].fBounds);
+                    REPORTER_ASSERT(reporter, 0 == memcmp(masks[0].fImage, masks[1].fImage,
+                                                          masks[0].computeImageSize()));
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Resources.h"
+#include "SkBitmap.h"
+#include "SkCodec.h"
+#include "SkData.h"
+#include "Test.h"
+
+// Decodes region of the image, scaled to scale, with GetRegionInParallel, and checks it
+// byte for byte against the same rows of a getPixels decode.
+static void check_parallel_region(skiatest::Reporter* reporter, SkData* data, float scale,
+                                  const SkIRect& region) {
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(data));
+    REPORTER_ASSERT(reporter, codec);
+    if (!codec) {
+        return;
+    }
+    const SkISize size = codec->getScaledDimensions(scale);
+    const SkImageInfo info = codec->getInfo().makeWH(size.width(), size.height())
+                                             .makeColorType(kN32_SkColorType);
+    SkBitmap expected;
+    expected.allocPixels(info);
+    REPORTER_ASSERT(reporter, SkCodec::kSuccess ==
+                              codec->getPixels(info, expected.getPixels(), expected.rowBytes()));
+
+    SkBitmap actual;
+    actual.allocPixels(info.makeWH(region.width(), region.height()));
+    REPORTER_ASSERT(reporter, SkCodec::kSuccess ==
+                              SkCodec::GetRegionInParallel(data, info, region,
+                                                           actual.getPixels(), actual.rowBytes()));
+
+    const size_t bytes = region.width() * info.bytesPerPixel();
+    for (int y = 0; y < region.height(); y++) {
+        if (memcmp(expected.getAddr(region.left(), region.top() + y), actual.getAddr(0, y),
+                   bytes)) {
+            ERRORF(reporter, "Row %d of [%d %d %d %d] at scale %g differs", y, region.left(),
+                   region.top(), region.width(), region.height(), scale);
+            return;
+        }
+    }
+}
+
+// The jpeg has a restart marker at the start of each row of MCUs, so regions several hundred
+// rows tall are split into bands which begin decoding partway down the image.
+DEF_TEST(Codec_GetRegionInParallel, reporter) {
+    SkString path = GetResourcePath("mandrill_512_q075_restart.jpg");
+    SkAutoTUnref<SkData> data(SkData::NewFromFileName(path.c_str()));
+    if (NULL == data) {
+        SkDebugf("Codec_GetRegionInParallel: can't load test file %s\n", path.c_str());
+        return;
+    }
+
+    check_parallel_region(reporter, data, 1.0f, SkIRect::MakeWH(512, 512));
+    check_parallel_region(reporter, data, 1.0f, SkIRect::MakeLTRB(37, 5, 301, 509));
+    check_parallel_region(reporter, data, 0.5f, SkIRect::MakeWH(256, 256));
+    check_parallel_region(reporter, data, 0.5f, SkIRect::MakeLTRB(3, 0, 200, 256));
+}
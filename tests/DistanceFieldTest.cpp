@@ -0,0 +1,64 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkDistanceFieldGen.h"
+#include "SkTemplates.h"
+#include "Test.h"
+
+// The distance field of an antialiased disk should match the distance to its circle, near the
+// circle. The exact transform should be at least as close as the 8SSEDT sweeps.
+DEF_TEST(DistanceField_Disk, reporter) {
+    static const int kSize = 64;
+    static const float kCenter = 31.5f;
+    static const float kRadius = 20.3f;
+
+    SkBitmap mask;
+    mask.allocPixels(SkImageInfo::MakeA8(kSize, kSize));
+    mask.eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas canvas(mask);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    canvas.drawCircle(kCenter + 0.5f, kCenter + 0.5f, kRadius, paint);
+
+    static const int kDFSize = kSize + 2*SK_DistanceFieldPad;
+    unsigned char distanceFields[2][kDFSize * kDFSize];
+    float maxError[2], sumError[2];
+    for (int exact = 0; exact < 2; ++exact) {
+        SkAutoLockPixels alp(mask);
+        const unsigned char* image = (const unsigned char*)mask.getPixels();
+        REPORTER_ASSERT(reporter, exact
+                ? SkGenerateDistanceFieldFromA8ImageExact(distanceFields[exact], image,
+                                                          kSize, kSize, mask.rowBytes())
+                : SkGenerateDistanceFieldFromA8Image8SSEDT(distanceFields[exact], image,
+                                                           kSize, kSize, mask.rowBytes()));
+
+        // Distances within the magnitude are packed as 128 at the edge, larger inside.
+        static const float kPerTexel = 128.0f / SK_DistanceFieldMagnitude;
+        maxError[exact] = sumError[exact] = 0;
+        for (int y = 0; y < kSize; ++y) {
+            for (int x = 0; x < kSize; ++x) {
+                const float dist = SkPoint::Length(x - kCenter, y - kCenter) - kRadius;
+                if (SkScalarAbs(dist) > SK_DistanceFieldMagnitude - 1) {
+                    continue;
+                }
+                const int packed = distanceFields[exact][(y + SK_DistanceFieldPad)*kDFSize +
+                                                         x + SK_DistanceFieldPad];
+                const float found = (128 - packed) / kPerTexel;
+                maxError[exact] = SkTMax(maxError[exact], SkScalarAbs(found - dist));
+                sumError[exact] += SkScalarAbs(found - dist);
+            }
+        }
+    }
+
+    // Inside texels measure to the edge texels' edge points, which leaves them up to about half
+    // a texel short.
+    REPORTER_ASSERT(reporter, maxError[1] < 0.75f);
+    REPORTER_ASSERT(reporter, maxError[1] <= maxError[0]);
+    REPORTER_ASSERT(reporter, sumError[1] <= sumError[0]);
+}
@@ -1,6 +1,7 @@
 #include "Test.h"
 
 #include "SkCanvas.h"
+#include "SkData.h"
 #include "SkDocument.h"
 #include "SkOSFile.h"
 #include "SkStream.h"
@@ -96,10 +97,79 @@ static void test_close(skiatest::Reporter* reporter) {
     REPORTER_ASSERT(reporter, stream.bytesWritten() != 0);
 }
 
+static void draw_page(SkDocument* doc, int i) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(16, 16);
+    bitmap.eraseARGB(0x80, 0x10 * i, 0, 0xFF);  // Not opaque, so it has an SMask too.
+    bitmap.setImmutable();
+
+    SkCanvas* canvas = doc->beginPage(100, 100);
+    canvas->drawColor(SK_ColorRED);
+    canvas->drawBitmap(bitmap, 10, 10);
+    doc->endPage();
+}
+
+// Returns the number of objects in the PDF's cross-reference table, after
+// checking that each of their offsets points at its "n 0 obj".
+static int count_objects(skiatest::Reporter* reporter, SkData* pdf) {
+    // The objects are mostly deflated, so search the trailer from the end.
+    const char* bytes = (const char*)pdf->data();
+    const char kStartXRef[] = "startxref\n";
+    const char* startxref = bytes + pdf->size() - strlen(kStartXRef);
+    while (startxref > bytes && memcmp(startxref, kStartXRef, strlen(kStartXRef))) {
+        --startxref;
+    }
+    if (startxref == bytes) {
+        ERRORF(reporter, "no startxref");
+        return 0;
+    }
+    int xref = atoi(startxref + strlen(kStartXRef));
+    if (0 != strncmp(bytes + xref, "xref\n", 5)) {
+        ERRORF(reporter, "no xref at %d", xref);
+        return 0;
+    }
+    // Each entry is 20 bytes; the first is the free list's head.
+    int objCount = 0;
+    for (const char* entry = strstr(bytes + xref, " f \n") + 4;
+         0 == strncmp(entry + 10, " 00000 n \n", 10);
+         entry += 20) {
+        SkString obj;
+        obj.printf("%d 0 obj\n", ++objCount);
+        REPORTER_ASSERT(reporter, 0 == strncmp(bytes + atoi(entry), obj.c_str(), obj.size()));
+    }
+    return objCount;
+}
+
+static void test_streaming(skiatest::Reporter* reporter) {
+    SkDynamicMemoryWStream stream;
+    SkAutoTUnref<SkDocument> doc(SkDocument::CreateStreamingPDF(&stream));
+    draw_page(doc, 0);
+    draw_page(doc, 1);
+    // The first page's content and image should be written by now.
+    REPORTER_ASSERT(reporter, stream.bytesWritten() != 0);
+    draw_page(doc, 2);
+    REPORTER_ASSERT(reporter, doc->close());
+    SkAutoTUnref<SkData> streamed(stream.copyToData());
+
+    SkDynamicMemoryWStream allAtOnceStream;
+    doc.reset(SkDocument::CreatePDF(&allAtOnceStream));
+    draw_page(doc, 0);
+    draw_page(doc, 1);
+    draw_page(doc, 2);
+    REPORTER_ASSERT(reporter, doc->close());
+    SkAutoTUnref<SkData> allAtOnce(allAtOnceStream.copyToData());
+
+    // The same objects, in a different order.
+    int objCount = count_objects(reporter, streamed);
+    REPORTER_ASSERT(reporter, objCount > 0);
+    REPORTER_ASSERT(reporter, objCount == count_objects(reporter, allAtOnce));
+}
+
 DEF_TEST(document_tests, reporter) {
     test_empty(reporter);
     test_abort(reporter);
     test_abortWithFile(reporter);
     test_file(reporter);
     test_close(reporter);
+    test_streaming(reporter);
 }
@@ -11,6 +11,8 @@
 #include "SkPaint.h"
 #include "SkPoint.h"
 #include "SkRect.h"
+#include "SkRegion.h"
+#include "SkTextBlob.h"
 #include "SkTypes.h"
 #include "Test.h"
 
@@ -106,3 +108,94 @@ DEF_TEST(DrawText, reporter) {
         }
     }
 }
+
+static const char gBlobText[] = "Hamburgefons";
+static const int kBlobGlyphs = sizeof(gBlobText) - 1;
+
+// A blob with one run of each positioning, and the same runs drawn without a blob.
+static const SkTextBlob* make_blob(const SkPaint& font, uint16_t glyphs[kBlobGlyphs],
+                                   SkScalar xpos[kBlobGlyphs], SkPoint pos[kBlobGlyphs]) {
+    SkPaint textFont(font);
+    textFont.setTextEncoding(SkPaint::kUTF8_TextEncoding);
+    textFont.textToGlyphs(gBlobText, kBlobGlyphs, glyphs);
+    for (int i = 0; i < kBlobGlyphs; ++i) {
+        xpos[i] = 4.5f + i * 11.25f;
+        pos[i].set(3.25f + i * 10.5f, 70 + i * 1.75f);
+    }
+
+    SkTextBlobBuilder builder;
+    const SkTextBlobBuilder::RunBuffer& run = builder.allocRun(font, kBlobGlyphs, 2, 20);
+    memcpy(run.glyphs, glyphs, sizeof(uint16_t) * kBlobGlyphs);
+    const SkTextBlobBuilder::RunBuffer& runH = builder.allocRunPosH(font, kBlobGlyphs, 45);
+    memcpy(runH.glyphs, glyphs, sizeof(uint16_t) * kBlobGlyphs);
+    memcpy(runH.pos, xpos, sizeof(SkScalar) * kBlobGlyphs);
+    const SkTextBlobBuilder::RunBuffer& runP = builder.allocRunPos(font, kBlobGlyphs);
+    memcpy(runP.glyphs, glyphs, sizeof(uint16_t) * kBlobGlyphs);
+    memcpy(runP.pos, pos, sizeof(SkPoint) * kBlobGlyphs);
+    return builder.build();
+}
+
+static void draw_runs(SkCanvas* canvas, const SkPaint& paint, const uint16_t glyphs[],
+                      const SkScalar xpos[], const SkPoint pos[], SkScalar x, SkScalar y) {
+    size_t len = kBlobGlyphs * sizeof(uint16_t);
+    canvas->drawText(glyphs, len, x + 2, y + 20, paint);
+    canvas->save();
+    canvas->translate(x, y);
+    canvas->drawPosTextH(glyphs, len, xpos, 45, paint);
+    canvas->drawPosText(glyphs, len, pos, paint);
+    canvas->restore();
+}
+
+// Draws the blob twice at each position, so the second draw comes from the glyph run cache,
+// and compares both to the runs drawn as plain text.
+static void test_blob(skiatest::Reporter* reporter, const SkPaint& paint, const SkRegion& clip) {
+    uint16_t glyphs[kBlobGlyphs];
+    SkScalar xpos[kBlobGlyphs];
+    SkPoint pos[kBlobGlyphs];
+    SkAutoTUnref<const SkTextBlob> blob(make_blob(paint, glyphs, xpos, pos));
+
+    SkIRect rect = SkIRect::MakeWH(160, 120);
+    SkBitmap blobBitmap, textBitmap;
+    create(&blobBitmap, rect);
+    create(&textBitmap, rect);
+    // The clip keeps drawBG() off the edges.
+    blobBitmap.eraseColor(bgColor);
+    textBitmap.eraseColor(bgColor);
+    SkCanvas blobCanvas(blobBitmap);
+    SkCanvas textCanvas(textBitmap);
+    blobCanvas.clipRegion(clip);
+    textCanvas.clipRegion(clip);
+
+    // Whole pixel moves share a cache entry; the last one does not.
+    const SkPoint origins[] = { { 5, 7 }, { 5, 7 }, { 12, -3 }, { -4, 16 }, { 5.375f, 7.5f } };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(origins); ++i) {
+        drawBG(&blobCanvas);
+        blobCanvas.drawTextBlob(blob, origins[i].fX, origins[i].fY, paint);
+        drawBG(&textCanvas);
+        draw_runs(&textCanvas, paint, glyphs, xpos, pos, origins[i].fX, origins[i].fY);
+        REPORTER_ASSERT(reporter, compare(textBitmap, rect, blobBitmap, rect));
+    }
+}
+
+DEF_TEST(DrawTextBlob, reporter) {
+    SkPaint paint;
+    paint.setColor(SK_ColorGRAY);
+    paint.setTextSize(SkIntToScalar(14));
+    paint.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+
+    SkRegion rectClip(SkIRect::MakeLTRB(10, 10, 150, 100));
+    SkRegion complexClip(rectClip);
+    complexClip.op(SkIRect::MakeLTRB(40, 30, 90, 60), SkRegion::kDifference_Op);
+
+    for (int align = 0; align < SkPaint::kAlignCount; ++align) {
+        paint.setTextAlign(static_cast<SkPaint::Align>(align));
+        for (unsigned int flags = 0; flags < (1 << 3); ++flags) {
+            paint.setAntiAlias(SkToBool(flags & 1));
+            paint.setSubpixelText(SkToBool(flags & 2));
+            paint.setLCDRenderText(SkToBool(flags & 4));
+
+            test_blob(reporter, paint, rectClip);
+            test_blob(reporter, paint, complexClip);
+        }
+    }
+}
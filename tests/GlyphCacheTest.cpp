@@ -0,0 +1,90 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkDescriptor.h"
+#include "SkGlyphCache_Globals.h"
+#include "SkPaint.h"
+#include "SkScalerContext.h"
+#include "SkTaskGroup.h"
+#include "SkTypeface.h"
+#include "Test.h"
+
+static const int kShardCount = 4;
+static const int kSizeCount = 64;
+
+namespace {
+// Attaches a new cache, for one text size, to the shard for its descriptor, as the shared
+// glyph cache would.
+struct AttachRec {
+    SkGlyphCache_Globals** fShards;
+    int                    fSize;
+};
+}  // namespace
+
+static void attach_at_size(AttachRec* attach) {
+    SkPaint paint;
+    paint.setTextSize(SkIntToScalar(attach->fSize));
+    SkScalerContext::Rec rec;
+    SkScalerContext::MakeRec(paint, NULL, NULL, &rec);
+
+    SkAutoDescriptor ad(SkDescriptor::ComputeOverhead(1) + sizeof(rec));
+    SkDescriptor* desc = ad.getDesc();
+    desc->init();
+    desc->addEntry(kRec_SkDescriptorTag, sizeof(rec), &rec);
+    desc->computeChecksum();
+
+    SkAutoTUnref<SkTypeface> typeface(SkTypeface::RefDefault());
+    SkGlyphCache_Globals* shard = attach->fShards[desc->getChecksum() % kShardCount];
+    shard->attachNewCacheForTesting(typeface, desc);
+    SkGlyphCache_Globals::BalanceShards(attach->fShards, kShardCount);
+}
+
+// The shared glyph cache is sharded, but the shards must still honor one budget between them.
+// This checks that on shards of our own, leaving the process-wide cache alone.
+DEF_TEST(GlyphCache_ShardedBudget, reporter) {
+    SkGlyphCache_Globals* shards[kShardCount];
+    for (int i = 0; i < kShardCount; i++) {
+        shards[i] = SkNEW_ARGS(SkGlyphCache_Globals, (SkGlyphCache_Globals::kYes_UseMutex));
+        shards[i]->setCacheCountLimit(16);
+    }
+
+    AttachRec attaches[kSizeCount];
+    for (int i = 0; i < kSizeCount; i++) {
+        attaches[i].fShards = shards;
+        attaches[i].fSize = 8 + i;
+        attach_at_size(&attaches[i]);
+    }
+    REPORTER_ASSERT(reporter,
+                    SkGlyphCache_Globals::ShardsCacheCountUsed(shards, kShardCount) > 0);
+    REPORTER_ASSERT(reporter,
+                    SkGlyphCache_Globals::ShardsCacheCountUsed(shards, kShardCount) <= 16);
+
+    {
+        SkTaskGroup tg;
+        tg.batch(attach_at_size, attaches, kSizeCount);
+        tg.wait();
+    }
+    REPORTER_ASSERT(reporter,
+                    SkGlyphCache_Globals::ShardsCacheCountUsed(shards, kShardCount) <= 16);
+
+    for (int i = 0; i < kShardCount; i++) {
+        REPORTER_ASSERT(reporter, shards[i]->setCacheCountLimit(4) == 16);
+    }
+    SkGlyphCache_Globals::BalanceShards(shards, kShardCount);
+    REPORTER_ASSERT(reporter,
+                    SkGlyphCache_Globals::ShardsCacheCountUsed(shards, kShardCount) <= 4);
+
+    for (int i = 0; i < kShardCount; i++) {
+        shards[i]->purgeAll();
+    }
+    REPORTER_ASSERT(reporter, SkGlyphCache_Globals::ShardsCacheCountUsed(shards, kShardCount) == 0);
+    REPORTER_ASSERT(reporter, SkGlyphCache_Globals::ShardsMemoryUsed(shards, kShardCount) == 0);
+
+    for (int i = 0; i < kShardCount; i++) {
+        SkDELETE(shards[i]);
+    }
+}
@@ -7,6 +7,8 @@
 
 #include "SkDiscardableMemory.h"
 #include "SkResourceCache.h"
+#include "SkShardedResourceCache.h"
+#include "SkTaskGroup.h"
 #include "Test.h"
 
 namespace {
@@ -149,3 +151,62 @@ DEF_TEST(ImageCache_doubleAdd, r) {
     REPORTER_ASSERT(r, cache.find(key, TestingRec::Visitor, &value));
     REPORTER_ASSERT(r, 2 == value || 3 == value);
 }
+
+DEF_TEST(ImageCache_sharded, r) {
+    const size_t recSize = sizeof(TestingKey) + sizeof(intptr_t);
+    const size_t limit = 50 * recSize;
+    SkShardedResourceCache cache(4, limit);
+
+    for (int i = 0; i < COUNT * 100; ++i) {
+        cache.add(SkNEW_ARGS(TestingRec, (TestingKey(i, i & 1), i)));
+        REPORTER_ASSERT(r, cache.getTotalBytesUsed() <= limit);
+    }
+
+    // The most recent entry must have survived all the purging.
+    intptr_t value = -1;
+    const int last = COUNT * 100 - 1;
+    REPORTER_ASSERT(r, cache.find(TestingKey(last, last & 1), TestingRec::Visitor, &value));
+    REPORTER_ASSERT(r, last == value);
+
+    // Purge messages reach every shard.
+    SkResourceCache::PostPurgeSharedID(1);
+    REPORTER_ASSERT(r, !cache.find(TestingKey(last, last & 1), TestingRec::Visitor, &value));
+
+    cache.purgeAll();
+    REPORTER_ASSERT(r, 0 == cache.getTotalBytesUsed());
+}
+
+namespace {
+struct ShardedWork {
+    SkShardedResourceCache* fCache;
+    int                     fStart;
+};
+}
+
+static void add_and_find(ShardedWork* work) {
+    for (int i = work->fStart; i < work->fStart + COUNT * 10; ++i) {
+        intptr_t value;
+        if (!work->fCache->find(TestingKey(i), TestingRec::Visitor, &value)) {
+            work->fCache->add(SkNEW_ARGS(TestingRec, (TestingKey(i), i)));
+        }
+    }
+}
+
+DEF_TEST(ImageCache_shardedThreaded, r) {
+    const size_t recSize = sizeof(TestingKey) + sizeof(intptr_t);
+    const size_t limit = 200 * recSize;
+    SkShardedResourceCache cache(8, limit);
+
+    ShardedWork work[16];
+    for (int i = 0; i < 16; ++i) {
+        work[i].fCache = &cache;
+        work[i].fStart = i * COUNT;  // Overlapping ranges, so threads share some keys.
+    }
+    SkTaskGroup tg;
+    tg.batch(add_and_find, work, 16);
+    tg.wait();
+
+    REPORTER_ASSERT(r, cache.getTotalBytesUsed() <= limit);
+    cache.setTotalByteLimit(0);
+    REPORTER_ASSERT(r, 0 == cache.getTotalBytesUsed());
+}
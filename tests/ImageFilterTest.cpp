@@ -23,7 +23,9 @@
 #include "SkMergeImageFilter.h"
 #include "SkMorphologyImageFilter.h"
 #include "SkOffsetImageFilter.h"
+#include "SkOSFile.h"
 #include "SkPerlinNoiseShader.h"
+#include "SkPersistentImageFilterCache.h"
 #include "SkPicture.h"
 #include "SkPictureImageFilter.h"
 #include "SkPictureRecorder.h"
@@ -34,6 +36,13 @@
 #include "SkXfermodeImageFilter.h"
 #include "Test.h"
 
+#ifdef SK_BUILD_FOR_WIN
+    #include <process.h>
+    #define getpid _getpid
+#else
+    #include <unistd.h>
+#endif
+
 #if SK_SUPPORT_GPU
 #include "GrContextFactory.h"
 #include "SkGpuDevice.h"
@@ -1136,6 +1145,169 @@ DEF_TEST(ComposedImageFilterOffset, reporter) {
     REPORTER_ASSERT(reporter, offset.fX == 1 && offset.fY == 0);
 }
 
+static void remove_cache_files(const char* dir) {
+    SkOSFile::Iter iter(dir, "skif");
+    SkString name;
+    while (iter.next(&name)) {
+        sk_remove(SkOSPath::Join(dir, name.c_str()).c_str());
+    }
+}
+
+static bool filter_with_cache(SkImageFilter* filter, const SkBitmap& src,
+                              SkImageFilter::Cache* cache, SkBitmap* result) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(100, 100);
+    SkBitmapDevice device(bitmap);
+    SkDeviceImageFilterProxy proxy(&device, SkSurfaceProps(SkSurfaceProps::kLegacyFontHost_InitType));
+    SkImageFilter::Context ctx(SkMatrix::I(), SkIRect::MakeWH(100, 100), cache);
+    SkIPoint offset;
+    return filter->filterImage(&proxy, src, ctx, result, &offset);
+}
+
+// The context is the uint32_t the test sets the time in.
+static uint32_t fake_clock(void* context) {
+    return *static_cast<const uint32_t*>(context);
+}
+
+// Each lookup uses a new filter and a copy of src, so it misses the memory level (which is
+// keyed by ID) and reaches the disk.
+static bool filter_copy_with_cache(const SkBitmap& src, SkImageFilter::Cache* cache) {
+    SkBitmap srcCopy, result;
+    SkAutoTUnref<SkImageFilter> blur(makeBlur());
+    return src.copyTo(&srcCopy) && filter_with_cache(blur, srcCopy, cache, &result);
+}
+
+static void test_persistent_cache_max_age(skiatest::Reporter* reporter, const char* dir,
+                                          const SkBitmap& src) {
+    SkAutoTUnref<SkImageFilter::Cache> memory(SkImageFilter::Cache::Create(1024 * 1024));
+    SkPersistentImageFilterCache::Options options;
+    options.fMaxAgeSeconds = 60;
+    uint32_t seconds = 1000;
+    options.fClock = fake_clock;
+    options.fClockContext = &seconds;
+    SkAutoTUnref<SkPersistentImageFilterCache> cache(
+            SkPersistentImageFilterCache::Create(dir, memory, options));
+    REPORTER_ASSERT(reporter, cache);
+    if (!cache) {
+        return;
+    }
+
+    REPORTER_ASSERT(reporter, filter_copy_with_cache(src, cache));
+    seconds += options.fMaxAgeSeconds;
+    REPORTER_ASSERT(reporter, filter_copy_with_cache(src, cache));
+    SkPersistentImageFilterCache::Stats stats;
+    cache->getStats(&stats);
+    REPORTER_ASSERT(reporter, 1 == stats.fDiskHits);
+    REPORTER_ASSERT(reporter, 1 == stats.fMisses);
+    REPORTER_ASSERT(reporter, 0 == stats.fDiskEvictions);
+
+    // Past its age, the entry is evicted when it's found, and written again.
+    seconds++;
+    REPORTER_ASSERT(reporter, filter_copy_with_cache(src, cache));
+    cache->getStats(&stats);
+    REPORTER_ASSERT(reporter, 1 == stats.fDiskHits);
+    REPORTER_ASSERT(reporter, 2 == stats.fMisses);
+    REPORTER_ASSERT(reporter, 1 == stats.fDiskEvictions);
+    REPORTER_ASSERT(reporter, 2 == stats.fDiskWrites);
+    REPORTER_ASSERT(reporter, 1 == stats.fDiskEntries);
+
+    // The new entry is as old as the clock says, so it is found again...
+    REPORTER_ASSERT(reporter, filter_copy_with_cache(src, cache));
+    cache->getStats(&stats);
+    REPORTER_ASSERT(reporter, 2 == stats.fDiskHits);
+
+    // ...until that too is past its age, when purgeExpired() evicts it without a lookup.
+    seconds += options.fMaxAgeSeconds + 1;
+    cache->purgeExpired();
+    cache->getStats(&stats);
+    REPORTER_ASSERT(reporter, 2 == stats.fDiskEvictions);
+    REPORTER_ASSERT(reporter, 0 == stats.fDiskEntries);
+    REPORTER_ASSERT(reporter, 0 == stats.fDiskBytes);
+}
+
+DEF_TEST(ImageFilterPersistentCache, reporter) {
+    SkString tmpDir = skiatest::GetTmpDir();
+    if (tmpDir.isEmpty()) {
+        return;
+    }
+    // Other processes may be running this test at the same time.
+    SkString dirName;
+    dirName.printf("image_filter_cache_%d", getpid());
+    SkString dir = SkOSPath::Join(tmpDir.c_str(), dirName.c_str());
+    sk_mkdir(dir.c_str());
+    remove_cache_files(dir.c_str());
+
+    SkBitmap src;
+    src.allocN32Pixels(50, 50);
+    src.eraseColor(SK_ColorTRANSPARENT);
+    src.eraseArea(SkIRect::MakeXYWH(10, 10, 30, 30), SK_ColorGREEN);
+
+    SkBitmap expected;
+    {
+        SkAutoTUnref<SkImageFilter::Cache> memory(SkImageFilter::Cache::Create(1024 * 1024));
+        SkAutoTUnref<SkPersistentImageFilterCache> cache(
+                SkPersistentImageFilterCache::Create(dir.c_str(), memory));
+        REPORTER_ASSERT(reporter, cache);
+        if (!cache) {
+            return;
+        }
+        SkAutoTUnref<SkImageFilter> blur(makeBlur());
+        REPORTER_ASSERT(reporter, filter_with_cache(blur, src, cache, &expected));
+        SkBitmap result;
+        REPORTER_ASSERT(reporter, filter_with_cache(blur, src, cache, &result));
+
+        SkPersistentImageFilterCache::Stats stats;
+        cache->getStats(&stats);
+        REPORTER_ASSERT(reporter, 1 == stats.fMemoryHits);
+        REPORTER_ASSERT(reporter, 0 == stats.fDiskHits);
+        REPORTER_ASSERT(reporter, 1 == stats.fMisses);
+        REPORTER_ASSERT(reporter, 1 == stats.fDiskWrites);
+        REPORTER_ASSERT(reporter, 1 == stats.fDiskEntries);
+    }
+
+    // An equal filter and source, with new IDs, should be found on disk by a new cache.
+    SkBitmap srcCopy;
+    REPORTER_ASSERT(reporter, src.copyTo(&srcCopy));
+    SkAutoTUnref<SkImageFilter::Cache> memory(SkImageFilter::Cache::Create(1024 * 1024));
+    SkPersistentImageFilterCache::Options options;
+    options.fMaxDiskBytes = 2 * expected.getSize();
+    SkAutoTUnref<SkPersistentImageFilterCache> cache(
+            SkPersistentImageFilterCache::Create(dir.c_str(), memory, options));
+    REPORTER_ASSERT(reporter, cache);
+    if (!cache) {
+        return;
+    }
+    SkAutoTUnref<SkImageFilter> blur(makeBlur());
+    SkBitmap result;
+    REPORTER_ASSERT(reporter, filter_with_cache(blur, srcCopy, cache, &result));
+    SkPersistentImageFilterCache::Stats stats;
+    cache->getStats(&stats);
+    REPORTER_ASSERT(reporter, 1 == stats.fDiskHits);
+    REPORTER_ASSERT(reporter, 0 == stats.fMisses);
+    {
+        SkAutoLockPixels alpExpected(expected), alpResult(result);
+        REPORTER_ASSERT(reporter, expected.info() == result.info());
+        for (int y = 0; y < expected.height(); y++) {
+            REPORTER_ASSERT(reporter, 0 == memcmp(expected.getAddr(0, y), result.getAddr(0, y),
+                                                  expected.width() * expected.bytesPerPixel()));
+        }
+    }
+
+    // A different filter misses, and pushes the least recently used entry out.
+    SkAutoTUnref<SkImageFilter> otherBlur(SkBlurImageFilter::Create(3, 3));
+    REPORTER_ASSERT(reporter, filter_with_cache(otherBlur, srcCopy, cache, &result));
+    SkAutoTUnref<SkImageFilter> thirdBlur(SkBlurImageFilter::Create(5, 5));
+    REPORTER_ASSERT(reporter, filter_with_cache(thirdBlur, srcCopy, cache, &result));
+    cache->getStats(&stats);
+    REPORTER_ASSERT(reporter, 2 == stats.fMisses);
+    REPORTER_ASSERT(reporter, stats.fDiskEvictions > 0);
+    REPORTER_ASSERT(reporter, stats.fDiskBytes <= options.fMaxDiskBytes);
+
+    remove_cache_files(dir.c_str());
+    test_persistent_cache_max_age(reporter, dir.c_str(), src);
+    remove_cache_files(dir.c_str());
+}
+
 #if SK_SUPPORT_GPU
 const SkSurfaceProps gProps = SkSurfaceProps(SkSurfaceProps::kLegacyFontHost_InitType);
 
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBBHFactory.h"
+#include "SkCanvas.h"
+#include "SkImage.h"
+#include "SkMultiPictureDraw.h"
+#include "SkPictureRecorder.h"
+#include "SkRandom.h"
+#include "SkSurface.h"
+#include "Test.h"
+
+static const int kWidth  = 300;
+static const int kHeight = 200;
+
+static SkPicture* make_picture() {
+    SkRTreeFactory factory;
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(SkIntToScalar(kWidth), SkIntToScalar(kHeight),
+                                               &factory);
+    SkRandom rand;
+    SkPaint paint;
+    for (int i = 0; i < 100; i++) {
+        paint.setColor(rand.nextU() | 0xFF000000);
+        paint.setAntiAlias(0 == (i & 1));  // Anti-aliased rects, aliased ovals.
+        SkRect r = SkRect::MakeXYWH(rand.nextRangeScalar(-20, SkIntToScalar(kWidth)),
+                                    rand.nextRangeScalar(-20, SkIntToScalar(kHeight)),
+                                    rand.nextRangeScalar(1, 80),
+                                    rand.nextRangeScalar(1, 80));
+        if (i & 1) {
+            canvas->drawOval(r, paint);
+        } else {
+            canvas->drawRect(r, paint);
+        }
+    }
+    return recorder.endRecording();
+}
+
+static bool same_pixels(const SkBitmap& a, const SkBitmap& b) {
+    SkAutoLockPixels lockA(a), lockB(b);
+    for (int y = 0; y < a.height(); y++) {
+        if (0 != memcmp(a.getAddr32(0, y), b.getAddr32(0, y), a.width() * sizeof(SkPMColor))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+DEF_TEST(MultiPictureDraw_Tiled, r) {
+    SkAutoTUnref<SkPicture> picture(make_picture());
+    SkMatrix matrix;
+    matrix.setScale(0.75f, 1.25f);
+
+    SkBitmap expected;
+    expected.allocN32Pixels(kWidth, kHeight);
+    expected.eraseColor(SK_ColorWHITE);
+    SkCanvas expectedCanvas(expected);
+    expectedCanvas.clipRect(SkRect::MakeLTRB(10, 5, 290, 190));
+    expectedCanvas.drawPicture(picture, &matrix, NULL);
+
+    SkBitmap actual;
+    actual.allocN32Pixels(kWidth, kHeight);
+    actual.eraseColor(SK_ColorWHITE);
+    SkAutoTUnref<SkCanvas> actualCanvas(SkNEW_ARGS(SkCanvas, (actual)));
+    actualCanvas->clipRect(SkRect::MakeLTRB(10, 5, 290, 190));
+
+    // Odd tile sizes make sure tiles straddle the clip edges.
+    SkMultiPictureDraw mpd;
+    mpd.addTiled(actualCanvas, picture, SkISize::Make(37, 23), &matrix);
+    mpd.draw();
+
+    REPORTER_ASSERT(r, same_pixels(expected, actual));
+}
+
+DEF_TEST(MultiPictureDraw_TiledSurfaceCopyOnWrite, r) {
+    SkAutoTUnref<SkPicture> picture(make_picture());
+
+    SkImageInfo info = SkImageInfo::MakeN32Premul(kWidth, kHeight);
+    SkAutoTUnref<SkSurface> surface(SkSurface::NewRaster(info));
+    surface->getCanvas()->clear(SK_ColorWHITE);
+    SkAutoTUnref<SkImage> before(surface->newImageSnapshot());
+
+    SkMultiPictureDraw mpd;
+    mpd.addTiled(surface->getCanvas(), picture, SkISize::Make(64, 64));
+    mpd.draw();
+
+    // The snapshot taken before drawing must still be all white.
+    SkBitmap bitmap;
+    bitmap.allocPixels(info);
+    REPORTER_ASSERT(r, before->readPixels(info, bitmap.getPixels(), bitmap.rowBytes(), 0, 0));
+    REPORTER_ASSERT(r, SK_ColorWHITE == bitmap.getColor(kWidth/2, kHeight/2));
+
+    SkAutoTUnref<SkImage> after(surface->newImageSnapshot());
+    REPORTER_ASSERT(r, before->uniqueID() != after->uniqueID());
+}
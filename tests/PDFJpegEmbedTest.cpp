@@ -10,6 +10,7 @@
 #include "SkImageGenerator.h"
 #include "SkData.h"
 #include "SkStream.h"
+#include "SkUtils.h"
 
 #include "Resources.h"
 #include "Test.h"
@@ -81,8 +82,7 @@ DEF_TEST(PDFJpegEmbedTest, r) {
     SkASSERT(pdfData);
     pdf.reset();
 
-    // Test disabled, waiting on resolution to http://skbug.com/3180
-    // REPORTER_ASSERT(r, is_subset_of(mandrillData, pdfData));
+    REPORTER_ASSERT(r, is_subset_of(mandrillData, pdfData));
 
     // This JPEG uses a nonstandard colorspace - it can not be
     // embedded into the PDF directly.
@@ -97,3 +97,81 @@ DEF_TEST(PDFJpegEmbedTest, r) {
         }
     }
 }
+
+static int count_occurrences(SkData* smaller, SkData* larger) {
+    int count = 0;
+    for (size_t i = 0; i + smaller->size() <= larger->size(); ++i) {
+        if (0 == memcmp(larger->bytes() + i, smaller->bytes(), smaller->size())) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+namespace {
+// Stands in for a JPEG decoder: it keeps the encoded data, and its pixels
+// are all gray.
+class JpegGenerator : public SkImageGenerator {
+public:
+    JpegGenerator(SkData* data, int width, int height)
+        : INHERITED(SkImageInfo::MakeN32(width, height, kOpaque_SkAlphaType))
+        , fData(SkRef(data)) {}
+
+protected:
+    SkData* onRefEncodedData() override { return SkRef(fData.get()); }
+
+    Result onGetPixels(const SkImageInfo& info, void* pixels, size_t rowBytes,
+                       const Options&, SkPMColor*, int*) override {
+        for (int y = 0; y < info.height(); ++y) {
+            sk_memset32((uint32_t*)((char*)pixels + y * rowBytes), SK_ColorGRAY, info.width());
+        }
+        return kSuccess;
+    }
+
+private:
+    SkAutoTUnref<SkData> fData;
+
+    typedef SkImageGenerator INHERITED;
+};
+}  // namespace
+
+static SkBitmap bitmap_from_jpeg(SkData* data, int width, int height) {
+    SkBitmap bm;
+    SkInstallDiscardablePixelRef(SkNEW_ARGS(JpegGenerator, (data, width, height)), &bm);
+    return bm;
+}
+
+/**
+ *  Test that JFIF JPEGs are embedded as they are, and only once even when
+ *  decoded from separate copies of the same data.
+ */
+DEF_TEST(PDFJpegPassthrough, r) {
+    const char test[] = "PDFJpegPassthrough";
+    SkAutoTUnref<SkData> mandrillData(
+            load_resource(r, test, "mandrill_512_q075.jpg"));
+    SkAutoTUnref<SkData> grayData(load_resource(r, test, "grayscale.jpg"));
+    SkAutoTUnref<SkData> cmykData(load_resource(r, test, "CMYK.jpg"));
+    if (!mandrillData || !grayData || !cmykData) {
+        return;
+    }
+    SkAutoTUnref<SkData> mandrillCopy(
+            SkData::NewWithCopy(mandrillData->data(), mandrillData->size()));
+
+    SkDynamicMemoryWStream pdf;
+    SkAutoTUnref<SkDocument> document(SkDocument::CreatePDF(&pdf));
+    SkCanvas* canvas = document->beginPage(1200, 1200);
+    canvas->drawBitmap(bitmap_from_jpeg(mandrillData, 512, 512), 0, 0);
+    canvas->drawBitmap(bitmap_from_jpeg(mandrillCopy, 512, 512), 512, 0);
+    canvas->drawBitmap(bitmap_from_jpeg(grayData, 128, 128), 0, 512);
+    canvas->drawBitmap(bitmap_from_jpeg(cmykData, 642, 516), 0, 640);
+    document->endPage();
+    document->close();
+    SkAutoTUnref<SkData> pdfData(pdf.copyToData());
+
+    REPORTER_ASSERT(r, 1 == count_occurrences(mandrillData, pdfData));
+    REPORTER_ASSERT(r, is_subset_of(grayData, pdfData));
+    REPORTER_ASSERT(r, !is_subset_of(cmykData, pdfData));
+
+    SkAutoTUnref<SkData> dctDecode(SkData::NewWithCString("/DCTDecode"));
+    REPORTER_ASSERT(r, 2 == count_occurrences(dctDecode, pdfData));
+}
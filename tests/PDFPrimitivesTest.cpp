@@ -348,3 +348,55 @@ DEF_TEST(PDFImageFilter, reporter) {
     // Filter was used in rendering; should be visited.
     REPORTER_ASSERT(reporter, filter->visited());
 }
+
+static int count_images(SkData* pdf) {
+    static const char kImage[] = "/Subtype /Image";
+    int count = 0;
+    for (size_t i = 0; i + strlen(kImage) <= pdf->size(); ++i) {
+        if (0 == memcmp(pdf->bytes() + i, kImage, strlen(kImage))) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+// Check that bitmaps with the same pixels are written once, even when they
+// do not share a pixel ref.
+DEF_TEST(PDFBitmapDedup, reporter) {
+    SkBitmap bitmaps[3];
+    for (int i = 0; i < 3; ++i) {
+        bitmaps[i].allocN32Pixels(20, 10);
+        bitmaps[i].eraseColor(SK_ColorBLUE);
+    }
+    *bitmaps[2].getAddr32(5, 5) = SK_ColorRED;
+
+    SkDynamicMemoryWStream stream;
+    SkAutoTUnref<SkDocument> doc(SkDocument::CreatePDF(&stream));
+    SkCanvas* canvas = doc->beginPage(100.0f, 100.0f);
+    for (int i = 0; i < 3; ++i) {
+        canvas->drawBitmap(bitmaps[i], 0, 20.0f * i);
+    }
+    doc->close();
+
+    SkAutoTUnref<SkData> pdf(stream.copyToData());
+    REPORTER_ASSERT(reporter, 2 == count_images(pdf));
+}
+
+// A streaming document writes and drops each page's images at the next
+// endPage(); drawing the same bitmap again must still reuse that image.
+DEF_TEST(PDFBitmapDedupAfterDrop, reporter) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(20, 10);
+    bitmap.eraseColor(SK_ColorBLUE);
+
+    SkDynamicMemoryWStream stream;
+    SkAutoTUnref<SkDocument> doc(SkDocument::CreateStreamingPDF(&stream));
+    for (int i = 0; i < 3; ++i) {
+        doc->beginPage(100.0f, 100.0f)->drawBitmap(bitmap, 0, 0);
+        doc->endPage();
+    }
+    doc->close();
+
+    SkAutoTUnref<SkData> pdf(stream.copyToData());
+    REPORTER_ASSERT(reporter, 1 == count_images(pdf));
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "PathOpsTestCommon.h"
+#include "SkAddIntersections.h"
+#include "SkOpEdgeBuilder.h"
+#include "SkPathOps.h"
+#include "SkPathOpsCommon.h"
+#include "SkRandom.h"
+#include "Test.h"
+
+// A grid of overlapping shapes, with enough contours for AddAllIntersectTs() to use threads.
+static void make_grid(SkPath* path) {
+    SkRandom rand;
+    for (int y = 0; y < 12; ++y) {
+        for (int x = 0; x < 12; ++x) {
+            SkScalar left = SkIntToScalar(x * 10);
+            SkScalar top = SkIntToScalar(y * 10);
+            path->moveTo(left, top + rand.nextRangeScalar(0, 4));
+            path->lineTo(left + 15, top + rand.nextRangeScalar(0, 4));
+            path->quadTo(left + 20, top + 10, left + 12, top + 16);
+            path->lineTo(left + rand.nextRangeScalar(0, 4), top + 14);
+            path->close();
+            path->moveTo(left + 5, top + 2);
+            path->quadTo(left + 14, top + 1, left + 14, top + 9);
+            path->lineTo(left + 4, top + 11);
+            path->close();
+        }
+    }
+}
+
+DEF_TEST(PathOpsAddIntersectionsThreaded, reporter) {
+    SkPath path;
+    make_grid(&path);
+
+    // The segments point into their builder, so it must outlive them.
+    SkTArray<SkOpContour> serialContours, threadedContours;
+    SkOpEdgeBuilder serialBuilder(path, serialContours);
+    SkOpEdgeBuilder threadedBuilder(path, threadedContours);
+    SkAssertResult(serialBuilder.finish());
+    SkAssertResult(threadedBuilder.finish());
+    SkTArray<SkOpContour*, true> serialList, threadedList;
+    MakeContourList(serialContours, serialList, false, false);
+    MakeContourList(threadedContours, threadedList, false, false);
+    AddAllIntersectTs(serialList, false);
+    AddAllIntersectTs(threadedList, true);
+
+    // Both must have added the same Ts, in the same order. Stop at the first count that
+    // differs, rather than read past the end of the shorter array.
+    if (serialList.count() != threadedList.count()) {
+        ERRORF(reporter, "%d contours serially, %d threaded",
+               serialList.count(), threadedList.count());
+        return;
+    }
+    for (int c = 0; c < serialList.count(); ++c) {
+        SkTArray<SkOpSegment>& serial = serialList[c]->segments();
+        SkTArray<SkOpSegment>& threaded = threadedList[c]->segments();
+        if (serial.count() != threaded.count()) {
+            ERRORF(reporter, "contour %d: %d segments serially, %d threaded",
+                   c, serial.count(), threaded.count());
+            return;
+        }
+        for (int s = 0; s < serial.count(); ++s) {
+            if (serial[s].count() != threaded[s].count()) {
+                ERRORF(reporter, "contour %d segment %d: %d spans serially, %d threaded",
+                       c, s, serial[s].count(), threaded[s].count());
+                return;
+            }
+            for (int t = 0; t < serial[s].count(); ++t) {
+                const SkOpSpan& a = serial[s].span(t);
+                const SkOpSpan& b = threaded[s].span(t);
+                REPORTER_ASSERT(reporter, a.fT == b.fT && a.fOtherT == b.fOtherT);
+                REPORTER_ASSERT(reporter, a.fPt == b.fPt);
+                REPORTER_ASSERT(reporter, a.fOtherIndex == b.fOtherIndex);
+                REPORTER_ASSERT(reporter, a.fWindValue == b.fWindValue);
+            }
+        }
+    }
+
+    SkPath result;
+    REPORTER_ASSERT(reporter, Simplify(path, &result));
+    REPORTER_ASSERT(reporter, !result.isEmpty());
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "PathOpsTestCommon.h"
+#include "SkCanvas.h"
+#include "Test.h"
+
+static int count_different_pixels(const SkPath& one, const SkPath& two) {
+    SkBitmap bits[2];
+    const SkPath* paths[] = { &one, &two };
+    for (int i = 0; i < 2; ++i) {
+        bits[i].allocN32Pixels(100, 100);
+        SkCanvas canvas(bits[i]);
+        canvas.drawColor(SK_ColorWHITE);
+        canvas.drawPath(*paths[i], SkPaint());
+    }
+    int different = 0;
+    for (int y = 0; y < 100; ++y) {
+        for (int x = 0; x < 100; ++x) {
+            different += *bits[0].getAddr32(x, y) != *bits[1].getAddr32(x, y);
+        }
+    }
+    return different;
+}
+
+DEF_TEST(PathOpsBuilderReduction, reporter) {
+    // Overlapping rects, circles and L shapes, each group apart from the others, so that the
+    // reductions both combine full ops and take the bounds-disjoint fast path.
+    SkTArray<SkPath> paths;
+    for (int y = 0; y < 4; ++y) {
+        for (int x = 0; x < 4; ++x) {
+            SkPath& rect = paths.push_back();
+            rect.addRect(x * 10.f, y * 10.f, x * 10.f + 14, y * 10.f + 12);
+            SkPath& circle = paths.push_back();
+            circle.addCircle(x * 10.f + 5, y * 10.f + 52, 6);
+            // Not convex, so resolve() cannot just simplify the sum of all the paths.
+            SkPath& ell = paths.push_back();
+            ell.addRect(x * 7.f + 55, y * 7.f + 55, x * 7.f + 63, y * 7.f + 60);
+            ell.addRect(x * 7.f + 55, y * 7.f + 55, x * 7.f + 60, y * 7.f + 63);
+        }
+    }
+
+    const SkPathOp ops[] = { kUnion_PathOp, kIntersect_PathOp };
+    for (size_t o = 0; o < SK_ARRAY_COUNT(ops); ++o) {
+        // Start with a difference so the run of ops follows an earlier result.
+        SkPath start, results[3];
+        start.addRect(0, 0, 100, 100);
+        SkPath hole;
+        hole.addRect(11, 2, 12, 4);
+        for (int reduction = 0; reduction < 3; ++reduction) {
+            SkOpBuilder builder((SkOpBuilder::Reduction) reduction);
+            if (kIntersect_PathOp == ops[o]) {
+                builder.add(start, kUnion_PathOp);
+                builder.add(hole, kDifference_PathOp);
+            }
+            for (int i = 0; i < paths.count(); ++i) {
+                // Intersecting everything leaves nothing, so only intersect two rects.
+                if (kUnion_PathOp == ops[o] || 0 == i || 3 == i) {
+                    builder.add(paths[i], ops[o]);
+                }
+            }
+            REPORTER_ASSERT(reporter, builder.resolve(&results[reduction]));
+        }
+        REPORTER_ASSERT(reporter, !results[0].isEmpty());
+        REPORTER_ASSERT(reporter, count_different_pixels(results[0], results[1]) <= 4);
+        REPORTER_ASSERT(reporter, count_different_pixels(results[0], results[2]) <= 4);
+        REPORTER_ASSERT(reporter, results[1] == results[2]);
+    }
+}
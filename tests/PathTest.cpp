@@ -11,6 +11,7 @@
 #include "SkParsePath.h"
 #include "SkPath.h"
 #include "SkPathEffect.h"
+#include "SkPathPriv.h"
 #include "SkRRect.h"
 #include "SkRandom.h"
 #include "SkReader32.h"
@@ -3527,6 +3528,61 @@ public:
             ed.resetToSize(0, 0, 0);
         }
     }
+
+    static void TestLazyTransform(skiatest::Reporter* reporter) {
+        static const int kPtCount = 40;
+
+        SkAutoTUnref<SkPathRef> src(SkNEW(SkPathRef));
+        {
+            SkPathRef::Editor ed(&src);
+            SkPoint* pts = ed.growForRepeatedVerb(SkPath::kLine_Verb, kPtCount);
+            for (int i = 0; i < kPtCount; ++i) {
+                pts[i].set(SkIntToScalar(i), SkIntToScalar(i * i % 7));
+            }
+        }
+
+        SkMatrix scale;
+        scale.setScale(2, 3);
+        scale.postTranslate(5, -1);
+        SkAutoTUnref<SkPathRef> dst(SkRef(src.get()));
+        SkPathRef::CreateTransformedCopy(&dst, *src, scale);
+
+        // The bounds come from src's, without mapping the points.
+        REPORTER_ASSERT(reporter, dst->fLazy && dst->hasComputedBounds());
+        REPORTER_ASSERT(reporter, kPtCount == dst->countPoints());
+        REPORTER_ASSERT(reporter, SkPath::kLine_SegmentMask == dst->getSegmentMasks());
+        SkRect expected;
+        scale.mapRect(&expected, src->getBounds());
+        REPORTER_ASSERT(reporter, dst->getBounds() == expected);
+        REPORTER_ASSERT(reporter, NULL == dst->fPoints);
+
+        // A transform of a transform views the original source, through the concatenation.
+        SkMatrix rotate;
+        rotate.setRotate(30);
+        SkAutoTUnref<SkPathRef> twice(SkPathRef::CreateEmpty());
+        SkPathRef::CreateTransformedCopy(&twice, *dst, rotate);
+        REPORTER_ASSERT(reporter, twice->fLazy && !twice->hasComputedBounds());
+
+        SkMatrix concat;
+        concat.setConcat(rotate, scale);
+        for (int i = 0; i < kPtCount; ++i) {
+            REPORTER_ASSERT(reporter, dst->atPoint(i) == scale.mapXY(src->atPoint(i).fX,
+                                                                     src->atPoint(i).fY));
+            REPORTER_ASSERT(reporter, twice->atPoint(i) == concat.mapXY(src->atPoint(i).fX,
+                                                                        src->atPoint(i).fY));
+            REPORTER_ASSERT(reporter, src->atVerb(i) == dst->atVerb(i));
+        }
+
+        // Editing a transformed copy leaves its source alone.
+        {
+            SkPathRef::Editor ed(&dst);
+            REPORTER_ASSERT(reporter, NULL == dst->fLazy);
+            ed.growForVerb(SkPath::kLine_Verb)->set(-100, -100);
+        }
+        REPORTER_ASSERT(reporter, kPtCount + 1 == dst->countPoints());
+        REPORTER_ASSERT(reporter, kPtCount == src->countPoints());
+        REPORTER_ASSERT(reporter, twice->atPoint(1) == concat.mapXY(1, 1));
+    }
 };
 
 static void test_operatorEqual(skiatest::Reporter* reporter) {
@@ -3766,9 +3822,44 @@ DEF_TEST(Paths, reporter) {
     test_contains(reporter);
     PathTest_Private::TestPathTo(reporter);
     PathRefTest_Private::TestPathRef(reporter);
+    PathRefTest_Private::TestLazyTransform(reporter);
     test_dump(reporter);
     test_path_crbug389050(reporter);
     test_path_crbugskia2820(reporter);
     test_skbug_3469(reporter);
     test_skbug_3239(reporter);
 }
+
+namespace {
+class CountingListener : public SkPathRef::GenIDChangeListener {
+public:
+    CountingListener(int id, int* count) : fID(id), fCount(count) {}
+
+private:
+    int fID;
+    int* fCount;
+
+    void onChange() override { ++*fCount; }
+    const void* kind() const override {
+        static const char kKind = 0;
+        return &kKind;
+    }
+    bool equals(const GenIDChangeListener& other) const override {
+        return static_cast<const CountingListener&>(other).fID == fID;
+    }
+};
+}  // namespace
+
+// Equal listeners are only added once; unequal ones are all called.
+DEF_TEST(PathRef_GenIDChangeListeners, reporter) {
+    SkPath path;
+    path.moveTo(0, 0);
+    path.lineTo(10, 10);
+
+    int count = 0;
+    SkPathPriv::AddGenIDChangeListener(path, SkNEW_ARGS(CountingListener, (1, &count)));
+    SkPathPriv::AddGenIDChangeListener(path, SkNEW_ARGS(CountingListener, (1, &count)));
+    SkPathPriv::AddGenIDChangeListener(path, SkNEW_ARGS(CountingListener, (2, &count)));
+    path.lineTo(20, 0);
+    REPORTER_ASSERT(reporter, 2 == count);
+}
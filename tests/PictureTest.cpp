@@ -1119,7 +1119,7 @@ static void test_bytes_used(skiatest::Reporter* reporter) {
 
     // Protect against any unintentional bloat.
     size_t approxUsed = SkPictureUtils::ApproximateBytesUsed(empty.get());
-    REPORTER_ASSERT(reporter, approxUsed <= 136);
+    REPORTER_ASSERT(reporter, approxUsed <= 144);
 
     // Sanity check of nested SkPictures.
     SkPictureRecorder r2;
@@ -1311,3 +1311,206 @@ DEF_TEST(Picture_BitmapLeak, r) {
     REPORTER_ASSERT(r, mut.pixelRef()->unique());
     REPORTER_ASSERT(r, immut.pixelRef()->unique());
 }
+
+static void draw_for_data_test(SkCanvas* canvas, const SkBitmap& bm) {
+    SkPath path;
+    path.moveTo(10, 10);
+    path.cubicTo(100, 0, 0, 100, 90, 90);
+    path.close();
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(SK_ColorRED);
+    canvas->drawPath(path, paint);
+
+    canvas->drawBitmap(bm, 20, 30);
+
+    SkPictureRecorder recorder;
+    SkCanvas* nested = recorder.beginRecording(100, 100);
+    path.reset();
+    path.addCircle(50, 50, 30);
+    paint.setColor(SK_ColorGREEN);
+    nested->drawPath(path, paint);
+    SkAutoTUnref<SkPicture> nestedPicture(recorder.endRecording());
+    canvas->drawPicture(nestedPicture);
+}
+
+static void check_same_pixels(skiatest::Reporter* r, const SkBitmap& expected,
+                              const SkPicture* picture) {
+    REPORTER_ASSERT(r, picture);
+    if (!picture) {
+        return;
+    }
+    SkBitmap actual;
+    actual.allocN32Pixels(expected.width(), expected.height());
+    actual.eraseColor(SK_ColorWHITE);
+    SkCanvas canvas(actual);
+    canvas.drawPicture(picture);
+    REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                   expected.getSize()));
+}
+
+DEF_TEST(Picture_CreateFromData, r) {
+    SkBitmap bm;
+    bm.allocN32Pixels(32, 32);
+    SkRandom rand;
+    for (int y = 0; y < bm.height(); ++y) {
+        for (int x = 0; x < bm.width(); ++x) {
+            *bm.getAddr32(x, y) = rand.nextU() | 0xFF000000;
+        }
+    }
+    bm.setImmutable();
+
+    SkPictureRecorder recorder;
+    draw_for_data_test(recorder.beginRecording(100, 100), bm);
+    SkAutoTUnref<SkPicture> picture(recorder.endRecording());
+
+    SkBitmap expected;
+    expected.allocN32Pixels(100, 100);
+    expected.eraseColor(SK_ColorWHITE);
+    SkCanvas canvas(expected);
+    draw_for_data_test(&canvas, bm);
+
+    SkAutoDataUnref data;
+    {
+        SkDynamicMemoryWStream stream;
+        picture->serialize(&stream);
+        data.reset(stream.copyToData());
+    }
+    REPORTER_ASSERT(r, data->unique());
+
+    // Reading from a stream copies everything out of data.
+    SkAutoTUnref<SkPicture> fromStream;
+    {
+        SkMemoryStream memStream(data);
+        fromStream.reset(SkPicture::CreateFromStream(&memStream));
+    }
+    check_same_pixels(r, expected, fromStream);
+    REPORTER_ASSERT(r, data->unique());
+
+    // Reading from data shares it for the bitmap's pixels.
+    {
+        SkAutoTUnref<SkPicture> fromData(SkPicture::CreateFromData(data));
+        check_same_pixels(r, expected, fromData);
+        REPORTER_ASSERT(r, !data->unique());
+    }
+    REPORTER_ASSERT(r, data->unique());
+
+    // Data that isn't 4-byte aligned is read correctly, if by copying.
+    SkAutoTMalloc<char> storage(data->size() + 1);
+    memcpy(storage.get() + 1, data->data(), data->size());
+    SkAutoDataUnref misaligned(SkData::NewWithoutCopy(storage.get() + 1, data->size()));
+    {
+        SkAutoTUnref<SkPicture> fromData(SkPicture::CreateFromData(misaligned));
+        check_same_pixels(r, expected, fromData);
+        REPORTER_ASSERT(r, misaligned->unique());
+    }
+}
+
+// Counts the draws a picture makes, skipping those it nooped.
+class DrawCountingCanvas : public SkCanvas {
+public:
+    DrawCountingCanvas(int width, int height) : INHERITED(width, height), fDrawCount(0) {}
+
+    void onDrawPaint(const SkPaint& paint) override {
+        fDrawCount++;
+        this->INHERITED::onDrawPaint(paint);
+    }
+    void onDrawRect(const SkRect& rect, const SkPaint& paint) override {
+        fDrawCount++;
+        this->INHERITED::onDrawRect(rect, paint);
+    }
+    void onDrawOval(const SkRect& oval, const SkPaint& paint) override {
+        fDrawCount++;
+        this->INHERITED::onDrawOval(oval, paint);
+    }
+
+    int drawCount() const { return fDrawCount; }
+
+private:
+    int fDrawCount;
+
+    typedef SkCanvas INHERITED;
+};
+
+static const int kOccludingSceneDraws = 10;
+
+static void draw_occluding_scene(SkCanvas* canvas) {
+    SkPaint aliased, antialiased;
+    antialiased.setAntiAlias(true);
+
+    // A background painted twice, on either side of a save/restore: only the second one matters.
+    aliased.setColor(SK_ColorRED);
+    canvas->drawRect(SkRect::MakeXYWH(10.3f, 10.6f, 80, 80), aliased);
+    canvas->save();
+    canvas->rotate(10);
+    antialiased.setColor(SK_ColorGRAY);
+    canvas->drawRect(SkRect::MakeXYWH(30, 0, 50, 20), antialiased);
+    canvas->restore();
+    aliased.setColor(SK_ColorGREEN);
+    canvas->drawRect(SkRect::MakeXYWH(10.3f, 10.6f, 80, 80), aliased);
+
+    // Anti-aliased draws covered with room to spare.
+    antialiased.setColor(SK_ColorBLUE);
+    canvas->drawOval(SkRect::MakeXYWH(20.5f, 20.25f, 30, 20), antialiased);
+    antialiased.setColor(SK_ColorYELLOW);
+    canvas->drawRect(SkRect::MakeXYWH(20.25f, 50.5f, 30, 20), antialiased);
+    aliased.setColor(SK_ColorCYAN);
+    canvas->drawRect(SkRect::MakeXYWH(18, 18, 35, 55), aliased);
+
+    // An anti-aliased draw covered in the recording's pixels, but not with room to spare.
+    antialiased.setColor(SK_ColorMAGENTA);
+    canvas->drawRect(SkRect::MakeXYWH(60.5f, 20.5f, 20, 20), antialiased);
+    aliased.setColor(SK_ColorBLACK);
+    canvas->drawRect(SkRect::MakeXYWH(60, 20, 21, 21), aliased);
+
+    // A paint filling a clip covers what was drawn under that clip.
+    canvas->save();
+    canvas->clipRect(SkRect::MakeXYWH(55.5f, 55.5f, 30, 30));
+    aliased.setColor(SK_ColorRED);
+    canvas->drawRect(SkRect::MakeXYWH(50, 50, 40, 40), aliased);
+    aliased.setColor(SK_ColorBLUE);
+    canvas->drawPaint(aliased);
+    canvas->restore();
+}
+
+static SkPicture* record_occluding_scene(uint32_t flags) {
+    SkPictureRecorder recorder;
+    draw_occluding_scene(recorder.beginRecording(100, 100, NULL, flags));
+    return recorder.endRecording();
+}
+
+static void draw_picture_to(SkBitmap* bitmap, const SkPicture* picture, const SkMatrix& matrix) {
+    bitmap->allocN32Pixels(100, 100);
+    bitmap->eraseColor(SK_ColorWHITE);
+    SkCanvas canvas(*bitmap);
+    canvas.drawPicture(picture, &matrix, NULL);
+}
+
+// Nooping occluded draws must not change a picture's pixels under matrices that don't scale it
+// down, though they move its edges onto different pixels than it was recorded with.
+DEF_TEST(Picture_NoopOccludedDraws, r) {
+    SkAutoTUnref<SkPicture> plain(record_occluding_scene(0));
+    SkAutoTUnref<SkPicture> nooped(record_occluding_scene(
+            SkPictureRecorder::kNoopOccludedDraws_RecordFlag));
+
+    DrawCountingCanvas plainCounter(100, 100), noopedCounter(100, 100);
+    plain->playback(&plainCounter);
+    nooped->playback(&noopedCounter);
+    REPORTER_ASSERT(r, kOccludingSceneDraws == plainCounter.drawCount());
+    REPORTER_ASSERT(r, kOccludingSceneDraws - 4 == noopedCounter.drawCount());
+
+    SkMatrix matrices[4];
+    matrices[0].setIdentity();
+    matrices[1].setTranslate(0.3f, 0.7f);
+    matrices[2].setRotate(30, 50, 50);
+    matrices[3].setScale(1.5f, 1.25f);
+    matrices[3].postTranslate(-20.4f, -10.1f);
+    for (size_t i = 0; i < SK_ARRAY_COUNT(matrices); i++) {
+        SkBitmap expected, actual;
+        draw_picture_to(&expected, plain, matrices[i]);
+        draw_picture_to(&actual, nooped, matrices[i]);
+        if (memcmp(expected.getPixels(), actual.getPixels(), expected.getSize())) {
+            ERRORF(r, "Nooping occluded draws changed pixels under matrix %d", SkToInt(i));
+        }
+    }
+}
@@ -89,3 +89,70 @@ DEF_TEST(RTree, reporter) {
                                   expectedDepthMax >= rtree.getDepth());
     }
 }
+
+DEF_TEST(RTree_Hilbert, reporter) {
+    SkRandom rand;
+    SkAutoTMalloc<SkRect> rects(NUM_RECTS);
+    for (size_t i = 0; i < NUM_ITERATIONS; ++i) {
+        SkRTree rtree(1, SkRTreeFactory::kHilbert_BulkLoad);
+
+        for (int j = 0; j < NUM_RECTS; j++) {
+            rects[j] = random_rect(rand);
+        }
+        rtree.insert(rects.get(), NUM_RECTS);
+
+        // verify_query() checks the hits come back in op order, even though they're not stored so.
+        run_queries(reporter, rand, rects, rtree);
+        REPORTER_ASSERT(reporter, NUM_RECTS == rtree.getCount());
+        // Packing fills every node but the last at each level.
+        REPORTER_ASSERT(reporter, rtree.getFill() > 0.8f);
+    }
+}
+
+DEF_TEST(RTree_Update, reporter) {
+    SkRandom rand;
+    SkAutoTMalloc<SkRect> rects(NUM_RECTS);
+    for (size_t i = 0; i < NUM_ITERATIONS / 10; ++i) {
+        for (int j = 0; j < NUM_RECTS; j++) {
+            rects[j] = random_rect(rand);
+        }
+
+        // Build half the tree in bulk and the rest one at a time, or all of it one at a time.
+        SkRTree rtree;
+        int bulk = (i % 2) ? NUM_RECTS / 2 : 0;
+        if (bulk) {
+            rtree.insert(rects.get(), bulk);
+        }
+        for (int j = bulk; j < NUM_RECTS; j++) {
+            rtree.insert(j, rects[j]);
+        }
+        REPORTER_ASSERT(reporter, NUM_RECTS == rtree.getCount());
+        run_queries(reporter, rand, rects, rtree);
+
+        // Move rects around.
+        for (int j = 0; j < NUM_RECTS; j++) {
+            int index = rand.nextULessThan(NUM_RECTS);
+            REPORTER_ASSERT(reporter, rtree.remove(index, rects[index]));
+            REPORTER_ASSERT(reporter, !rtree.remove(index, rects[index]));
+            rects[index] = random_rect(rand);
+            rtree.insert(index, rects[index]);
+        }
+        REPORTER_ASSERT(reporter, NUM_RECTS == rtree.getCount());
+        REPORTER_ASSERT(reporter, rtree.getDepth() <= 4);
+        REPORTER_ASSERT(reporter, rtree.getFill() > 0.4f);
+        run_queries(reporter, rand, rects, rtree);
+
+        // Remove them all.
+        for (int j = 0; j < NUM_RECTS; j++) {
+            REPORTER_ASSERT(reporter, rtree.remove(j, rects[j]));
+            REPORTER_ASSERT(reporter, NUM_RECTS - j - 1 == rtree.getCount());
+        }
+        REPORTER_ASSERT(reporter, 0 == rtree.getDepth());
+        REPORTER_ASSERT(reporter, rtree.getRootBound().isEmpty());
+
+        // The tree can start over.
+        rtree.insert(7, rects[7]);
+        REPORTER_ASSERT(reporter, 1 == rtree.getCount());
+        REPORTER_ASSERT(reporter, rtree.getRootBound() == rects[7]);
+    }
+}
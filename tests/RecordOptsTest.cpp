@@ -10,6 +10,7 @@
 
 #include "SkColorFilter.h"
 #include "SkRecord.h"
+#include "SkRecordDraw.h"
 #include "SkRecordOpts.h"
 #include "SkRecorder.h"
 #include "SkRecords.h"
@@ -170,7 +171,12 @@ DEF_TEST(RecordOpts_NoopSaveLayerDrawRestore, r) {
 
     const SkRecords::DrawRect* drawRect = assert_type<SkRecords::DrawRect>(r, record, 16);
     REPORTER_ASSERT(r, drawRect != NULL);
-    REPORTER_ASSERT(r, drawRect->paint.getColor() == 0x03020202);
+    REPORTER_ASSERT(r, drawRect->paint->getColor() == 0x03020202);
+
+    // Folding the alpha must not change the other draws sharing that paint.
+    const SkRecords::DrawRect* otherDrawRect = assert_type<SkRecords::DrawRect>(r, record, 10);
+    REPORTER_ASSERT(r, otherDrawRect != NULL);
+    REPORTER_ASSERT(r, otherDrawRect->paint->getColor() == 0xFF020202);
 }
 
 static void assert_merge_svg_opacity_and_filter_layers(skiatest::Reporter* r,
@@ -308,3 +314,181 @@ DEF_TEST(RecordOpts_MergeSvgOpacityAndFilterLayers, r) {
     assert_type<SkRecords::Restore>(r, record, index + 3);
     index += 4;
 }
+
+DEF_TEST(RecordOpts_NoopOccludedDraws, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkPaint opaque, translucent, antialiased, stroked, srcOver, dstOver;
+    opaque.setColor(0xFF020202);
+    translucent.setColor(0x80020202);
+    antialiased.setColor(0xFF020202);
+    antialiased.setAntiAlias(true);
+    stroked.setColor(0xFF020202);
+    stroked.setStyle(SkPaint::kStroke_Style);
+    stroked.setStrokeWidth(4);
+    srcOver.setColor(0xFF020202);
+    srcOver.setXfermodeMode(SkXfermode::kSrcOver_Mode);
+    dstOver.setColor(0xFF020202);
+    dstOver.setXfermodeMode(SkXfermode::kDstOver_Mode);
+
+    SkRect background = SkRect::MakeWH(500, 500);
+
+    // The same background painted three times: only the last one matters.
+    recorder.drawRect(background, opaque);                          // 0: occluded
+    recorder.drawRect(background, translucent);                     // 1: occluded
+    recorder.drawRect(background, srcOver);                         // 2
+
+    // Covered across a save/restore, which returns to the same matrix and clip.
+    recorder.drawOval(SkRect::MakeXYWH(10, 10, 50, 50), stroked);      // 3: occluded
+    recorder.save();                                                   // 4
+        recorder.translate(10, 10);                                    // 5
+        recorder.drawRect(SkRect::MakeXYWH(10, 10, 20, 20), opaque);   // 6: other matrix
+    recorder.restore();                                                // 7
+    recorder.drawRect(SkRect::MakeXYWH(5, 5, 100, 100), opaque);       // 8
+
+    // A cover under another clip doesn't count either.
+    recorder.drawRect(SkRect::MakeXYWH(200, 0, 10, 10), opaque);       // 9
+    recorder.save();                                                   // 10
+        recorder.clipRect(SkRect::MakeXYWH(200, 0, 5, 5));             // 11
+        recorder.drawRect(SkRect::MakeXYWH(190, -10, 30, 30), opaque); // 12
+    recorder.restore();                                                // 13
+
+    // Not covered by any of these.
+    recorder.drawRect(SkRect::MakeWH(100, 100), opaque);               // 14
+    recorder.drawRect(SkRect::MakeWH(100, 100), translucent);          // 15: translucent
+    recorder.drawRect(SkRect::MakeWH(100, 100), stroked);              // 16: only the outline
+    recorder.drawRect(SkRect::MakeWH(100, 100), dstOver);              // 17: keeps the dst
+    recorder.drawRect(SkRect::MakeWH(99.5f, 99.5f), antialiased);      // 18: partial edge pixels
+
+    // Unless both are aliased fills of the same rect, covers must reach two pixels further.
+    recorder.drawRect(SkRect::MakeXYWH(400, 0, 50, 50), antialiased);  // 19: occluded
+    recorder.drawRect(SkRect::MakeXYWH(400, 60, 50, 50), opaque);      // 20
+    recorder.drawRect(SkRect::MakeXYWH(398, -2, 54, 54), opaque);      // 21
+    recorder.drawRect(SkRect::MakeXYWH(399, 59, 52, 52), antialiased); // 22
+
+    // A clip limits what a draw covers.
+    recorder.drawRect(SkRect::MakeXYWH(200, 200, 100, 100), opaque);   // 23
+    recorder.save();                                                   // 24
+        recorder.clipRect(SkRect::MakeXYWH(200, 200, 50, 50));         // 25
+        recorder.drawRect(SkRect::MakeXYWH(210, 210, 10, 10), opaque); // 26: occluded
+        recorder.drawPaint(opaque);                                    // 27
+    recorder.restore();                                                // 28
+
+    // Nothing covers the partial pixels at an anti-aliased clip's edge.
+    recorder.save();                                                   // 29
+        recorder.clipRect(SkRect::MakeXYWH(200, 200, 50, 50),
+                          SkRegion::kIntersect_Op, true);              // 30
+        recorder.drawRect(SkRect::MakeXYWH(210, 210, 10, 10), opaque); // 31
+        recorder.drawPaint(opaque);                                    // 32
+    recorder.restore();                                                // 33
+
+    // Draws in a layer can't occlude those outside it.
+    recorder.drawRect(SkRect::MakeXYWH(300, 300, 10, 10), opaque);     // 34
+    recorder.saveLayer(NULL, &translucent);                            // 35
+        recorder.drawRect(SkRect::MakeXYWH(300, 300, 10, 10), opaque); // 36: occluded
+        recorder.drawRect(SkRect::MakeXYWH(290, 290, 30, 30), opaque); // 37
+    recorder.restore();                                                // 38
+
+    SkRecordNoopOccludedDraws(&record);
+    const unsigned occluded[] = { 0, 1, 3, 19, 26, 36 };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(occluded); i++) {
+        assert_type<SkRecords::NoOp>(r, record, occluded[i]);
+    }
+    REPORTER_ASSERT(r, SK_ARRAY_COUNT(occluded) ==
+                       (size_t)count_instances_of_type<SkRecords::NoOp>(record));
+
+    // An opaque draw filling an unclipped canvas covers every draw made under the same matrix
+    // and clip, outside layers.
+    recorder.drawColor(SK_ColorWHITE, SkXfermode::kSrc_Mode);          // 39
+    SkRecordNoopOccludedDraws(&record);
+    const unsigned keptRects[] = { 6, 12, 31, 37 }, keptPaints[] = { 27, 32, 39 };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(keptRects); i++) {
+        assert_type<SkRecords::DrawRect>(r, record, keptRects[i]);
+    }
+    for (size_t i = 0; i < SK_ARRAY_COUNT(keptPaints); i++) {
+        assert_type<SkRecords::DrawPaint>(r, record, keptPaints[i]);
+    }
+    REPORTER_ASSERT(r, 3 == count_instances_of_type<SkRecords::DrawPaint>(record));
+    REPORTER_ASSERT(r, 4 == count_instances_of_type<SkRecords::DrawRect>(record));
+}
+
+DEF_TEST(RecordOpts_BatchDraws, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkPaint red, blue;
+    red.setColor(SK_ColorRED);
+    blue.setColor(SK_ColorBLUE);
+
+    SkBitmap sheet, other;
+    sheet.allocN32Pixels(64, 64);
+    sheet.eraseColor(SK_ColorGREEN);
+    other.allocN32Pixels(64, 64);
+    other.eraseColor(SK_ColorGREEN);
+    // Recording copies mutable bitmaps, so only immutable ones are recognized as the same.
+    sheet.setImmutable();
+    other.setImmutable();
+    const SkRect sprite = SkRect::MakeWH(16, 16);
+
+    recorder.drawRect(SkRect::MakeXYWH( 0, 0, 10, 10), red);               // 0: batch of 3
+    recorder.drawRect(SkRect::MakeXYWH(20, 0, 10, 10), red);               // 1
+    recorder.drawRect(SkRect::MakeXYWH(40, 0, 10, 10), red);               // 2
+    recorder.drawRect(SkRect::MakeXYWH(60, 0, 10, 10), blue);              // 3: new paint
+    recorder.translate(5, 5);                                              // 4
+    recorder.drawRect(SkRect::MakeXYWH(80, 0, 10, 10), blue);              // 5: new matrix
+
+    recorder.drawBitmapRectToRect(sheet, &sprite, SkRect::MakeWH(16, 16)); // 6: batch of 3
+    recorder.drawBitmapRectToRect(sheet, &sprite, SkRect::MakeXYWH(16, 0, 16, 16));  // 7
+    recorder.drawBitmapRectToRect(sheet, NULL, SkRect::MakeXYWH(32, 0, 64, 64));     // 8
+    recorder.drawBitmapRectToRect(other, &sprite, SkRect::MakeWH(16, 16)); // 9: new bitmap
+    recorder.drawBitmapRectToRect(other, &sprite, SkRect::MakeWH(16, 16), &red);     // 10
+
+    SkRecordBatchDraws(&record);
+
+    const SkRecords::DrawRects* rects = assert_type<SkRecords::DrawRects>(r, record, 0);
+    REPORTER_ASSERT(r, 3 == rects->count);
+    REPORTER_ASSERT(r, SkRect::MakeXYWH(40, 0, 10, 10) == rects->rects[2]);
+    assert_type<SkRecords::NoOp>(r, record, 1);
+    assert_type<SkRecords::NoOp>(r, record, 2);
+    assert_type<SkRecords::DrawRect>(r, record, 3);
+    assert_type<SkRecords::DrawRect>(r, record, 5);
+
+    const SkRecords::DrawBitmapRects* sprites =
+            assert_type<SkRecords::DrawBitmapRects>(r, record, 6);
+    REPORTER_ASSERT(r, 3 == sprites->count);
+    REPORTER_ASSERT(r, NULL == sprites->paint);
+    REPORTER_ASSERT(r, SkRect::MakeWH(64, 64) == sprites->src[2]);
+    REPORTER_ASSERT(r, SkRect::MakeXYWH(16, 0, 16, 16) == sprites->dst[1]);
+    assert_type<SkRecords::NoOp>(r, record, 7);
+    assert_type<SkRecords::NoOp>(r, record, 8);
+    assert_type<SkRecords::DrawBitmapRectToRect>(r, record, 9);
+    assert_type<SkRecords::DrawBitmapRectToRect>(r, record, 10);
+
+    // Batching doesn't change what's drawn.
+    SkBitmap batched, unbatched;
+    batched.allocN32Pixels(W, H);
+    unbatched.allocN32Pixels(W, H);
+    batched.eraseColor(SK_ColorWHITE);
+    unbatched.eraseColor(SK_ColorWHITE);
+    {
+        SkCanvas canvas(batched);
+        SkRecordDraw(record, &canvas, NULL, NULL, 0, NULL, NULL);
+    }
+    {
+        SkCanvas canvas(unbatched);
+        canvas.drawRect(SkRect::MakeXYWH( 0, 0, 10, 10), red);
+        canvas.drawRect(SkRect::MakeXYWH(20, 0, 10, 10), red);
+        canvas.drawRect(SkRect::MakeXYWH(40, 0, 10, 10), red);
+        canvas.drawRect(SkRect::MakeXYWH(60, 0, 10, 10), blue);
+        canvas.translate(5, 5);
+        canvas.drawRect(SkRect::MakeXYWH(80, 0, 10, 10), blue);
+        canvas.drawBitmapRectToRect(sheet, &sprite, SkRect::MakeWH(16, 16));
+        canvas.drawBitmapRectToRect(sheet, &sprite, SkRect::MakeXYWH(16, 0, 16, 16));
+        canvas.drawBitmapRectToRect(sheet, NULL, SkRect::MakeXYWH(32, 0, 64, 64));
+        canvas.drawBitmapRectToRect(other, &sprite, SkRect::MakeWH(16, 16));
+        canvas.drawBitmapRectToRect(other, &sprite, SkRect::MakeWH(16, 16), &red);
+    }
+    REPORTER_ASSERT(r, 0 == memcmp(batched.getPixels(), unbatched.getPixels(),
+                                   batched.getSize()));
+}
@@ -6,6 +6,7 @@
  */
 
 #include "Test.h"
+#include "RecordTestUtils.h"
 
 #include "SkPictureRecorder.h"
 #include "SkRecord.h"
@@ -50,6 +51,38 @@ DEF_TEST(Recorder, r) {
     REPORTER_ASSERT(r, 1 == tally.count<SkRecords::DrawRect>());
 }
 
+// Equal paints and matrices should be stored once, and shared by the commands using them.
+DEF_TEST(Recorder_SharesPaintsAndMatrices, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, 1920, 1080);
+
+    SkPaint red, blue;
+    red.setColor(SK_ColorRED);
+    blue.setColor(SK_ColorBLUE);
+
+    recorder.drawRect(SkRect::MakeWH(10, 10), red);
+    recorder.drawOval(SkRect::MakeWH(20, 20), blue);
+    recorder.translate(5, 5);
+    recorder.drawRect(SkRect::MakeWH(30, 30), SkPaint(red));
+    recorder.setMatrix(SkMatrix::I());
+    recorder.setMatrix(SkMatrix::I());
+
+    const SkRecords::DrawRect* first = assert_type<SkRecords::DrawRect>(r, record, 0);
+    const SkRecords::DrawOval* second = assert_type<SkRecords::DrawOval>(r, record, 1);
+    const SkRecords::DrawRect* third = assert_type<SkRecords::DrawRect>(r, record, 3);
+    REPORTER_ASSERT(r, first->paint.get() == third->paint.get());
+    REPORTER_ASSERT(r, first->paint.get() != second->paint.get());
+    REPORTER_ASSERT(r, SK_ColorRED == first->paint->getColor());
+    REPORTER_ASSERT(r, SK_ColorBLUE == second->paint->getColor());
+
+    const SkRecords::SetMatrix* translate = assert_type<SkRecords::SetMatrix>(r, record, 2);
+    const SkRecords::SetMatrix* identity1 = assert_type<SkRecords::SetMatrix>(r, record, 4);
+    const SkRecords::SetMatrix* identity2 = assert_type<SkRecords::SetMatrix>(r, record, 5);
+    REPORTER_ASSERT(r, identity1->matrix.get() == identity2->matrix.get());
+    REPORTER_ASSERT(r, translate->matrix.get() != identity1->matrix.get());
+    REPORTER_ASSERT(r, translate->matrix->getTranslateX() == 5);
+}
+
 // All of Skia will work fine without support for comment groups, but
 // Chrome's inspector can break.  This serves as a simple regression test.
 DEF_TEST(Recorder_CommentGroups, r) {
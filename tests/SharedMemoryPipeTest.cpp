@@ -0,0 +1,83 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkGPipe.h"
+#include "SkSharedMemoryPipe.h"
+#include "SkString.h"
+#include "Test.h"
+
+#include <unistd.h>
+
+static void draw_frame(SkCanvas* canvas, const SkBitmap& shared, const SkBitmap& unshared,
+                       int i) {
+    SkPaint paint;
+    paint.setColor(0xFF000000 | (i * 0x10305));
+    canvas->drawRect(SkRect::MakeXYWH(SkIntToScalar(i % 7 * 10), SkIntToScalar(i % 5 * 10),
+                                      30, 30), paint);
+    canvas->drawBitmap(shared, SkIntToScalar(i % 3 * 20), 0);
+    canvas->drawBitmap(unshared, 0, SkIntToScalar(i % 4 * 20));
+}
+
+// Pipes frames through a small ring buffer, so that it wraps around, with a bitmap in
+// shared pixels (too big to fit through the ring) and one that has to be flattened into it.
+DEF_TEST(SharedMemoryPipe, reporter) {
+    SkString name;
+    name.printf("/skia-SharedMemoryPipeTest-%d", getpid());
+    SkAutoTDelete<SkSharedMemoryPipeController> controller(
+            SkSharedMemoryPipeController::Create(name.c_str(), 64 * 1024, 512 * 1024));
+    REPORTER_ASSERT(reporter, controller.get());
+    if (!controller.get()) {
+        return;
+    }
+
+    SkBitmap shared;
+    REPORTER_ASSERT(reporter, controller->allocSharedPixels(&shared,
+                                                            SkImageInfo::MakeN32Premul(200, 200)));
+    shared.eraseColor(0x80FF0000);
+    SkBitmap unshared;
+    unshared.allocN32Pixels(64, 64);
+    unshared.eraseColor(0xFF00FF00);
+
+    SkBitmap expected;
+    expected.allocN32Pixels(128, 128);
+    expected.eraseColor(SK_ColorWHITE);
+    SkBitmap actual;
+    actual.allocN32Pixels(128, 128);
+    actual.eraseColor(SK_ColorWHITE);
+    SkCanvas expectedCanvas(expected);
+    SkCanvas actualCanvas(actual);
+
+    SkAutoTDelete<SkSharedMemoryPipeReader> reader(
+            SkSharedMemoryPipeReader::Open(name.c_str(), &actualCanvas));
+    REPORTER_ASSERT(reporter, reader.get());
+    if (!reader.get()) {
+        return;
+    }
+
+    SkGPipeWriter writer;
+    SkCanvas* pipeCanvas = writer.startRecording(controller.get(),
+                                                 SkGPipeWriter::kCrossProcess_Flag, 128, 128);
+    for (int i = 0; i < 50; ++i) {
+        if (i % 10 == 5) {
+            // New contents, which each need sending again, once the reader has drawn the old.
+            controller->waitForReader();
+            shared.eraseColor(0x80000000 | (i * 0x40404));
+            unshared.eraseColor(0xFF000000 | (i * 0x30201));
+        }
+        draw_frame(pipeCanvas, shared, unshared, i);
+        writer.flushRecording(false);
+        REPORTER_ASSERT(reporter, SkGPipeReader::kEOF_Status == reader->playbackAvailable());
+
+        draw_frame(&expectedCanvas, shared, unshared, i);
+        REPORTER_ASSERT(reporter, !memcmp(expected.getPixels(), actual.getPixels(),
+                                          expected.getSize()));
+    }
+    writer.endRecording();
+    REPORTER_ASSERT(reporter, SkGPipeReader::kDone_Status == reader->playbackAvailable());
+}
@@ -85,6 +85,11 @@ DEF_TEST(Sk4x_Arith, r) {
     ASSERT_EQ(Sk4i(4,6,8,10),    Sk4i(1,2,3,4) + Sk4i(3,4,5,6));
     ASSERT_EQ(Sk4i(-2,-2,-2,-2), Sk4i(1,2,3,4) - Sk4i(3,4,5,6));
     ASSERT_EQ(Sk4i(3,8,15,24),   Sk4i(1,2,3,4) * Sk4i(3,4,5,6));
+
+    ASSERT_EQ(Sk4i(4,8,2,-2),         Sk4i(2,4,1,-1).shiftLeft(1));
+    ASSERT_EQ(Sk4i(0,0x100,0,-256),   Sk4i(0x01000000,1,0,-1).shiftLeft(8));
+    ASSERT_EQ(Sk4i(1,2,0,0x7FFFFFFF), Sk4i(2,4,1,-1).shiftRight(1));
+    ASSERT_EQ(Sk4i(0,0,0,0xFF),       Sk4i(0x00FFFFFF,1,0,-1).shiftRight(24));
 }
 
 DEF_TEST(Sk4x_ExplicitPromotion, r) {
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkAtomics.h"
+#include "SkTaskGroup.h"
+#include "Test.h"
+
+static void inc(int32_t* x) {
+    sk_atomic_inc(x);
+}
+
+DEF_TEST(SkTaskGroup_AddAndBatch, r) {
+    int32_t count = 0;
+
+    SkTaskGroup tg;
+    for (int i = 0; i < 1000; i++) {
+        tg.add(inc, &count);
+    }
+    tg.wait();
+    REPORTER_ASSERT(r, 1000 == count);
+
+    // Reusing the group after wait() is fine.
+    int32_t batch[100];
+    for (int i = 0; i < 100; i++) {
+        batch[i] = 0;
+    }
+    tg.batch(inc, batch, 100);
+    tg.wait();
+    for (int i = 0; i < 100; i++) {
+        REPORTER_ASSERT(r, 1 == batch[i]);
+    }
+}
+
+namespace {
+
+struct Node {
+    int32_t* count;
+    int      depth;
+};
+
+// Each Node spawns four child Nodes in its own SkTaskGroup and waits on them from inside a task.
+void spawn(Node* node) {
+    sk_atomic_inc(node->count);
+    if (node->depth == 0) {
+        return;
+    }
+    Node kids[4];
+    for (int i = 0; i < 4; i++) {
+        kids[i].count = node->count;
+        kids[i].depth = node->depth - 1;
+    }
+    SkTaskGroup tg;
+    tg.batch(spawn, kids, 3);
+    tg.add(spawn, &kids[3]);
+    tg.wait();
+}
+
+}  // namespace
+
+DEF_TEST(SkTaskGroup_Nested, r) {
+    int32_t count = 0;
+    Node root = { &count, 5 };
+
+    SkTaskGroup tg;
+    tg.add(spawn, &root);
+    tg.wait();
+
+    // 1 + 4 + 16 + 64 + 256 + 1024
+    REPORTER_ASSERT(r, 1365 == count);
+}
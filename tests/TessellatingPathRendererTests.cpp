@@ -7,6 +7,7 @@
 
 #if SK_SUPPORT_GPU
 #include "GrContextFactory.h"
+#include "GrGpu.h"
 #include "GrTessellatingPathRenderer.h"
 #include "GrTest.h"
 #include "Test.h"
@@ -271,4 +272,68 @@ DEF_GPUTEST(TessellatingPathRendererTests, reporter, factory) {
     test_path(dt, rt, create_path_14());
     test_path(dt, rt, create_path_15());
 }
+
+static void draw_cached(GrContext* context, GrRenderTarget* rt, const SkPath& path,
+                        const SkMatrix& viewMatrix) {
+    GrTessellatingPathRenderer tess(context);
+    GrTestTarget tt;
+    context->getTestTarget(&tt);
+    GrPipelineBuilder pipelineBuilder;
+    pipelineBuilder.setRenderTarget(rt);
+    SkStrokeRec stroke(SkStrokeRec::kFill_InitStyle);
+    tess.drawPath(tt.target(), &pipelineBuilder, SK_ColorWHITE, viewMatrix, path, stroke, false);
+}
+
+static int resource_count(GrContext* context) {
+    int count;
+    context->getResourceCacheUsage(&count, NULL);
+    return count;
+}
+
+// Tests that redrawing a path reuses its tessellation, and that editing the path or
+// drawing it at another scale does not.
+DEF_GPUTEST(TessellatingPathRendererCache, reporter, factory) {
+    GrContext* context = factory->get(static_cast<GrContextFactory::GLContextType>(0));
+    if (NULL == context) {
+        return;
+    }
+    GrSurfaceDesc desc;
+    desc.fFlags = kRenderTarget_GrSurfaceFlag;
+    desc.fWidth = 100;
+    desc.fHeight = 100;
+    desc.fConfig = kSkia8888_GrPixelConfig;
+    SkAutoTUnref<GrTexture> texture(
+        context->refScratchTexture(desc, GrContext::kExact_ScratchTexMatch)
+    );
+    GrRenderTarget* rt = texture->asRenderTarget();
+
+    SkPath path = create_path_1();
+    int count = resource_count(context);
+    draw_cached(context, rt, path, SkMatrix::I());
+    REPORTER_ASSERT(reporter, count + 1 == resource_count(context));
+    draw_cached(context, rt, path, SkMatrix::I());
+    REPORTER_ASSERT(reporter, count + 1 == resource_count(context));
+#if GR_GPU_STATS
+    GrGpu::Stats* stats = context->getGpu()->stats();
+    int hits = stats->tessellationCacheHits();
+    int misses = stats->tessellationCacheMisses();
+    draw_cached(context, rt, path, SkMatrix::I());
+    REPORTER_ASSERT(reporter, hits + 1 == stats->tessellationCacheHits());
+    REPORTER_ASSERT(reporter, misses == stats->tessellationCacheMisses());
+
+    SkMatrix scale;
+    scale.setScale(4, 4);
+    draw_cached(context, rt, path, scale);
+    REPORTER_ASSERT(reporter, misses + 1 == stats->tessellationCacheMisses());
+
+    path.lineTo(5, 5);
+    draw_cached(context, rt, path, SkMatrix::I());
+    REPORTER_ASSERT(reporter, misses + 2 == stats->tessellationCacheMisses());
+
+    path.setIsVolatile(true);
+    draw_cached(context, rt, path, SkMatrix::I());
+    REPORTER_ASSERT(reporter, misses + 2 == stats->tessellationCacheMisses());
+    REPORTER_ASSERT(reporter, hits + 1 == stats->tessellationCacheHits());
+#endif
+}
 #endif
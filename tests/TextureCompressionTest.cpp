@@ -9,7 +9,11 @@
 #include "SkData.h"
 #include "SkEndian.h"
 #include "SkImageInfo.h"
+#include "SkRandom.h"
 #include "SkTextureCompressor.h"
+#include "SkTextureCompressor_ASTC.h"
+#include "SkTextureCompressor_LATC.h"
+#include "SkTextureCompressor_R11EAC.h"
 #include "Test.h"
 
 // TODO: Create separate tests for RGB and RGBA data once
@@ -302,3 +306,60 @@ DEF_TEST(CompressLATC, reporter) {
         }
     }
 }
+
+/**
+ * Make sure that the platform-specific compressors, and compressing large images in bands,
+ * give the same results as the portable compressors working on the whole image.
+ */
+DEF_TEST(CompressAlphaOptsAndBands, reporter) {
+    // Divisible by 12 (ASTC) but not 16, so SIMD compressors have blocks left over in each row,
+    // and tall enough to be split into bands.
+    static const int kWidth = 492;
+    static const int kHeight = 264;
+    static const size_t kRowBytes = kWidth + 16;
+
+    // A mix of solid transparent, solid opaque and noisy blocks.
+    SkAutoMalloc srcMemory(kRowBytes * kHeight);
+    uint8_t* src = reinterpret_cast<uint8_t*>(srcMemory.get());
+    SkRandom rand;
+    for (int y = 0; y < kHeight; ++y) {
+        for (int x = 0; x < kWidth; ++x) {
+            switch ((x / 8 + y / 8) % 3) {
+                case 0:  src[y * kRowBytes + x] = 0;                    break;
+                case 1:  src[y * kRowBytes + x] = 0xFF;                 break;
+                default: src[y * kRowBytes + x] = rand.nextU() & 0xFF;  break;
+            }
+        }
+    }
+
+    static const struct {
+        SkTextureCompressor::Format            fFormat;
+        SkTextureCompressor::CompressionProc   fPortableProc;
+    } kFormats[] = {
+        { SkTextureCompressor::kLATC_Format,       SkTextureCompressor::CompressA8ToLATC },
+        { SkTextureCompressor::kR11_EAC_Format,    SkTextureCompressor::CompressA8ToR11EAC },
+        { SkTextureCompressor::kASTC_12x12_Format, SkTextureCompressor::CompressA8To12x12ASTC },
+    };
+
+    for (size_t i = 0; i < SK_ARRAY_COUNT(kFormats); ++i) {
+        const SkTextureCompressor::Format fmt = kFormats[i].fFormat;
+        const int size = SkTextureCompressor::GetCompressedDataSize(fmt, kWidth, kHeight);
+        REPORTER_ASSERT(reporter, size > 0);
+
+        SkAutoMalloc expected(size), portable(size), opt(size);
+        REPORTER_ASSERT(reporter,
+                        kFormats[i].fPortableProc((uint8_t*)expected.get(), src,
+                                                  kWidth, kHeight, kRowBytes));
+        REPORTER_ASSERT(reporter,
+                        SkTextureCompressor::CompressBufferToFormat(
+                            (uint8_t*)portable.get(), src, kAlpha_8_SkColorType,
+                            kWidth, kHeight, kRowBytes, fmt, false));
+        REPORTER_ASSERT(reporter,
+                        SkTextureCompressor::CompressBufferToFormat(
+                            (uint8_t*)opt.get(), src, kAlpha_8_SkColorType,
+                            kWidth, kHeight, kRowBytes, fmt, true));
+
+        REPORTER_ASSERT(reporter, 0 == memcmp(expected.get(), portable.get(), size));
+        REPORTER_ASSERT(reporter, 0 == memcmp(expected.get(), opt.get(), size));
+    }
+}
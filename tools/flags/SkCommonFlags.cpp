@@ -43,6 +43,8 @@ DEFINE_bool(preAbandonGpuContext, false, "Abandons the GrContext before running
 
 DEFINE_bool(abandonGpuContext, false, "Abandon the GrContext after running each test.");
 
+DEFINE_bool(analyticAA, false, "Anti-alias paths with analytic coverage instead of supersampling.");
+
 DEFINE_string(skps, "skps", "Directory to read skps from.");
 
 DEFINE_int32(threads, -1, "Run threadsafe tests on a threadpool with this many extra threads, "
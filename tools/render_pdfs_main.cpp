@@ -16,6 +16,7 @@
 #include "SkStream.h"
 #include "SkTArray.h"
 #include "SkTSort.h"
+#include "SkTaskGroup.h"
 #include "ProcStats.h"
 
 __SK_FORCE_IMAGE_DECODER_LINKING;
@@ -56,6 +57,9 @@ DEFINE_string2(match, m, "",
                "If a file does not match any list entry,\n"
                "it is skipped unless some list entry starts with ~");
 
+DEFINE_int32(threads, -1,
+             "Threads to compress PDF streams and images on. Default NUM_CPUS.");
+
 /** Replaces the extension of a file.
  * @param path File name whose extension will be changed.
  * @param old_extension The old extension.
@@ -190,6 +194,7 @@ int tool_main_core(int argc, char** argv) {
     SkCommandLineFlags::Parse(argc, argv);
 
     SkAutoGraphics ag;
+    SkTaskGroup::Enabler enabled(FLAGS_threads);
 
     SkString outputDir;
     if (FLAGS_outputDir.count() > 0) {